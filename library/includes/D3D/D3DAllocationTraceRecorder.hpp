@@ -0,0 +1,117 @@
+#ifndef D3D_ALLOCATION_TRACE_RECORDER_HPP_
+#define D3D_ALLOCATION_TRACE_RECORDER_HPP_
+#include <D3DHeaders.hpp>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Gaia
+{
+// Records the allocations of the memory manager and the shared buffers to a binary file, so the
+// allocation strategies can be tuned offline against the traces of real sessions. The events are
+// buffered and only written when the buffer is full or flushed.
+class AllocationTraceRecorder
+{
+	static constexpr size_t s_bufferedEventCount = 4'096u;
+
+public:
+	enum class EventType : std::uint8_t
+	{
+		Allocate,
+		Deallocate,
+		SharedAllocate,
+		SharedRelinquish
+	};
+
+	// The owner is the memoryID of a heap or the ID of a shared buffer. With the offset, it
+	// identifies an allocation, so a deallocation can be matched with it when replaying.
+	struct Event
+	{
+		UINT64        size;
+		UINT64        alignment;
+		UINT64        offset;
+		std::uint32_t frameNumber;
+		std::uint16_t ownerID;
+		EventType     type;
+		// The D3D12_HEAP_TYPE, with the MSAA flag on the top bit.
+		std::uint8_t  heapType;
+	};
+
+	static_assert(sizeof(Event) == 32u, "The events should be tightly packed.");
+
+	// "GTRC", followed by the version and then the events.
+	static constexpr std::uint32_t s_fileMagic    = 0x43525447u;
+	static constexpr std::uint32_t s_fileVersion  = 1u;
+	static constexpr std::uint8_t  s_msaaHeapFlag = 0x80u;
+
+public:
+	// Overwrites the file if it already exists.
+	AllocationTraceRecorder(const std::string& filePath);
+	~AllocationTraceRecorder() noexcept;
+
+	// Can be called from multiple threads.
+	void RecordHeapEvent(
+		EventType type, D3D12_HEAP_TYPE heapType, bool msaa, std::uint16_t memoryID,
+		UINT64 offset, UINT64 size, UINT64 alignment
+	) noexcept;
+	void RecordSharedBufferEvent(
+		EventType type, std::uint16_t bufferID, UINT64 offset, UINT64 size
+	) noexcept;
+
+	// Should be called once per frame.
+	void AdvanceFrame() noexcept;
+
+	// Writes the buffered events to the file.
+	void Flush() noexcept;
+
+	[[nodiscard]]
+	static std::vector<Event> ReadTrace(const std::string& filePath);
+
+	[[nodiscard]]
+	static D3D12_HEAP_TYPE GetHeapType(const Event& event) noexcept
+	{
+		return static_cast<D3D12_HEAP_TYPE>(event.heapType & ~s_msaaHeapFlag);
+	}
+	[[nodiscard]]
+	static bool IsMSAA(const Event& event) noexcept
+	{
+		return event.heapType & s_msaaHeapFlag;
+	}
+
+private:
+	void Record(const Event& event) noexcept;
+	// The mutex must be locked.
+	void FlushLocked() noexcept;
+
+private:
+	std::ofstream               m_traceFile;
+	// The buffer is reserved, so recording an event never allocates.
+	std::vector<Event>          m_bufferedEvents;
+	std::uint32_t               m_frameNumber;
+	// In a pointer, so the recorder can still be moved.
+	std::unique_ptr<std::mutex> m_mutex;
+
+public:
+	AllocationTraceRecorder(const AllocationTraceRecorder&) = delete;
+	AllocationTraceRecorder& operator=(const AllocationTraceRecorder&) = delete;
+
+	AllocationTraceRecorder(AllocationTraceRecorder&& other) noexcept
+		: m_traceFile{ std::move(other.m_traceFile) },
+		m_bufferedEvents{ std::move(other.m_bufferedEvents) },
+		m_frameNumber{ other.m_frameNumber }, m_mutex{ std::move(other.m_mutex) }
+	{}
+	AllocationTraceRecorder& operator=(AllocationTraceRecorder&& other) noexcept
+	{
+		m_traceFile      = std::move(other.m_traceFile);
+		m_bufferedEvents = std::move(other.m_bufferedEvents);
+		m_frameNumber    = other.m_frameNumber;
+		m_mutex          = std::move(other.m_mutex);
+
+		return *this;
+	}
+};
+}
+#endif
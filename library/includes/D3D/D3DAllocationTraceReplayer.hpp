@@ -0,0 +1,63 @@
+#ifndef D3D_ALLOCATION_TRACE_REPLAYER_HPP_
+#define D3D_ALLOCATION_TRACE_REPLAYER_HPP_
+#include <D3DAllocator.hpp>
+#include <D3DAllocationTraceRecorder.hpp>
+#include <D3DSharedBuffer.hpp>
+#include <vector>
+
+namespace Gaia
+{
+// Feeds a recorded trace through the memory manager and the shared buffer allocator, without a
+// device. The heaps are only bookkeeping, so the allocator settings can be compared on the CPU.
+class AllocationTraceReplayer
+{
+public:
+	struct Settings
+	{
+		HeapAllocatorType        allocatorType;
+		// The same as the render engine's.
+		UINT64                   initialBudgetGPU;
+		UINT64                   initialBudgetCPU;
+		SharedBufferGrowthPolicy sharedBufferGrowthPolicy;
+	};
+
+	struct Report
+	{
+		size_t eventCount;
+		// The deallocations of the allocations which were made before the recording started.
+		size_t unmatchedEventCount;
+		size_t frameCount;
+		UINT64 peakHeapSize;
+		UINT64 peakHeapUsedSize;
+		// Sampled at the end of every frame. 0 if all of the free memory of each heap is
+		// contiguous.
+		float  averageHeapFragmentation;
+		UINT64 peakSharedBufferSize;
+		UINT64 peakSharedBufferUsedSize;
+		float  averageSharedBufferFragmentation;
+		double replayMilliseconds;
+	};
+
+public:
+	AllocationTraceReplayer(const Settings& settings) : m_settings{ settings } {}
+
+	[[nodiscard]]
+	Report Replay(const std::vector<AllocationTraceRecorder::Event>& events) const;
+
+	[[nodiscard]]
+	static Settings GetDefaultSettings() noexcept
+	{
+		return Settings
+		{
+			.allocatorType            = HeapAllocatorType::Buddy,
+			.initialBudgetGPU         = 20_MB,
+			.initialBudgetCPU         = 400_KB,
+			.sharedBufferGrowthPolicy = SharedBufferGrowthPolicy::GetDefaultPolicy()
+		};
+	}
+
+private:
+	Settings m_settings;
+};
+}
+#endif
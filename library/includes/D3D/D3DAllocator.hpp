@@ -1,24 +1,63 @@
 #ifndef D3D_ALLOCATOR_HPP_
 #define D3D_ALLOCATOR_HPP_
 #include <Buddy.hpp>
+#include <TLSFAllocator.hpp>
 #include <D3DHeap.hpp>
+#include <D3DHeapGrowthPolicy.hpp>
+#include <D3DHeapDefragPlanner.hpp>
+#include <D3DAllocationTraceRecorder.hpp>
+#include <GaiaException.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <queue>
+#include <thread>
+#include <variant>
+#include <vector>
 
 namespace Gaia
 {
+enum class HeapAllocatorType
+{
+	Buddy,
+	TLSF
+};
+
 class D3DAllocator
 {
+	using Allocator_t = std::variant<Callisto::Buddy, TLSFAllocator>;
+
+	static constexpr size_t s_granularity = 256_B;
+
+public:
+	struct LiveAllocation
+	{
+		UINT64 size;
+		UINT64 alignment;
+	};
+
+	using LiveAllocations_t = std::map<UINT64, LiveAllocation>;
+
 public:
-	D3DAllocator(D3DHeap&& heap, std::uint16_t id)
-		: m_heap{ std::move(heap) },
-		m_allocator{ 0u, static_cast<size_t>(m_heap.Size()), 256_B },
-		m_id{ id }
+	D3DAllocator(
+		D3DHeap&& heap, std::uint16_t id, HeapAllocatorType allocatorType = HeapAllocatorType::Buddy
+	) : m_heap{ std::move(heap) },
+		m_allocator{ CreateAllocator(static_cast<size_t>(m_heap.Size()), allocatorType) },
+		m_id{ id }, m_liveAllocations{}
 	{}
 
 	[[nodiscard]]
 	// Returns false if there is not enough memory.
-	std::optional<UINT64> Allocate(const D3D12_RESOURCE_ALLOCATION_INFO& allocInfo) noexcept;
+	std::optional<UINT64> Allocate(const D3D12_RESOURCE_ALLOCATION_INFO& allocInfo);
+	[[nodiscard]]
+	// Returns false if the range at the heapOffset isn't free.
+	bool AllocateAt(UINT64 heapOffset, const D3D12_RESOURCE_ALLOCATION_INFO& allocInfo);
 
 	void Deallocate(UINT64 startingAddress, UINT64 bufferSize, UINT64 alignment) noexcept;
 
@@ -27,17 +66,38 @@ public:
 	[[nodiscard]]
 	UINT64 Size() const noexcept { return m_heap.Size(); }
 	[[nodiscard]]
-	UINT64 AvailableSize() const noexcept
+	UINT64 AvailableSize() const noexcept;
+	[[nodiscard]]
+	// Exact for the TLSF allocator. The buddy allocator doesn't expose its blocks, so the
+	// available size is returned as the upper bound.
+	UINT64 LargestFreeBlockSize() const noexcept;
+	[[nodiscard]]
+	ID3D12Heap* GetHeap() const noexcept { return m_heap.Get(); }
+	[[nodiscard]]
+	// The allocations which haven't been deallocated yet, sorted by their offsets.
+	const LiveAllocations_t& GetLiveAllocations() const noexcept { return m_liveAllocations; }
+	[[nodiscard]]
+	HeapAllocatorType GetAllocatorType() const noexcept
 	{
-		return static_cast<UINT64>(m_allocator.AvailableSize());
+		return std::holds_alternative<TLSFAllocator>(m_allocator) ?
+			HeapAllocatorType::TLSF : HeapAllocatorType::Buddy;
 	}
+
 	[[nodiscard]]
-	ID3D12Heap* GetHeap() const noexcept { return m_heap.Get(); }
+	// The size of a new heap, which should be able to house an allocation of bufferSize.
+	static UINT64 GetMinimumRequiredNewAllocationSizeFor(
+		UINT64 bufferSize, HeapAllocatorType allocatorType
+	) noexcept;
+
+private:
+	[[nodiscard]]
+	static Allocator_t CreateAllocator(size_t heapSize, HeapAllocatorType allocatorType);
 
 private:
-	D3DHeap         m_heap;
-	Callisto::Buddy m_allocator;
-	std::uint16_t   m_id;
+	D3DHeap           m_heap;
+	Allocator_t       m_allocator;
+	std::uint16_t     m_id;
+	LiveAllocations_t m_liveAllocations;
 
 public:
 	D3DAllocator(const D3DAllocator&) = delete;
@@ -45,102 +105,584 @@ public:
 
 	D3DAllocator(D3DAllocator&& other) noexcept
 		: m_heap{ std::move(other.m_heap) }, m_allocator{ std::move(other.m_allocator) },
-		m_id{ other.m_id }
+		m_id{ other.m_id }, m_liveAllocations{ std::move(other.m_liveAllocations) }
 	{}
 	D3DAllocator& operator=(D3DAllocator&& other) noexcept
 	{
-		m_heap      = std::move(other.m_heap);
-		m_allocator = std::move(other.m_allocator);
-		m_id        = other.m_id;
+		m_heap            = std::move(other.m_heap);
+		m_allocator       = std::move(other.m_allocator);
+		m_id              = other.m_id;
+		m_liveAllocations = std::move(other.m_liveAllocations);
 
 		return *this;
 	}
 };
 
-class MemoryManager
+// Keeps the allocators of a single heap type. The allocators are indexed by their ID for the
+// deallocations. And there is a max tree of their largest free blocks for the allocations, which
+// finds the first allocator that can house a size in O(log n) instead of walking all of the heaps.
+// So, the allocators are still tried in the same order as before.
+class D3DAllocatorGroup
 {
+	static constexpr size_t s_invalidSlot = std::numeric_limits<size_t>::max();
+
 public:
-	struct MemoryAllocation
+	struct Allocation
 	{
 		UINT64        heapOffset;
 		ID3D12Heap*   heap;
-		UINT64        size;
-		UINT64        alignment;
 		std::uint16_t memoryID;
-		bool          isValid = false;
 	};
 
 public:
-	MemoryManager(
-		IDXGIAdapter3* adapter, ID3D12Device* device, UINT64 initialBudgetGPU,
-		UINT64 initialBudgetCPU
-	);
+	D3DAllocatorGroup(
+		HeapAllocatorType allocatorType = HeapAllocatorType::Buddy,
+		D3D12_HEAP_TYPE heapType = D3D12_HEAP_TYPE_DEFAULT
+	) : m_allocators{}, m_slotsByID{}, m_freeBlockTree{}, m_leafCount{ 0u }, m_idleFrameCounts{},
+		m_evacuatingSlots{}, m_evictedSlots{}, m_availableIDs{}, m_allocatorType{ allocatorType },
+		m_growthPolicy{ HeapGrowthPolicy::GetDefaultSettings(heapType) }
+	{}
 
 	[[nodiscard]]
-	MemoryAllocation Allocate(
-		const D3D12_RESOURCE_DESC& resourceDesc, D3D12_HEAP_TYPE heapType, bool msaa = false
+	std::optional<Allocation> Allocate(const D3D12_RESOURCE_ALLOCATION_INFO& allocInfo);
+
+	// Returns the ID of the new allocator.
+	std::uint16_t AddAllocator(D3DHeap&& heap);
+	[[nodiscard]]
+	// Allocates from the specified allocator only.
+	std::optional<Allocation> AllocateFrom(
+		std::uint16_t id, const D3D12_RESOURCE_ALLOCATION_INFO& allocInfo
+	);
+	[[nodiscard]]
+	// Allocates at the heapOffset of the specified allocator only. Even an evacuating allocator
+	// can be used.
+	std::optional<Allocation> AllocateAt(
+		std::uint16_t id, UINT64 heapOffset, const D3D12_RESOURCE_ALLOCATION_INFO& allocInfo
 	);
 
-	void Deallocate(
-		const MemoryAllocation& allocation, D3D12_HEAP_TYPE heapType, bool msaa = false
+	// Returns true if the allocator is empty after the deallocation.
+	bool Deallocate(
+		std::uint16_t id, UINT64 startingAddress, UINT64 bufferSize, UINT64 alignment
 	) noexcept;
 
-private:
+	void RemoveAllocator(std::uint16_t id) noexcept;
+
+	// Should be called once per frame. The allocators which have been empty for more than
+	// idleFramesBeforeRelease frames are removed, but the last allocator is always kept. The
+	// evacuating and evicted allocators are removed as soon as they are empty.
+	void ReleaseIdleAllocators(std::uint32_t idleFramesBeforeRelease) noexcept;
+
+	// An evacuating allocator isn't used by Allocate, so the resources which are moved out of it
+	// don't end up in it again.
+	void SetEvacuating(std::uint16_t id, bool evacuating) noexcept;
+	void ClearEvacuatingAllocators() noexcept;
+
 	[[nodiscard]]
-	std::vector<D3DAllocator>& GetAllocators(bool cpu, bool msaa = false) noexcept;
+	bool IsEvacuating(std::uint16_t id) const noexcept;
+
+	// The heap of an evicted allocator isn't resident, so it isn't used by Allocate either.
+	void SetEvicted(std::uint16_t id, bool evicted) noexcept;
+
 	[[nodiscard]]
-	std::queue<std::uint16_t>& GetAvailableIndices(bool cpu, bool msaa = false) noexcept;
+	bool IsEvicted(std::uint16_t id) const noexcept;
+
+	void SetAllocatorType(HeapAllocatorType allocatorType) noexcept
+	{
+		m_allocatorType = allocatorType;
+	}
+
 	[[nodiscard]]
-	UINT64 GetAvailableMemory() const noexcept;
+	HeapAllocatorType GetAllocatorType() const noexcept { return m_allocatorType; }
+	[[nodiscard]]
+	size_t GetAllocatorCount() const noexcept { return std::size(m_allocators); }
+	[[nodiscard]]
+	const std::vector<D3DAllocator>& GetAllocators() const noexcept { return m_allocators; }
 	[[nodiscard]]
-	std::uint16_t GetID(bool cpu, bool msaa = false) noexcept;
+	HeapGrowthPolicy& GetGrowthPolicy() noexcept { return m_growthPolicy; }
 	[[nodiscard]]
-	D3DHeap CreateHeap(D3D12_HEAP_TYPE type, UINT64 size, bool msaa = false) const;
+	const HeapGrowthPolicy& GetGrowthPolicy() const noexcept { return m_growthPolicy; }
 
+private:
+	[[nodiscard]]
+	std::uint16_t GetNewID() noexcept;
 	[[nodiscard]]
-	UINT64 GetNewAllocationSize(D3D12_HEAP_TYPE heapType) const noexcept;
+	size_t GetSlot(std::uint16_t id) const noexcept;
 
+	[[nodiscard]]
+	std::optional<Allocation> AllocateFromSlot(
+		size_t slot, const D3D12_RESOURCE_ALLOCATION_INFO& allocInfo
+	);
+	[[nodiscard]]
+	UINT64 GetFreeBlockKey(size_t slot) const noexcept
+	{
+		return m_freeBlockTree[m_leafCount + slot];
+	}
+	// The key must never be lower than the actual largest free block of the allocator, or it
+	// would be skipped.
+	void SetFreeBlockKey(size_t slot, UINT64 freeBlockSize) noexcept;
+	[[nodiscard]]
+	// Returns the first slot at or after the startingSlot, whose key is at least the size.
+	size_t FindSlot(UINT64 size, size_t startingSlot) const noexcept;
+	// Doubles the leaf count, when all of the leaves are used.
+	void GrowFreeBlockTree();
+
+private:
+	std::vector<D3DAllocator>  m_allocators;
+	std::vector<size_t>        m_slotsByID;
+	// The leaves are the keys of the slots, which are the upper bounds of their largest free
+	// blocks. Every other node has the max of its children. The root is at 1.
+	std::vector<UINT64>        m_freeBlockTree;
+	size_t                     m_leafCount;
+	// The number of frames each slot has been empty for.
+	std::vector<std::uint32_t> m_idleFrameCounts;
+	std::vector<bool>          m_evacuatingSlots;
+	std::vector<bool>          m_evictedSlots;
+	std::queue<std::uint16_t>  m_availableIDs;
+	HeapAllocatorType          m_allocatorType;
+	HeapGrowthPolicy           m_growthPolicy;
+
+public:
+	D3DAllocatorGroup(const D3DAllocatorGroup&) = delete;
+	D3DAllocatorGroup& operator=(const D3DAllocatorGroup&) = delete;
+
+	D3DAllocatorGroup(D3DAllocatorGroup&& other) noexcept
+		: m_allocators{ std::move(other.m_allocators) },
+		m_slotsByID{ std::move(other.m_slotsByID) },
+		m_freeBlockTree{ std::move(other.m_freeBlockTree) },
+		m_leafCount{ other.m_leafCount },
+		m_idleFrameCounts{ std::move(other.m_idleFrameCounts) },
+		m_evacuatingSlots{ std::move(other.m_evacuatingSlots) },
+		m_evictedSlots{ std::move(other.m_evictedSlots) },
+		m_availableIDs{ std::move(other.m_availableIDs) },
+		m_allocatorType{ other.m_allocatorType },
+		m_growthPolicy{ other.m_growthPolicy }
+	{}
+	D3DAllocatorGroup& operator=(D3DAllocatorGroup&& other) noexcept
+	{
+		m_allocators      = std::move(other.m_allocators);
+		m_slotsByID       = std::move(other.m_slotsByID);
+		m_freeBlockTree   = std::move(other.m_freeBlockTree);
+		m_leafCount       = other.m_leafCount;
+		m_idleFrameCounts = std::move(other.m_idleFrameCounts);
+		m_evacuatingSlots = std::move(other.m_evacuatingSlots);
+		m_evictedSlots    = std::move(other.m_evictedSlots);
+		m_availableIDs    = std::move(other.m_availableIDs);
+		m_allocatorType   = other.m_allocatorType;
+		m_growthPolicy    = other.m_growthPolicy;
+
+		return *this;
+	}
+};
+
+// Creates the heaps and queries the device for the MemoryManager. The allocation logic can then be
+// used with a fake provider, without a device.
+class D3DHeapProvider
+{
+public:
+	D3DHeapProvider(IDXGIAdapter3* adapter, ID3D12Device* device)
+		: m_adapter{ adapter }, m_device{ device }
+	{}
+
+	[[nodiscard]]
+	D3DHeap CreateHeap(D3D12_HEAP_TYPE type, UINT64 size, bool msaa) const;
+	[[nodiscard]]
+	UINT64 GetAvailableMemory() const noexcept;
 	[[nodiscard]]
 	D3D12_RESOURCE_ALLOCATION_INFO GetAllocationInfo(
 		const D3D12_RESOURCE_DESC& resourceDesc
 	) const noexcept;
 
 private:
-	IDXGIAdapter3*            m_adapter;
-	ID3D12Device*             m_device;
-	std::vector<D3DAllocator> m_cpuAllocators;
-	std::vector<D3DAllocator> m_gpuAllocators;
-	std::vector<D3DAllocator> m_msaaAllocators;
-	std::queue<std::uint16_t> m_availableGPUIndices;
-	std::queue<std::uint16_t> m_availableCPUIndices;
-	std::queue<std::uint16_t> m_availableMsaaIndices;
+	IDXGIAdapter3* m_adapter;
+	ID3D12Device*  m_device;
+};
+
+// Allocate and Deallocate can be called from multiple threads. The small buffers are freed into
+// and reused from 16 cache shards, where each thread uses the shard its ID hashes to. So, the
+// threads rarely wait on each other for those, but a shard can still be shared by a few threads.
+// Everything else locks the allocator groups. This part doesn't need the heap provider.
+class MemoryManagerBase
+{
+	// Only the small buffers with the default 64KB alignment are cached, from 64KB to 256KB.
+	static constexpr UINT64 s_cachedAlignment      = 64_KB;
+	static constexpr size_t s_cachedSizeClassCount = 4u;
+	static constexpr size_t s_cachedBlocksPerClass = 16u;
+	static constexpr size_t s_cacheCount           = 16u;
+	// The CPU, GPU and MSAA groups.
+	static constexpr size_t s_groupCount           = 3u;
+
+	using CachedBlocks_t = std::vector<D3DAllocatorGroup::Allocation>;
+
+	struct AllocationCache
+	{
+		std::mutex                                                      mutex;
+		std::array<CachedBlocks_t, s_groupCount * s_cachedSizeClassCount> blocks;
+		// The allocations which were taken from the cache, since the growth policies were
+		// last updated.
+		std::array<std::uint32_t, s_groupCount * s_cachedSizeClassCount>  hitCounts{};
+	};
+
+	using AllocationCaches_t = std::array<AllocationCache, s_cacheCount>;
 
 public:
-	MemoryManager(const MemoryManager&) = delete;
-	MemoryManager& operator=(const MemoryManager&) = delete;
+	struct MemoryAllocation
+	{
+		UINT64        heapOffset;
+		ID3D12Heap*   heap;
+		UINT64        size;
+		UINT64        alignment;
+		std::uint16_t memoryID;
+		bool          isValid = false;
+	};
+
+public:
+	MemoryManagerBase();
+
+	void Deallocate(
+		const MemoryAllocation& allocation, D3D12_HEAP_TYPE heapType, bool msaa = false
+	) noexcept;
+
+	// Only the heaps which are created after this call will use the new allocator type.
+	void SetAllocatorType(
+		D3D12_HEAP_TYPE heapType, HeapAllocatorType allocatorType, bool msaa = false
+	) noexcept;
+
+	void SetGrowthPolicySettings(
+		D3D12_HEAP_TYPE heapType, const HeapGrowthPolicy::Settings& settings, bool msaa = false
+	) noexcept;
+
+	// Every allocation and deallocation will be recorded, until it is set to nullptr. The
+	// recorder must outlive the recording.
+	void SetTraceRecorder(AllocationTraceRecorder* traceRecorder) noexcept
+	{
+		m_traceRecorder = traceRecorder;
+	}
 
-	MemoryManager(MemoryManager&& other) noexcept
-		: m_adapter{ other.m_adapter }, m_device{ other.m_device },
-		m_cpuAllocators{ std::move(other.m_cpuAllocators) },
+	// Should be called once per frame, after the GPU has finished with the frame. Returns the
+	// cached blocks to their heaps, so they don't keep the heaps alive. Then releases the GPU
+	// and MSAA heaps which have been empty for a while.
+	void ReleaseIdleHeaps() noexcept;
+
+	[[nodiscard]]
+	// The heaps and their live allocations for the defragmentation. None of the allocations are
+	// marked as movable, as only the owners of the resources know if they can be moved.
+	std::vector<HeapDefragPlanner::Heap> GetDefragHeaps(
+		D3D12_HEAP_TYPE heapType, bool msaa = false
+	);
+
+	// The new resources won't be allocated on an evacuating heap and it will be released once
+	// it is empty.
+	void SetHeapEvacuating(
+		std::uint16_t memoryID, D3D12_HEAP_TYPE heapType, bool evacuating, bool msaa = false
+	) noexcept;
+	void ClearEvacuatingHeaps(D3D12_HEAP_TYPE heapType, bool msaa = false) noexcept;
+
+	// Should be called after a heap has been evicted or made resident. The new resources won't
+	// be allocated on an evicted heap either.
+	void SetHeapEvicted(
+		std::uint16_t memoryID, D3D12_HEAP_TYPE heapType, bool evicted, bool msaa = false
+	) noexcept;
+
+	// Calls the function with each allocator group, its heap type and if it is the MSAA group.
+	// The groups are locked during the call.
+	template<typename Function>
+	void ForEachAllocatorGroup(Function&& function) const
+	{
+		std::scoped_lock allocatorLock{ *m_allocatorMutex };
+
+		function(m_cpuAllocators, D3D12_HEAP_TYPE_UPLOAD, false);
+		function(m_gpuAllocators, D3D12_HEAP_TYPE_DEFAULT, false);
+		function(m_msaaAllocators, D3D12_HEAP_TYPE_DEFAULT, true);
+	}
+
+protected:
+	[[nodiscard]]
+	D3DAllocatorGroup& GetAllocators(bool cpu, bool msaa = false) noexcept
+	{
+		return cpu ? m_cpuAllocators : (msaa ? m_msaaAllocators : m_gpuAllocators);
+	}
+
+	[[nodiscard]]
+	// Takes a block out of the cache shard of this thread, if there is one of the size.
+	std::optional<D3DAllocatorGroup::Allocation> AllocateFromCache(
+		UINT64 size, UINT64 alignment, bool cpu, bool msaa
+	) noexcept;
+
+	void RecordAllocation(
+		const MemoryAllocation& allocation, D3D12_HEAP_TYPE heapType, bool msaa
+	) const noexcept;
+
+	// The allocator mutex must be locked. The cache hits don't lock it, so they are added to
+	// the growth policies here, before a policy is used to size a new heap.
+	void RecordCacheHits() noexcept;
+
+private:
+	[[nodiscard]]
+	AllocationCache& GetThreadCache() noexcept
+	{
+		const size_t cacheIndex
+			= std::hash<std::thread::id>{}(std::this_thread::get_id()) % s_cacheCount;
+
+		return (*m_allocationCaches)[cacheIndex];
+	}
+
+	[[nodiscard]]
+	// Returns the index of the block list in a cache, if the allocation can be cached.
+	static std::optional<size_t> GetCachedBlocksIndex(
+		UINT64 size, UINT64 alignment, bool cpu, bool msaa
+	) noexcept;
+
+	// The allocator mutex must be locked.
+	void DeallocateLocked(
+		D3DAllocatorGroup& allocators, bool isCPUAccessible, std::uint16_t memoryID,
+		UINT64 heapOffset, UINT64 size, UINT64 alignment
+	) noexcept;
+	// The allocator mutex must be locked.
+	void FlushCaches() noexcept;
+	// The allocator mutex must be locked. Sets the flag before flushing the caches, so a block
+	// which is freed during the flush either sees the flag or is flushed with its shard.
+	void FlushCachesForUnavailableHeap() noexcept;
+	// The allocator mutex must be locked.
+	void UpdateUnavailableHeapsFlag() noexcept;
+
+protected:
+	D3DAllocatorGroup                     m_cpuAllocators;
+	D3DAllocatorGroup                     m_gpuAllocators;
+	D3DAllocatorGroup                     m_msaaAllocators;
+	// In pointers, so the manager can still be moved.
+	std::unique_ptr<std::mutex>           m_allocatorMutex;
+	std::unique_ptr<AllocationCaches_t>   m_allocationCaches;
+	// The freed blocks of an evacuating or evicted heap shouldn't be cached, or they would be
+	// reused. It is read with the lock of a shard held.
+	std::atomic_bool                      m_hasUnavailableHeaps;
+	std::atomic<AllocationTraceRecorder*> m_traceRecorder;
+
+public:
+	MemoryManagerBase(const MemoryManagerBase&) = delete;
+	MemoryManagerBase& operator=(const MemoryManagerBase&) = delete;
+
+	MemoryManagerBase(MemoryManagerBase&& other) noexcept
+		: m_cpuAllocators{ std::move(other.m_cpuAllocators) },
 		m_gpuAllocators{ std::move(other.m_gpuAllocators) },
 		m_msaaAllocators{ std::move(other.m_msaaAllocators) },
-		m_availableGPUIndices{ std::move(other.m_availableGPUIndices) },
-		m_availableCPUIndices{ std::move(other.m_availableCPUIndices) },
-		m_availableMsaaIndices{ std::move(other.m_availableMsaaIndices) }
+		m_allocatorMutex{ std::move(other.m_allocatorMutex) },
+		m_allocationCaches{ std::move(other.m_allocationCaches) },
+		m_hasUnavailableHeaps{ other.m_hasUnavailableHeaps.load() },
+		m_traceRecorder{ other.m_traceRecorder.load() }
+	{}
+	MemoryManagerBase& operator=(MemoryManagerBase&& other) noexcept
+	{
+		m_cpuAllocators       = std::move(other.m_cpuAllocators);
+		m_gpuAllocators       = std::move(other.m_gpuAllocators);
+		m_msaaAllocators      = std::move(other.m_msaaAllocators);
+		m_allocatorMutex      = std::move(other.m_allocatorMutex);
+		m_allocationCaches    = std::move(other.m_allocationCaches);
+		m_hasUnavailableHeaps = other.m_hasUnavailableHeaps.load();
+		m_traceRecorder       = other.m_traceRecorder.load();
+
+		return *this;
+	}
+};
+
+// Creates the new heaps of the MemoryManagerBase with the heap provider.
+template<class HeapProvider_t>
+class MemoryManagerGeneric : public MemoryManagerBase
+{
+public:
+	MemoryManagerGeneric(
+		IDXGIAdapter3* adapter, ID3D12Device* device, UINT64 initialBudgetGPU,
+		UINT64 initialBudgetCPU
+	);
+
+	[[nodiscard]]
+	MemoryAllocation Allocate(
+		const D3D12_RESOURCE_DESC& resourceDesc, D3D12_HEAP_TYPE heapType, bool msaa = false
+	);
+	[[nodiscard]]
+	// Allocates at the exact heapOffset of the heap, i.e. for a planned relocation. A new heap
+	// is never created, so the allocation won't be valid if the range isn't free.
+	MemoryAllocation AllocateAt(
+		const D3D12_RESOURCE_DESC& resourceDesc, D3D12_HEAP_TYPE heapType,
+		std::uint16_t memoryID, UINT64 heapOffset, bool msaa = false
+	);
+
+private:
+	[[nodiscard]]
+	MemoryAllocation AllocateFromHeaps(
+		const D3D12_RESOURCE_DESC& resourceDesc, D3D12_HEAP_TYPE heapType, bool msaa
+	);
+
+private:
+	HeapProvider_t m_heapProvider;
+
+public:
+	MemoryManagerGeneric(const MemoryManagerGeneric&) = delete;
+	MemoryManagerGeneric& operator=(const MemoryManagerGeneric&) = delete;
+
+	MemoryManagerGeneric(MemoryManagerGeneric&& other) noexcept
+		: MemoryManagerBase{ std::move(other) },
+		m_heapProvider{ std::move(other.m_heapProvider) }
 	{}
-	MemoryManager& operator=(MemoryManager&& other) noexcept
+	MemoryManagerGeneric& operator=(MemoryManagerGeneric&& other) noexcept
 	{
-		m_adapter              = other.m_adapter;
-		m_device               = other.m_device;
-		m_cpuAllocators        = std::move(other.m_cpuAllocators);
-		m_gpuAllocators        = std::move(other.m_gpuAllocators);
-		m_msaaAllocators       = std::move(other.m_msaaAllocators);
-		m_availableGPUIndices  = std::move(other.m_availableGPUIndices);
-		m_availableCPUIndices  = std::move(other.m_availableCPUIndices);
-		m_availableMsaaIndices = std::move(other.m_availableMsaaIndices);
+		MemoryManagerBase::operator=(std::move(other));
+		m_heapProvider = std::move(other.m_heapProvider);
 
 		return *this;
 	}
 };
+
+template<class HeapProvider_t>
+MemoryManagerGeneric<HeapProvider_t>::MemoryManagerGeneric(
+	IDXGIAdapter3* adapter, ID3D12Device* device, UINT64 initialBudgetGPU, UINT64 initialBudgetCPU
+) : MemoryManagerBase{}, m_heapProvider{ adapter, device }
+{
+	const UINT64 availableMemory = m_heapProvider.GetAvailableMemory();
+
+	if (availableMemory < initialBudgetCPU + initialBudgetGPU)
+		throw Exception("MemoryException", "Not Enough memory for allocation.");
+
+	m_cpuAllocators.AddAllocator(
+		m_heapProvider.CreateHeap(D3D12_HEAP_TYPE_UPLOAD, initialBudgetCPU, false)
+	);
+	m_gpuAllocators.AddAllocator(
+		m_heapProvider.CreateHeap(D3D12_HEAP_TYPE_DEFAULT, initialBudgetCPU, false)
+	);
+}
+
+template<class HeapProvider_t>
+typename MemoryManagerGeneric<HeapProvider_t>::MemoryAllocation
+MemoryManagerGeneric<HeapProvider_t>::Allocate(
+	const D3D12_RESOURCE_DESC& resourceDesc, D3D12_HEAP_TYPE heapType, bool msaa /* = false */
+) {
+	const MemoryAllocation allocation = AllocateFromHeaps(resourceDesc, heapType, msaa);
+
+	RecordAllocation(allocation, heapType, msaa);
+
+	return allocation;
+}
+
+template<class HeapProvider_t>
+typename MemoryManagerGeneric<HeapProvider_t>::MemoryAllocation
+MemoryManagerGeneric<HeapProvider_t>::AllocateAt(
+	const D3D12_RESOURCE_DESC& resourceDesc, D3D12_HEAP_TYPE heapType,
+	std::uint16_t memoryID, UINT64 heapOffset, bool msaa /* = false */
+) {
+	const D3D12_RESOURCE_ALLOCATION_INFO allocationInfo
+		= m_heapProvider.GetAllocationInfo(resourceDesc);
+
+	std::optional<D3DAllocatorGroup::Allocation> allocation{};
+
+	{
+		std::scoped_lock allocatorLock{ *m_allocatorMutex };
+
+		allocation = GetAllocators(heapType == D3D12_HEAP_TYPE_UPLOAD, msaa).AllocateAt(
+			memoryID, heapOffset, allocationInfo
+		);
+	}
+
+	if (!allocation)
+		return MemoryAllocation{};
+
+	const MemoryAllocation memoryAllocation
+	{
+		.heapOffset = allocation->heapOffset,
+		.heap       = allocation->heap,
+		.size       = allocationInfo.SizeInBytes,
+		.alignment  = allocationInfo.Alignment,
+		.memoryID   = allocation->memoryID,
+		.isValid    = true
+	};
+
+	RecordAllocation(memoryAllocation, heapType, msaa);
+
+	return memoryAllocation;
+}
+
+template<class HeapProvider_t>
+typename MemoryManagerGeneric<HeapProvider_t>::MemoryAllocation
+MemoryManagerGeneric<HeapProvider_t>::AllocateFromHeaps(
+	const D3D12_RESOURCE_DESC& resourceDesc, D3D12_HEAP_TYPE heapType, bool msaa
+) {
+	const D3D12_RESOURCE_ALLOCATION_INFO allocationInfo
+		= m_heapProvider.GetAllocationInfo(resourceDesc);
+	const UINT64 bufferSize    = allocationInfo.SizeInBytes;
+	const bool isCPUAccessible = heapType == D3D12_HEAP_TYPE_UPLOAD;
+
+	auto MakeAllocation = [bufferSize, alignment = allocationInfo.Alignment]
+		(const D3DAllocatorGroup::Allocation& allocation) -> MemoryAllocation
+		{
+			return MemoryAllocation
+			{
+				.heapOffset = allocation.heapOffset,
+				.heap       = allocation.heap,
+				.size       = bufferSize,
+				.alignment  = alignment,
+				.memoryID   = allocation.memoryID,
+				.isValid    = true
+			};
+		};
+
+	if (std::optional<D3DAllocatorGroup::Allocation> cachedBlock = AllocateFromCache(
+			bufferSize, allocationInfo.Alignment, isCPUAccessible, msaa
+		); cachedBlock)
+		return MakeAllocation(cachedBlock.value());
+
+	std::scoped_lock allocatorLock{ *m_allocatorMutex };
+
+	D3DAllocatorGroup& allocators  = GetAllocators(isCPUAccessible, msaa);
+	HeapGrowthPolicy& growthPolicy = allocators.GetGrowthPolicy();
+
+	RecordCacheHits();
+
+	growthPolicy.RecordAllocation(bufferSize);
+
+	// Look through the already existing allocators and try to allocate the buffer.
+	if (std::optional<D3DAllocatorGroup::Allocation> allocation = allocators.Allocate(allocationInfo);
+		allocation)
+		return MakeAllocation(allocation.value());
+
+	{
+		// If the already available allocators were unable to allocate, then try to allocate new memory.
+		// If the bufferSize isn't an exponent of 2, the largest block in the
+		// buddy allocator might not be able to house it. So, we have to query the required
+		// size.
+		const UINT64 minimumRequiredSize = D3DAllocator::GetMinimumRequiredNewAllocationSizeFor(
+			bufferSize, allocators.GetAllocatorType()
+		);
+
+		const UINT64 availableMemorySize = m_heapProvider.GetAvailableMemory();
+
+		UINT64 newAllocationSize = growthPolicy.GetNewHeapSize(
+			minimumRequiredSize, availableMemorySize
+		);
+
+		// If allocation is not possible, check if the buffer can be allocated on the available memory.
+		// Going over the budget is still possible, as the OS would page the memory out. So, rather
+		// than failing, only the minimum size is allocated, and the residency manager should evict
+		// the unused heaps to get back under the budget.
+		if (newAllocationSize > availableMemorySize)
+			newAllocationSize = std::max(availableMemorySize, minimumRequiredSize);
+
+		// Since this is a new allocator. If the code reaches here, at least the top most
+		// block should have enough memory for allocation.
+		const std::uint16_t newID = allocators.AddAllocator(
+			m_heapProvider.CreateHeap(heapType, newAllocationSize, msaa)
+		);
+
+		growthPolicy.RecordNewHeap(newAllocationSize);
+
+		std::optional<D3DAllocatorGroup::Allocation> allocation = allocators.AllocateFrom(
+			newID, allocationInfo
+		);
+
+		if (allocation)
+			return MakeAllocation(allocation.value());
+		else
+			throw Exception("MemoryException", "Not Enough memory for allocation.");
+	}
+}
+
+using MemoryManager = MemoryManagerGeneric<D3DHeapProvider>;
 }
 #endif
@@ -0,0 +1,44 @@
+#ifndef D3D_BUFFER_COMPACTION_PLANNER_HPP_
+#define D3D_BUFFER_COMPACTION_PLANNER_HPP_
+#include <D3DHeaders.hpp>
+#include <map>
+#include <vector>
+
+namespace Gaia
+{
+// Decides which allocations of a shared buffer should be moved into the holes before them, so
+// the free space ends up at the end of the buffer and the buffer can be shrunk. It only works on
+// the offsets, so the copies and the updates of the offsets have to be done by the owners.
+class BufferCompactionPlanner
+{
+public:
+	struct Move
+	{
+		UINT64 srcOffset;
+		UINT64 dstOffset;
+		UINT64 size;
+	};
+
+	struct Plan
+	{
+		std::vector<Move> moves;
+		UINT64            movedBytes;
+	};
+
+public:
+	[[nodiscard]]
+	// Starts from the last allocation and moves each one to the lowest free region before it
+	// which can house it. The source regions aren't reused in the same plan, so none of the
+	// copies overlap and they can be done in any order. Stops once byteBudget bytes have been
+	// moved, but the last move can go over the budget, so a big allocation can still be moved.
+	static Plan CreatePlan(
+		const std::map<UINT64, UINT64>& freeRegions,
+		const std::map<UINT64, UINT64>& liveAllocations, UINT64 byteBudget
+	);
+
+	[[nodiscard]]
+	// The end of the last allocation.
+	static UINT64 GetUsedEnd(const std::map<UINT64, UINT64>& liveAllocations) noexcept;
+};
+}
+#endif
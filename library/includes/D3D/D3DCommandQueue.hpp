@@ -33,6 +33,15 @@ public:
 	// is implicitly promoted and doesn't require a barrier afterwards.
 	void Copy(
 		const Buffer& src, UINT64 srcOffset, const Texture& dst, UINT subresourceIndex
+	) const noexcept {
+		CopyRows(src, srcOffset, dst, subresourceIndex, 0u, dst.GetMipRowCount(subresourceIndex));
+	}
+	// Copies a band of rows, which starts at the srcOffset, to the rows starting at the
+	// firstRow of the texture. The subresource should be a mip of a texture without any array
+	// slices. The rows are rows of blocks, if the texture is block compressed.
+	void CopyRows(
+		const Buffer& src, UINT64 srcOffset, const Texture& dst, UINT subresourceIndex,
+		UINT firstRow, UINT rowCount
 	) const noexcept;
 	// Texture copied by this function will usually be used in the shaders. And so the state
 	// is implicitly promoted and doesn't require a barrier afterwards.
@@ -4,7 +4,7 @@
 #include <GraphicsTechniqueExtension.hpp>
 #include <D3DExternalResourceFactory.hpp>
 #include <D3DDescriptorHeapManager.hpp>
-#include <D3DStagingBufferManager.hpp>
+#include <D3DUploadScheduler.hpp>
 #include <ReusableVector.hpp>
 #include <D3DCommandQueue.hpp>
 
@@ -29,9 +29,10 @@ public:
 		const ExternalBufferBindingDetails& bindingDetails
 	) const;
 
-	void UploadExternalBufferGPUOnlyData(
-		StagingBufferManager& stagingBufferManager,
-		Callisto::TemporaryDataBufferGPU& tempGPUBuffer, std::uint32_t externalBufferIndex,
+	// The upload is critical, so even the data bigger than the chunk size of the scheduler is
+	// copied with the next frame. The callers expect the data to be there after that.
+	UploadTicket UploadExternalBufferGPUOnlyData(
+		UploadScheduler& uploadScheduler, std::uint32_t externalBufferIndex,
 		std::shared_ptr<void> cpuData, size_t srcDataSizeInBytes, size_t dstBufferOffset
 	) const;
 
@@ -9,6 +9,9 @@ class D3DHeap
 {
 public:
 	D3DHeap(ID3D12Device* device, D3D12_HEAP_TYPE type, UINT64 size, bool msaa = false);
+	// Doesn't create an ID3D12Heap. Should be used when only the bookkeeping of the allocators
+	// is required, i.e. in the CPU only tests.
+	D3DHeap(D3D12_HEAP_TYPE type, UINT64 size) : m_type{ type }, m_size{ size }, m_heap{} {}
 
 	[[nodiscard]]
 	ID3D12Heap* Get() const noexcept { return m_heap.Get(); }
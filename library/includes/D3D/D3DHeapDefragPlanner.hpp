@@ -0,0 +1,111 @@
+#ifndef D3D_HEAP_DEFRAG_PLANNER_HPP_
+#define D3D_HEAP_DEFRAG_PLANNER_HPP_
+#include <D3DHeaders.hpp>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace Gaia
+{
+// Decides which allocations should be moved, so some of the sparsely used heaps become empty and
+// can be released. It only works on the offsets and doesn't need a device, so the relocation has
+// to be done by the owners of the resources.
+class HeapDefragPlanner
+{
+public:
+	struct Settings
+	{
+		// Only the heaps which are used less than this will be evacuated.
+		float  maximumOccupancy;
+		// The total size of the allocations which can be moved in a single plan.
+		UINT64 maximumMovedBytes;
+	};
+
+	struct Allocation
+	{
+		UINT64 offset;
+		UINT64 size;
+		UINT64 alignment;
+		// An index which the owner can use to find the resource. Only used if it is movable.
+		size_t resourceIndex;
+		bool   isMovable;
+	};
+
+	struct Heap
+	{
+		std::uint16_t           memoryID;
+		UINT64                  size;
+		std::vector<Allocation> allocations;
+		// The buddy allocator rounds each block up to a power of 2, which is also its alignment.
+		bool                    usesPowerOfTwoBlocks = false;
+	};
+
+	struct Relocation
+	{
+		size_t        resourceIndex;
+		std::uint16_t srcMemoryID;
+		UINT64        srcOffset;
+		std::uint16_t dstMemoryID;
+		// The resource must be allocated at exactly this offset, as the later placements of the
+		// plan depend on it.
+		UINT64        dstOffset;
+		UINT64        size;
+	};
+
+	struct Plan
+	{
+		std::vector<std::uint16_t> evacuatedHeaps;
+		std::vector<Relocation>    relocations;
+		UINT64                     movedBytes;
+	};
+
+public:
+	HeapDefragPlanner(const Settings& settings) : m_settings{ settings } {}
+
+	[[nodiscard]]
+	// A heap is only evacuated if all of its allocations are movable and can be placed in the
+	// free space of the other heaps. A heap which receives an allocation won't be evacuated.
+	Plan CreatePlan(const std::vector<Heap>& heaps) const;
+
+	[[nodiscard]]
+	const Settings& GetSettings() const noexcept { return m_settings; }
+
+private:
+	struct FreeRange
+	{
+		UINT64 offset;
+		UINT64 size;
+	};
+
+	struct Placement
+	{
+		size_t heapIndex;
+		size_t rangeIndex;
+		UINT64 offset;
+		// The size of the block, which will be taken from the range.
+		UINT64 size;
+	};
+
+	using FreeRanges_t = std::vector<std::vector<FreeRange>>;
+
+	[[nodiscard]]
+	static std::vector<FreeRange> GetFreeRanges(const Heap& heap);
+	[[nodiscard]]
+	static UINT64 GetUsedSize(const Heap& heap) noexcept;
+	[[nodiscard]]
+	// The size which the allocator of the heap would actually take for an allocation.
+	static UINT64 GetBlockSize(const Heap& heap, UINT64 size, UINT64 alignment) noexcept;
+
+	[[nodiscard]]
+	// Finds the smallest free range which can house the allocation.
+	static std::optional<Placement> FindPlacement(
+		const std::vector<Heap>& heaps, const FreeRanges_t& freeRanges,
+		const std::vector<bool>& isDestination, UINT64 size, UINT64 alignment
+	) noexcept;
+	static void Place(FreeRanges_t& freeRanges, const Placement& placement);
+
+private:
+	Settings m_settings;
+};
+}
+#endif
@@ -0,0 +1,75 @@
+#ifndef D3D_HEAP_GROWTH_POLICY_HPP_
+#define D3D_HEAP_GROWTH_POLICY_HPP_
+#include <D3DHeaders.hpp>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace Gaia
+{
+// Decides the size of a new heap from the recent allocations and the remaining budget. A small
+// scene shouldn't reserve a lot of memory upfront. But if new heaps are being created back to
+// back, each new heap is made larger, so a large scene doesn't keep creating heaps.
+class HeapGrowthPolicy
+{
+	static constexpr size_t s_historySize = 32u;
+
+public:
+	struct Settings
+	{
+		UINT64        minimumHeapSize;
+		UINT64        maximumHeapSize;
+		// The fraction of the remaining budget a new heap can take at most.
+		float         budgetFraction;
+		// If a heap was created in this many allocations, the next heap will be twice as large.
+		std::uint32_t growthWindow;
+		// An empty heap is released after this many frames. Only used for the GPU heaps, as
+		// the empty CPU heaps are released right away.
+		std::uint32_t idleFramesBeforeRelease;
+	};
+
+public:
+	HeapGrowthPolicy(const Settings& settings)
+		: m_settings{ settings }, m_recentSizes{}, m_recentSizeIndex{ 0u }, m_recentTotal{ 0u },
+		m_allocationsSinceNewHeap{ std::numeric_limits<std::uint32_t>::max() },
+		m_lastHeapSize{ 0u }
+	{
+		m_recentSizes.fill(0u);
+	}
+
+	void RecordAllocation(UINT64 size) noexcept;
+	// Records count allocations of the same size at once.
+	void RecordAllocations(UINT64 size, std::uint32_t count) noexcept;
+	void RecordNewHeap(UINT64 heapSize) noexcept;
+
+	[[nodiscard]]
+	// The returned size will always be at least the minimumRequiredSize, even if it goes over the
+	// budget. The caller should check that.
+	UINT64 GetNewHeapSize(UINT64 minimumRequiredSize, UINT64 availableBudget) const noexcept;
+
+	void SetSettings(const Settings& settings) noexcept { m_settings = settings; }
+
+	[[nodiscard]]
+	const Settings& GetSettings() const noexcept { return m_settings; }
+	[[nodiscard]]
+	std::uint32_t GetIdleFramesBeforeRelease() const noexcept
+	{
+		return m_settings.idleFramesBeforeRelease;
+	}
+	[[nodiscard]]
+	// The total size of the last few allocations.
+	UINT64 GetRecentAllocationSize() const noexcept { return m_recentTotal; }
+
+	[[nodiscard]]
+	static Settings GetDefaultSettings(D3D12_HEAP_TYPE heapType) noexcept;
+
+private:
+	Settings                          m_settings;
+	std::array<UINT64, s_historySize> m_recentSizes;
+	size_t                            m_recentSizeIndex;
+	UINT64                            m_recentTotal;
+	std::uint32_t                     m_allocationsSinceNewHeap;
+	UINT64                            m_lastHeapSize;
+};
+}
+#endif
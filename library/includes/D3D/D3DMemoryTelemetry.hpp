@@ -0,0 +1,156 @@
+#ifndef D3D_MEMORY_TELEMETRY_HPP_
+#define D3D_MEMORY_TELEMETRY_HPP_
+#include <D3DHeaders.hpp>
+#include <D3DAllocator.hpp>
+#include <D3DSharedBuffer.hpp>
+#include <ThreadPool.hpp>
+#include <array>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <vector>
+
+namespace Gaia
+{
+// Reports how much of each heap and shared buffer is used and how fragmented the rest is. The
+// reports can be appended to a file as JSON every few frames, so the memory usage can be checked
+// without attaching a graphics debugger. The reports are written on the thread pool, so the frame
+// doesn't wait on the file.
+class MemoryTelemetry
+{
+public:
+	// The allocation sizes are counted in power of 2 bins. The first bin has the allocations
+	// of 256B and below and the last one has everything above 4MB.
+	static constexpr size_t s_histogramBinCount = 16u;
+
+	using Histogram_t = std::array<std::uint32_t, s_histogramBinCount>;
+
+	struct RegionStats
+	{
+		UINT64      size;
+		UINT64      usedSize;
+		UINT64      largestFreeBlock;
+		// 0 if all of the free memory is contiguous. It approaches 1 as the free memory gets
+		// split into smaller blocks.
+		float       fragmentation;
+		size_t      allocationCount;
+		Histogram_t sizeHistogram;
+	};
+
+	struct HeapReport
+	{
+		std::uint16_t     memoryID;
+		D3D12_HEAP_TYPE   heapType;
+		bool              msaa;
+		HeapAllocatorType allocatorType;
+		RegionStats       stats;
+	};
+
+	struct SharedBufferReport
+	{
+		std::string name;
+		RegionStats stats;
+	};
+
+	struct Report
+	{
+		std::uint64_t                   frameNumber;
+		std::vector<HeapReport>         heaps;
+		std::vector<SharedBufferReport> sharedBuffers;
+	};
+
+	// Collects the stats of a region. The allocations must be added in the order of their
+	// offsets.
+	class RegionStatsBuilder
+	{
+	public:
+		RegionStatsBuilder(UINT64 regionSize);
+
+		void AddAllocation(UINT64 offset, UINT64 size) noexcept;
+
+		[[nodiscard]]
+		RegionStats Build() const noexcept;
+
+	private:
+		RegionStats m_stats;
+		UINT64      m_freeStart;
+	};
+
+public:
+	// If there isn't a thread pool, the reports are written on the calling thread.
+	MemoryTelemetry(ThreadPool* threadPool)
+		: m_threadPool{ threadPool }, m_exportPath{}, m_exportInterval{ 0u },
+		m_framesSinceExport{ 0u }, m_frameNumber{ 0u }, m_exportWaitObj{}
+	{}
+	~MemoryTelemetry() noexcept;
+
+	// Exporting is disabled if the interval is 0. Each report is appended to the file as a
+	// single line of JSON.
+	void SetExport(std::uint32_t frameInterval, std::string filePath) noexcept;
+
+	[[nodiscard]]
+	// Should be called once per frame. Returns true if a report should be exported.
+	bool AdvanceFrame() noexcept;
+
+	// Waits for the previous report to be written first, so the reports stay in order.
+	void Export(Report&& report);
+
+	void WaitForExport() noexcept;
+
+	[[nodiscard]]
+	std::uint64_t GetFrameNumber() const noexcept { return m_frameNumber; }
+
+	[[nodiscard]]
+	static RegionStats GetRegionStats(const D3DAllocator& allocator);
+	[[nodiscard]]
+	static RegionStats GetRegionStats(const SharedBufferBase& sharedBuffer);
+
+	static void AddHeapReports(
+		std::vector<HeapReport>& heapReports, const D3DAllocatorGroup& allocators,
+		D3D12_HEAP_TYPE heapType, bool msaa
+	);
+	[[nodiscard]]
+	static std::vector<HeapReport> GetHeapReports(const MemoryManager& memoryManager);
+
+	[[nodiscard]]
+	static std::string ToJSON(const Report& report);
+
+	[[nodiscard]]
+	static size_t GetHistogramBin(UINT64 size) noexcept;
+
+private:
+	ThreadPool*       m_threadPool;
+	std::string       m_exportPath;
+	std::uint32_t     m_exportInterval;
+	std::uint32_t     m_framesSinceExport;
+	std::uint64_t     m_frameNumber;
+	std::future<void> m_exportWaitObj;
+
+public:
+	MemoryTelemetry(const MemoryTelemetry&) = delete;
+	MemoryTelemetry& operator=(const MemoryTelemetry&) = delete;
+
+	MemoryTelemetry(MemoryTelemetry&& other) noexcept
+		: m_threadPool{ other.m_threadPool },
+		m_exportPath{ std::move(other.m_exportPath) },
+		m_exportInterval{ other.m_exportInterval },
+		m_framesSinceExport{ other.m_framesSinceExport },
+		m_frameNumber{ other.m_frameNumber },
+		m_exportWaitObj{ std::move(other.m_exportWaitObj) }
+	{}
+	MemoryTelemetry& operator=(MemoryTelemetry&& other) noexcept
+	{
+		WaitForExport();
+
+		m_threadPool        = other.m_threadPool;
+		m_exportPath        = std::move(other.m_exportPath);
+		m_exportInterval    = other.m_exportInterval;
+		m_framesSinceExport = other.m_framesSinceExport;
+		m_frameNumber       = other.m_frameNumber;
+		m_exportWaitObj     = std::move(other.m_exportWaitObj);
+
+		return *this;
+	}
+};
+}
+#endif
@@ -72,6 +72,31 @@ public:
 		return m_perMeshBundleSharedData;
 	}
 
+	// The setters should be called after the mesh manager has moved the regions of the bundle.
+	// The details have the offsets in elements, so they are updated as well.
+	void SetVertexOffset(UINT64 offset) noexcept
+	{
+		SetOffset<Vertex>(offset, m_vertexBufferSharedData, m_meshBundleDetails.vertexOffset);
+	}
+	void SetVertexIndicesOffset(UINT64 offset) noexcept
+	{
+		SetOffset<std::uint32_t>(
+			offset, m_vertexIndicesBufferSharedData, m_meshBundleDetails.vertexIndicesOffset
+		);
+	}
+	void SetPrimIndicesOffset(UINT64 offset) noexcept
+	{
+		SetOffset<std::uint32_t>(
+			offset, m_primIndicesBufferSharedData, m_meshBundleDetails.primIndicesOffset
+		);
+	}
+	void SetPerMeshletOffset(UINT64 offset) noexcept
+	{
+		SetOffset<MeshletDetails>(
+			offset, m_perMeshletBufferSharedData, m_meshBundleDetails.meshletOffset
+		);
+	}
+
 	[[nodiscard]]
 	MeshBundleDetailsMS GetMeshBundleDetailsMS() const noexcept { return m_meshBundleDetails; }
 	[[nodiscard]]
@@ -94,6 +119,14 @@ private:
 		Callisto::TemporaryDataBufferGPU& tempBuffer
 	);
 
+	template<typename T>
+	static void SetOffset(
+		UINT64 offset, SharedBufferData& sharedData, std::uint32_t& detailOffset
+	) noexcept {
+		sharedData.offset = offset;
+		detailOffset      = static_cast<std::uint32_t>(offset / sizeof(T));
+	}
+
 private:
 	SharedBufferData    m_vertexBufferSharedData;
 	SharedBufferData    m_vertexIndicesBufferSharedData;
@@ -13,13 +13,14 @@ namespace Gaia
 {
 class D3DMeshBundleVS
 {
+	using MeshBundleDetails_t = std::vector<MeshTemporaryDetailsVS>;
+
+public:
 	struct PerMeshBundleData
 	{
 		std::uint32_t meshOffset;
 	};
 
-	using MeshBundleDetails_t = std::vector<MeshTemporaryDetailsVS>;
-
 public:
 	D3DMeshBundleVS();
 
@@ -37,6 +38,15 @@ public:
 
 	void Bind(const D3DCommandList& graphicsCmdList) const noexcept;
 
+	// The setters should be called after the mesh manager has moved the regions of the bundle.
+	void SetVertexOffset(UINT64 offset) noexcept { m_vertexBufferSharedData.offset = offset; }
+	void SetIndexOffset(UINT64 offset) noexcept { m_indexBufferSharedData.offset = offset; }
+	// The per mesh bundle data has the offset of the per mesh data, so it is uploaded again.
+	void SetPerMeshOffset(
+		UINT64 offset, StagingBufferManager& stagingBufferMan,
+		Callisto::TemporaryDataBufferGPU& tempBuffer
+	);
+
 	[[nodiscard]]
 	const SharedBufferData& GetVertexSharedData() const noexcept { return m_vertexBufferSharedData; }
 	[[nodiscard]]
@@ -62,6 +72,10 @@ private:
 		Callisto::TemporaryDataBufferGPU& tempBuffer
 	);
 
+	void UploadPerMeshBundleData(
+		StagingBufferManager& stagingBufferMan, Callisto::TemporaryDataBufferGPU& tempBuffer
+	);
+
 private:
 	SharedBufferData    m_vertexBufferSharedData;
 	SharedBufferData    m_indexBufferSharedData;
@@ -5,12 +5,25 @@
 #include <ReusableVector.hpp>
 #include <D3DSharedBuffer.hpp>
 #include <D3DStagingBufferManager.hpp>
+#include <functional>
+#include <unordered_map>
+#include <vector>
 
 namespace Gaia
 {
 template<class Derived, class D3DMeshBundle>
 class MeshManager
 {
+public:
+	struct CompactionResult
+	{
+		// Includes the copies of the shrunk buffers.
+		UINT64 copiedBytes;
+		// The GPU addresses of the recreated buffers have changed, so their descriptors must be
+		// set again.
+		bool   isBufferRecreated;
+	};
+
 public:
 	MeshManager() : m_meshBundles{}, m_oldBufferCopyNecessary{ false } {}
 
@@ -32,6 +45,27 @@ public:
 		return static_cast<std::uint32_t>(meshIndex);
 	}
 
+	[[nodiscard]]
+	// The space of all of the bundles is reserved first, so each shared buffer is extended at
+	// most once for the whole batch.
+	std::vector<std::uint32_t> AddMeshBundles(
+		std::vector<MeshBundleTemporaryData>&& meshBundles, StagingBufferManager& stagingBufferMan,
+		Callisto::TemporaryDataBufferGPU& tempBuffer
+	) {
+		static_cast<Derived*>(this)->ReserveMeshBundles(meshBundles, tempBuffer);
+
+		std::vector<std::uint32_t> bundleIndices{};
+
+		bundleIndices.reserve(std::size(meshBundles));
+
+		for (MeshBundleTemporaryData& meshBundle : meshBundles)
+			bundleIndices.emplace_back(
+				AddMeshBundle(std::move(meshBundle), stagingBufferMan, tempBuffer)
+			);
+
+		return bundleIndices;
+	}
+
 	void RemoveMeshBundle(std::uint32_t bundleIndex) noexcept
 	{
 		static_cast<Derived*>(this)->ConfigureRemoveMesh(bundleIndex);
@@ -46,6 +80,127 @@ public:
 	[[nodiscard]]
 	const D3DMeshBundle& GetBundle(size_t index) const noexcept { return m_meshBundles.at(index); }
 
+	[[nodiscard]]
+	// The shared buffers which can be moved to a different heap. The bundles only keep a pointer
+	// to the buffer objects, so they don't need to be updated after a relocation.
+	std::vector<SharedBufferGPU*> GetSharedBuffers() noexcept
+	{
+		return static_cast<Derived*>(this)->GetSharedBuffersImpl();
+	}
+
+	// Should be called after a shared buffer has been relocated, so its data is copied.
+	void SetOldBufferCopyNecessary() noexcept { m_oldBufferCopyNecessary = true; }
+
+	// Should be called once per frame, after the GPU has finished with a frame. The regions of
+	// the removed bundles are only reused after the frames which might read them have finished.
+	void ReleaseRetiredRegions(size_t frameCount) noexcept
+	{
+		for (SharedBufferGPU* sharedBuffer : GetSharedBuffers())
+			sharedBuffer->ReleaseRetiredRegions(frameCount);
+	}
+
+	[[nodiscard]]
+	// Moves the regions of the live bundles into the holes left by the removed ones and shrinks
+	// the buffers which have nothing left to move. Stops once byteBudget bytes have been copied,
+	// so it can be called every frame. The copies are done with CopyOldBuffers.
+	CompactionResult CompactBuffers(
+		UINT64 byteBudget, StagingBufferManager& stagingBufferMan,
+		Callisto::TemporaryDataBufferGPU& tempBuffer
+	) {
+		CompactionResult result{ .copiedBytes = 0u, .isBufferRecreated = false };
+
+		// The data of the new bundles might not have been uploaded yet, so it can't be moved.
+		if (m_oldBufferCopyNecessary)
+			return result;
+
+		static_cast<Derived*>(this)->CompactBuffersImpl(
+			byteBudget, result, stagingBufferMan, tempBuffer
+		);
+
+		if (result.copiedBytes)
+			m_oldBufferCopyNecessary = true;
+
+		return result;
+	}
+
+protected:
+	// getSharedData should return the SharedBufferData of a bundle in the sharedBuffer and
+	// setOffset is called with the new offset of each moved bundle.
+	template<typename GetSharedData_t, typename SetOffset_t>
+	void CompactBuffer(
+		SharedBufferGPU& sharedBuffer, UINT64 byteBudget, CompactionResult& result,
+		GetSharedData_t&& getSharedData, SetOffset_t&& setOffset,
+		Callisto::TemporaryDataBufferGPU& tempBuffer
+	) {
+		if (result.copiedBytes >= byteBudget)
+			return;
+
+		const std::vector<BufferCompactionPlanner::Move> moves = sharedBuffer.MoveRegions(
+			byteBudget - result.copiedBytes, tempBuffer
+		);
+
+		if (std::empty(moves))
+		{
+			ShrinkBuffer(sharedBuffer, byteBudget, result, tempBuffer);
+
+			return;
+		}
+
+		std::unordered_map<UINT64, size_t> bundleIndicesByOffset{};
+
+		const size_t bundleCount = std::size(m_meshBundles);
+
+		for (size_t index = 0u; index < bundleCount; ++index)
+		{
+			if (!m_meshBundles.IsInUse(index))
+				continue;
+
+			const SharedBufferData& sharedData = std::invoke(getSharedData, m_meshBundles[index]);
+
+			// The empty regions aren't moved and might share their offsets.
+			if (sharedData.size)
+				bundleIndicesByOffset.emplace(sharedData.offset, index);
+		}
+
+		for (const BufferCompactionPlanner::Move& move : moves)
+		{
+			auto bundleIndex = bundleIndicesByOffset.find(move.srcOffset);
+
+			if (bundleIndex != std::end(bundleIndicesByOffset))
+				std::invoke(setOffset, m_meshBundles[bundleIndex->second], move.dstOffset);
+
+			result.copiedBytes += move.size;
+		}
+	}
+
+	// getSize should return the size a bundle will allocate in the sharedBuffer.
+	template<typename GetSize_t>
+	static void ReserveBuffer(
+		SharedBufferGPU& sharedBuffer, const std::vector<MeshBundleTemporaryData>& meshBundles,
+		GetSize_t&& getSize, Callisto::TemporaryDataBufferGPU& tempBuffer
+	) {
+		std::vector<UINT64> sizes{};
+
+		sizes.reserve(std::size(meshBundles));
+
+		for (const MeshBundleTemporaryData& meshBundle : meshBundles)
+			sizes.emplace_back(static_cast<UINT64>(std::invoke(getSize, meshBundle)));
+
+		[[maybe_unused]] const bool isRecreated = sharedBuffer.Reserve(sizes, tempBuffer);
+	}
+
+	void ShrinkBuffer(
+		SharedBufferGPU& sharedBuffer, UINT64 byteBudget, CompactionResult& result,
+		Callisto::TemporaryDataBufferGPU& tempBuffer
+	) {
+		if (result.copiedBytes >= byteBudget || !sharedBuffer.Shrink(tempBuffer))
+			return;
+
+		// The used part of the buffer will be copied to the new one.
+		result.copiedBytes       += sharedBuffer.Size();
+		result.isBufferRecreated  = true;
+	}
+
 protected:
 	Callisto::ReusableVector<D3DMeshBundle> m_meshBundles;
 	bool                                    m_oldBufferCopyNecessary;
@@ -81,6 +236,20 @@ private:
 		D3DMeshBundleVS& d3dMeshBundle, Callisto::TemporaryDataBufferGPU& tempBuffer
 	);
 	void ConfigureRemoveMesh(size_t bundleIndex) noexcept;
+	void ReserveMeshBundles(
+		const std::vector<MeshBundleTemporaryData>& meshBundles,
+		Callisto::TemporaryDataBufferGPU& tempBuffer
+	);
+	void CompactBuffersImpl(
+		UINT64 byteBudget, CompactionResult& result, StagingBufferManager& stagingBufferMan,
+		Callisto::TemporaryDataBufferGPU& tempBuffer
+	);
+
+	[[nodiscard]]
+	std::vector<SharedBufferGPU*> GetSharedBuffersImpl() noexcept
+	{
+		return { &m_vertexBuffer, &m_indexBuffer };
+	}
 
 private:
 	SharedBufferGPU m_vertexBuffer;
@@ -126,6 +295,22 @@ private:
 		D3DMeshBundleVS& d3dMeshBundle, Callisto::TemporaryDataBufferGPU& tempBuffer
 	);
 	void ConfigureRemoveMesh(size_t bundleIndex) noexcept;
+	void ReserveMeshBundles(
+		const std::vector<MeshBundleTemporaryData>& meshBundles,
+		Callisto::TemporaryDataBufferGPU& tempBuffer
+	);
+	void CompactBuffersImpl(
+		UINT64 byteBudget, CompactionResult& result, StagingBufferManager& stagingBufferMan,
+		Callisto::TemporaryDataBufferGPU& tempBuffer
+	);
+
+	[[nodiscard]]
+	std::vector<SharedBufferGPU*> GetSharedBuffersImpl() noexcept
+	{
+		return {
+			&m_vertexBuffer, &m_indexBuffer, &m_perMeshDataBuffer, &m_perMeshBundleDataBuffer
+		};
+	}
 
 private:
 	SharedBufferGPU m_vertexBuffer;
@@ -184,6 +369,22 @@ private:
 		D3DMeshBundleMS& d3dMeshBundle, Callisto::TemporaryDataBufferGPU& tempBuffer
 	);
 	void ConfigureRemoveMesh(size_t bundleIndex) noexcept;
+	void ReserveMeshBundles(
+		const std::vector<MeshBundleTemporaryData>& meshBundles,
+		Callisto::TemporaryDataBufferGPU& tempBuffer
+	);
+	void CompactBuffersImpl(
+		UINT64 byteBudget, CompactionResult& result, StagingBufferManager& stagingBufferMan,
+		Callisto::TemporaryDataBufferGPU& tempBuffer
+	);
+
+	[[nodiscard]]
+	std::vector<SharedBufferGPU*> GetSharedBuffersImpl() noexcept
+	{
+		return {
+			&m_perMeshletBuffer, &m_vertexBuffer, &m_vertexIndicesBuffer, &m_primIndicesBuffer
+		};
+	}
 
 private:
 	SharedBufferGPU m_perMeshletBuffer;
@@ -204,8 +204,8 @@ public:
 
 	void AllocateBuffers(
 		const std::vector<PipelineModelBundle>& pipelineBundles,
-		std::vector<SharedBufferCPU>& argumentInputSharedBuffers,
-		SharedBufferCPU& perPipelineSharedBuffer, SharedBufferCPU& perModelSharedBuffer
+		std::vector<SharedBufferPagedCPU>& argumentInputSharedBuffers,
+		SharedBufferSlabCPU& perPipelineSharedBuffer, SharedBufferPagedCPU& perModelSharedBuffer
 	);
 
 	void ResetCullingData() const noexcept;
@@ -218,8 +218,8 @@ public:
 	) const noexcept;
 
 	void RelinquishMemory(
-		std::vector<SharedBufferCPU>& argumentInputSharedBuffers,
-		SharedBufferCPU& perPipelineSharedBuffer, SharedBufferCPU& perModelSharedBuffer
+		std::vector<SharedBufferPagedCPU>& argumentInputSharedBuffers,
+		SharedBufferSlabCPU& perPipelineSharedBuffer, SharedBufferPagedCPU& perModelSharedBuffer
 	) noexcept;
 
 	[[nodiscard]]
@@ -236,9 +236,11 @@ public:
 	}
 
 private:
-	SharedBufferData              m_perPipelineSharedData;
-	SharedBufferData              m_perModelSharedData;
-	std::vector<SharedBufferData> m_argumentInputSharedData;
+	SharedBufferData             m_perPipelineSharedData;
+	// The per model and the argument input allocations are always made together with the same
+	// model count, so they are on the same page and at the same model offset.
+	PagedBufferData              m_perModelSharedData;
+	std::vector<PagedBufferData> m_argumentInputSharedData;
 
 public:
 	PipelineModelsCSIndirect(const PipelineModelsCSIndirect&) = delete;
@@ -271,8 +273,8 @@ public:
 	void SetModelCount(UINT count) noexcept { m_modelCount = count; }
 
 	void AllocateBuffers(
-		std::vector<SharedBufferGPUWriteOnly>& argumentOutputSharedBuffers,
-		std::vector<SharedBufferGPUWriteOnly>& counterSharedBuffers
+		std::vector<SharedBufferPagedGPUWriteOnly>& argumentOutputSharedBuffers,
+		std::vector<SharedBufferSlabGPUWriteOnly>& counterSharedBuffers
 	);
 	void Draw(
 		size_t frameIndex, ID3D12CommandSignature* commandSignature,
@@ -280,8 +282,8 @@ public:
 	) const noexcept;
 
 	void RelinquishMemory(
-		std::vector<SharedBufferGPUWriteOnly>& argumentOutputSharedBuffers,
-		std::vector<SharedBufferGPUWriteOnly>& counterSharedBuffers
+		std::vector<SharedBufferPagedGPUWriteOnly>& argumentOutputSharedBuffers,
+		std::vector<SharedBufferSlabGPUWriteOnly>& counterSharedBuffers
 	) noexcept;
 
 	[[nodiscard]]
@@ -290,11 +292,13 @@ public:
 	static consteval UINT GetConstantCount() noexcept { return 1u; }
 
 private:
-	std::vector<SharedBufferData> m_argumentOutputSharedData;
+	// At the same page and offset as the argument input of the pipeline, as the compute shader
+	// writes an argument at the index of its input.
+	std::vector<PagedBufferData>  m_argumentOutputSharedData;
 	std::vector<SharedBufferData> m_counterSharedData;
 	UINT                          m_modelCount;
 
-	inline static UINT64 s_counterBufferSize = static_cast<UINT64>(sizeof(std::uint32_t));
+	static constexpr UINT64 s_counterBufferSize = static_cast<UINT64>(sizeof(std::uint32_t));
 
 public:
 	PipelineModelsVSIndirect(const PipelineModelsVSIndirect&) = delete;
@@ -495,33 +499,33 @@ public:
 
 	// Assuming any new pipelines will added at the back.
 	void AddNewPipelinesFromBundle(
-		std::uint32_t modelBundleIndex, std::vector<SharedBufferCPU>& argumentInputSharedBuffers,
-		SharedBufferCPU& perPipelineSharedBuffer, SharedBufferCPU& perModelDataCSBuffer,
-		std::vector<SharedBufferGPUWriteOnly>& argumentOutputSharedBuffers,
-		std::vector<SharedBufferGPUWriteOnly>& counterSharedBuffers
+		std::uint32_t modelBundleIndex, std::vector<SharedBufferPagedCPU>& argumentInputSharedBuffers,
+		SharedBufferSlabCPU& perPipelineSharedBuffer, SharedBufferPagedCPU& perModelDataCSBuffer,
+		std::vector<SharedBufferPagedGPUWriteOnly>& argumentOutputSharedBuffers,
+		std::vector<SharedBufferSlabGPUWriteOnly>& counterSharedBuffers
 	);
 
 	void RemovePipeline(
-		size_t pipelineLocalIndex, std::vector<SharedBufferCPU>& argumentInputSharedBuffers,
-		SharedBufferCPU& perPipelineSharedBuffer, SharedBufferCPU& perModelDataCSBuffer,
-		std::vector<SharedBufferGPUWriteOnly>& argumentOutputSharedBuffers,
-		std::vector<SharedBufferGPUWriteOnly>& counterSharedBuffers
+		size_t pipelineLocalIndex, std::vector<SharedBufferPagedCPU>& argumentInputSharedBuffers,
+		SharedBufferSlabCPU& perPipelineSharedBuffer, SharedBufferPagedCPU& perModelDataCSBuffer,
+		std::vector<SharedBufferPagedGPUWriteOnly>& argumentOutputSharedBuffers,
+		std::vector<SharedBufferSlabGPUWriteOnly>& counterSharedBuffers
 	) noexcept;
 
 	void CleanupData(
-		std::vector<SharedBufferCPU>& argumentInputSharedBuffers,
-		SharedBufferCPU& perPipelineSharedBuffer, SharedBufferCPU& perModelDataCSBuffer,
-		std::vector<SharedBufferGPUWriteOnly>& argumentOutputSharedBuffers,
-		std::vector<SharedBufferGPUWriteOnly>& counterSharedBuffers
+		std::vector<SharedBufferPagedCPU>& argumentInputSharedBuffers,
+		SharedBufferSlabCPU& perPipelineSharedBuffer, SharedBufferPagedCPU& perModelDataCSBuffer,
+		std::vector<SharedBufferPagedGPUWriteOnly>& argumentOutputSharedBuffers,
+		std::vector<SharedBufferSlabGPUWriteOnly>& counterSharedBuffers
 	) noexcept;
 
 	void ReconfigureModels(
 		std::uint32_t modelBundleIndex, std::uint32_t decreasedModelsPipelineIndex,
 		std::uint32_t increasedModelsPipelineIndex,
-		std::vector<SharedBufferCPU>& argumentInputSharedBuffers,
-		SharedBufferCPU& perPipelineSharedBuffer, SharedBufferCPU& perModelDataCSBuffer,
-		std::vector<SharedBufferGPUWriteOnly>& argumentOutputSharedBuffers,
-		std::vector<SharedBufferGPUWriteOnly>& counterSharedBuffers
+		std::vector<SharedBufferPagedCPU>& argumentInputSharedBuffers,
+		SharedBufferSlabCPU& perPipelineSharedBuffer, SharedBufferPagedCPU& perModelDataCSBuffer,
+		std::vector<SharedBufferPagedGPUWriteOnly>& argumentOutputSharedBuffers,
+		std::vector<SharedBufferSlabGPUWriteOnly>& counterSharedBuffers
 	);
 
 	void UpdatePipeline(
@@ -536,27 +540,27 @@ public:
 
 	void SetupPipelineBuffers(
 		std::uint32_t pipelineLocalIndex, std::uint32_t modelBundleIndex,
-		std::vector<SharedBufferCPU>& argumentInputSharedBuffers,
-		SharedBufferCPU& perPipelineSharedBuffer, SharedBufferCPU& perModelDataCSBuffer,
-		std::vector<SharedBufferGPUWriteOnly>& argumentOutputSharedBuffers,
-		std::vector<SharedBufferGPUWriteOnly>& counterSharedBuffers
+		std::vector<SharedBufferPagedCPU>& argumentInputSharedBuffers,
+		SharedBufferSlabCPU& perPipelineSharedBuffer, SharedBufferPagedCPU& perModelDataCSBuffer,
+		std::vector<SharedBufferPagedGPUWriteOnly>& argumentOutputSharedBuffers,
+		std::vector<SharedBufferSlabGPUWriteOnly>& counterSharedBuffers
 	);
 
 private:
 	void ResizePreviousPipelines(
 		size_t addableStartIndex, size_t pipelineLocalIndex, std::uint32_t modelBundleIndex,
-		std::vector<SharedBufferCPU>& argumentInputSharedBuffers,
-		SharedBufferCPU& perPipelineSharedBuffer, SharedBufferCPU& perModelDataCSBuffer,
-		std::vector<SharedBufferGPUWriteOnly>& argumentOutputSharedBuffers,
-		std::vector<SharedBufferGPUWriteOnly>& counterSharedBuffers
+		std::vector<SharedBufferPagedCPU>& argumentInputSharedBuffers,
+		SharedBufferSlabCPU& perPipelineSharedBuffer, SharedBufferPagedCPU& perModelDataCSBuffer,
+		std::vector<SharedBufferPagedGPUWriteOnly>& argumentOutputSharedBuffers,
+		std::vector<SharedBufferSlabGPUWriteOnly>& counterSharedBuffers
 	);
 
 	void RecreateFollowingPipelines(
 		size_t pipelineLocalIndex, std::uint32_t modelBundleIndex,
-		std::vector<SharedBufferCPU>& argumentInputSharedBuffers,
-		SharedBufferCPU& perPipelineSharedBuffer, SharedBufferCPU& perModelDataCSBuffer,
-		std::vector<SharedBufferGPUWriteOnly>& argumentOutputSharedBuffers,
-		std::vector<SharedBufferGPUWriteOnly>& counterSharedBuffers
+		std::vector<SharedBufferPagedCPU>& argumentInputSharedBuffers,
+		SharedBufferSlabCPU& perPipelineSharedBuffer, SharedBufferPagedCPU& perModelDataCSBuffer,
+		std::vector<SharedBufferPagedGPUWriteOnly>& argumentOutputSharedBuffers,
+		std::vector<SharedBufferSlabGPUWriteOnly>& counterSharedBuffers
 	);
 
 	[[nodiscard]]
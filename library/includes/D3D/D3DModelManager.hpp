@@ -30,6 +30,12 @@ public:
 		return m_modelBundles[bundleIndex].GetPipelineLocalIndex(pipelineIndex);
 	}
 
+	// Only the indirect model manager has any shared buffers, which hides this.
+	void SetTraceRecorder(
+		[[maybe_unused]] AllocationTraceRecorder* traceRecorder,
+		[[maybe_unused]] std::uint16_t firstBufferID
+	) noexcept {}
+
 protected:
 	Callisto::ReusableVector<ModelBundleType> m_modelBundles;
 
@@ -175,6 +181,11 @@ public:
 
 	void ResetCounterBuffer(const D3DCommandList& computeList, size_t frameIndex) const noexcept;
 
+	// The shared buffers are given consecutive IDs from the firstBufferID.
+	void SetTraceRecorder(
+		AllocationTraceRecorder* traceRecorder, std::uint16_t firstBufferID
+	) noexcept;
+
 	void SetCSPSOIndex(std::uint32_t psoIndex) noexcept { m_csPSOIndex = psoIndex; }
 
 	void SetComputeConstantsRootIndex(
@@ -215,8 +226,10 @@ public:
 		const MeshManagerVSIndirect& meshManager
 	) const noexcept;
 
+	// The argument input and the per model buffers are paged, so the culling is dispatched for
+	// each page.
 	void Dispatch(
-		const D3DCommandList& computeList,
+		size_t frameIndex, const D3DCommandList& computeList,
 		const PipelineManager<ComputePipeline_t>& pipelineManager
 	) const noexcept;
 
@@ -229,7 +242,6 @@ public:
 	) const noexcept;
 
 private:
-	void UpdateAllocatedModelCount() noexcept;
 	void UpdateCounterResetValues();
 
 	[[nodiscard]]
@@ -239,18 +251,19 @@ private:
 	}
 
 private:
-	std::vector<SharedBufferCPU>          m_argumentInputBuffers;
-	std::vector<SharedBufferGPUWriteOnly> m_argumentOutputBuffers;
-	SharedBufferCPU                       m_perPipelineBuffer;
-	std::vector<SharedBufferGPUWriteOnly> m_counterBuffers;
-	Buffer                                m_counterResetBuffer;
-	MultiInstanceCPUBuffer                m_perModelBundleBuffer;
-	SharedBufferCPU                       m_perModelBuffer;
-	UINT                                  m_dispatchXCount;
-	UINT                                  m_allocatedModelCount;
-	std::uint32_t                         m_csPSOIndex;
-	UINT                                  m_constantsVSRootIndex;
-	UINT                                  m_constantsCSRootIndex;
+	std::vector<SharedBufferPagedCPU>          m_argumentInputBuffers;
+	std::vector<SharedBufferPagedGPUWriteOnly> m_argumentOutputBuffers;
+	SharedBufferSlabCPU                        m_perPipelineBuffer;
+	std::vector<SharedBufferSlabGPUWriteOnly>  m_counterBuffers;
+	Buffer                                     m_counterResetBuffer;
+	MultiInstanceCPUBuffer                     m_perModelBundleBuffer;
+	SharedBufferPagedCPU                       m_perModelBuffer;
+	std::uint32_t                              m_csPSOIndex;
+	UINT                                       m_constantsVSRootIndex;
+	UINT                                       m_constantsCSRootIndex;
+	UINT                                       m_argumentInputRootIndex;
+	UINT                                       m_argumentOutputRootIndex;
+	UINT                                       m_perModelRootIndex;
 
 	// Vertex Shader ones
 	// CBV
@@ -271,6 +284,9 @@ private:
 	// Each Compute Thread Group should have 64 threads.
 	static constexpr float THREADBLOCKSIZE = 64.f;
 
+	// The model count of a page. A pipeline with more models will have a bigger page of its own.
+	static constexpr size_t s_modelsPerPage = 4096u;
+
 public:
 	ModelManagerVSIndirect(const ModelManagerVSIndirect&) = delete;
 	ModelManagerVSIndirect& operator=(const ModelManagerVSIndirect&) = delete;
@@ -284,27 +300,29 @@ public:
 		m_counterResetBuffer{ std::move(other.m_counterResetBuffer) },
 		m_perModelBundleBuffer{ std::move(other.m_perModelBundleBuffer) },
 		m_perModelBuffer{ std::move(other.m_perModelBuffer) },
-		m_dispatchXCount{ other.m_dispatchXCount },
-		m_allocatedModelCount{ other.m_allocatedModelCount },
 		m_csPSOIndex{ other.m_csPSOIndex },
 		m_constantsVSRootIndex{ other.m_constantsVSRootIndex },
-		m_constantsCSRootIndex{ other.m_constantsCSRootIndex }
+		m_constantsCSRootIndex{ other.m_constantsCSRootIndex },
+		m_argumentInputRootIndex{ other.m_argumentInputRootIndex },
+		m_argumentOutputRootIndex{ other.m_argumentOutputRootIndex },
+		m_perModelRootIndex{ other.m_perModelRootIndex }
 	{}
 	ModelManagerVSIndirect& operator=(ModelManagerVSIndirect&& other) noexcept
 	{
 		ModelManager::operator=(std::move(other));
-		m_argumentInputBuffers   = std::move(other.m_argumentInputBuffers);
-		m_argumentOutputBuffers  = std::move(other.m_argumentOutputBuffers);
-		m_perPipelineBuffer      = std::move(other.m_perPipelineBuffer);
-		m_counterBuffers         = std::move(other.m_counterBuffers);
-		m_counterResetBuffer     = std::move(other.m_counterResetBuffer);
-		m_perModelBundleBuffer   = std::move(other.m_perModelBundleBuffer);
-		m_perModelBuffer         = std::move(other.m_perModelBuffer);
-		m_dispatchXCount         = other.m_dispatchXCount;
-		m_allocatedModelCount    = other.m_allocatedModelCount;
-		m_csPSOIndex             = other.m_csPSOIndex;
-		m_constantsVSRootIndex   = other.m_constantsVSRootIndex;
-		m_constantsCSRootIndex   = other.m_constantsCSRootIndex;
+		m_argumentInputBuffers    = std::move(other.m_argumentInputBuffers);
+		m_argumentOutputBuffers   = std::move(other.m_argumentOutputBuffers);
+		m_perPipelineBuffer       = std::move(other.m_perPipelineBuffer);
+		m_counterBuffers          = std::move(other.m_counterBuffers);
+		m_counterResetBuffer      = std::move(other.m_counterResetBuffer);
+		m_perModelBundleBuffer    = std::move(other.m_perModelBundleBuffer);
+		m_perModelBuffer          = std::move(other.m_perModelBuffer);
+		m_csPSOIndex              = other.m_csPSOIndex;
+		m_constantsVSRootIndex    = other.m_constantsVSRootIndex;
+		m_constantsCSRootIndex    = other.m_constantsCSRootIndex;
+		m_argumentInputRootIndex  = other.m_argumentInputRootIndex;
+		m_argumentOutputRootIndex = other.m_argumentOutputRootIndex;
+		m_perModelRootIndex       = other.m_perModelRootIndex;
 
 		return *this;
 	}
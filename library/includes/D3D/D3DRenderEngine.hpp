@@ -5,6 +5,7 @@
 #include <array>
 #include <memory>
 #include <string>
+#include <algorithm>
 #include <D3DDeviceManager.hpp>
 #include <D3DFence.hpp>
 #include <TemporaryDataBuffer.hpp>
@@ -21,6 +22,8 @@
 #include <D3DPipelineManager.hpp>
 #include <D3DExternalRenderPass.hpp>
 #include <D3DExternalResourceManager.hpp>
+#include <D3DMemoryTelemetry.hpp>
+#include <D3DResidencyManager.hpp>
 
 namespace Gaia
 {
@@ -49,13 +52,31 @@ public:
 	{
 		self.WaitForGPUToFinish();
 
-		const size_t textureIndex = self.m_textureStorage.AddTexture(
-			std::move(texture), self.m_stagingManager, self.m_temporaryDataBuffer
-		);
+		return self.AddTextureAsync(std::move(texture), UploadPriority::Critical).result;
+	}
+
+	[[nodiscard]]
+	// Doesn't wait for the GPU. The texture will be uploaded with the next frame, unless the
+	// upload budget delays it.
+	AsyncUpload<size_t> AddTextureAsync(
+		STexture&& texture, UploadPriority priority = UploadPriority::Normal
+	) {
+		m_gpuCopyNecessary = true;
+
+		return m_textureStorage.AddTexture(std::move(texture), m_uploadScheduler, priority);
+	}
 
-		self.m_gpuCopyNecessary = true;
+	[[nodiscard]]
+	bool IsUploadCompleted(const UploadTicket& ticket) noexcept
+	{
+		return m_uploadTracker.IsCompleted(ticket);
+	}
 
-		return textureIndex;
+	// Only waits for the copy queue. Returns false without waiting, if the copies haven't been
+	// submitted with a frame yet.
+	bool WaitForUpload(const UploadTicket& ticket)
+	{
+		return m_uploadTracker.Wait(ticket);
 	}
 
 	void UnbindTexture(size_t textureIndex, UINT bindingIndex);
@@ -73,7 +94,11 @@ public:
 				static_cast<UINT>(textureIndex)
 			);
 
-		return self.BindTextureCommon(texture, localCacheIndex);
+		const UINT bindingIndex = self.BindTextureCommon(texture, localCacheIndex);
+
+		self.m_textureStorage.AddBinding(textureIndex);
+
+		return bindingIndex;
 	}
 
 	void UnbindExternalTexture(UINT bindingIndex);
@@ -99,6 +124,8 @@ public:
 	{
 		self.WaitForGPUToFinish();
 
+		self.m_uploadScheduler.RemoveTexture(self.m_textureStorage.GetPtr(textureIndex));
+
 		std::vector<UINT> localTextureCacheIndices
 			= self.m_textureStorage.GetAndRemoveTextureCacheDetails(
 				static_cast<UINT>(textureIndex)
@@ -115,6 +142,38 @@ public:
 	[[nodiscard]]
 	const D3DCommandQueue& GetPresentQueue() const noexcept { return m_graphicsQueue; }
 
+	// Only the heaps which are created after this call will use the new sizes.
+	void SetHeapGrowthPolicy(
+		D3D12_HEAP_TYPE heapType, const HeapGrowthPolicy::Settings& settings, bool msaa = false
+	) noexcept {
+		m_memoryManager->SetGrowthPolicySettings(heapType, settings, msaa);
+	}
+
+	// A memory report will be appended to the file every frameInterval frames. Setting the
+	// interval to 0 stops the exporting.
+	void SetMemoryReportExport(std::uint32_t frameInterval, std::string filePath) noexcept
+	{
+		m_memoryTelemetry.SetExport(frameInterval, std::move(filePath));
+	}
+
+	void SetResidencySettings(const ResidencyManager::Settings& settings) noexcept
+	{
+		m_residencyManager.SetSettings(settings);
+	}
+
+	// The non critical uploads which don't fit in the budget are carried over to the next
+	// frames. Setting it to 0 removes the limit.
+	void SetUploadBudget(UINT64 bytesPerFrame) noexcept
+	{
+		m_uploadScheduler.SetBudget(bytesPerFrame);
+	}
+
+	[[nodiscard]]
+	const UploadScheduler::FrameStats& GetUploadStats() const noexcept
+	{
+		return m_uploadScheduler.GetFrameStats();
+	}
+
 private:
 	template<class Derived>
 	[[nodiscard]]
@@ -174,7 +233,7 @@ private:
 			for (D3DDescriptorManager& descriptorManager : self.m_graphicsDescriptorManagers)
 				descriptorManager.CreateSRV(
 					s_textureSRVRegisterSlot, s_pixelShaderRegisterSpace, freeGlobalDescIndex,
-					texture.Get(), texture.GetSRVDesc()
+					texture.Get(), texture.GetSRVDesc(0u, texture.GetMipLevelCount())
 				);
 		// Since it is a descriptor table, there is no point in setting it every time.
 		// It should be fine to just bind it once after the descriptorManagers have
@@ -193,7 +252,9 @@ public:
 
 	void UpdateExternalBufferDescriptor(const ExternalBufferBindingDetails& bindingDetails);
 
-	void UploadExternalBufferGPUOnlyData(
+	// The data is copied with the next frame, so a copy from the buffer can be queued in the
+	// frame after this one.
+	UploadTicket UploadExternalBufferGPUOnlyData(
 		std::uint32_t externalBufferIndex, std::shared_ptr<void> cpuData,
 		size_t srcDataSizeInBytes, size_t dstBufferOffset
 	);
@@ -266,6 +327,20 @@ public:
 protected:
 	void WaitForGraphicsQueueToFinish();
 
+	// Moves the uploads which fit in the budget to the staging manager. Should be called before
+	// the queued copies are recorded.
+	void QueueScheduledUploads()
+	{
+		m_uploadScheduler.QueueUploads(m_stagingManager, m_temporaryDataBuffer);
+
+		m_textureStorage.QueueTransitions(m_uploadScheduler.GetQueuedTextures());
+	}
+
+	// Evicts the GPU heaps which only have unbound textures on them, if the video memory budget
+	// has been exceeded. And makes the evicted heaps which are used again resident. Should be
+	// called before the commands of a frame are recorded.
+	void UpdateResidency();
+
 protected:
 	// These descriptors are bound to the pixel shader. So, they should be the same across
 	// all of the pipeline types. That's why we are going to bind them to their own RegisterSpace.
@@ -284,6 +359,9 @@ protected:
 
 protected:
 	std::shared_ptr<ThreadPool>                m_threadPool;
+	// Before the memory manager, so it outlives the resources which are deallocated on
+	// destruction.
+	std::unique_ptr<AllocationTraceRecorder>   m_traceRecorder;
 	std::unique_ptr<MemoryManager>             m_memoryManager;
 	std::vector<UINT64>                        m_counterValues;
 	D3DCommandQueue                            m_graphicsQueue;
@@ -291,6 +369,8 @@ protected:
 	D3DCommandQueue                            m_copyQueue;
 	std::vector<D3DFence>                      m_copyWait;
 	StagingBufferManager                       m_stagingManager;
+	UploadScheduler                            m_uploadScheduler;
+	UploadTracker                              m_uploadTracker;
 	std::unique_ptr<D3DReusableDescriptorHeap> m_dsvHeap;
 	std::vector<D3DDescriptorManager>          m_graphicsDescriptorManagers;
 	D3DExternalResourceManager                 m_externalResourceManager;
@@ -302,6 +382,8 @@ protected:
 	Callisto::TemporaryDataBufferGPU           m_temporaryDataBuffer;
 	ExternalRenderPassContainer_t              m_renderPasses;
 	ExternalRenderPassSP_t                     m_swapchainRenderPass;
+	MemoryTelemetry                            m_memoryTelemetry;
+	ResidencyManager                           m_residencyManager;
 	bool                                       m_gpuCopyNecessary;
 
 public:
@@ -310,6 +392,7 @@ public:
 
 	RenderEngine(RenderEngine&& other) noexcept
 		: m_threadPool{ std::move(other.m_threadPool) },
+		m_traceRecorder{ std::move(other.m_traceRecorder) },
 		m_memoryManager{ std::move(other.m_memoryManager) },
 		m_counterValues{ std::move(other.m_counterValues) },
 		m_graphicsQueue{ std::move(other.m_graphicsQueue) },
@@ -317,6 +400,8 @@ public:
 		m_copyQueue{ std::move(other.m_copyQueue) },
 		m_copyWait{ std::move(other.m_copyWait) },
 		m_stagingManager{ std::move(other.m_stagingManager) },
+		m_uploadScheduler{ std::move(other.m_uploadScheduler) },
+		m_uploadTracker{ std::move(other.m_uploadTracker) },
 		m_dsvHeap{ std::move(other.m_dsvHeap) },
 		m_graphicsDescriptorManagers{ std::move(other.m_graphicsDescriptorManagers) },
 		m_externalResourceManager{ std::move(other.m_externalResourceManager) },
@@ -328,11 +413,14 @@ public:
 		m_temporaryDataBuffer{ std::move(other.m_temporaryDataBuffer) },
 		m_renderPasses{ std::move(other.m_renderPasses) },
 		m_swapchainRenderPass{ std::move(other.m_swapchainRenderPass) },
+		m_memoryTelemetry{ std::move(other.m_memoryTelemetry) },
+		m_residencyManager{ std::move(other.m_residencyManager) },
 		m_gpuCopyNecessary{ other.m_gpuCopyNecessary }
 	{}
 	RenderEngine& operator=(RenderEngine&& other) noexcept
 	{
 		m_threadPool                 = std::move(other.m_threadPool);
+		m_traceRecorder              = std::move(other.m_traceRecorder);
 		m_memoryManager              = std::move(other.m_memoryManager);
 		m_counterValues              = std::move(other.m_counterValues);
 		m_graphicsQueue              = std::move(other.m_graphicsQueue);
@@ -340,6 +428,8 @@ public:
 		m_copyQueue                  = std::move(other.m_copyQueue);
 		m_copyWait                   = std::move(other.m_copyWait);
 		m_stagingManager             = std::move(other.m_stagingManager);
+		m_uploadScheduler            = std::move(other.m_uploadScheduler);
+		m_uploadTracker              = std::move(other.m_uploadTracker);
 		m_dsvHeap                    = std::move(other.m_dsvHeap);
 		m_graphicsDescriptorManagers = std::move(other.m_graphicsDescriptorManagers);
 		m_externalResourceManager    = std::move(other.m_externalResourceManager);
@@ -351,6 +441,8 @@ public:
 		m_temporaryDataBuffer        = std::move(other.m_temporaryDataBuffer);
 		m_renderPasses               = std::move(other.m_renderPasses);
 		m_swapchainRenderPass        = std::move(other.m_swapchainRenderPass);
+		m_memoryTelemetry            = std::move(other.m_memoryTelemetry);
+		m_residencyManager           = std::move(other.m_residencyManager);
 		m_gpuCopyNecessary           = other.m_gpuCopyNecessary;
 
 		return *this;
@@ -381,7 +473,7 @@ public:
 			static_cast<std::uint32_t>(frameCount)
 		},
 		m_meshManager{ deviceManager.GetDevice(), m_memoryManager.get() },
-		m_graphicsPipelineManager{ deviceManager.GetDevice() }
+		m_graphicsPipelineManager{ deviceManager.GetDevice() }, m_meshCompactionBudget{ 0u }
 	{
 		for (D3DDescriptorManager& descriptorManager : m_graphicsDescriptorManagers)
 			m_textureManager.SetDescriptorLayout(
@@ -414,6 +506,8 @@ public:
 		m_graphicsPipelineManager.SetOverwritable(pipelineIndex);
 	}
 
+	// Doesn't wait for the GPU. The regions of the bundle are only reused after the frames in
+	// flight have finished.
 	void RemoveMeshBundle(std::uint32_t bundleIndex) noexcept
 	{
 		m_meshManager.RemoveMeshBundle(bundleIndex);
@@ -430,6 +524,165 @@ public:
 		m_viewportAndScissors.Resize(width, height);
 	}
 
+	// Moves the mesh buffers out of the sparsely used GPU heaps, so those heaps can be released
+	// once the copies have finished. Only the mesh buffers are moved for now. The texture
+	// descriptors aren't tracked, and the model buffers are on the upload heaps. Each buffer is
+	// placed at its planned offset. If any of them can't be, nothing is moved and an empty plan
+	// is returned.
+	HeapDefragPlanner::Plan DefragmentGPUHeaps(const HeapDefragPlanner::Settings& settings)
+	{
+		static_cast<Derived*>(this)->WaitForGPUToFinish();
+
+		// If a previous evacuation couldn't be finished, the heap can be used again.
+		m_memoryManager->ClearEvacuatingHeaps(D3D12_HEAP_TYPE_DEFAULT);
+
+		std::vector<HeapDefragPlanner::Heap> heaps = m_memoryManager->GetDefragHeaps(
+			D3D12_HEAP_TYPE_DEFAULT
+		);
+		std::vector<SharedBufferGPU*> sharedBuffers = m_meshManager.GetSharedBuffers();
+
+		for (size_t bufferIndex = 0u; bufferIndex < std::size(sharedBuffers); ++bufferIndex)
+		{
+			const MemoryManager::MemoryAllocation& allocation
+				= sharedBuffers[bufferIndex]->GetBuffer().GetAllocation();
+
+			if (!allocation.isValid)
+				continue;
+
+			auto heap = std::ranges::find_if(
+				heaps, [memoryID = allocation.memoryID](const HeapDefragPlanner::Heap& defragHeap)
+				{
+					return defragHeap.memoryID == memoryID;
+				}
+			);
+
+			if (heap == std::end(heaps))
+				continue;
+
+			auto heapAllocation = std::ranges::find_if(
+				heap->allocations,
+				[heapOffset = allocation.heapOffset]
+				(const HeapDefragPlanner::Allocation& defragAllocation)
+				{
+					return defragAllocation.offset == heapOffset;
+				}
+			);
+
+			if (heapAllocation != std::end(heap->allocations))
+			{
+				heapAllocation->isMovable     = true;
+				heapAllocation->resourceIndex = bufferIndex;
+			}
+		}
+
+		HeapDefragPlanner::Plan plan = HeapDefragPlanner{ settings }.CreatePlan(heaps);
+
+		// The heaps must be marked before the relocations, so the new buffers aren't allocated
+		// on them.
+		for (std::uint16_t memoryID : plan.evacuatedHeaps)
+			m_memoryManager->SetHeapEvacuating(memoryID, D3D12_HEAP_TYPE_DEFAULT, true);
+
+		// The plan only works if every buffer ends up where it was planned, as the later
+		// placements depend on the earlier ones. So, if one of them can't be placed, undo all
+		// of them, before anything has been copied.
+		for (size_t relocationIndex = 0u; relocationIndex < std::size(plan.relocations);
+			++relocationIndex)
+		{
+			const HeapDefragPlanner::Relocation& relocation = plan.relocations[relocationIndex];
+
+			const bool isRelocated = sharedBuffers[relocation.resourceIndex]->RelocateTo(
+				relocation.dstMemoryID, relocation.dstOffset, m_temporaryDataBuffer
+			);
+
+			if (isRelocated)
+				continue;
+
+			for (size_t doneIndex = 0u; doneIndex < relocationIndex; ++doneIndex)
+				sharedBuffers[plan.relocations[doneIndex].resourceIndex]->CancelRelocation();
+
+			m_memoryManager->ClearEvacuatingHeaps(D3D12_HEAP_TYPE_DEFAULT);
+
+			return HeapDefragPlanner::Plan
+			{
+				.evacuatedHeaps = {},
+				.relocations    = {},
+				.movedBytes     = 0u
+			};
+		}
+
+		if (!std::empty(plan.relocations))
+		{
+			m_meshManager.SetOldBufferCopyNecessary();
+
+			// The buffer objects are the same, but their GPU addresses have changed.
+			static_cast<Derived*>(this)->_setMeshDescriptors();
+
+			m_gpuCopyNecessary = true;
+		}
+
+		return plan;
+	}
+
+	// Moves the mesh data into the holes left by the removed mesh bundles and shrinks the mesh
+	// buffers afterwards. The copies will be done with the next frame. Returns the copied size,
+	// which might go over the budget by a single region or buffer.
+	UINT64 CompactMeshBuffers(UINT64 byteBudget)
+	{
+		const auto [copiedBytes, isBufferRecreated] = m_meshManager.CompactBuffers(
+			byteBudget, m_stagingManager, m_temporaryDataBuffer
+		);
+
+		if (isBufferRecreated)
+			static_cast<Derived*>(this)->_setMeshDescriptors();
+
+		if (copiedBytes)
+			m_gpuCopyNecessary = true;
+
+		return copiedBytes;
+	}
+
+	// The mesh buffers will be compacted at the start of each frame, until the budget has been
+	// copied. Setting it to 0 stops the compaction.
+	void SetMeshCompactionBudget(UINT64 bytesPerFrame) noexcept
+	{
+		m_meshCompactionBudget = bytesPerFrame;
+	}
+
+	// Records the allocations of the memory manager, the mesh buffers and the model buffers to
+	// the file, which can be replayed with the AllocationTraceReplayer. An empty path stops the
+	// recording.
+	void SetAllocationTraceRecording(const std::string& filePath)
+	{
+		std::vector<SharedBufferGPU*> sharedBuffers = m_meshManager.GetSharedBuffers();
+
+		// The model buffers take the IDs after the mesh buffers.
+		const auto firstModelBufferID = static_cast<std::uint16_t>(std::size(sharedBuffers));
+
+		m_memoryManager->SetTraceRecorder(nullptr);
+
+		for (SharedBufferGPU* sharedBuffer : sharedBuffers)
+			sharedBuffer->SetTraceRecorder(nullptr, 0u);
+
+		m_modelManager.SetTraceRecorder(nullptr, 0u);
+
+		// Flushes the events of the previous recording.
+		m_traceRecorder.reset();
+
+		if (std::empty(filePath))
+			return;
+
+		m_traceRecorder = std::make_unique<AllocationTraceRecorder>(filePath);
+
+		m_memoryManager->SetTraceRecorder(m_traceRecorder.get());
+
+		for (size_t index = 0u; index < std::size(sharedBuffers); ++index)
+			sharedBuffers[index]->SetTraceRecorder(
+				m_traceRecorder.get(), static_cast<std::uint16_t>(index)
+			);
+
+		m_modelManager.SetTraceRecorder(m_traceRecorder.get(), firstModelBufferID);
+	}
+
 	void WaitForCurrentBackBuffer(size_t frameIndex)
 	{
 		// Wait for the previous Graphics command buffer to finish.
@@ -439,6 +692,47 @@ public:
 		// It should be okay to clear the data now that the frame has finished
 		// its submission.
 		m_temporaryDataBuffer.Clear(frameIndex);
+
+		m_memoryManager->ReleaseIdleHeaps();
+
+		m_stagingManager.ShrinkUploadRing();
+
+		// Before the compaction, so the newly retired regions can be filled.
+		m_meshManager.ReleaseRetiredRegions(std::size(m_counterValues));
+
+		if (m_meshCompactionBudget)
+			CompactMeshBuffers(m_meshCompactionBudget);
+
+		if (m_traceRecorder)
+			m_traceRecorder->AdvanceFrame();
+
+		if (m_memoryTelemetry.AdvanceFrame())
+			m_memoryTelemetry.Export(GetMemoryReport());
+	}
+
+	[[nodiscard]]
+	// The heaps of the memory manager and the shared buffers of the mesh manager.
+	MemoryTelemetry::Report GetMemoryReport()
+	{
+		MemoryTelemetry::Report report
+		{
+			.frameNumber   = m_memoryTelemetry.GetFrameNumber(),
+			.heaps         = MemoryTelemetry::GetHeapReports(*m_memoryManager),
+			.sharedBuffers = {}
+		};
+
+		std::vector<SharedBufferGPU*> sharedBuffers = m_meshManager.GetSharedBuffers();
+
+		for (size_t index = 0u; index < std::size(sharedBuffers); ++index)
+			report.sharedBuffers.emplace_back(
+				MemoryTelemetry::SharedBufferReport
+				{
+					.name  = "MeshBuffer" + std::to_string(index),
+					.stats = MemoryTelemetry::GetRegionStats(*sharedBuffers[index])
+				}
+			);
+
+		return report;
 	}
 
 	void UpdateCamera(size_t frameIndex, const Camera& cameraData) const noexcept
@@ -459,6 +753,9 @@ public:
 		// as it should immedietly return.
 		ID3D12Fence* waitFence = m_graphicsWait[frameIndex].Get();
 
+		// The textures might have been bound after the wait, so this needs to be done here.
+		UpdateResidency();
+
 		static_cast<Derived*>(this)->ExecutePipelineStages(
 			frameIndex, swapchainBackBuffer, counterValue, waitFence
 		);
@@ -499,6 +796,7 @@ protected:
 	ModelBuffers                        m_modelBuffers;
 	MeshManager_t                       m_meshManager;
 	PipelineManager<GraphicsPipeline_t> m_graphicsPipelineManager;
+	UINT64                              m_meshCompactionBudget;
 
 public:
 	RenderEngineCommon(const RenderEngineCommon&) = delete;
@@ -509,7 +807,8 @@ public:
 		m_modelManager{ std::move(other.m_modelManager) },
 		m_modelBuffers{ std::move(other.m_modelBuffers) },
 		m_meshManager{ std::move(other.m_meshManager) },
-		m_graphicsPipelineManager{ std::move(other.m_graphicsPipelineManager) }
+		m_graphicsPipelineManager{ std::move(other.m_graphicsPipelineManager) },
+		m_meshCompactionBudget{ other.m_meshCompactionBudget }
 	{}
 	RenderEngineCommon& operator=(RenderEngineCommon&& other) noexcept
 	{
@@ -518,6 +817,7 @@ public:
 		m_modelBuffers            = std::move(other.m_modelBuffers);
 		m_meshManager             = std::move(other.m_meshManager);
 		m_graphicsPipelineManager = std::move(other.m_graphicsPipelineManager);
+		m_meshCompactionBudget    = other.m_meshCompactionBudget;
 
 		return *this;
 	}
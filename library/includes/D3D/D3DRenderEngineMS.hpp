@@ -35,6 +35,17 @@ public:
 
 	[[nodiscard]]
 	std::uint32_t AddMeshBundle(MeshBundleTemporaryData&& meshBundle);
+	[[nodiscard]]
+	// Each of the mesh buffers is extended at most once for the whole batch.
+	std::vector<std::uint32_t> AddMeshBundles(std::vector<MeshBundleTemporaryData>&& meshBundles);
+
+	[[nodiscard]]
+	// Doesn't wait for the GPU. The mesh data will be uploaded with the next frame.
+	AsyncUpload<std::uint32_t> AddMeshBundleAsync(MeshBundleTemporaryData&& meshBundle);
+	[[nodiscard]]
+	AsyncUpload<std::vector<std::uint32_t>> AddMeshBundlesAsync(
+		std::vector<MeshBundleTemporaryData>&& meshBundles
+	);
 
 	void SetShaderPath(const std::wstring& shaderPath)
 	{
@@ -69,6 +80,11 @@ private:
 		m_modelBuffers.Update(frameIndex);
 	}
 
+	void _setMeshDescriptors()
+	{
+		m_meshManager.SetDescriptors(m_graphicsDescriptorManagers, s_vertexShaderRegisterSpace);
+	}
+
 	[[nodiscard]]
 	static ModelManagerMS CreateModelManager(
 		[[maybe_unused]] ID3D12Device5* device,
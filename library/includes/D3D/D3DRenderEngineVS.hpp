@@ -35,6 +35,17 @@ public:
 
 	[[nodiscard]]
 	std::uint32_t AddMeshBundle(MeshBundleTemporaryData&& meshBundle);
+	[[nodiscard]]
+	// Each of the mesh buffers is extended at most once for the whole batch.
+	std::vector<std::uint32_t> AddMeshBundles(std::vector<MeshBundleTemporaryData>&& meshBundles);
+
+	[[nodiscard]]
+	// Doesn't wait for the GPU. The mesh data will be uploaded with the next frame.
+	AsyncUpload<std::uint32_t> AddMeshBundleAsync(MeshBundleTemporaryData&& meshBundle);
+	[[nodiscard]]
+	AsyncUpload<std::vector<std::uint32_t>> AddMeshBundlesAsync(
+		std::vector<MeshBundleTemporaryData>&& meshBundles
+	);
 
 	void SetShaderPath(const std::wstring& shaderPath)
 	{
@@ -69,6 +80,10 @@ private:
 		m_modelBuffers.Update(frameIndex);
 	}
 
+	// The vertex and index buffer views are created from the buffer addresses when they are
+	// bound. So, there is nothing to update.
+	void _setMeshDescriptors() const noexcept {}
+
 	[[nodiscard]]
 	static ModelManagerVSIndividual CreateModelManager(
 		[[maybe_unused]] ID3D12Device5* device,
@@ -130,6 +145,17 @@ public:
 
 	[[nodiscard]]
 	std::uint32_t AddMeshBundle(MeshBundleTemporaryData&& meshBundle);
+	[[nodiscard]]
+	// Each of the mesh buffers is extended at most once for the whole batch.
+	std::vector<std::uint32_t> AddMeshBundles(std::vector<MeshBundleTemporaryData>&& meshBundles);
+
+	[[nodiscard]]
+	// Doesn't wait for the GPU. The mesh data will be uploaded with the next frame.
+	AsyncUpload<std::uint32_t> AddMeshBundleAsync(MeshBundleTemporaryData&& meshBundle);
+	[[nodiscard]]
+	AsyncUpload<std::vector<std::uint32_t>> AddMeshBundlesAsync(
+		std::vector<MeshBundleTemporaryData>&& meshBundles
+	);
 
 	void WaitForGPUToFinish();
 
@@ -164,6 +190,11 @@ private:
 
 	void _updatePerFrame(UINT64 frameIndex) const noexcept;
 
+	void _setMeshDescriptors()
+	{
+		m_meshManager.SetDescriptorsCS(m_computeDescriptorManagers, s_computeShaderRegisterSpace);
+	}
+
 	[[nodiscard]]
 	static ModelManagerVSIndirect CreateModelManager(
 		ID3D12Device5* device, MemoryManager* memoryManager, std::uint32_t frameCount
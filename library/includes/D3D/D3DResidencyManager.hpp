@@ -0,0 +1,250 @@
+#ifndef D3D_RESIDENCY_MANAGER_HPP_
+#define D3D_RESIDENCY_MANAGER_HPP_
+#include <D3DHeaders.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Gaia
+{
+// Keeps the GPU heaps under the video memory budget. The last frame each heap was used in is
+// tracked, and when the usage goes over the budget, the evictable heaps which haven't been used
+// for the longest are evicted first. An evicted heap is made resident again once it is used.
+// The adapter and the device are template parameters, so the policy can be tested with fakes.
+template<class Adapter_t, class Device_t>
+class ResidencyManagerGeneric
+{
+public:
+	struct Settings
+	{
+		// The heaps are evicted until the usage is at or below this fraction of the budget.
+		float         budgetUsageLimit;
+		// A heap which was used in the last few frames might still be used by a frame in
+		// flight. So, it shouldn't be evicted.
+		std::uint32_t minimumIdleFrames;
+	};
+
+	struct HeapUsage
+	{
+		ID3D12Heap*   heap;
+		UINT64        size;
+		std::uint16_t memoryID;
+		// Only a heap which doesn't have anything the GPU can access should be evictable.
+		// Any other heap is considered as used in this frame.
+		bool          isEvictable;
+		bool          isResident;
+	};
+
+	struct Changes
+	{
+		std::vector<std::uint16_t> evictedHeaps;
+		std::vector<std::uint16_t> residentHeaps;
+	};
+
+public:
+	ResidencyManagerGeneric(Adapter_t* adapter, Device_t* device, const Settings& settings)
+		: m_adapter{ adapter }, m_device{ device }, m_settings{ settings }, m_heapStates{},
+		m_frameNumber{ 0u }
+	{}
+
+	[[nodiscard]]
+	// Should be called once per frame with all of the heaps which can be evicted or are evicted,
+	// before any of the commands of the frame are submitted. The returned heaps should be marked
+	// on the memory manager, so nothing new is allocated on an evicted heap.
+	Changes Update(const std::vector<HeapUsage>& heaps);
+
+	void SetSettings(const Settings& settings) noexcept { m_settings = settings; }
+
+	[[nodiscard]]
+	const Settings& GetSettings() const noexcept { return m_settings; }
+	[[nodiscard]]
+	std::uint64_t GetFrameNumber() const noexcept { return m_frameNumber; }
+
+	[[nodiscard]]
+	static Settings GetDefaultSettings(size_t frameCount) noexcept
+	{
+		return Settings
+		{
+			.budgetUsageLimit  = 0.95f,
+			.minimumIdleFrames = static_cast<std::uint32_t>(frameCount)
+		};
+	}
+
+private:
+	struct HeapState
+	{
+		UINT64        size;
+		std::uint64_t lastUsedFrame;
+		std::uint64_t lastSeenFrame;
+		std::uint16_t memoryID;
+	};
+
+private:
+	[[nodiscard]]
+	DXGI_QUERY_VIDEO_MEMORY_INFO QueryVideoMemoryInfo() const noexcept;
+
+private:
+	Adapter_t*                                 m_adapter;
+	Device_t*                                  m_device;
+	Settings                                   m_settings;
+	std::unordered_map<ID3D12Heap*, HeapState> m_heapStates;
+	std::uint64_t                              m_frameNumber;
+
+public:
+	ResidencyManagerGeneric(const ResidencyManagerGeneric&) = delete;
+	ResidencyManagerGeneric& operator=(const ResidencyManagerGeneric&) = delete;
+
+	ResidencyManagerGeneric(ResidencyManagerGeneric&& other) noexcept
+		: m_adapter{ other.m_adapter }, m_device{ other.m_device },
+		m_settings{ other.m_settings }, m_heapStates{ std::move(other.m_heapStates) },
+		m_frameNumber{ other.m_frameNumber }
+	{}
+	ResidencyManagerGeneric& operator=(ResidencyManagerGeneric&& other) noexcept
+	{
+		m_adapter     = other.m_adapter;
+		m_device      = other.m_device;
+		m_settings    = other.m_settings;
+		m_heapStates  = std::move(other.m_heapStates);
+		m_frameNumber = other.m_frameNumber;
+
+		return *this;
+	}
+};
+
+template<class Adapter_t, class Device_t>
+DXGI_QUERY_VIDEO_MEMORY_INFO ResidencyManagerGeneric<Adapter_t, Device_t>::QueryVideoMemoryInfo(
+) const noexcept {
+	// Assuming there is a single GPU for now. And only the GPU memory is checked, like the
+	// memory manager does.
+	DXGI_QUERY_VIDEO_MEMORY_INFO videoMemoryInfo
+	{
+		.Budget       = 0u,
+		.CurrentUsage = 0u
+	};
+
+	m_adapter->QueryVideoMemoryInfo(0u, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &videoMemoryInfo);
+
+	return videoMemoryInfo;
+}
+
+template<class Adapter_t, class Device_t>
+typename ResidencyManagerGeneric<Adapter_t, Device_t>::Changes
+ResidencyManagerGeneric<Adapter_t, Device_t>::Update(const std::vector<HeapUsage>& heaps)
+{
+	++m_frameNumber;
+
+	Changes changes{};
+
+	std::vector<ID3D12Pageable*> heapsToMakeResident{};
+	std::vector<HeapUsage const*> evictionCandidates{};
+	UINT64 residentSizeRequired = 0u;
+
+	for (const HeapUsage& heapUsage : heaps)
+	{
+		auto [heapState, isNew] = m_heapStates.try_emplace(
+			heapUsage.heap,
+			HeapState
+			{
+				.size          = heapUsage.size,
+				.lastUsedFrame = m_frameNumber,
+				.lastSeenFrame = m_frameNumber,
+				.memoryID      = heapUsage.memoryID
+			}
+		);
+
+		HeapState& state = heapState->second;
+
+		// A released heap's address might have been reused by a new heap.
+		if (!isNew && (state.memoryID != heapUsage.memoryID || state.size != heapUsage.size))
+			state = HeapState
+			{
+				.size          = heapUsage.size,
+				.lastUsedFrame = m_frameNumber,
+				.lastSeenFrame = m_frameNumber,
+				.memoryID      = heapUsage.memoryID
+			};
+
+		state.lastSeenFrame = m_frameNumber;
+
+		if (!heapUsage.isEvictable)
+		{
+			state.lastUsedFrame = m_frameNumber;
+
+			if (!heapUsage.isResident)
+			{
+				heapsToMakeResident.emplace_back(heapUsage.heap);
+				changes.residentHeaps.emplace_back(heapUsage.memoryID);
+
+				residentSizeRequired += heapUsage.size;
+			}
+		}
+		else if (heapUsage.isResident
+			&& m_frameNumber - state.lastUsedFrame >= m_settings.minimumIdleFrames)
+			evictionCandidates.emplace_back(&heapUsage);
+	}
+
+	// The heaps which weren't passed have been released.
+	std::erase_if(
+		m_heapStates, [frameNumber = m_frameNumber](const auto& heapState)
+		{
+			return heapState.second.lastSeenFrame != frameNumber;
+		}
+	);
+
+	const DXGI_QUERY_VIDEO_MEMORY_INFO videoMemoryInfo = QueryVideoMemoryInfo();
+
+	const auto usageLimit = static_cast<UINT64>(
+		static_cast<double>(videoMemoryInfo.Budget) * m_settings.budgetUsageLimit
+	);
+
+	UINT64 projectedUsage = videoMemoryInfo.CurrentUsage + residentSizeRequired;
+
+	if (projectedUsage > usageLimit)
+	{
+		// The least recently used heaps first. And the larger ones first if they were last used
+		// in the same frame, so fewer heaps are evicted.
+		std::ranges::sort(
+			evictionCandidates,
+			[this](HeapUsage const* lhs, HeapUsage const* rhs)
+			{
+				const std::uint64_t lhsLastUsedFrame = m_heapStates.at(lhs->heap).lastUsedFrame;
+				const std::uint64_t rhsLastUsedFrame = m_heapStates.at(rhs->heap).lastUsedFrame;
+
+				if (lhsLastUsedFrame != rhsLastUsedFrame)
+					return lhsLastUsedFrame < rhsLastUsedFrame;
+
+				return lhs->size > rhs->size;
+			}
+		);
+
+		std::vector<ID3D12Pageable*> heapsToEvict{};
+
+		for (HeapUsage const* candidate : evictionCandidates)
+		{
+			if (projectedUsage <= usageLimit)
+				break;
+
+			heapsToEvict.emplace_back(candidate->heap);
+			changes.evictedHeaps.emplace_back(candidate->memoryID);
+
+			projectedUsage -= std::min(projectedUsage, candidate->size);
+		}
+
+		if (!std::empty(heapsToEvict))
+			m_device->Evict(static_cast<UINT>(std::size(heapsToEvict)), std::data(heapsToEvict));
+	}
+
+	// If the usage still can't be under the budget, the heaps are made resident anyway, as they
+	// will be used in this frame. The OS will page them, which is slow but won't crash.
+	if (!std::empty(heapsToMakeResident))
+		m_device->MakeResident(
+			static_cast<UINT>(std::size(heapsToMakeResident)), std::data(heapsToMakeResident)
+		);
+
+	return changes;
+}
+
+using ResidencyManager = ResidencyManagerGeneric<IDXGIAdapter3, ID3D12Device>;
+}
+#endif
@@ -1,9 +1,11 @@
 #ifndef D3D_RESOURCES_HPP_
 #define D3D_RESOURCES_HPP_
+#include <algorithm>
 #include <cstdint>
 #include <utility>
 #include <D3DHeaders.hpp>
 #include <D3DAllocator.hpp>
+#include <D3DTextureFormat.hpp>
 
 namespace Gaia
 {
@@ -18,6 +20,11 @@ public:
 	UINT64 AllocationSize() const noexcept { return m_allocationInfo.size; }
 	[[nodiscard]]
 	ID3D12Resource* Get() const noexcept { return m_resource.Get(); }
+	[[nodiscard]]
+	const MemoryManager::MemoryAllocation& GetAllocation() const noexcept
+	{
+		return m_allocationInfo;
+	}
 
 protected:
 	[[nodiscard]]
@@ -28,6 +35,12 @@ protected:
 		const D3D12_CLEAR_VALUE* clearValue
 	);
 	void Allocate(const D3D12_RESOURCE_DESC& resourceDesc, bool msaa);
+	[[nodiscard]]
+	// Returns false if the range at the heapOffset of the heap isn't free.
+	bool AllocateAt(
+		const D3D12_RESOURCE_DESC& resourceDesc, std::uint16_t memoryID, UINT64 heapOffset,
+		bool msaa
+	);
 	void Deallocate(bool msaa) noexcept;
 
 protected:
@@ -80,6 +93,13 @@ public:
 		UINT64 bufferSize, D3D12_RESOURCE_STATES initialState,
 		D3D12_RESOURCE_FLAGS flags = D3D12_RESOURCE_FLAG_NONE
 	);
+	[[nodiscard]]
+	// Creates the buffer at the exact heapOffset of the heap. Returns false and leaves the
+	// buffer empty if the range isn't free.
+	bool CreateAt(
+		UINT64 bufferSize, D3D12_RESOURCE_STATES initialState, std::uint16_t memoryID,
+		UINT64 heapOffset, D3D12_RESOURCE_FLAGS flags = D3D12_RESOURCE_FLAG_NONE
+	);
 
 	void Destroy() noexcept;
 
@@ -117,6 +137,14 @@ public:
 private:
 	void SelfDestruct() noexcept;
 
+	[[nodiscard]]
+	static D3D12_RESOURCE_DESC GetBufferDesc(UINT64 bufferSize, D3D12_RESOURCE_FLAGS flags) noexcept;
+
+	// The memory must already be allocated.
+	void CreatePlacedBuffer(
+		const D3D12_RESOURCE_DESC& bufferDesc, D3D12_RESOURCE_STATES initialState
+	);
+
 private:
 	std::uint8_t* m_cpuHandle;
 	UINT64        m_bufferSize;
@@ -186,6 +214,33 @@ public:
 	UINT GetHeight() const noexcept { return m_height; }
 	[[nodiscard]]
 	UINT16 GetDepth() const noexcept { return m_depth; }
+	[[nodiscard]]
+	UINT16 GetMipLevelCount() const noexcept { return m_mipLevels; }
+	[[nodiscard]]
+	UINT64 GetMipWidth(UINT mipLevelIndex) const noexcept
+	{
+		return std::max<UINT64>(m_width >> mipLevelIndex, 1u);
+	}
+	[[nodiscard]]
+	UINT GetMipHeight(UINT mipLevelIndex) const noexcept
+	{
+		return std::max(m_height >> mipLevelIndex, 1u);
+	}
+	[[nodiscard]]
+	UINT16 GetMipDepth(UINT mipLevelIndex) const noexcept
+	{
+		return static_cast<UINT16>(std::max(m_depth >> mipLevelIndex, 1));
+	}
+	[[nodiscard]]
+	// The width and the height of a block in texels. 1 for the uncompressed formats.
+	UINT GetBlockSize() const noexcept { return GetTextureFormatInfo(m_format).blockSize; }
+	[[nodiscard]]
+	// The rows of a mip in a buffer. For the block compressed formats, a row has a row of
+	// blocks.
+	UINT GetMipRowCount(UINT mipLevelIndex) const noexcept
+	{
+		return GetTextureRowCount(m_format, GetMipHeight(mipLevelIndex));
+	}
 
 	[[nodiscard]]
 	D3D12_SHADER_RESOURCE_VIEW_DESC GetSRVDesc(
@@ -195,16 +250,21 @@ public:
 	D3D12_UNORDERED_ACCESS_VIEW_DESC GetUAVDesc(UINT mipSlice = 0u) const noexcept;
 
 	[[nodiscard]]
-	// The allocation size will be different. This will return the Size of the Texture
-	// if it were to fit in a Buffer.
-	UINT64 GetBufferSize() const noexcept { return GetRowPitchD3DAligned() * m_height * m_depth; }
+	// The allocation size will be different. This will return the Size of the mip of the
+	// Texture if it were to fit in a Buffer.
+	UINT64 GetBufferSize(UINT mipLevelIndex = 0u) const noexcept
+	{
+		return GetRowPitchD3DAligned(mipLevelIndex) * GetMipRowCount(mipLevelIndex)
+			* GetMipDepth(mipLevelIndex);
+	}
 	[[nodiscard]]
 	// This will be the RowPitch without any alignment. Usually be the RowPitch
-	// after loading the texture from the Disk drive.
-	UINT64 GetRowPitch() const noexcept;
+	// after loading the texture from the Disk drive. A row of blocks, if the format is block
+	// compressed.
+	UINT64 GetRowPitch(UINT mipLevelIndex = 0u) const noexcept;
 	[[nodiscard]]
 	// This will be the RowPitch in a D3DBuffer, which would be aligned to 256B.
-	UINT64 GetRowPitchD3DAligned() const noexcept;
+	UINT64 GetRowPitchD3DAligned(UINT mipLevelIndex = 0u) const noexcept;
 
 private:
 	void Create(
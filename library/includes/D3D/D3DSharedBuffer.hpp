@@ -3,9 +3,18 @@
 #include <D3DResources.hpp>
 #include <D3DDescriptorHeapManager.hpp>
 #include <D3DCommandQueue.hpp>
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <map>
+#include <memory>
 #include <queue>
+#include <span>
 #include <TemporaryDataBuffer.hpp>
-#include <SharedBufferAllocator.hpp>
+#include <FreeRegionAllocator.hpp>
+#include <D3DBufferCompactionPlanner.hpp>
+#include <SlabAllocator.hpp>
+#include <PageAllocator.hpp>
 
 #include <MeshBundle.hpp>
 
@@ -18,6 +27,67 @@ struct SharedBufferData
 	UINT64        size;
 };
 
+struct PagedBufferData
+{
+	// The page which has the allocation.
+	Buffer const* bufferData;
+	size_t        pageIndex;
+	// The offset from the start of the page.
+	UINT64        offset;
+	UINT64        size;
+};
+
+// Decides the new size of a shared buffer, when none of its free blocks can fit an allocation.
+// The slack after the allocation is kept as a free block, so growing the buffer geometrically
+// makes the recreations and the copies of the old data amortised O(1) per allocation.
+struct SharedBufferGrowthPolicy
+{
+	// The new size will be at least the old size multiplied by this.
+	float  growthFactor;
+	UINT64 minimumSize;
+	// The new size is rounded up to a multiple of this, unless it is exactly the required size.
+	UINT64 granularity;
+
+	[[nodiscard]]
+	UINT64 GetNewSize(UINT64 oldSize, UINT64 requiredSize) const noexcept
+	{
+		const auto grownSize = static_cast<UINT64>(
+			static_cast<double>(oldSize) * static_cast<double>(growthFactor)
+		);
+
+		const UINT64 newSize = std::max({ requiredSize, grownSize, minimumSize });
+
+		if (newSize == requiredSize)
+			return newSize;
+
+		return (newSize + granularity - 1u) / granularity * granularity;
+	}
+
+	[[nodiscard]]
+	// A placed buffer takes at least 64KB of its heap anyway.
+	static SharedBufferGrowthPolicy GetDefaultPolicy() noexcept
+	{
+		return SharedBufferGrowthPolicy
+		{
+			.growthFactor = 1.5f,
+			.minimumSize  = 64_KB,
+			.granularity  = 256u
+		};
+	}
+
+	[[nodiscard]]
+	// Only grows by the size of the allocation, so the buffer never has any slack.
+	static SharedBufferGrowthPolicy GetExactPolicy() noexcept
+	{
+		return SharedBufferGrowthPolicy
+		{
+			.growthFactor = 1.f,
+			.minimumSize  = 0u,
+			.granularity  = 1u
+		};
+	}
+};
+
 class SharedBufferBase
 {
 protected:
@@ -26,7 +96,8 @@ protected:
 		D3D12_RESOURCE_FLAGS buferFlag, Buffer&& buffer
 	) : m_device{ device }, m_memoryManager{ memoryManager },
 		m_buffer{ std::move(buffer) }, m_allocator{}, m_resourceState{ resourceState },
-		m_bufferFlag{ buferFlag }
+		m_bufferFlag{ buferFlag }, m_liveAllocations{}, m_traceRecorder{ nullptr }, m_traceID{ 0u },
+		m_growthPolicy{ SharedBufferGrowthPolicy::GetDefaultPolicy() }
 	{}
 
 public:
@@ -44,13 +115,130 @@ public:
 	[[nodiscard]]
 	ID3D12Resource* GetD3Dbuffer() const noexcept { return m_buffer.Get(); }
 
+	[[nodiscard]]
+	// The sizes of the allocations which haven't been relinquished yet, keyed by their offsets.
+	const std::map<UINT64, UINT64>& GetLiveAllocations() const noexcept
+	{
+		return m_liveAllocations;
+	}
+
+	// The allocations will be recorded with the bufferID, until it is set to nullptr. The
+	// recorder must outlive the recording.
+	void SetTraceRecorder(AllocationTraceRecorder* traceRecorder, std::uint16_t bufferID) noexcept
+	{
+		m_traceRecorder = traceRecorder;
+		m_traceID       = bufferID;
+	}
+
+	// Only affects the future extensions of the buffer.
+	void SetGrowthPolicy(const SharedBufferGrowthPolicy& growthPolicy) noexcept
+	{
+		m_growthPolicy = growthPolicy;
+	}
+
+	[[nodiscard]]
+	// The buffer size which is needed, so all of the sizes can be allocated in the same order
+	// without extending the buffer again. The allocations are tried on a copy of the free
+	// regions, and the buffer is extended by the sizes which didn't fit, until all of them fit.
+	UINT64 GetReservedSize(std::span<const UINT64> sizes) const
+	{
+		const UINT64 oldSize = m_buffer.BufferSize();
+		UINT64 missingSize   = 0u;
+
+		while (true)
+		{
+			FreeRegionAllocator allocator = m_allocator.Clone();
+			UINT64 newSize                = oldSize;
+
+			if (missingSize)
+			{
+				const UINT64 offset = allocator.RemoveTrailingRegion(oldSize).value_or(oldSize);
+
+				newSize = m_growthPolicy.GetNewSize(oldSize, oldSize + missingSize);
+
+				allocator.Deallocate(offset, newSize - offset);
+			}
+
+			UINT64 failedSize = 0u;
+
+			for (UINT64 size : sizes)
+				if (size && !allocator.Allocate(size))
+					failedSize += size;
+
+			if (!failedSize)
+				return newSize;
+
+			missingSize += failedSize;
+		}
+	}
+
+protected:
+	// A zero size allocation can be at the same offset as another one, so they aren't tracked.
+	void AddLiveAllocation(UINT64 offset, UINT64 size)
+	{
+		if (!size)
+			return;
+
+		m_liveAllocations.emplace(offset, size);
+
+		if (m_traceRecorder)
+			m_traceRecorder->RecordSharedBufferEvent(
+				AllocationTraceRecorder::EventType::SharedAllocate, m_traceID, offset, size
+			);
+	}
+	void RemoveLiveAllocation(UINT64 offset, UINT64 size) noexcept
+	{
+		if (!size)
+			return;
+
+		auto liveAllocation = m_liveAllocations.find(offset);
+
+		if (liveAllocation == std::end(m_liveAllocations))
+			return;
+
+		if (m_traceRecorder)
+			m_traceRecorder->RecordSharedBufferEvent(
+				AllocationTraceRecorder::EventType::SharedRelinquish, m_traceID, offset,
+				liveAllocation->second
+			);
+
+		m_liveAllocations.erase(liveAllocation);
+	}
+
+	struct BufferExtension
+	{
+		UINT64 offset;
+		UINT64 newSize;
+	};
+
+	[[nodiscard]]
+	// For an allocation which doesn't fit in any of the free regions. It is placed at the
+	// trailing free region if there is one, so the buffer only grows by what is missing. The
+	// slack after the allocation is added as a free region.
+	BufferExtension GetBufferExtension(UINT64 size)
+	{
+		const UINT64 oldSize      = m_buffer.BufferSize();
+		const UINT64 offset       = m_allocator.RemoveTrailingRegion(oldSize).value_or(oldSize);
+		const UINT64 requiredSize = offset + size;
+		const UINT64 newSize      = m_growthPolicy.GetNewSize(oldSize, requiredSize);
+
+		if (newSize > requiredSize)
+			m_allocator.Deallocate(requiredSize, newSize - requiredSize);
+
+		return BufferExtension{ .offset = offset, .newSize = newSize };
+	}
+
 protected:
 	ID3D12Device*                   m_device;
 	MemoryManager*                  m_memoryManager;
 	Buffer                          m_buffer;
-	Callisto::SharedBufferAllocator m_allocator;
+	FreeRegionAllocator             m_allocator;
 	D3D12_RESOURCE_STATES           m_resourceState;
 	D3D12_RESOURCE_FLAGS            m_bufferFlag;
+	std::map<UINT64, UINT64>        m_liveAllocations;
+	AllocationTraceRecorder*        m_traceRecorder;
+	std::uint16_t                   m_traceID;
+	SharedBufferGrowthPolicy        m_growthPolicy;
 
 public:
 	SharedBufferBase(const SharedBufferBase&) = delete;
@@ -61,7 +249,10 @@ public:
 		m_buffer{ std::move(other.m_buffer) },
 		m_allocator{ std::move(other.m_allocator) },
 		m_resourceState{ other.m_resourceState },
-		m_bufferFlag{ other.m_bufferFlag }
+		m_bufferFlag{ other.m_bufferFlag },
+		m_liveAllocations{ std::move(other.m_liveAllocations) },
+		m_traceRecorder{ other.m_traceRecorder }, m_traceID{ other.m_traceID },
+		m_growthPolicy{ other.m_growthPolicy }
 	{}
 	SharedBufferBase& operator=(SharedBufferBase&& other) noexcept
 	{
@@ -69,8 +260,12 @@ public:
 		m_memoryManager = other.m_memoryManager;
 		m_buffer        = std::move(other.m_buffer);
 		m_allocator     = std::move(other.m_allocator);
-		m_resourceState = other.m_resourceState;
-		m_bufferFlag    = other.m_bufferFlag;
+		m_resourceState   = other.m_resourceState;
+		m_bufferFlag      = other.m_bufferFlag;
+		m_liveAllocations = std::move(other.m_liveAllocations);
+		m_traceRecorder   = other.m_traceRecorder;
+		m_traceID         = other.m_traceID;
+		m_growthPolicy    = other.m_growthPolicy;
 
 		return *this;
 	}
@@ -88,9 +283,11 @@ public:
 			// manual transition in some cases though.
 			device, memoryManager, D3D12_RESOURCE_STATE_COMMON, bufferFlag,
 			GetGPUResource<Buffer>(device, memoryManager)
-		}, m_oldBuffer{}
+		}, m_oldBuffer{}, m_moveBuffer{}, m_pendingMoves{}, m_retiringRegions{},
+		m_frameNumber{ 0u }
 	{}
 
+	// Also records the copies of the moved regions.
 	void CopyOldBuffer(const D3DCommandList& copyList) noexcept;
 
 	[[nodiscard]]
@@ -99,10 +296,55 @@ public:
 		UINT64 size, Callisto::TemporaryDataBufferGPU& tempBuffer
 	);
 
-	void RelinquishMemory(const SharedBufferData& sharedData) noexcept
+	// The frames in flight might still be reading the region, so it is only freed by
+	// ReleaseRetiredRegions, after those frames have finished.
+	void RelinquishMemory(const SharedBufferData& sharedData) noexcept;
+
+	// Should be called once per frame, after the GPU has finished with a frame. Frees the
+	// regions which were relinquished at least frameCount frames ago, as none of the frames in
+	// flight can read them anymore. If the GPU is idle, 0 frees all of them.
+	void ReleaseRetiredRegions(size_t frameCount) noexcept;
+
+	[[nodiscard]]
+	// Extends the buffer once, so the sizes can then be allocated one by one, in the same order,
+	// without recreating it for each of them. Returns true if the buffer was recreated.
+	bool Reserve(std::span<const UINT64> sizes, Callisto::TemporaryDataBufferGPU& tempBuffer);
+
+	[[nodiscard]]
+	// Recreates the buffer with the same size at the exact heapOffset of the heap and the data
+	// will be copied with the next CopyOldBuffer call. Returns false if the range isn't free or
+	// if there is already a copy pending, as the old buffer can't be replaced before it is copied.
+	bool RelocateTo(
+		std::uint16_t memoryID, UINT64 heapOffset, Callisto::TemporaryDataBufferGPU& tempBuffer
+	);
+	// Puts the old buffer back before its data has been copied, i.e. when the rest of a
+	// relocation plan couldn't be done. The new allocation is freed.
+	void CancelRelocation() noexcept;
+
+	[[nodiscard]]
+	// Moves the allocations into the free regions before them, until byteBudget bytes have been
+	// moved. The owners of the allocations must update their offsets with the returned moves.
+	// The data will be copied with the next CopyOldBuffer call, so nothing is moved while an
+	// old buffer or other moves are waiting to be copied. The sources are relinquished, so the
+	// frames in flight can still read them.
+	std::vector<BufferCompactionPlanner::Move> MoveRegions(
+		UINT64 byteBudget, Callisto::TemporaryDataBufferGPU& tempBuffer
+	);
+
+	[[nodiscard]]
+	// Recreates the buffer without the trailing free region. Only shrinks when at most half of
+	// the buffer is used up to the last allocation, so a buffer which has just grown isn't
+	// shrunk right away. Returns true if the buffer was recreated, as its GPU address changes.
+	bool Shrink(Callisto::TemporaryDataBufferGPU& tempBuffer);
+
+private:
+	struct RetiringRegion
 	{
-		m_allocator.RelinquishMemory(sharedData.offset, sharedData.size);
-	}
+		UINT64 offset;
+		UINT64 size;
+		// The frame number when it was relinquished.
+		UINT64 frameNumber;
+	};
 
 private:
 	void CreateBuffer(UINT64 size, Callisto::TemporaryDataBufferGPU& tempBuffer);
@@ -110,7 +352,14 @@ private:
 	UINT64 ExtendBuffer(UINT64 size, Callisto::TemporaryDataBufferGPU& tempBuffer);
 
 private:
-	std::shared_ptr<Buffer> m_oldBuffer;
+	std::shared_ptr<Buffer>                    m_oldBuffer;
+	// A buffer can't be the source and the destination of a copy at the same time. So, the
+	// moved regions are copied into this one first.
+	std::shared_ptr<Buffer>                    m_moveBuffer;
+	std::vector<BufferCompactionPlanner::Move> m_pendingMoves;
+	// They aren't free nor live, so they can't be allocated or moved until they are released.
+	std::deque<RetiringRegion>                 m_retiringRegions;
+	UINT64                                     m_frameNumber;
 
 public:
 	SharedBufferGPU(const SharedBufferGPU&) = delete;
@@ -118,12 +367,20 @@ public:
 
 	SharedBufferGPU(SharedBufferGPU&& other) noexcept
 		: SharedBufferBase{ std::move(other) },
-		m_oldBuffer{ std::move(other.m_oldBuffer) }
+		m_oldBuffer{ std::move(other.m_oldBuffer) },
+		m_moveBuffer{ std::move(other.m_moveBuffer) },
+		m_pendingMoves{ std::move(other.m_pendingMoves) },
+		m_retiringRegions{ std::move(other.m_retiringRegions) },
+		m_frameNumber{ other.m_frameNumber }
 	{}
 	SharedBufferGPU& operator=(SharedBufferGPU&& other) noexcept
 	{
 		SharedBufferBase::operator=(std::move(other));
-		m_oldBuffer = std::move(other.m_oldBuffer);
+		m_oldBuffer       = std::move(other.m_oldBuffer);
+		m_moveBuffer      = std::move(other.m_moveBuffer);
+		m_pendingMoves    = std::move(other.m_pendingMoves);
+		m_retiringRegions = std::move(other.m_retiringRegions);
+		m_frameNumber     = other.m_frameNumber;
 
 		return *this;
 	}
@@ -146,28 +403,29 @@ public:
 	// The offset from the start of the buffer will be returned.
 	SharedBufferData AllocateAndGetSharedData(UINT64 size, bool copyOldBuffer = false)
 	{
-		auto availableAllocIndex = m_allocator.GetAvailableAllocInfo(size);
+		// An empty allocation doesn't need a region, so it must never extend the buffer.
+		if (!size)
+			return SharedBufferData{ .bufferData = &m_buffer, .offset = 0u, .size = 0u };
 
-		Callisto::SharedBufferAllocator::AllocInfo allocInfo{ .offset = 0u, .size = 0u };
+		std::optional<UINT64> offset = m_allocator.Allocate(size);
 
-		if (!availableAllocIndex)
-		{
-			allocInfo.size   = size;
-			allocInfo.offset = ExtendBuffer(size, copyOldBuffer);
-		}
-		else
-			allocInfo = m_allocator.GetAndRemoveAllocInfo(*availableAllocIndex);
+		if (!offset)
+			offset = ExtendBuffer(size, copyOldBuffer);
+
+		AddLiveAllocation(*offset, size);
 
 		return SharedBufferData{
 			.bufferData = &m_buffer,
-			.offset     = m_allocator.AllocateMemory(allocInfo, size),
+			.offset     = *offset,
 			.size       = size
 		};
 	}
 
 	void RelinquishMemory(const SharedBufferData& sharedData) noexcept
 	{
-		m_allocator.RelinquishMemory(sharedData.offset, sharedData.size);
+		m_allocator.Deallocate(sharedData.offset, sharedData.size);
+
+		RemoveLiveAllocation(sharedData.offset, sharedData.size);
 	}
 
 private:
@@ -176,9 +434,8 @@ private:
 	{
 		// I probably don't need to worry about aligning here, since it's all inside a single
 		// buffer?
-		const UINT64 oldSize = m_buffer.BufferSize();
-		const UINT64 offset  = oldSize;
-		const UINT64 newSize = oldSize + size;
+		const UINT64 oldSize         = m_buffer.BufferSize();
+		const auto [offset, newSize] = GetBufferExtension(size);
 
 		// If the alignment is 16bytes, at least 16bytes will be allocated. If the requested size
 		// is bigger, then there shouldn't be any issues. But if the requested size is smaller,
@@ -216,5 +473,237 @@ public:
 
 typedef SharedBufferWriteOnly<D3D12_HEAP_TYPE_UPLOAD> SharedBufferCPU;
 typedef SharedBufferWriteOnly<D3D12_HEAP_TYPE_DEFAULT> SharedBufferGPUWriteOnly;
+
+// Sub-allocates the tiny fixed size data, i.e. the per pipeline data or the indirect counters.
+// The buffer is extended a slab at a time, instead of being recreated for each allocation. The
+// slot index of an allocation is its offset divided by the slot size, so it can be used to
+// index the buffer in the shaders.
+template<D3D12_HEAP_TYPE MemoryType>
+class SharedBufferSlab
+{
+public:
+	SharedBufferSlab(
+		ID3D12Device* device, MemoryManager* memoryManager, D3D12_RESOURCE_STATES resourceState,
+		UINT64 slotSize, D3D12_RESOURCE_FLAGS bufferFlag = D3D12_RESOURCE_FLAG_NONE,
+		UINT64 slabSize = 4_KB
+	) : m_sharedBuffer{ device, memoryManager, resourceState, bufferFlag },
+		m_slabAllocator{ static_cast<size_t>(slotSize), static_cast<size_t>(slabSize) }
+	{
+		// The slack must be a multiple of the slab size, or the next slab wouldn't be placed
+		// right after the last one. The slab size is rounded down to a multiple of the slot
+		// size, so the requested one can't be used.
+		SharedBufferGrowthPolicy growthPolicy = SharedBufferGrowthPolicy::GetDefaultPolicy();
+
+		growthPolicy.granularity = static_cast<UINT64>(m_slabAllocator.GetSlabSize());
+
+		m_sharedBuffer.SetGrowthPolicy(growthPolicy);
+	}
+
+	[[nodiscard]]
+	// The data of the old buffer will only be kept if copyOldBuffer is true and the buffer
+	// needs to be extended.
+	SharedBufferData AllocateAndGetSharedData(bool copyOldBuffer = false)
+	{
+		std::optional<size_t> slotIndex = m_slabAllocator.Allocate();
+
+		if (!slotIndex)
+		{
+			// Nothing else is allocated from the shared buffer and the slabs are never
+			// relinquished. So, a new slab should always be placed at the end.
+			[[maybe_unused]] const SharedBufferData slabData
+				= m_sharedBuffer.AllocateAndGetSharedData(
+					static_cast<UINT64>(m_slabAllocator.GetSlabSize()), copyOldBuffer
+				);
+
+			const size_t firstSlotIndex = m_slabAllocator.AddSlab();
+
+			assert(
+				slabData.offset == m_slabAllocator.GetSlotOffset(firstSlotIndex)
+				&& "The slabs aren't contiguous."
+			);
+
+			slotIndex = m_slabAllocator.Allocate();
+		}
+
+		return SharedBufferData{
+			.bufferData = &m_sharedBuffer.GetBuffer(),
+			.offset     = static_cast<UINT64>(m_slabAllocator.GetSlotOffset(slotIndex.value())),
+			.size       = static_cast<UINT64>(m_slabAllocator.GetSlotSize())
+		};
+	}
+
+	void RelinquishMemory(const SharedBufferData& sharedData) noexcept
+	{
+		m_slabAllocator.Deallocate(
+			static_cast<size_t>(sharedData.offset) / m_slabAllocator.GetSlotSize()
+		);
+	}
+
+	[[nodiscard]]
+	UINT64 Size() const noexcept { return m_sharedBuffer.Size(); }
+	[[nodiscard]]
+	D3D12_GPU_VIRTUAL_ADDRESS GetGPUAddress() const noexcept
+	{
+		return m_sharedBuffer.GetGPUAddress();
+	}
+	[[nodiscard]]
+	const Buffer& GetBuffer() const noexcept { return m_sharedBuffer.GetBuffer(); }
+	[[nodiscard]]
+	const SlabAllocator& GetSlabAllocator() const noexcept { return m_slabAllocator; }
+
+	// Only the slabs are recorded, as they are the allocations of the shared buffer.
+	void SetTraceRecorder(AllocationTraceRecorder* traceRecorder, std::uint16_t bufferID) noexcept
+	{
+		m_sharedBuffer.SetTraceRecorder(traceRecorder, bufferID);
+	}
+
+private:
+	SharedBufferWriteOnly<MemoryType> m_sharedBuffer;
+	SlabAllocator                     m_slabAllocator;
+
+public:
+	SharedBufferSlab(const SharedBufferSlab&) = delete;
+	SharedBufferSlab& operator=(const SharedBufferSlab&) = delete;
+
+	SharedBufferSlab(SharedBufferSlab&& other) noexcept
+		: m_sharedBuffer{ std::move(other.m_sharedBuffer) },
+		m_slabAllocator{ std::move(other.m_slabAllocator) }
+	{}
+	SharedBufferSlab& operator=(SharedBufferSlab&& other) noexcept
+	{
+		m_sharedBuffer  = std::move(other.m_sharedBuffer);
+		m_slabAllocator = std::move(other.m_slabAllocator);
+
+		return *this;
+	}
+};
+
+typedef SharedBufferSlab<D3D12_HEAP_TYPE_UPLOAD> SharedBufferSlabCPU;
+typedef SharedBufferSlab<D3D12_HEAP_TYPE_DEFAULT> SharedBufferSlabGPUWriteOnly;
+
+// Sub-allocates from a list of fixed size buffers, so growing only creates a new page and none
+// of the old data has to be copied. The pages never move, so their GPU addresses stay the same.
+// But the pages are separate resources, so the shaders need to be bound to each page.
+template<D3D12_HEAP_TYPE MemoryType>
+class SharedBufferPaged
+{
+public:
+	SharedBufferPaged(
+		ID3D12Device* device, MemoryManager* memoryManager, D3D12_RESOURCE_STATES resourceState,
+		UINT64 pageSize, D3D12_RESOURCE_FLAGS bufferFlag = D3D12_RESOURCE_FLAG_NONE
+	) : m_device{ device }, m_memoryManager{ memoryManager }, m_resourceState{ resourceState },
+		m_bufferFlag{ bufferFlag }, m_pages{}, m_pageAllocator{ pageSize },
+		m_traceRecorder{ nullptr }, m_traceID{ 0u }
+	{}
+
+	[[nodiscard]]
+	// An allocation bigger than the page size will get a page of its own.
+	PagedBufferData AllocateAndGetSharedData(UINT64 size)
+	{
+		std::optional<PageAllocator::Allocation> allocation = m_pageAllocator.Allocate(size);
+
+		if (!allocation)
+		{
+			const size_t pageIndex = m_pageAllocator.AddPage(size);
+
+			auto page = std::make_unique<Buffer>(m_device, m_memoryManager, MemoryType);
+
+			page->Create(m_pageAllocator.GetPageSize(pageIndex), m_resourceState, m_bufferFlag);
+
+			m_pages.emplace_back(std::move(page));
+
+			allocation = m_pageAllocator.Allocate(size);
+		}
+
+		if (m_traceRecorder && size)
+			m_traceRecorder->RecordSharedBufferEvent(
+				AllocationTraceRecorder::EventType::SharedAllocate, m_traceID,
+				GetTraceOffset(allocation->pageIndex, allocation->offset), size
+			);
+
+		return PagedBufferData{
+			.bufferData = m_pages[allocation->pageIndex].get(),
+			.pageIndex  = allocation->pageIndex,
+			.offset     = allocation->offset,
+			.size       = size
+		};
+	}
+
+	void RelinquishMemory(const PagedBufferData& pagedData) noexcept
+	{
+		if (m_traceRecorder && pagedData.size)
+			m_traceRecorder->RecordSharedBufferEvent(
+				AllocationTraceRecorder::EventType::SharedRelinquish, m_traceID,
+				GetTraceOffset(pagedData.pageIndex, pagedData.offset), pagedData.size
+			);
+
+		m_pageAllocator.Deallocate(
+			PageAllocator::Allocation{ .pageIndex = pagedData.pageIndex, .offset = pagedData.offset },
+			pagedData.size
+		);
+	}
+
+	// The allocations will be recorded with the bufferID, until it is set to nullptr. The
+	// recorder must outlive the recording.
+	void SetTraceRecorder(AllocationTraceRecorder* traceRecorder, std::uint16_t bufferID) noexcept
+	{
+		m_traceRecorder = traceRecorder;
+		m_traceID       = bufferID;
+	}
+
+	[[nodiscard]]
+	size_t GetPageCount() const noexcept { return std::size(m_pages); }
+	[[nodiscard]]
+	const Buffer& GetPage(size_t pageIndex) const noexcept { return *m_pages[pageIndex]; }
+	[[nodiscard]]
+	const PageAllocator& GetPageAllocator() const noexcept { return m_pageAllocator; }
+
+private:
+	[[nodiscard]]
+	// The trace only needs the offset to match a relinquish with its allocation. The pages are
+	// far smaller than 4GB, so the page index is put in the top bits.
+	static UINT64 GetTraceOffset(size_t pageIndex, UINT64 offset) noexcept
+	{
+		return static_cast<UINT64>(pageIndex) << 32u | offset;
+	}
+
+private:
+	ID3D12Device*                        m_device;
+	MemoryManager*                       m_memoryManager;
+	D3D12_RESOURCE_STATES                m_resourceState;
+	D3D12_RESOURCE_FLAGS                 m_bufferFlag;
+	// The allocations keep pointers to the pages, so they are kept on the heap.
+	std::vector<std::unique_ptr<Buffer>> m_pages;
+	PageAllocator                        m_pageAllocator;
+	AllocationTraceRecorder*             m_traceRecorder;
+	std::uint16_t                        m_traceID;
+
+public:
+	SharedBufferPaged(const SharedBufferPaged&) = delete;
+	SharedBufferPaged& operator=(const SharedBufferPaged&) = delete;
+
+	SharedBufferPaged(SharedBufferPaged&& other) noexcept
+		: m_device{ other.m_device }, m_memoryManager{ other.m_memoryManager },
+		m_resourceState{ other.m_resourceState }, m_bufferFlag{ other.m_bufferFlag },
+		m_pages{ std::move(other.m_pages) }, m_pageAllocator{ std::move(other.m_pageAllocator) },
+		m_traceRecorder{ other.m_traceRecorder }, m_traceID{ other.m_traceID }
+	{}
+	SharedBufferPaged& operator=(SharedBufferPaged&& other) noexcept
+	{
+		m_device        = other.m_device;
+		m_memoryManager = other.m_memoryManager;
+		m_resourceState = other.m_resourceState;
+		m_bufferFlag    = other.m_bufferFlag;
+		m_pages         = std::move(other.m_pages);
+		m_pageAllocator = std::move(other.m_pageAllocator);
+		m_traceRecorder = other.m_traceRecorder;
+		m_traceID       = other.m_traceID;
+
+		return *this;
+	}
+};
+
+typedef SharedBufferPaged<D3D12_HEAP_TYPE_UPLOAD> SharedBufferPagedCPU;
+typedef SharedBufferPaged<D3D12_HEAP_TYPE_DEFAULT> SharedBufferPagedGPUWriteOnly;
 }
 #endif
@@ -2,7 +2,13 @@
 #define D3D_STAGING_BUFFER_MANAGER_HPP_
 #include <D3DResources.hpp>
 #include <D3DCommandQueue.hpp>
+#include <D3DUploadRingAllocator.hpp>
+#include <ParallelCopyQueue.hpp>
 #include <vector>
+#include <span>
+#include <future>
+#include <thread>
+#include <algorithm>
 #include <ThreadPool.hpp>
 #include <TemporaryDataBuffer.hpp>
 
@@ -10,28 +16,115 @@ namespace Gaia
 {
 class StagingBufferManager
 {
+public:
+	struct CopyCounters
+	{
+		// The buffer copies which were queued and the copy commands which were recorded for
+		// them, after the contiguous ones were merged.
+		size_t queuedBufferCopyCount;
+		size_t recordedBufferCopyCount;
+	};
+
+	// The data should be written straight into the mapped upload memory, so it doesn't need to
+	// be copied there. The memory is write combined, so it shouldn't be read.
+	struct Reservation
+	{
+		std::span<std::uint8_t> data;
+		Buffer const*           src;
+		UINT64                  srcOffset;
+	};
+
 public:
 	StagingBufferManager(
 		ID3D12Device* device, MemoryManager* memoryManager, ThreadPool* threadPool
 	) : m_device{ device }, m_memoryManager{ memoryManager },
-		m_threadPool{ threadPool }, m_bufferInfo{}, m_tempBufferToBuffer{},
-		m_textureInfo{}, m_tempBufferToTexture{}, m_cpuTempBuffer{}
+		m_threadPool{ threadPool }, m_bufferInfo{}, m_textureInfo{}, m_tempBuffers{},
+		m_cpuTempBuffer{}, m_uploadRing{ device, memoryManager },
+		m_copyCounters{ .queuedBufferCopyCount = 0u, .recordedBufferCopyCount = 0u },
+		m_reservationCount{ 0u }, m_copyQueue{}, m_copyWaitObjs{},
+		m_maxCopyWorkerCount{ std::max(std::thread::hardware_concurrency(), 1u) }
 	{}
 
 	// The destination info is required, when an ownership transfer is desired. Which
-	// is needed when a resource has exclusive ownership.
+	// is needed when a resource has exclusive ownership. The repack mode can convert the
+	// pixels of the cpu data, while they are being copied.
 	StagingBufferManager& AddTexture(
 		std::shared_ptr<void> cpuData, Texture const* dst,
-		Callisto::TemporaryDataBufferGPU& tempDataBuffer, UINT mipLevelIndex = 0u
+		Callisto::TemporaryDataBufferGPU& tempDataBuffer, UINT mipLevelIndex = 0u,
+		RepackMode repackMode = RepackMode::Copy
+	) {
+		return AddTextureRows(
+			std::move(cpuData), dst, 0u, dst->GetMipRowCount(mipLevelIndex), tempDataBuffer,
+			mipLevelIndex, repackMode
+		);
+	}
+	// Only stages the rows from the firstRow. The cpu data should start at the firstRow.
+	StagingBufferManager& AddTextureRows(
+		std::shared_ptr<void> cpuData, Texture const* dst, UINT firstRow, UINT rowCount,
+		Callisto::TemporaryDataBufferGPU& tempDataBuffer, UINT mipLevelIndex = 0u,
+		RepackMode repackMode = RepackMode::Copy
 	);
 	StagingBufferManager& AddBuffer(
 		std::shared_ptr<void> cpuData, UINT64 bufferSize, Buffer const* dst, UINT64 offset,
 		Callisto::TemporaryDataBufferGPU& tempDataBuffer
 	);
 
+	[[nodiscard]]
+	// The reservation must be committed before the queued buffers are copied.
+	Reservation ReserveBuffer(
+		UINT64 bufferSize, Callisto::TemporaryDataBufferGPU& tempDataBuffer
+	);
+	[[nodiscard]]
+	// The rows must be written with the D3D aligned row pitch of the mip.
+	Reservation ReserveTexture(
+		Texture const* dst, Callisto::TemporaryDataBufferGPU& tempDataBuffer,
+		UINT mipLevelIndex = 0u
+	);
+
+	StagingBufferManager& CommitBuffer(
+		const Reservation& reservation, Buffer const* dst, UINT64 offset
+	);
+	StagingBufferManager& CommitTexture(
+		const Reservation& reservation, Texture const* dst, UINT mipLevelIndex = 0u
+	);
+
+	// The data which isn't bigger than the max allocation size of the upload ring is staged
+	// there. So, the copies must be marked as used with the fence of the submission afterwards.
 	void CopyAndClearQueuedBuffers(const D3DCommandList& copyCmdList);
 
+	void SetUsed(ID3D12Fence* fence, UINT64 fenceValue)
+	{
+		m_uploadRing.SetUsed(fence, fenceValue);
+	}
+
+	// Should be called once per frame, so the upload ring doesn't keep the memory it grew to
+	// for a burst of uploads.
+	void ShrinkUploadRing() { m_uploadRing.ShrinkIfUnderused(); }
+
+	[[nodiscard]]
+	// The counts since the creation or the last reset.
+	const CopyCounters& GetCopyCounters() const noexcept { return m_copyCounters; }
+
+	void ResetCopyCounters() noexcept
+	{
+		m_copyCounters       = CopyCounters{ .queuedBufferCopyCount = 0u, .recordedBufferCopyCount = 0u };
+	}
+
 private:
+	[[nodiscard]]
+	// Returns null if the data can be staged in the upload ring.
+	Buffer const* CreateDedicatedBuffer(
+		UINT64 bufferSize, Callisto::TemporaryDataBufferGPU& tempDataBuffer
+	);
+	[[nodiscard]]
+	Reservation Reserve(
+		UINT64 bufferSize, UINT64 alignment, Callisto::TemporaryDataBufferGPU& tempDataBuffer
+	);
+	// Sorts the buffer copies by their destinations and offsets, so the contiguous ones are
+	// next to each other and can be merged. Keeps the order if any of the destination ranges
+	// overlap, as the later copy must be the one which is kept.
+	void SortBufferInfo();
+	void AllocateFromUploadRing();
 	void CopyCPU();
 	void CopyGPU(const D3DCommandList& copyCmdList);
 
@@ -39,12 +132,17 @@ private:
 	void CleanUpBufferInfo() noexcept;
 
 private:
+	// The src is null until it is allocated from the upload ring, unless the data was too big
+	// for the ring and got its own buffer. The cpuHandle is null if the data was reserved, as
+	// it has already been written to the src.
 	struct BufferInfo
 	{
 		void const*   cpuHandle;
 		UINT64        bufferSize;
 		Buffer const* dst;
 		UINT64        offset;
+		Buffer const* src;
+		UINT64        srcOffset;
 	};
 
 	struct TextureInfo
@@ -53,6 +151,11 @@ private:
 		UINT64         bufferSize;
 		Texture const* dst;
 		UINT           mipLevelIndex;
+		Buffer const*  src;
+		UINT64         srcOffset;
+		RepackMode     repackMode;
+		UINT           firstRow;
+		UINT           rowCount;
 	};
 
 private:
@@ -60,10 +163,15 @@ private:
 	MemoryManager*                       m_memoryManager;
 	ThreadPool*                          m_threadPool;
 	std::vector<BufferInfo>              m_bufferInfo;
-	std::vector<std::shared_ptr<Buffer>> m_tempBufferToBuffer;
 	std::vector<TextureInfo>             m_textureInfo;
-	std::vector<std::shared_ptr<Buffer>> m_tempBufferToTexture;
+	std::vector<std::shared_ptr<Buffer>> m_tempBuffers;
 	Callisto::TemporaryDataBufferCPU     m_cpuTempBuffer;
+	UploadRingAllocator                  m_uploadRing;
+	CopyCounters                         m_copyCounters;
+	size_t                               m_reservationCount;
+	ParallelCopyQueue                    m_copyQueue;
+	std::vector<std::future<void>>       m_copyWaitObjs;
+	size_t                               m_maxCopyWorkerCount;
 
 public:
 	StagingBufferManager(const StagingBufferManager&) = delete;
@@ -73,22 +181,32 @@ public:
 		: m_device{ other.m_device }, m_memoryManager{ other.m_memoryManager },
 		m_threadPool{ other.m_threadPool },
 		m_bufferInfo{ std::move(other.m_bufferInfo) },
-		m_tempBufferToBuffer{ std::move(other.m_tempBufferToBuffer) },
 		m_textureInfo{ std::move(other.m_textureInfo) },
-		m_tempBufferToTexture{ std::move(other.m_tempBufferToTexture) },
-		m_cpuTempBuffer{ std::move(other.m_cpuTempBuffer) }
+		m_tempBuffers{ std::move(other.m_tempBuffers) },
+		m_cpuTempBuffer{ std::move(other.m_cpuTempBuffer) },
+		m_uploadRing{ std::move(other.m_uploadRing) },
+		m_copyCounters{ other.m_copyCounters },
+		m_reservationCount{ other.m_reservationCount },
+		m_copyQueue{ std::move(other.m_copyQueue) },
+		m_copyWaitObjs{ std::move(other.m_copyWaitObjs) },
+		m_maxCopyWorkerCount{ other.m_maxCopyWorkerCount }
 	{}
 
 	StagingBufferManager& operator=(StagingBufferManager&& other) noexcept
 	{
-		m_device              = other.m_device;
-		m_memoryManager       = other.m_memoryManager;
-		m_threadPool          = other.m_threadPool;
-		m_bufferInfo          = std::move(other.m_bufferInfo);
-		m_tempBufferToBuffer  = std::move(other.m_tempBufferToBuffer);
-		m_textureInfo         = std::move(other.m_textureInfo);
-		m_tempBufferToTexture = std::move(other.m_tempBufferToTexture);
-		m_cpuTempBuffer       = std::move(other.m_cpuTempBuffer);
+		m_device             = other.m_device;
+		m_memoryManager      = other.m_memoryManager;
+		m_threadPool         = other.m_threadPool;
+		m_bufferInfo         = std::move(other.m_bufferInfo);
+		m_textureInfo        = std::move(other.m_textureInfo);
+		m_tempBuffers        = std::move(other.m_tempBuffers);
+		m_cpuTempBuffer      = std::move(other.m_cpuTempBuffer);
+		m_uploadRing         = std::move(other.m_uploadRing);
+		m_copyCounters       = other.m_copyCounters;
+		m_reservationCount   = other.m_reservationCount;
+		m_copyQueue          = std::move(other.m_copyQueue);
+		m_copyWaitObjs       = std::move(other.m_copyWaitObjs);
+		m_maxCopyWorkerCount = other.m_maxCopyWorkerCount;
 
 		return *this;
 	}
@@ -0,0 +1,30 @@
+#ifndef D3D_TEXTURE_FORMAT_HPP_
+#define D3D_TEXTURE_FORMAT_HPP_
+#include <D3DHeaders.hpp>
+
+namespace Gaia
+{
+// The memory layout of a texture format. The block compressed formats store blocks of 4x4
+// texels, so a row in a buffer is a row of blocks. The other formats are handled as blocks of
+// a single texel.
+struct TextureFormatInfo
+{
+	UINT blockSize;
+	// 0, if the format isn't supported.
+	UINT bytesPerBlock;
+};
+
+[[nodiscard]]
+TextureFormatInfo GetTextureFormatInfo(DXGI_FORMAT format) noexcept;
+
+[[nodiscard]]
+bool IsBlockCompressed(DXGI_FORMAT format) noexcept;
+
+[[nodiscard]]
+// The size of a tightly packed row of blocks.
+UINT64 GetTextureRowPitch(DXGI_FORMAT format, UINT64 width) noexcept;
+[[nodiscard]]
+// The number of rows of blocks.
+UINT GetTextureRowCount(DXGI_FORMAT format, UINT height) noexcept;
+}
+#endif
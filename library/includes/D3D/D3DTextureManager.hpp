@@ -1,13 +1,15 @@
 #ifndef D3D_TEXTURE_MANAGER_HPP_
 #define D3D_TEXTURE_MANAGER_HPP_
 #include <D3DResources.hpp>
-#include <D3DStagingBufferManager.hpp>
+#include <D3DUploadScheduler.hpp>
 #include <D3DDescriptorHeapManager.hpp>
 #include <D3DCommandQueue.hpp>
+#include <MipGenerator.hpp>
 #include <TemporaryDataBuffer.hpp>
 #include <ReusableVector.hpp>
 #include <deque>
 #include <optional>
+#include <unordered_map>
 #include <Texture.hpp>
 
 namespace Gaia
@@ -18,15 +20,16 @@ class TextureStorage
 {
 	inline static size_t s_defaultSamplerIndex = 0u;
 public:
-	TextureStorage(ID3D12Device* device, MemoryManager* memoryManager)
+	TextureStorage(ID3D12Device* device, MemoryManager* memoryManager, ThreadPool* threadPool)
 		: m_device{ device }, m_memoryManager{ memoryManager },
-		m_textures{}, m_samplers{}, m_transitionQueue{}, m_textureCacheDetails{}
+		m_textures{}, m_samplers{}, m_transitionQueue{}, m_textureCacheDetails{},
+		m_bindingCounts{}, m_mipGenerator{ threadPool }
 	{}
 
 	[[nodiscard]]
-	size_t AddTexture(
-		STexture&& texture, StagingBufferManager& stagingBufferManager,
-		Callisto::TemporaryDataBufferGPU& tempBuffer, bool msaa = false
+	AsyncUpload<size_t> AddTexture(
+		STexture&& texture, UploadScheduler& uploadScheduler, UploadPriority priority,
+		bool msaa = false
 	);
 	[[nodiscard]]
 	size_t AddSampler(const SamplerBuilder& builder);
@@ -42,6 +45,19 @@ public:
 	[[nodiscard]]
 	std::vector<UINT> GetAndRemoveTextureCacheDetails(UINT textureIndex) noexcept;
 
+	// A texture can be bound multiple times, so the bindings are counted.
+	void AddBinding(size_t index) noexcept { ++m_bindingCounts[index]; }
+	void RemoveBinding(size_t index) noexcept
+	{
+		if (m_bindingCounts[index])
+			--m_bindingCounts[index];
+	}
+
+	[[nodiscard]]
+	// The number of the textures which aren't bound on each heap, keyed by the memoryID. The GPU
+	// can't access those textures, so a heap which only has them can be evicted.
+	std::unordered_map<std::uint16_t, size_t> GetUnboundTextureCounts() const;
+
 	[[nodiscard]]
 	const Texture& Get(size_t index) const noexcept
 	{
@@ -66,6 +82,14 @@ public:
 	// the ownership transfer wouldn't be necessary.
 	void TransitionQueuedTextures(const D3DCommandList& graphicsCmdList);
 
+	// The copies of the textures might be delayed by the upload scheduler. So, they should only
+	// be transitioned once their copies have been queued.
+	void QueueTransitions(const std::vector<Texture const*>& textures)
+	{
+		for (Texture const* texture : textures)
+			m_transitionQueue.push(texture);
+	}
+
 private:
 	struct TextureCacheDetails
 	{
@@ -79,17 +103,23 @@ private:
 		}
 	};
 
+private:
+	[[nodiscard]]
+	static DXGI_FORMAT GetTextureFormat(STextureFormat format, bool srgb) noexcept;
+
 private:
 	ID3D12Device*                               m_device;
 	MemoryManager*                              m_memoryManager;
 	// The TextureView objects need to have the same address until their data is copied.
-	// For the transitionQueue member and also the StagingBufferManager.
+	// For the transitionQueue member and also the UploadScheduler.
 	Callisto::ReusableDeque<Texture>            m_textures;
 	Callisto::ReusableDeque<D3D12_SAMPLER_DESC> m_samplers;
 	std::queue<Texture const*>                  m_transitionQueue;
 
 	std::vector<TextureCacheDetails>            m_textureCacheDetails;
 	// Sampler cache too at some point?
+	std::vector<std::uint32_t>                  m_bindingCounts;
+	MipGenerator                                m_mipGenerator;
 
 	static constexpr DXGI_FORMAT s_textureFormat = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
 
@@ -102,7 +132,9 @@ public:
 		m_textures{ std::move(other.m_textures) },
 		m_samplers{ std::move(other.m_samplers) },
 		m_transitionQueue{ std::move(other.m_transitionQueue) },
-		m_textureCacheDetails{ std::move(other.m_textureCacheDetails) }
+		m_textureCacheDetails{ std::move(other.m_textureCacheDetails) },
+		m_bindingCounts{ std::move(other.m_bindingCounts) },
+		m_mipGenerator{ std::move(other.m_mipGenerator) }
 	{}
 	TextureStorage& operator=(TextureStorage&& other) noexcept
 	{
@@ -112,6 +144,8 @@ public:
 		m_samplers            = std::move(other.m_samplers);
 		m_transitionQueue     = std::move(other.m_transitionQueue);
 		m_textureCacheDetails = std::move(other.m_textureCacheDetails);
+		m_bindingCounts       = std::move(other.m_bindingCounts);
+		m_mipGenerator        = std::move(other.m_mipGenerator);
 
 		return *this;
 	}
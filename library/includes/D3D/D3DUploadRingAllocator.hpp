@@ -0,0 +1,122 @@
+#ifndef D3D_UPLOAD_RING_ALLOCATOR_HPP_
+#define D3D_UPLOAD_RING_ALLOCATOR_HPP_
+#include <D3DHeaders.hpp>
+#include <D3DResources.hpp>
+#include <RingAllocator.hpp>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace Gaia
+{
+// Allocates the transient upload data from a single persistently mapped upload buffer, which is
+// used as a ring. The allocations of a submission are freed once its fence has been reached. If
+// the ring is full, it is replaced with a bigger one and the old one is kept until the GPU has
+// finished reading it. So, the ring grows to the size of the uploads instead of adding a buffer
+// for each of them. And it is replaced with one of the initial capacity again, once the uploads
+// have been small enough for a while.
+class UploadRingAllocator
+{
+public:
+	struct Allocation
+	{
+		Buffer const* buffer;
+		UINT64        offset;
+	};
+
+public:
+	UploadRingAllocator(
+		ID3D12Device* device, MemoryManager* memoryManager, UINT64 capacity = 16_MB,
+		UINT64 maxAllocationSize = 4_MB, std::uint32_t underusedFramesBeforeShrink = 120u
+	);
+
+	[[nodiscard]]
+	// The size must not be larger than the max allocation size.
+	Allocation Allocate(UINT64 size, UINT64 alignment);
+
+	// Should be called after the copies which read the allocations made since the last call
+	// have been submitted. They will be freed once the fence reaches the value.
+	void SetUsed(ID3D12Fence* fence, UINT64 fenceValue);
+
+	// Should be called once per frame. If the ring has grown, but the allocations in flight
+	// would have fit in half of the initial capacity for underusedFramesBeforeShrink frames
+	// in a row, it is shrunk back to the initial capacity.
+	void ShrinkIfUnderused();
+
+	[[nodiscard]]
+	// The bigger data should get its own buffer, so it doesn't grow the ring.
+	UINT64 GetMaxAllocationSize() const noexcept { return m_maxAllocationSize; }
+	[[nodiscard]]
+	UINT64 GetCapacity() const noexcept { return m_ring.GetCapacity(); }
+
+private:
+	struct Submission
+	{
+		ID3D12Fence* fence;
+		UINT64       fenceValue;
+	};
+
+	// A replaced ring might still have allocations which haven't been submitted yet. So, the
+	// fence is set with the next submission.
+	struct RetiredBuffer
+	{
+		std::unique_ptr<Buffer> buffer;
+		Submission              submission;
+	};
+
+private:
+	void ReleaseCompletedSubmissions() noexcept;
+	void Grow(UINT64 size);
+	void Replace(UINT64 capacity);
+
+	[[nodiscard]]
+	static bool IsCompleted(const Submission& submission) noexcept
+	{
+		return submission.fence && submission.fence->GetCompletedValue() >= submission.fenceValue;
+	}
+
+private:
+	ID3D12Device*              m_device;
+	MemoryManager*             m_memoryManager;
+	// The allocations keep a pointer to the buffer, so it is kept on the heap.
+	std::unique_ptr<Buffer>    m_buffer;
+	RingAllocator              m_ring;
+	std::deque<Submission>     m_submissions;
+	std::vector<RetiredBuffer> m_retiredBuffers;
+	UINT64                     m_maxAllocationSize;
+	UINT64                     m_initialCapacity;
+	std::uint32_t              m_underusedFramesBeforeShrink;
+	std::uint32_t              m_underusedFrameCount;
+
+public:
+	UploadRingAllocator(const UploadRingAllocator&) = delete;
+	UploadRingAllocator& operator=(const UploadRingAllocator&) = delete;
+
+	UploadRingAllocator(UploadRingAllocator&& other) noexcept
+		: m_device{ other.m_device }, m_memoryManager{ other.m_memoryManager },
+		m_buffer{ std::move(other.m_buffer) }, m_ring{ std::move(other.m_ring) },
+		m_submissions{ std::move(other.m_submissions) },
+		m_retiredBuffers{ std::move(other.m_retiredBuffers) },
+		m_maxAllocationSize{ other.m_maxAllocationSize },
+		m_initialCapacity{ other.m_initialCapacity },
+		m_underusedFramesBeforeShrink{ other.m_underusedFramesBeforeShrink },
+		m_underusedFrameCount{ other.m_underusedFrameCount }
+	{}
+	UploadRingAllocator& operator=(UploadRingAllocator&& other) noexcept
+	{
+		m_device                      = other.m_device;
+		m_memoryManager               = other.m_memoryManager;
+		m_buffer                      = std::move(other.m_buffer);
+		m_ring                        = std::move(other.m_ring);
+		m_submissions                 = std::move(other.m_submissions);
+		m_retiredBuffers              = std::move(other.m_retiredBuffers);
+		m_maxAllocationSize           = other.m_maxAllocationSize;
+		m_initialCapacity             = other.m_initialCapacity;
+		m_underusedFramesBeforeShrink = other.m_underusedFramesBeforeShrink;
+		m_underusedFrameCount         = other.m_underusedFrameCount;
+
+		return *this;
+	}
+};
+}
+#endif
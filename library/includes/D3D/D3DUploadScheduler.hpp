@@ -0,0 +1,166 @@
+#ifndef D3D_UPLOAD_SCHEDULER_HPP_
+#define D3D_UPLOAD_SCHEDULER_HPP_
+#include <D3DStagingBufferManager.hpp>
+#include <D3DUploadTracker.hpp>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace Gaia
+{
+// Holds the uploads in front of the staging buffer manager, so a frame only copies as many bytes
+// as its budget allows. The critical uploads are always queued. Then the normal and the
+// background ones are queued in order, until the next one doesn't fit in the budget. The
+// uploads which don't fit are carried over to the next frames. The uploads which are bigger than
+// the chunk size are split into ranges or bands of rows. Only a window of their chunks is queued
+// each frame, so they don't need an equally big upload buffer. But all the chunks of a critical
+// upload are queued together. The destinations must stay alive until their uploads have been
+// queued. The mesh bundles don't go through it, as they are drawn as soon as they are added. So,
+// their streams can't be spread over several frames.
+class UploadScheduler
+{
+public:
+	struct FrameStats
+	{
+		// The bytes which were queued by the last call to QueueUploads.
+		UINT64 uploadedBytes;
+		UINT64 backlogBytes;
+		// Each chunk of a split upload is counted.
+		size_t backlogCount;
+	};
+
+public:
+	// A budget of 0 means there isn't any limit. The chunks should fit in the upload ring of the
+	// staging buffer manager, so they don't get their own buffers.
+	UploadScheduler(
+		UINT64 bytesPerFrame = 0u, UINT64 chunkSize = 4_MB, UINT64 stagingWindowSize = 8_MB
+	);
+
+	[[nodiscard]]
+	UploadTicket AddBuffer(
+		std::shared_ptr<void> cpuData, UINT64 bufferSize, Buffer const* dst, UINT64 offset,
+		UploadPriority priority
+	);
+	[[nodiscard]]
+	// The texture will be transitioned after this upload.
+	UploadTicket AddTexture(
+		std::shared_ptr<void> cpuData, Texture const* dst, UploadPriority priority,
+		UINT mipLevelIndex = 0u, RepackMode repackMode = RepackMode::Copy
+	);
+	[[nodiscard]]
+	// The mips are uploaded in order with a single ticket, and the texture is transitioned
+	// after the last one.
+	UploadTicket AddTextureMips(
+		std::vector<std::shared_ptr<void>> mipData, Texture const* dst, UploadPriority priority
+	);
+
+	[[nodiscard]]
+	// For the copies which were added to the staging buffer manager directly. They will be
+	// submitted with the next frame, like the critical uploads.
+	UploadTicket GetImmediateTicket() noexcept { return GetNextTicket(UploadPriority::Critical); }
+
+	// Drops the uploads to the texture which haven't been queued yet. Should be called before
+	// the texture is destroyed.
+	void RemoveTexture(Texture const* dst) noexcept;
+
+	void QueueUploads(
+		StagingBufferManager& stagingBufferManager,
+		Callisto::TemporaryDataBufferGPU& tempDataBuffer
+	);
+
+	void SetBudget(UINT64 bytesPerFrame) noexcept { m_bytesPerFrame = bytesPerFrame; }
+
+	[[nodiscard]]
+	UINT64 GetBudget() const noexcept { return m_bytesPerFrame; }
+	[[nodiscard]]
+	UINT64 GetChunkSize() const noexcept { return m_chunkSize; }
+	[[nodiscard]]
+	UINT64 GetStagingWindowSize() const noexcept { return m_stagingWindowSize; }
+	[[nodiscard]]
+	bool HasBacklog() const noexcept { return m_frameStats.backlogCount != 0u; }
+	[[nodiscard]]
+	const FrameStats& GetFrameStats() const noexcept { return m_frameStats; }
+	[[nodiscard]]
+	// The textures which were queued by the last call to QueueUploads. They need to be
+	// transitioned after their copies.
+	const std::vector<Texture const*>& GetQueuedTextures() const noexcept
+	{
+		return m_queuedTextures;
+	}
+	[[nodiscard]]
+	// The number of the uploads of each priority which have been queued so far, including the
+	// immediate ones and the removed ones.
+	UploadTracker::UploadCounts GetQueuedCounts() const noexcept;
+
+private:
+	// Either the buffer or the texture destination is set. The chunks of an upload have the
+	// same index, so its ticket is only queued with the last chunk.
+	struct Upload
+	{
+		std::shared_ptr<void> cpuData;
+		UINT64                bufferSize;
+		Buffer const*         dstBuffer;
+		UINT64                offset;
+		Texture const*        dstTexture;
+		UINT                  mipLevelIndex;
+		RepackMode            repackMode;
+		UINT                  firstRow;
+		UINT                  rowCount;
+		bool                  isChunked;
+		bool                  isLastChunk;
+		UINT64                uploadIndex;
+	};
+
+private:
+	void AddUpload(Upload&& upload, UploadPriority priority);
+	void AddTextureBands(
+		std::shared_ptr<void> cpuData, Texture const* dst, UploadPriority priority,
+		UINT mipLevelIndex, RepackMode repackMode, UINT64 uploadIndex, bool isLastMip
+	);
+
+	[[nodiscard]]
+	UploadTicket GetNextTicket(UploadPriority priority) noexcept
+	{
+		return UploadTicket{
+			.priority    = priority,
+			.uploadIndex = m_nextUploadIndices[static_cast<size_t>(priority)]++
+		};
+	}
+
+private:
+	std::array<std::deque<Upload>, UploadTracker::s_priorityCount> m_uploads;
+	UploadTracker::UploadCounts                                   m_nextUploadIndices;
+	std::vector<Texture const*>                                   m_queuedTextures;
+	UINT64                                                        m_bytesPerFrame;
+	UINT64                                                        m_chunkSize;
+	UINT64                                                        m_stagingWindowSize;
+	FrameStats                                                    m_frameStats;
+
+public:
+	UploadScheduler(const UploadScheduler&) = delete;
+	UploadScheduler& operator=(const UploadScheduler&) = delete;
+
+	UploadScheduler(UploadScheduler&& other) noexcept
+		: m_uploads{ std::move(other.m_uploads) },
+		m_nextUploadIndices{ other.m_nextUploadIndices },
+		m_queuedTextures{ std::move(other.m_queuedTextures) },
+		m_bytesPerFrame{ other.m_bytesPerFrame },
+		m_chunkSize{ other.m_chunkSize },
+		m_stagingWindowSize{ other.m_stagingWindowSize },
+		m_frameStats{ other.m_frameStats }
+	{}
+	UploadScheduler& operator=(UploadScheduler&& other) noexcept
+	{
+		m_uploads           = std::move(other.m_uploads);
+		m_nextUploadIndices = other.m_nextUploadIndices;
+		m_queuedTextures    = std::move(other.m_queuedTextures);
+		m_bytesPerFrame     = other.m_bytesPerFrame;
+		m_chunkSize         = other.m_chunkSize;
+		m_stagingWindowSize = other.m_stagingWindowSize;
+		m_frameStats        = other.m_frameStats;
+
+		return *this;
+	}
+};
+}
+#endif
@@ -0,0 +1,101 @@
+#ifndef D3D_UPLOAD_TRACKER_HPP_
+#define D3D_UPLOAD_TRACKER_HPP_
+#include <D3DFence.hpp>
+#include <array>
+#include <deque>
+
+namespace Gaia
+{
+// The critical uploads are always submitted with the next frame. The others might be delayed
+// by the upload budget, the normal ones are submitted before the background ones.
+enum class UploadPriority : std::uint8_t
+{
+	Critical,
+	Normal,
+	Background
+};
+
+// The uploads of a priority are numbered in the order they were added and are submitted in the
+// same order.
+struct UploadTicket
+{
+	UploadPriority priority;
+	UINT64         uploadIndex;
+};
+
+template<typename Result_t>
+struct AsyncUpload
+{
+	Result_t     result;
+	UploadTicket ticket;
+};
+
+// Keeps the fence values of the copy submissions, so the tickets can be checked without
+// draining the queues. The copies are submitted to a single queue, so the submissions complete
+// in order. So, a ticket is completed once the first submission which includes it has completed.
+class UploadTracker
+{
+public:
+	static constexpr size_t s_priorityCount = 3u;
+
+	// The number of the uploads of each priority.
+	using UploadCounts = std::array<UINT64, s_priorityCount>;
+
+public:
+	UploadTracker() : m_submissions{}, m_submittedCounts{}, m_completedCounts{} {}
+
+	// Should be called after the queued copies have been submitted, with the number of the
+	// uploads which have been submitted so far. The fence must outlive the tickets.
+	void SetSubmitted(
+		const D3DFence& fence, UINT64 fenceValue, const UploadCounts& submittedCounts
+	);
+
+	[[nodiscard]]
+	bool IsSubmitted(const UploadTicket& ticket) const noexcept
+	{
+		return ticket.uploadIndex < m_submittedCounts[static_cast<size_t>(ticket.priority)];
+	}
+	[[nodiscard]]
+	bool IsCompleted(const UploadTicket& ticket) noexcept;
+
+	// Returns false without waiting if the copies haven't been submitted yet. As that only
+	// happens with a later frame.
+	bool Wait(const UploadTicket& ticket);
+
+private:
+	struct Submission
+	{
+		D3DFence const* fence;
+		UINT64          fenceValue;
+		UploadCounts    submittedCounts;
+	};
+
+private:
+	void ReleaseCompletedSubmissions() noexcept;
+
+private:
+	// The submissions which might not have completed yet. The earlier ones have been released.
+	std::deque<Submission> m_submissions;
+	UploadCounts           m_submittedCounts;
+	UploadCounts           m_completedCounts;
+
+public:
+	UploadTracker(const UploadTracker&) = delete;
+	UploadTracker& operator=(const UploadTracker&) = delete;
+
+	UploadTracker(UploadTracker&& other) noexcept
+		: m_submissions{ std::move(other.m_submissions) },
+		m_submittedCounts{ other.m_submittedCounts },
+		m_completedCounts{ other.m_completedCounts }
+	{}
+	UploadTracker& operator=(UploadTracker&& other) noexcept
+	{
+		m_submissions     = std::move(other.m_submissions);
+		m_submittedCounts = other.m_submittedCounts;
+		m_completedCounts = other.m_completedCounts;
+
+		return *this;
+	}
+};
+}
+#endif
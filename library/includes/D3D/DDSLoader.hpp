@@ -0,0 +1,24 @@
+#ifndef DDS_LOADER_HPP_
+#define DDS_LOADER_HPP_
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <Texture.hpp>
+
+namespace Gaia
+{
+// Loads the 2D textures from DDS files. The block compressed formats BC1, BC3, BC5 and BC7 and
+// RGBA8 are supported, with either the legacy or the DX10 header. The mips in the file are
+// kept, so the texture can be uploaded as it is. Only the _SRGB formats are loaded as sRGB.
+class DDSLoader
+{
+public:
+	[[nodiscard]]
+	static STexture Load(const std::string& filePath);
+
+	[[nodiscard]]
+	// The data of the texture will point into the file data, so it won't be copied.
+	static STexture Parse(std::shared_ptr<std::uint8_t[]> fileData, size_t fileSize);
+};
+}
+#endif
@@ -0,0 +1,93 @@
+#ifndef FREE_REGION_ALLOCATOR_HPP_
+#define FREE_REGION_ALLOCATOR_HPP_
+#include <D3DHeaders.hpp>
+#include <map>
+#include <optional>
+#include <set>
+#include <utility>
+
+namespace Gaia
+{
+// Keeps the free regions of a shared buffer. The regions are indexed by their offsets, so a
+// relinquished region can be merged with its free neighbours right away, and by their sizes, so
+// the smallest region which fits an allocation can be found without going through all of them.
+class FreeRegionAllocator
+{
+	// The size first, so the regions are ordered by their sizes and then their offsets.
+	using SizeKey_t = std::pair<UINT64, UINT64>;
+
+public:
+	FreeRegionAllocator() : m_regionsByOffset{}, m_regionsBySize{}, m_freeSize{ 0u } {}
+
+	[[nodiscard]]
+	// Returns the offset of the smallest free region which fits the size. If there are
+	// multiple, the one with the lowest offset is used. The rest of the region stays free.
+	std::optional<UINT64> Allocate(UINT64 size);
+	[[nodiscard]]
+	// Allocates the exact range, if it is inside a single free region. The parts of the region
+	// before and after the range stay free.
+	bool AllocateAt(UINT64 offset, UINT64 size);
+
+	// Merges the region with the free regions right before and after it.
+	void Deallocate(UINT64 offset, UINT64 size);
+
+	[[nodiscard]]
+	// If the last free region ends at the end of the buffer, it is removed and its offset is
+	// returned. So, an allocation which doesn't fit anywhere can be started from there, when
+	// the buffer is extended.
+	std::optional<UINT64> RemoveTrailingRegion(UINT64 bufferSize) noexcept;
+
+	[[nodiscard]]
+	size_t GetFreeRegionCount() const noexcept { return std::size(m_regionsByOffset); }
+	[[nodiscard]]
+	UINT64 GetFreeSize() const noexcept { return m_freeSize; }
+	[[nodiscard]]
+	UINT64 GetLargestFreeRegion() const noexcept
+	{
+		return std::empty(m_regionsBySize) ? 0u : std::prev(std::end(m_regionsBySize))->first;
+	}
+	[[nodiscard]]
+	// The sizes of the free regions, keyed by their offsets.
+	const std::map<UINT64, UINT64>& GetFreeRegions() const noexcept { return m_regionsByOffset; }
+
+	[[nodiscard]]
+	// A copy of both indices, so the allocations can be tried without changing these regions.
+	FreeRegionAllocator Clone() const
+	{
+		FreeRegionAllocator allocator{};
+
+		allocator.m_regionsByOffset = m_regionsByOffset;
+		allocator.m_regionsBySize   = m_regionsBySize;
+		allocator.m_freeSize        = m_freeSize;
+
+		return allocator;
+	}
+
+private:
+	void AddRegion(UINT64 offset, UINT64 size);
+	void RemoveRegion(std::map<UINT64, UINT64>::iterator region) noexcept;
+
+private:
+	std::map<UINT64, UINT64> m_regionsByOffset;
+	std::set<SizeKey_t>      m_regionsBySize;
+	UINT64                   m_freeSize;
+
+public:
+	FreeRegionAllocator(const FreeRegionAllocator&) = delete;
+	FreeRegionAllocator& operator=(const FreeRegionAllocator&) = delete;
+
+	FreeRegionAllocator(FreeRegionAllocator&& other) noexcept
+		: m_regionsByOffset{ std::move(other.m_regionsByOffset) },
+		m_regionsBySize{ std::move(other.m_regionsBySize) }, m_freeSize{ other.m_freeSize }
+	{}
+	FreeRegionAllocator& operator=(FreeRegionAllocator&& other) noexcept
+	{
+		m_regionsByOffset = std::move(other.m_regionsByOffset);
+		m_regionsBySize   = std::move(other.m_regionsBySize);
+		m_freeSize        = other.m_freeSize;
+
+		return *this;
+	}
+};
+}
+#endif
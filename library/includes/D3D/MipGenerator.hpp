@@ -0,0 +1,78 @@
+#ifndef MIP_GENERATOR_HPP_
+#define MIP_GENERATOR_HPP_
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <vector>
+#include <ThreadPool.hpp>
+
+namespace Gaia
+{
+// Generates the mip chain of an RGBA8 image on the CPU. Each mip is the 2x2 box filtered
+// previous one. The sRGB colours are averaged in the linear space, otherwise the mips would get
+// darker. The linear colours and the alpha are averaged as they are. The rows of each mip are
+// split among the workers of the thread pool.
+class MipGenerator
+{
+public:
+	struct Mip
+	{
+		std::shared_ptr<std::uint8_t[]> data;
+		std::uint32_t                   width;
+		std::uint32_t                   height;
+	};
+
+public:
+	MipGenerator(ThreadPool* threadPool);
+
+	[[nodiscard]]
+	// Returns the mips after the first one, which is the image. The rows of the image and the
+	// mips are tightly packed.
+	std::vector<Mip> Generate(
+		std::uint8_t const* image, std::uint32_t width, std::uint32_t height, bool srgb = true
+	);
+
+	void SetMaxWorkerCount(size_t maxWorkerCount) noexcept
+	{
+		m_maxWorkerCount = std::max<size_t>(maxWorkerCount, 1u);
+	}
+
+	[[nodiscard]]
+	// Including the first mip.
+	static std::uint16_t GetMipLevelCount(std::uint32_t width, std::uint32_t height) noexcept;
+
+private:
+	// The workers wouldn't have enough to do with fewer rows.
+	static constexpr size_t s_minRowsPerWorker = 16u;
+
+private:
+	static void DownsampleRows(
+		std::uint8_t* dst, std::uint32_t dstWidth, std::uint8_t const* src, std::uint32_t srcWidth,
+		std::uint32_t srcHeight, size_t firstRow, size_t rowCount, bool srgb
+	) noexcept;
+
+private:
+	ThreadPool*                    m_threadPool;
+	std::vector<std::future<void>> m_waitObjs;
+	size_t                         m_maxWorkerCount;
+
+public:
+	MipGenerator(const MipGenerator&) = delete;
+	MipGenerator& operator=(const MipGenerator&) = delete;
+
+	MipGenerator(MipGenerator&& other) noexcept
+		: m_threadPool{ other.m_threadPool }, m_waitObjs{ std::move(other.m_waitObjs) },
+		m_maxWorkerCount{ other.m_maxWorkerCount }
+	{}
+	MipGenerator& operator=(MipGenerator&& other) noexcept
+	{
+		m_threadPool     = other.m_threadPool;
+		m_waitObjs       = std::move(other.m_waitObjs);
+		m_maxWorkerCount = other.m_maxWorkerCount;
+
+		return *this;
+	}
+};
+}
+#endif
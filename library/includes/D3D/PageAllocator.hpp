@@ -0,0 +1,79 @@
+#ifndef PAGE_ALLOCATOR_HPP_
+#define PAGE_ALLOCATOR_HPP_
+#include <D3DHeaders.hpp>
+#include <FreeRegionAllocator.hpp>
+#include <optional>
+#include <vector>
+
+namespace Gaia
+{
+// Sub-allocates from a list of pages, which are only added when nothing fits. So, the memory it
+// is used for never needs to be recreated or copied. An allocation never straddles pages, so it
+// is addressed by its page index and its offset in the page. The first page which fits an
+// allocation is used, and the best fitting region in it. So, two page allocators with the same
+// sequence of allocations and deallocations, whose sizes are proportional to their page sizes,
+// will return the same page indices and proportional offsets.
+class PageAllocator
+{
+public:
+	struct Allocation
+	{
+		size_t pageIndex;
+		UINT64 offset;
+	};
+
+public:
+	PageAllocator(UINT64 pageSize);
+
+	[[nodiscard]]
+	// Returns an empty optional if none of the pages can fit the size.
+	std::optional<Allocation> Allocate(UINT64 size);
+
+	void Deallocate(const Allocation& allocation, UINT64 size);
+
+	// The page will be bigger than the page size, if the size doesn't fit in one. Returns the
+	// index of the new page.
+	size_t AddPage(UINT64 size);
+
+	[[nodiscard]]
+	UINT64 GetPageSize() const noexcept { return m_pageSize; }
+	[[nodiscard]]
+	UINT64 GetPageSize(size_t pageIndex) const noexcept { return m_pages[pageIndex].size; }
+	[[nodiscard]]
+	size_t GetPageCount() const noexcept { return std::size(m_pages); }
+	[[nodiscard]]
+	UINT64 GetTotalSize() const noexcept { return m_totalSize; }
+	[[nodiscard]]
+	UINT64 GetFreeSize() const noexcept;
+
+private:
+	struct Page
+	{
+		UINT64              size;
+		FreeRegionAllocator freeRegions;
+	};
+
+private:
+	UINT64            m_pageSize;
+	std::vector<Page> m_pages;
+	UINT64            m_totalSize;
+
+public:
+	PageAllocator(const PageAllocator&) = delete;
+	PageAllocator& operator=(const PageAllocator&) = delete;
+
+	PageAllocator(PageAllocator&& other) noexcept
+		: m_pageSize{ other.m_pageSize }, m_pages{ std::move(other.m_pages) },
+		m_totalSize{ other.m_totalSize }
+	{}
+	PageAllocator& operator=(PageAllocator&& other) noexcept
+	{
+		m_pageSize  = other.m_pageSize;
+		m_pages     = std::move(other.m_pages);
+		m_totalSize = other.m_totalSize;
+
+		return *this;
+	}
+};
+}
+#endif
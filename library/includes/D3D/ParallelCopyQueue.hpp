@@ -0,0 +1,114 @@
+#ifndef PARALLEL_COPY_QUEUE_HPP_
+#define PARALLEL_COPY_QUEUE_HPP_
+#include <AllocatorBase.hpp>
+#include <RowRepacker.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Gaia
+{
+// Splits the queued copies into chunks which should fit in the cache and distributes them among
+// a number of workers. Each worker gets a contiguous range of chunks of roughly the same size
+// and copies them from the front. Once its range is empty, it steals the chunks from the back of
+// the other ranges. So, a worker which starts late or gets the slower copies doesn't hold the
+// others up. The ranges are set before the workers are started, so the queue itself doesn't
+// need to be thread safe, only the ranges are. The chunks are copied with the row repacker.
+class ParallelCopyQueue
+{
+public:
+	ParallelCopyQueue(size_t chunkSize = 256_KB) : ParallelCopyQueue{ chunkSize, RowRepacker{} } {}
+	ParallelCopyQueue(size_t chunkSize, const RowRepacker& rowRepacker);
+
+	void AddCopy(void* dst, void const* src, size_t size);
+	// Copies rowCount rows of rowSize bytes. The rowSize is the size of a destination row and
+	// the padding after it is zeroed. The rows are never split, a chunk has as many of them as
+	// fit in the chunk size, but at least one.
+	void AddRowCopy(
+		void* dst, void const* src, size_t rowSize, size_t rowCount, size_t dstRowPitch,
+		size_t srcRowPitch, RepackMode mode = RepackMode::Copy
+	);
+
+	[[nodiscard]]
+	// Must be called after the copies have been added and before the workers are started.
+	// Returns the number of workers which should be started, which won't be more than the
+	// number of chunks.
+	size_t Distribute(size_t maxWorkerCount);
+
+	// Must be called once for each worker index returned by Distribute, from any thread.
+	void Run(size_t workerIndex) noexcept;
+
+	void Clear() noexcept;
+
+	[[nodiscard]]
+	size_t GetChunkSize() const noexcept { return m_chunkSize; }
+	[[nodiscard]]
+	size_t GetChunkCount() const noexcept { return std::size(m_chunks); }
+	[[nodiscard]]
+	size_t GetCopySize() const noexcept { return m_copySize; }
+
+private:
+	struct Chunk
+	{
+		std::uint8_t*       dst;
+		std::uint8_t const* src;
+		size_t              rowSize;
+		size_t              rowCount;
+		size_t              dstRowPitch;
+		size_t              srcRowPitch;
+		RepackMode          mode;
+	};
+
+private:
+	// The start and the end of a range are packed together, so both the owner and a thief can
+	// claim a chunk with a single compare exchange.
+	[[nodiscard]]
+	static std::uint64_t PackRange(std::uint64_t start, std::uint64_t end) noexcept
+	{
+		return start | (end << 32u);
+	}
+
+	[[nodiscard]]
+	bool PopFront(size_t workerIndex, size_t& chunkIndex) noexcept;
+	[[nodiscard]]
+	bool StealBack(size_t workerIndex, size_t& chunkIndex) noexcept;
+
+	void CopyChunk(const Chunk& chunk) const noexcept;
+
+private:
+	size_t                                        m_chunkSize;
+	size_t                                        m_copySize;
+	std::vector<Chunk>                            m_chunks;
+	// The atomics can't be moved, so they can't be kept in a vector.
+	std::unique_ptr<std::atomic<std::uint64_t>[]> m_ranges;
+	size_t                                        m_rangeCapacity;
+	size_t                                        m_workerCount;
+	RowRepacker                                   m_rowRepacker;
+
+public:
+	ParallelCopyQueue(const ParallelCopyQueue&) = delete;
+	ParallelCopyQueue& operator=(const ParallelCopyQueue&) = delete;
+
+	// Shouldn't be moved while the workers are running.
+	ParallelCopyQueue(ParallelCopyQueue&& other) noexcept
+		: m_chunkSize{ other.m_chunkSize }, m_copySize{ other.m_copySize },
+		m_chunks{ std::move(other.m_chunks) }, m_ranges{ std::move(other.m_ranges) },
+		m_rangeCapacity{ other.m_rangeCapacity }, m_workerCount{ other.m_workerCount },
+		m_rowRepacker{ other.m_rowRepacker }
+	{}
+	ParallelCopyQueue& operator=(ParallelCopyQueue&& other) noexcept
+	{
+		m_chunkSize     = other.m_chunkSize;
+		m_copySize      = other.m_copySize;
+		m_chunks        = std::move(other.m_chunks);
+		m_ranges        = std::move(other.m_ranges);
+		m_rangeCapacity = other.m_rangeCapacity;
+		m_workerCount   = other.m_workerCount;
+		m_rowRepacker   = other.m_rowRepacker;
+
+		return *this;
+	}
+};
+}
+#endif
@@ -74,6 +74,13 @@ public:
 		return m_gaia.GetRenderEngine().AddTexture(std::move(texture));
 	}
 
+	[[nodiscard]]
+	AsyncUpload<size_t> AddTextureAsync(
+		STexture&& texture, UploadPriority priority = UploadPriority::Normal
+	) {
+		return m_gaia.GetRenderEngine().AddTextureAsync(std::move(texture), priority);
+	}
+
 	void UnbindTexture(size_t textureIndex, std::uint32_t bindingIndex)
 	{
 		m_gaia.GetRenderEngine().UnbindTexture(textureIndex, bindingIndex);
@@ -129,6 +136,47 @@ public:
 		return m_gaia.GetRenderEngine().AddMeshBundle(std::move(meshBundle));
 	}
 
+	[[nodiscard]]
+	std::vector<std::uint32_t> AddMeshBundles(std::vector<MeshBundleTemporaryData>&& meshBundles)
+	{
+		return m_gaia.GetRenderEngine().AddMeshBundles(std::move(meshBundles));
+	}
+
+	[[nodiscard]]
+	AsyncUpload<std::uint32_t> AddMeshBundleAsync(MeshBundleTemporaryData&& meshBundle)
+	{
+		return m_gaia.GetRenderEngine().AddMeshBundleAsync(std::move(meshBundle));
+	}
+
+	[[nodiscard]]
+	AsyncUpload<std::vector<std::uint32_t>> AddMeshBundlesAsync(
+		std::vector<MeshBundleTemporaryData>&& meshBundles
+	) {
+		return m_gaia.GetRenderEngine().AddMeshBundlesAsync(std::move(meshBundles));
+	}
+
+	[[nodiscard]]
+	bool IsUploadCompleted(const UploadTicket& ticket) noexcept
+	{
+		return m_gaia.GetRenderEngine().IsUploadCompleted(ticket);
+	}
+
+	bool WaitForUpload(const UploadTicket& ticket)
+	{
+		return m_gaia.GetRenderEngine().WaitForUpload(ticket);
+	}
+
+	void SetUploadBudget(UINT64 bytesPerFrame) noexcept
+	{
+		m_gaia.GetRenderEngine().SetUploadBudget(bytesPerFrame);
+	}
+
+	[[nodiscard]]
+	const UploadScheduler::FrameStats& GetUploadStats() const noexcept
+	{
+		return m_gaia.GetRenderEngine().GetUploadStats();
+	}
+
 	void RemoveMeshBundle(std::uint32_t bundleIndex) noexcept
 	{
 		m_gaia.GetRenderEngine().RemoveMeshBundle(bundleIndex);
@@ -176,11 +224,11 @@ public:
 		m_gaia.GetRenderEngine().UpdateExternalBufferDescriptor(bindingDetails);
 	}
 
-	void UploadExternalBufferGPUOnlyData(
+	UploadTicket UploadExternalBufferGPUOnlyData(
 		std::uint32_t externalBufferIndex, std::shared_ptr<void> cpuData,
 		size_t srcDataSizeInBytes, size_t dstBufferOffset
 	) {
-		m_gaia.GetRenderEngine().UploadExternalBufferGPUOnlyData(
+		return m_gaia.GetRenderEngine().UploadExternalBufferGPUOnlyData(
 			externalBufferIndex, std::move(cpuData), srcDataSizeInBytes, dstBufferOffset
 		);
 	}
@@ -0,0 +1,63 @@
+#ifndef RING_ALLOCATOR_HPP_
+#define RING_ALLOCATOR_HPP_
+#include <D3DHeaders.hpp>
+#include <optional>
+#include <queue>
+
+namespace Gaia
+{
+// Linearly allocates from a ring of a fixed capacity. The allocations are grouped into
+// submissions and freed in the same order, a submission at a time, once the GPU has finished
+// reading them. An allocation never wraps around the end of the ring, the rest of the ring is
+// skipped instead.
+class RingAllocator
+{
+public:
+	RingAllocator(UINT64 capacity);
+
+	[[nodiscard]]
+	// Returns an empty optional if the ring doesn't have enough free space before the oldest
+	// submission which hasn't been released yet.
+	std::optional<UINT64> Allocate(UINT64 size, UINT64 alignment);
+
+	// The allocations made since the last submission will be released together.
+	void Submit();
+	// Releases the oldest submission.
+	void ReleaseSubmission() noexcept;
+
+	[[nodiscard]]
+	UINT64 GetCapacity() const noexcept { return m_capacity; }
+	[[nodiscard]]
+	// Includes the skipped space at the end of the ring.
+	UINT64 GetUsedSize() const noexcept { return m_head - m_tail; }
+	[[nodiscard]]
+	size_t GetSubmissionCount() const noexcept { return std::size(m_submissionEnds); }
+
+private:
+	UINT64             m_capacity;
+	// The head and the tail only increase, their offset in the ring is the remainder of the
+	// capacity. So, the used size is their difference, even after a wrap around.
+	UINT64             m_head;
+	UINT64             m_tail;
+	std::queue<UINT64> m_submissionEnds;
+
+public:
+	RingAllocator(const RingAllocator&) = delete;
+	RingAllocator& operator=(const RingAllocator&) = delete;
+
+	RingAllocator(RingAllocator&& other) noexcept
+		: m_capacity{ other.m_capacity }, m_head{ other.m_head }, m_tail{ other.m_tail },
+		m_submissionEnds{ std::move(other.m_submissionEnds) }
+	{}
+	RingAllocator& operator=(RingAllocator&& other) noexcept
+	{
+		m_capacity       = other.m_capacity;
+		m_head           = other.m_head;
+		m_tail           = other.m_tail;
+		m_submissionEnds = std::move(other.m_submissionEnds);
+
+		return *this;
+	}
+};
+}
+#endif
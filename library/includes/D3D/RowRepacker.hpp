@@ -0,0 +1,70 @@
+#ifndef ROW_REPACKER_HPP_
+#define ROW_REPACKER_HPP_
+#include <array>
+#include <cstdint>
+
+namespace Gaia
+{
+enum class RepackMode : std::uint8_t
+{
+	Copy,
+	// The source has 3 bytes per pixel. The alpha of the destination pixels is set to 255.
+	RGB8ToRGBA8
+};
+
+// Copies rows of pixels into the upload memory, which is write combined. So, the SIMD kernels
+// use non-temporal stores, which don't read the destination lines into the cache, and the
+// padding after each row is written as well, so the lines at the end of the rows are flushed
+// as a whole. The kernel is picked once, depending on the instruction sets the CPU supports.
+class RowRepacker
+{
+public:
+	enum class InstructionSet : std::uint8_t
+	{
+		Scalar,
+		SSE2,
+		AVX2
+	};
+
+public:
+	RowRepacker() : RowRepacker{ GetSupportedInstructionSet() } {}
+	// The instruction set must be supported by the CPU.
+	explicit RowRepacker(InstructionSet instructionSet);
+
+	// The rowSize is the size of a destination row. The bytes between the rowSize and the
+	// dstRowPitch are zeroed.
+	void Repack(
+		void* dst, void const* src, size_t rowSize, size_t rowCount, size_t dstRowPitch,
+		size_t srcRowPitch, RepackMode mode
+	) const noexcept;
+
+	[[nodiscard]]
+	InstructionSet GetInstructionSet() const noexcept { return m_instructionSet; }
+
+	[[nodiscard]]
+	static InstructionSet GetSupportedInstructionSet() noexcept;
+	[[nodiscard]]
+	static bool IsSupported(InstructionSet instructionSet) noexcept
+	{
+		return instructionSet <= GetSupportedInstructionSet();
+	}
+
+	[[nodiscard]]
+	static size_t GetSrcRowSize(size_t rowSize, RepackMode mode) noexcept
+	{
+		return mode == RepackMode::RGB8ToRGBA8 ? rowSize / 4u * 3u : rowSize;
+	}
+
+private:
+	using Kernel_t = void(*)(
+		std::uint8_t* dst, std::uint8_t const* src, size_t rowSize, size_t rowCount,
+		size_t dstRowPitch, size_t srcRowPitch
+	) noexcept;
+
+private:
+	InstructionSet          m_instructionSet;
+	// Indexed with the repack mode.
+	std::array<Kernel_t, 2> m_kernels;
+};
+}
+#endif
@@ -0,0 +1,78 @@
+#ifndef SLAB_ALLOCATOR_HPP_
+#define SLAB_ALLOCATOR_HPP_
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace Gaia
+{
+// Hands out fixed size slots, which are added a slab at a time. So, the memory it is used for
+// only needs to grow once per slab instead of once per allocation. The lowest free slot is
+// always returned, so two slab allocators with the same sequence of allocations and
+// deallocations will return the same slot indices, even if their slot sizes are different.
+class SlabAllocator
+{
+public:
+	// Each slab has as many slots as can fit in the slab size, but at least one.
+	SlabAllocator(size_t slotSize, size_t slabSize);
+
+	[[nodiscard]]
+	// Returns an empty optional if all of the slots are allocated.
+	std::optional<size_t> Allocate() noexcept;
+
+	void Deallocate(size_t slotIndex) noexcept;
+
+	// Returns the index of the first slot of the new slab.
+	size_t AddSlab();
+
+	[[nodiscard]]
+	size_t GetSlotOffset(size_t slotIndex) const noexcept { return slotIndex * m_slotSize; }
+	[[nodiscard]]
+	size_t GetSlotSize() const noexcept { return m_slotSize; }
+	[[nodiscard]]
+	size_t GetSlabSlotCount() const noexcept { return m_slabSlotCount; }
+	[[nodiscard]]
+	// The size in bytes, which should be added to the memory for each slab.
+	size_t GetSlabSize() const noexcept { return m_slabSlotCount * m_slotSize; }
+	[[nodiscard]]
+	size_t GetSlotCount() const noexcept { return m_slotCount; }
+	[[nodiscard]]
+	size_t GetAllocatedSlotCount() const noexcept { return m_allocatedSlotCount; }
+
+private:
+	void SetSlotFree(size_t slotIndex, bool isFree) noexcept;
+
+private:
+	size_t                     m_slotSize;
+	size_t                     m_slabSlotCount;
+	size_t                     m_slotCount;
+	size_t                     m_allocatedSlotCount;
+	// A set bit means the slot is free.
+	std::vector<std::uint64_t> m_freeSlotMasks;
+	// None of the words before this one have a free slot.
+	size_t                     m_firstFreeMaskIndex;
+
+public:
+	SlabAllocator(const SlabAllocator&) = delete;
+	SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+	SlabAllocator(SlabAllocator&& other) noexcept
+		: m_slotSize{ other.m_slotSize }, m_slabSlotCount{ other.m_slabSlotCount },
+		m_slotCount{ other.m_slotCount }, m_allocatedSlotCount{ other.m_allocatedSlotCount },
+		m_freeSlotMasks{ std::move(other.m_freeSlotMasks) },
+		m_firstFreeMaskIndex{ other.m_firstFreeMaskIndex }
+	{}
+	SlabAllocator& operator=(SlabAllocator&& other) noexcept
+	{
+		m_slotSize           = other.m_slotSize;
+		m_slabSlotCount      = other.m_slabSlotCount;
+		m_slotCount          = other.m_slotCount;
+		m_allocatedSlotCount = other.m_allocatedSlotCount;
+		m_freeSlotMasks      = std::move(other.m_freeSlotMasks);
+		m_firstFreeMaskIndex = other.m_firstFreeMaskIndex;
+
+		return *this;
+	}
+};
+}
+#endif
@@ -0,0 +1,150 @@
+#ifndef TLSF_ALLOCATOR_HPP_
+#define TLSF_ALLOCATOR_HPP_
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace Gaia
+{
+// Two level segregated fit allocator. It only keeps track of the offsets, so it can be used to
+// sub-allocate any kind of memory, i.e. an ID3D12Heap. Both allocation and deallocation should
+// be O(1). Unlike the buddy allocator, a request is only rounded up to the granularity and not to
+// the next power of 2.
+class TLSFAllocator
+{
+	static constexpr size_t s_secondLevelLog2  = 4u;
+	static constexpr size_t s_secondLevelCount = 1u << s_secondLevelLog2;
+	static constexpr size_t s_firstLevelCount  = 64u;
+	static constexpr size_t s_invalidIndex     = std::numeric_limits<size_t>::max();
+
+public:
+	// The granularity must be a power of 2. Every allocation's size and offset will be a
+	// multiple of it.
+	TLSFAllocator(size_t startingAddress, size_t size, size_t granularity);
+
+	[[nodiscard]]
+	// Returns an empty optional if there isn't a free block which can house the allocation.
+	std::optional<size_t> Allocate(size_t size, size_t alignment);
+	[[nodiscard]]
+	// Allocates at the exact offset. Returns false if the range isn't in a single free block.
+	bool AllocateAt(size_t offset, size_t size);
+
+	void Deallocate(size_t startingAddress) noexcept;
+
+	[[nodiscard]]
+	size_t Size() const noexcept { return m_size; }
+	[[nodiscard]]
+	size_t AvailableSize() const noexcept { return m_availableSize; }
+	[[nodiscard]]
+	size_t Granularity() const noexcept { return m_granularity; }
+	[[nodiscard]]
+	size_t LargestFreeBlockSize() const noexcept;
+	[[nodiscard]]
+	size_t FreeBlockCount() const noexcept { return m_freeBlockCount; }
+
+	[[nodiscard]]
+	// A new allocator created with this size should be able to house an allocation of
+	// allocationSize. As the first block will always be aligned to any alignment.
+	static size_t GetMinimumRequiredNewAllocationSizeFor(
+		size_t allocationSize, size_t granularity
+	) noexcept;
+
+private:
+	struct Block
+	{
+		size_t offset;
+		size_t size;
+		size_t prevPhysical;
+		size_t nextPhysical;
+		size_t prevFree;
+		size_t nextFree;
+		bool   isFree;
+	};
+
+	struct ListIndex
+	{
+		size_t firstLevel;
+		size_t secondLevel;
+	};
+
+private:
+	[[nodiscard]]
+	static ListIndex GetListIndex(size_t unitCount) noexcept;
+	[[nodiscard]]
+	// Rounds the unitCount up to the next list, so any block in the returned list can house it.
+	std::optional<ListIndex> FindSuitableList(size_t unitCount) const noexcept;
+	[[nodiscard]]
+	// The rounded up search skips the list of the size itself. So, if nothing was found, the
+	// blocks in that list are checked one by one, as some of them might still be big enough.
+	size_t FindFittingBlock(size_t size, size_t alignment) const noexcept;
+
+	[[nodiscard]]
+	size_t CreateBlock(size_t offset, size_t size, size_t prevPhysical, size_t nextPhysical);
+	void ReleaseBlock(size_t blockIndex) noexcept;
+
+	void InsertFreeBlock(size_t blockIndex) noexcept;
+	void RemoveFreeBlock(size_t blockIndex) noexcept;
+
+	[[nodiscard]]
+	// Keeps the first size bytes in the block and moves the rest into a new block. Returns the
+	// index of the new block.
+	size_t SplitBlock(size_t blockIndex, size_t size);
+	void MergeWithNext(size_t blockIndex) noexcept;
+
+	// The block must already be removed from the free lists. The padding before the offset and
+	// the leftover after the size are put back as free blocks.
+	void AllocateFromBlock(size_t blockIndex, size_t offset, size_t alignedSize);
+
+private:
+	using FreeHeads_t = std::array<std::array<size_t, s_secondLevelCount>, s_firstLevelCount>;
+
+	size_t                                       m_startingAddress;
+	size_t                                       m_size;
+	size_t                                       m_granularity;
+	size_t                                       m_availableSize;
+	size_t                                       m_freeBlockCount;
+	std::uint64_t                                m_firstLevelBitmap;
+	std::array<std::uint32_t, s_firstLevelCount> m_secondLevelBitmaps;
+	FreeHeads_t                                  m_freeHeads;
+	std::vector<Block>                           m_blocks;
+	std::vector<size_t>                          m_unusedBlockIndices;
+	std::unordered_map<size_t, size_t>           m_allocatedBlocks;
+
+public:
+	TLSFAllocator(const TLSFAllocator&) = delete;
+	TLSFAllocator& operator=(const TLSFAllocator&) = delete;
+
+	TLSFAllocator(TLSFAllocator&& other) noexcept
+		: m_startingAddress{ other.m_startingAddress }, m_size{ other.m_size },
+		m_granularity{ other.m_granularity }, m_availableSize{ other.m_availableSize },
+		m_freeBlockCount{ other.m_freeBlockCount },
+		m_firstLevelBitmap{ other.m_firstLevelBitmap },
+		m_secondLevelBitmaps{ other.m_secondLevelBitmaps },
+		m_freeHeads{ other.m_freeHeads },
+		m_blocks{ std::move(other.m_blocks) },
+		m_unusedBlockIndices{ std::move(other.m_unusedBlockIndices) },
+		m_allocatedBlocks{ std::move(other.m_allocatedBlocks) }
+	{}
+	TLSFAllocator& operator=(TLSFAllocator&& other) noexcept
+	{
+		m_startingAddress    = other.m_startingAddress;
+		m_size               = other.m_size;
+		m_granularity        = other.m_granularity;
+		m_availableSize      = other.m_availableSize;
+		m_freeBlockCount     = other.m_freeBlockCount;
+		m_firstLevelBitmap   = other.m_firstLevelBitmap;
+		m_secondLevelBitmaps = other.m_secondLevelBitmaps;
+		m_freeHeads          = other.m_freeHeads;
+		m_blocks             = std::move(other.m_blocks);
+		m_unusedBlockIndices = std::move(other.m_unusedBlockIndices);
+		m_allocatedBlocks    = std::move(other.m_allocatedBlocks);
+
+		return *this;
+	}
+};
+}
+#endif
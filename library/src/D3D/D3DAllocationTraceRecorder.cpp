@@ -0,0 +1,134 @@
+#include <D3DAllocationTraceRecorder.hpp>
+#include <GaiaException.hpp>
+
+namespace Gaia
+{
+AllocationTraceRecorder::AllocationTraceRecorder(const std::string& filePath)
+	: m_traceFile{ filePath, std::ios_base::binary | std::ios_base::out | std::ios_base::trunc },
+	m_bufferedEvents{}, m_frameNumber{ 0u }, m_mutex{ std::make_unique<std::mutex>() }
+{
+	if (!m_traceFile)
+		throw Exception("TraceException", "Couldn't create the allocation trace file.");
+
+	m_traceFile.write(reinterpret_cast<const char*>(&s_fileMagic), sizeof(s_fileMagic));
+	m_traceFile.write(reinterpret_cast<const char*>(&s_fileVersion), sizeof(s_fileVersion));
+
+	m_bufferedEvents.reserve(s_bufferedEventCount);
+}
+
+AllocationTraceRecorder::~AllocationTraceRecorder() noexcept
+{
+	// The mutex would be null if the recorder was moved from.
+	if (m_mutex)
+		Flush();
+}
+
+void AllocationTraceRecorder::RecordHeapEvent(
+	EventType type, D3D12_HEAP_TYPE heapType, bool msaa, std::uint16_t memoryID,
+	UINT64 offset, UINT64 size, UINT64 alignment
+) noexcept {
+	auto heapTypeFlags = static_cast<std::uint8_t>(heapType);
+
+	if (msaa)
+		heapTypeFlags |= s_msaaHeapFlag;
+
+	Record(
+		Event
+		{
+			.size        = size,
+			.alignment   = alignment,
+			.offset      = offset,
+			.frameNumber = 0u,
+			.ownerID     = memoryID,
+			.type        = type,
+			.heapType    = heapTypeFlags
+		}
+	);
+}
+
+void AllocationTraceRecorder::RecordSharedBufferEvent(
+	EventType type, std::uint16_t bufferID, UINT64 offset, UINT64 size
+) noexcept {
+	Record(
+		Event
+		{
+			.size        = size,
+			.alignment   = 0u,
+			.offset      = offset,
+			.frameNumber = 0u,
+			.ownerID     = bufferID,
+			.type        = type,
+			.heapType    = 0u
+		}
+	);
+}
+
+void AllocationTraceRecorder::Record(const Event& event) noexcept
+{
+	std::scoped_lock lock{ *m_mutex };
+
+	if (std::size(m_bufferedEvents) == s_bufferedEventCount)
+		FlushLocked();
+
+	m_bufferedEvents.emplace_back(event).frameNumber = m_frameNumber;
+}
+
+void AllocationTraceRecorder::AdvanceFrame() noexcept
+{
+	std::scoped_lock lock{ *m_mutex };
+
+	++m_frameNumber;
+}
+
+void AllocationTraceRecorder::Flush() noexcept
+{
+	std::scoped_lock lock{ *m_mutex };
+
+	FlushLocked();
+}
+
+void AllocationTraceRecorder::FlushLocked() noexcept
+{
+	m_traceFile.write(
+		reinterpret_cast<const char*>(std::data(m_bufferedEvents)),
+		static_cast<std::streamsize>(std::size(m_bufferedEvents) * sizeof(Event))
+	);
+	m_traceFile.flush();
+
+	m_bufferedEvents.clear();
+}
+
+std::vector<AllocationTraceRecorder::Event> AllocationTraceRecorder::ReadTrace(
+	const std::string& filePath
+) {
+	std::ifstream traceFile{ filePath, std::ios_base::binary | std::ios_base::ate };
+
+	if (!traceFile)
+		throw Exception("TraceException", "Couldn't open the allocation trace file.");
+
+	const auto fileSize = static_cast<size_t>(traceFile.tellg());
+
+	traceFile.seekg(0, std::ios_base::beg);
+
+	std::uint32_t fileMagic   = 0u;
+	std::uint32_t fileVersion = 0u;
+
+	traceFile.read(reinterpret_cast<char*>(&fileMagic), sizeof(fileMagic));
+	traceFile.read(reinterpret_cast<char*>(&fileVersion), sizeof(fileVersion));
+
+	if (!traceFile || fileMagic != s_fileMagic || fileVersion != s_fileVersion)
+		throw Exception("TraceException", "The file isn't a supported allocation trace.");
+
+	const size_t headerSize = sizeof(fileMagic) + sizeof(fileVersion);
+
+	// If the application didn't exit cleanly, the last event might have been cut off.
+	std::vector<Event> events((fileSize - headerSize) / sizeof(Event));
+
+	traceFile.read(
+		reinterpret_cast<char*>(std::data(events)),
+		static_cast<std::streamsize>(std::size(events) * sizeof(Event))
+	);
+
+	return events;
+}
+}
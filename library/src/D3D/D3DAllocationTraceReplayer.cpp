@@ -0,0 +1,306 @@
+#include <D3DAllocationTraceReplayer.hpp>
+#include <D3DMemoryTelemetry.hpp>
+#include <FreeRegionAllocator.hpp>
+#include <chrono>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+
+namespace Gaia
+{
+// The heaps are only bookkeeping, so no memory is allocated.
+class TraceHeapProvider
+{
+	// A typical budget, so the heaps grow like they would on a GPU.
+	static constexpr UINT64 s_availableMemory = 4_GB;
+
+public:
+	TraceHeapProvider(
+		[[maybe_unused]] IDXGIAdapter3* adapter, [[maybe_unused]] ID3D12Device* device
+	) {}
+
+	[[nodiscard]]
+	D3DHeap CreateHeap(D3D12_HEAP_TYPE type, UINT64 size, [[maybe_unused]] bool msaa) const
+	{
+		return D3DHeap{ type, size };
+	}
+
+	[[nodiscard]]
+	UINT64 GetAvailableMemory() const noexcept { return s_availableMemory; }
+
+	[[nodiscard]]
+	// The recorded sizes and alignments are already the ones the device returned.
+	D3D12_RESOURCE_ALLOCATION_INFO GetAllocationInfo(
+		const D3D12_RESOURCE_DESC& resourceDesc
+	) const noexcept {
+		return { .SizeInBytes = resourceDesc.Width, .Alignment = resourceDesc.Alignment };
+	}
+};
+
+using TraceMemoryManager = MemoryManagerGeneric<TraceHeapProvider>;
+
+struct TraceSharedBuffer
+{
+	FreeRegionAllocator allocator;
+	UINT64              size;
+	// The replayed offsets and the sizes, keyed by the recorded offsets.
+	std::map<UINT64, std::pair<UINT64, UINT64>> liveAllocations;
+};
+
+[[nodiscard]]
+static float GetFragmentation(UINT64 largestFreeBlocksSize, UINT64 freeSize) noexcept
+{
+	if (!freeSize)
+		return 0.f;
+
+	return 1.f - static_cast<float>(
+		static_cast<double>(largestFreeBlocksSize) / static_cast<double>(freeSize)
+	);
+}
+
+AllocationTraceReplayer::Report AllocationTraceReplayer::Replay(
+	const std::vector<AllocationTraceRecorder::Event>& events
+) const {
+	using EventType = AllocationTraceRecorder::EventType;
+	using HeapKey_t = std::tuple<std::uint8_t, std::uint16_t, UINT64>;
+	using Clock_t   = std::chrono::steady_clock;
+
+	Report report
+	{
+		.eventCount                       = std::size(events),
+		.unmatchedEventCount              = 0u,
+		.frameCount                       = 0u,
+		.peakHeapSize                     = 0u,
+		.peakHeapUsedSize                 = 0u,
+		.averageHeapFragmentation         = 0.f,
+		.peakSharedBufferSize             = 0u,
+		.peakSharedBufferUsedSize         = 0u,
+		.averageSharedBufferFragmentation = 0.f,
+		.replayMilliseconds               = 0.
+	};
+
+	TraceMemoryManager memoryManager{
+		nullptr, nullptr, m_settings.initialBudgetGPU, m_settings.initialBudgetCPU
+	};
+
+	memoryManager.SetAllocatorType(D3D12_HEAP_TYPE_UPLOAD, m_settings.allocatorType);
+	memoryManager.SetAllocatorType(D3D12_HEAP_TYPE_DEFAULT, m_settings.allocatorType);
+	memoryManager.SetAllocatorType(D3D12_HEAP_TYPE_DEFAULT, m_settings.allocatorType, true);
+
+	std::map<HeapKey_t, TraceMemoryManager::MemoryAllocation> liveHeapAllocations{};
+	std::unordered_map<std::uint16_t, TraceSharedBuffer> sharedBuffers{};
+
+	UINT64 heapUsedSize         = 0u;
+	UINT64 sharedBufferSize     = 0u;
+	UINT64 sharedBufferUsedSize = 0u;
+
+	double heapFragmentationTotal         = 0.;
+	double sharedBufferFragmentationTotal = 0.;
+
+	// The stats aren't part of the replay time.
+	Clock_t::duration samplingDuration{};
+
+	auto EndFrame = [&]
+	{
+		// The engine does this at the start of every frame.
+		memoryManager.ReleaseIdleHeaps();
+
+		const Clock_t::time_point samplingStart = Clock_t::now();
+
+		UINT64 largestFreeBlocksSize = 0u;
+		UINT64 freeSize              = 0u;
+
+		memoryManager.ForEachAllocatorGroup(
+			[&largestFreeBlocksSize, &freeSize]
+			(const D3DAllocatorGroup& allocators, D3D12_HEAP_TYPE, bool)
+			{
+				for (const D3DAllocator& allocator : allocators.GetAllocators())
+				{
+					const MemoryTelemetry::RegionStats stats
+						= MemoryTelemetry::GetRegionStats(allocator);
+
+					largestFreeBlocksSize += stats.largestFreeBlock;
+					freeSize              += stats.size - stats.usedSize;
+				}
+			}
+		);
+
+		heapFragmentationTotal += GetFragmentation(largestFreeBlocksSize, freeSize);
+
+		largestFreeBlocksSize = 0u;
+		freeSize              = 0u;
+
+		for (const auto& [bufferID, sharedBuffer] : sharedBuffers)
+		{
+			largestFreeBlocksSize += sharedBuffer.allocator.GetLargestFreeRegion();
+			freeSize              += sharedBuffer.allocator.GetFreeSize();
+		}
+
+		sharedBufferFragmentationTotal += GetFragmentation(largestFreeBlocksSize, freeSize);
+
+		++report.frameCount;
+
+		samplingDuration += Clock_t::now() - samplingStart;
+	};
+
+	const Clock_t::time_point replayStart = Clock_t::now();
+
+	std::uint32_t currentFrame = std::empty(events) ? 0u : events.front().frameNumber;
+
+	for (const AllocationTraceRecorder::Event& event : events)
+	{
+		if (event.frameNumber != currentFrame)
+		{
+			EndFrame();
+
+			currentFrame = event.frameNumber;
+		}
+
+		const HeapKey_t heapKey{ event.heapType, event.ownerID, event.offset };
+
+		switch (event.type)
+		{
+		case EventType::Allocate:
+		{
+			const D3D12_RESOURCE_DESC resourceDesc
+			{
+				.Dimension        = D3D12_RESOURCE_DIMENSION_BUFFER,
+				.Alignment        = event.alignment,
+				.Width            = event.size,
+				.Height           = 1u,
+				.DepthOrArraySize = 1u,
+				.MipLevels        = 1u,
+				.Format           = DXGI_FORMAT_UNKNOWN,
+				.SampleDesc       = { .Count = 1u, .Quality = 0u },
+				.Layout           = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
+				.Flags            = D3D12_RESOURCE_FLAG_NONE
+			};
+
+			liveHeapAllocations[heapKey] = memoryManager.Allocate(
+				resourceDesc, AllocationTraceRecorder::GetHeapType(event),
+				AllocationTraceRecorder::IsMSAA(event)
+			);
+
+			heapUsedSize += event.size;
+
+			// The heaps only grow on an allocation.
+			const Clock_t::time_point samplingStart = Clock_t::now();
+
+			UINT64 heapSize = 0u;
+
+			memoryManager.ForEachAllocatorGroup(
+				[&heapSize](const D3DAllocatorGroup& allocators, D3D12_HEAP_TYPE, bool)
+				{
+					for (const D3DAllocator& allocator : allocators.GetAllocators())
+						heapSize += allocator.Size();
+				}
+			);
+
+			report.peakHeapSize     = std::max(report.peakHeapSize, heapSize);
+			report.peakHeapUsedSize = std::max(report.peakHeapUsedSize, heapUsedSize);
+
+			samplingDuration += Clock_t::now() - samplingStart;
+
+			break;
+		}
+		case EventType::Deallocate:
+		{
+			auto liveAllocation = liveHeapAllocations.find(heapKey);
+
+			if (liveAllocation == std::end(liveHeapAllocations))
+			{
+				++report.unmatchedEventCount;
+
+				break;
+			}
+
+			memoryManager.Deallocate(
+				liveAllocation->second, AllocationTraceRecorder::GetHeapType(event),
+				AllocationTraceRecorder::IsMSAA(event)
+			);
+
+			heapUsedSize -= liveAllocation->second.size;
+
+			liveHeapAllocations.erase(liveAllocation);
+
+			break;
+		}
+		case EventType::SharedAllocate:
+		{
+			TraceSharedBuffer& sharedBuffer = sharedBuffers[event.ownerID];
+
+			// The same as the shared buffers. If no free region fits, the buffer is extended
+			// from its trailing free region.
+			std::optional<UINT64> offset = sharedBuffer.allocator.Allocate(event.size);
+
+			if (!offset)
+			{
+				const UINT64 oldSize = sharedBuffer.size;
+
+				offset = sharedBuffer.allocator.RemoveTrailingRegion(oldSize).value_or(oldSize);
+
+				const UINT64 requiredSize = *offset + event.size;
+				const UINT64 newSize      = m_settings.sharedBufferGrowthPolicy.GetNewSize(
+					oldSize, requiredSize
+				);
+
+				if (newSize > requiredSize)
+					sharedBuffer.allocator.Deallocate(requiredSize, newSize - requiredSize);
+
+				sharedBufferSize  += newSize - oldSize;
+				sharedBuffer.size  = newSize;
+			}
+
+			sharedBuffer.liveAllocations[event.offset] = { *offset, event.size };
+
+			sharedBufferUsedSize += event.size;
+
+			report.peakSharedBufferSize     = std::max(report.peakSharedBufferSize, sharedBufferSize);
+			report.peakSharedBufferUsedSize = std::max(
+				report.peakSharedBufferUsedSize, sharedBufferUsedSize
+			);
+
+			break;
+		}
+		case EventType::SharedRelinquish:
+		{
+			TraceSharedBuffer& sharedBuffer = sharedBuffers[event.ownerID];
+
+			auto liveAllocation = sharedBuffer.liveAllocations.find(event.offset);
+
+			if (liveAllocation == std::end(sharedBuffer.liveAllocations))
+			{
+				++report.unmatchedEventCount;
+
+				break;
+			}
+
+			const auto [offset, size] = liveAllocation->second;
+
+			sharedBuffer.allocator.Deallocate(offset, size);
+
+			sharedBuffer.liveAllocations.erase(liveAllocation);
+
+			sharedBufferUsedSize -= size;
+
+			break;
+		}
+		}
+	}
+
+	EndFrame();
+
+	const Clock_t::duration replayDuration = Clock_t::now() - replayStart - samplingDuration;
+
+	report.replayMilliseconds = std::chrono::duration<double, std::milli>(replayDuration).count();
+
+	report.averageHeapFragmentation = static_cast<float>(
+		heapFragmentationTotal / static_cast<double>(report.frameCount)
+	);
+	report.averageSharedBufferFragmentation = static_cast<float>(
+		sharedBufferFragmentationTotal / static_cast<double>(report.frameCount)
+	);
+
+	return report;
+}
+}
@@ -1,235 +1,798 @@
 #include <D3DAllocator.hpp>
-#include <GaiaException.hpp>
+#include <algorithm>
+#include <utility>
 
 namespace Gaia
 {
-std::optional<UINT64> D3DAllocator::Allocate(
-	const D3D12_RESOURCE_ALLOCATION_INFO& allocInfo
+D3DAllocator::Allocator_t D3DAllocator::CreateAllocator(
+	size_t heapSize, HeapAllocatorType allocatorType
+) {
+	if (allocatorType == HeapAllocatorType::TLSF)
+		return Allocator_t{ std::in_place_type<TLSFAllocator>, 0u, heapSize, s_granularity };
+
+	return Allocator_t{ std::in_place_type<Callisto::Buddy>, 0u, heapSize, s_granularity };
+}
+
+UINT64 D3DAllocator::GetMinimumRequiredNewAllocationSizeFor(
+	UINT64 bufferSize, HeapAllocatorType allocatorType
 ) noexcept {
-	std::optional<size_t> allocationStart = m_allocator.AllocateN(
-		static_cast<size_t>(allocInfo.SizeInBytes), static_cast<size_t>(allocInfo.Alignment)
+	// If the size isn't an exponent of 2, the largest block in the buddy allocator might
+	// not be able to house it. The TLSF allocator only needs the size to be aligned to
+	// its granularity.
+	if (allocatorType == HeapAllocatorType::TLSF)
+		return static_cast<UINT64>(
+			TLSFAllocator::GetMinimumRequiredNewAllocationSizeFor(
+				static_cast<size_t>(bufferSize), s_granularity
+			)
+		);
+
+	return static_cast<UINT64>(
+		Callisto::Buddy::GetMinimumRequiredNewAllocationSizeFor(static_cast<size_t>(bufferSize))
 	);
+}
+
+std::optional<UINT64> D3DAllocator::Allocate(const D3D12_RESOURCE_ALLOCATION_INFO& allocInfo)
+{
+	const auto size      = static_cast<size_t>(allocInfo.SizeInBytes);
+	const auto alignment = static_cast<size_t>(allocInfo.Alignment);
 
-	if (allocationStart)
-		return static_cast<UINT64>(allocationStart.value());
+	std::optional<size_t> allocationStart{};
 
-	return {};
+	if (TLSFAllocator* tlsfAllocator = std::get_if<TLSFAllocator>(&m_allocator); tlsfAllocator)
+		allocationStart = tlsfAllocator->Allocate(size, alignment);
+	else
+		allocationStart = std::get<Callisto::Buddy>(m_allocator).AllocateN(size, alignment);
+
+	if (!allocationStart)
+		return {};
+
+	const auto heapOffset = static_cast<UINT64>(allocationStart.value());
+
+	m_liveAllocations.emplace(
+		heapOffset,
+		LiveAllocation{ .size = allocInfo.SizeInBytes, .alignment = allocInfo.Alignment }
+	);
+
+	return heapOffset;
+}
+
+bool D3DAllocator::AllocateAt(UINT64 heapOffset, const D3D12_RESOURCE_ALLOCATION_INFO& allocInfo)
+{
+	const auto size      = static_cast<size_t>(allocInfo.SizeInBytes);
+	const auto alignment = static_cast<size_t>(allocInfo.Alignment);
+	const auto offset    = static_cast<size_t>(heapOffset);
+
+	if (alignment && offset % alignment)
+		return false;
+
+	bool isAllocated = false;
+
+	if (TLSFAllocator* tlsfAllocator = std::get_if<TLSFAllocator>(&m_allocator); tlsfAllocator)
+		isAllocated = tlsfAllocator->AllocateAt(offset, size);
+	else
+	{
+		// The buddy allocator can't allocate at an offset. So, keep taking blocks of the same
+		// size until the one at the offset is returned and give the skipped ones back. The
+		// blocks don't overlap, so this ends once the heap has no more blocks of the size.
+		Callisto::Buddy& buddyAllocator = std::get<Callisto::Buddy>(m_allocator);
+
+		std::vector<size_t> skippedStarts{};
+
+		for (std::optional<size_t> allocationStart = buddyAllocator.AllocateN(size, alignment);
+			allocationStart; allocationStart = buddyAllocator.AllocateN(size, alignment))
+		{
+			if (allocationStart.value() == offset)
+			{
+				isAllocated = true;
+
+				break;
+			}
+
+			skippedStarts.emplace_back(allocationStart.value());
+		}
+
+		for (size_t skippedStart : skippedStarts)
+			buddyAllocator.Deallocate(skippedStart, size, alignment);
+	}
+
+	if (isAllocated)
+		m_liveAllocations.emplace(
+			heapOffset,
+			LiveAllocation{ .size = allocInfo.SizeInBytes, .alignment = allocInfo.Alignment }
+		);
+
+	return isAllocated;
 }
 
 void D3DAllocator::Deallocate(UINT64 startingAddress, UINT64 bufferSize, UINT64 alignment) noexcept
 {
-	m_allocator.Deallocate(
-		static_cast<size_t>(startingAddress), static_cast<size_t>(bufferSize),
-		static_cast<size_t>(alignment)
+	m_liveAllocations.erase(startingAddress);
+
+	// The TLSF allocator keeps track of the allocated blocks, so it only needs the address.
+	if (TLSFAllocator* tlsfAllocator = std::get_if<TLSFAllocator>(&m_allocator); tlsfAllocator)
+		tlsfAllocator->Deallocate(static_cast<size_t>(startingAddress));
+	else
+		std::get<Callisto::Buddy>(m_allocator).Deallocate(
+			static_cast<size_t>(startingAddress), static_cast<size_t>(bufferSize),
+			static_cast<size_t>(alignment)
+		);
+}
+
+UINT64 D3DAllocator::AvailableSize() const noexcept
+{
+	return static_cast<UINT64>(
+		std::visit([](const auto& allocator) { return allocator.AvailableSize(); }, m_allocator)
 	);
 }
 
-// Memory Manager
-MemoryManager::MemoryManager(
-	IDXGIAdapter3* adapter, ID3D12Device* device, UINT64 initialBudgetGPU, UINT64 initialBudgetCPU
-) : m_adapter{ adapter }, m_device{ device }, m_cpuAllocators{}, m_gpuAllocators{}, m_msaaAllocators{},
-	m_availableCPUIndices{}, m_availableGPUIndices{}, m_availableMsaaIndices{}
+UINT64 D3DAllocator::LargestFreeBlockSize() const noexcept
 {
-	const UINT64 availableMemory = GetAvailableMemory();
+	if (const TLSFAllocator* tlsfAllocator = std::get_if<TLSFAllocator>(&m_allocator); tlsfAllocator)
+		return static_cast<UINT64>(tlsfAllocator->LargestFreeBlockSize());
 
-	if (availableMemory < initialBudgetCPU + initialBudgetGPU)
-		throw Exception("MemoryException", "Not Enough memory for allocation.");
+	return AvailableSize();
+}
 
-	m_cpuAllocators.emplace_back(
-		CreateHeap(D3D12_HEAP_TYPE_UPLOAD, initialBudgetCPU), GetID(true)
-	);
-	m_gpuAllocators.emplace_back(
-		CreateHeap(D3D12_HEAP_TYPE_DEFAULT, initialBudgetCPU), GetID(false)
-	);
+// D3D Allocator Group
+std::uint16_t D3DAllocatorGroup::GetNewID() noexcept
+{
+	if (std::empty(m_availableIDs))
+	{
+		m_availableIDs.push(static_cast<std::uint16_t>(std::size(m_slotsByID)));
+		m_slotsByID.emplace_back(s_invalidSlot);
+	}
+
+	const std::uint16_t ID = m_availableIDs.front();
+	m_availableIDs.pop();
+
+	return ID;
 }
 
-UINT64 MemoryManager::GetAvailableMemory() const noexcept
+size_t D3DAllocatorGroup::GetSlot(std::uint16_t id) const noexcept
 {
-	// Assuming there is a single GPU for now.
-	constexpr UINT gpuNodeIndex                      = 0u;
-	// Also only checking the GPU memory.
-	constexpr DXGI_MEMORY_SEGMENT_GROUP segmentGroup = DXGI_MEMORY_SEGMENT_GROUP_LOCAL;
+	return id < std::size(m_slotsByID) ? m_slotsByID[id] : s_invalidSlot;
+}
 
-	DXGI_QUERY_VIDEO_MEMORY_INFO videoMemoryInfo
+std::uint16_t D3DAllocatorGroup::AddAllocator(D3DHeap&& heap)
+{
+	const std::uint16_t id = GetNewID();
+	const size_t slot      = std::size(m_allocators);
+
+	if (slot == m_leafCount)
+		GrowFreeBlockTree();
+
+	m_allocators.emplace_back(std::move(heap), id, m_allocatorType);
+	m_idleFrameCounts.emplace_back(0u);
+	m_evacuatingSlots.emplace_back(false);
+	m_evictedSlots.emplace_back(false);
+
+	SetFreeBlockKey(slot, m_allocators.back().LargestFreeBlockSize());
+
+	m_slotsByID[id] = slot;
+
+	return id;
+}
+
+void D3DAllocatorGroup::RemoveAllocator(std::uint16_t id) noexcept
+{
+	const size_t slot = GetSlot(id);
+
+	if (slot == s_invalidSlot)
+		return;
+
+	// Move the last allocator into the removed slot, so no other slot has to change.
+	const size_t lastSlot = std::size(m_allocators) - 1u;
+
+	if (slot != lastSlot)
 	{
-		.Budget       = 0u,
-		.CurrentUsage = 0u
-	};
+		m_allocators[slot]      = std::move(m_allocators[lastSlot]);
+		m_idleFrameCounts[slot] = m_idleFrameCounts[lastSlot];
+		m_evacuatingSlots[slot] = m_evacuatingSlots[lastSlot];
+		m_evictedSlots[slot]    = m_evictedSlots[lastSlot];
 
-	m_adapter->QueryVideoMemoryInfo(gpuNodeIndex, segmentGroup, &videoMemoryInfo);
+		SetFreeBlockKey(slot, GetFreeBlockKey(lastSlot));
 
-	return videoMemoryInfo.Budget - videoMemoryInfo.CurrentUsage;
+		m_slotsByID[m_allocators[slot].GetID()] = slot;
+	}
+
+	SetFreeBlockKey(lastSlot, 0u);
+
+	m_allocators.pop_back();
+	m_idleFrameCounts.pop_back();
+	m_evacuatingSlots.pop_back();
+	m_evictedSlots.pop_back();
+
+	m_slotsByID[id] = s_invalidSlot;
+	m_availableIDs.push(id);
 }
 
-std::vector<D3DAllocator>& MemoryManager::GetAllocators(bool cpu, bool msaa /* = false */) noexcept
+void D3DAllocatorGroup::ReleaseIdleAllocators(std::uint32_t idleFramesBeforeRelease) noexcept
 {
-	return cpu ? m_cpuAllocators : (msaa ? m_msaaAllocators : m_gpuAllocators);
+	// Going backwards, as removing an allocator moves the last one into its slot.
+	for (size_t slot = std::size(m_allocators); slot > 0u; --slot)
+	{
+		const size_t currentSlot      = slot - 1u;
+		const D3DAllocator& allocator = m_allocators[currentSlot];
+		std::uint32_t& idleFrameCount = m_idleFrameCounts[currentSlot];
+
+		if (allocator.Size() != allocator.AvailableSize())
+		{
+			idleFrameCount = 0u;
+
+			continue;
+		}
+
+		++idleFrameCount;
+
+		// Waiting for a few frames, so a heap isn't released and created again when resources
+		// are being replaced. But an evacuated or evicted heap won't be used again anyway.
+		const bool canRelease = idleFrameCount > idleFramesBeforeRelease
+			|| m_evacuatingSlots[currentSlot] || m_evictedSlots[currentSlot];
+
+		if (canRelease && std::size(m_allocators) > 1u)
+			RemoveAllocator(allocator.GetID());
+	}
 }
 
-std::queue<std::uint16_t>& MemoryManager::GetAvailableIndices(
-	bool cpu, bool msaa /* = false */
-) noexcept {
-	return cpu ? m_availableCPUIndices : (msaa ? m_availableMsaaIndices : m_availableGPUIndices);
+void D3DAllocatorGroup::SetEvacuating(std::uint16_t id, bool evacuating) noexcept
+{
+	const size_t slot = GetSlot(id);
+
+	if (slot == s_invalidSlot)
+		return;
+
+	m_evacuatingSlots[slot] = evacuating;
+
+	SetFreeBlockKey(slot, m_allocators[slot].LargestFreeBlockSize());
+}
+
+void D3DAllocatorGroup::ClearEvacuatingAllocators() noexcept
+{
+	for (size_t slot = 0u; slot < std::size(m_allocators); ++slot)
+		if (m_evacuatingSlots[slot])
+		{
+			m_evacuatingSlots[slot] = false;
+
+			SetFreeBlockKey(slot, m_allocators[slot].LargestFreeBlockSize());
+		}
 }
 
-std::uint16_t MemoryManager::GetID(bool cpu, bool msaa/* = false */) noexcept
+bool D3DAllocatorGroup::IsEvacuating(std::uint16_t id) const noexcept
 {
-	std::vector<D3DAllocator>& allocators       = GetAllocators(cpu, msaa);
-	std::queue<std::uint16_t>& availableIndices = GetAvailableIndices(cpu, msaa);
+	const size_t slot = GetSlot(id);
 
-	if (std::empty(availableIndices))
-		availableIndices.push(static_cast<std::uint16_t>(std::size(allocators)));
+	return slot != s_invalidSlot && m_evacuatingSlots[slot];
+}
 
-	const std::uint16_t ID = availableIndices.front();
-	availableIndices.pop();
+void D3DAllocatorGroup::SetEvicted(std::uint16_t id, bool evicted) noexcept
+{
+	const size_t slot = GetSlot(id);
 
-	return ID;
+	if (slot == s_invalidSlot)
+		return;
+
+	m_evictedSlots[slot] = evicted;
+
+	SetFreeBlockKey(slot, m_allocators[slot].LargestFreeBlockSize());
 }
 
-D3DHeap MemoryManager::CreateHeap(D3D12_HEAP_TYPE type, UINT64 size, bool msaa /* = false */) const
+bool D3DAllocatorGroup::IsEvicted(std::uint16_t id) const noexcept
 {
-	return D3DHeap{ m_device, type, size, msaa };
+	const size_t slot = GetSlot(id);
+
+	return slot != s_invalidSlot && m_evictedSlots[slot];
 }
 
-D3D12_RESOURCE_ALLOCATION_INFO MemoryManager::GetAllocationInfo(
-	const D3D12_RESOURCE_DESC& resourceDesc
-) const noexcept {
-	return m_device->GetResourceAllocationInfo(0u, 1u, &resourceDesc);
+void D3DAllocatorGroup::GrowFreeBlockTree()
+{
+	const size_t oldLeafCount = m_leafCount;
+
+	m_leafCount = std::max(m_leafCount * 2u, size_t{ 8u });
+
+	std::vector<UINT64> oldTree = std::exchange(
+		m_freeBlockTree, std::vector<UINT64>(m_leafCount * 2u, 0u)
+	);
+
+	for (size_t slot = 0u; slot < oldLeafCount; ++slot)
+		SetFreeBlockKey(slot, oldTree[oldLeafCount + slot]);
+}
+
+void D3DAllocatorGroup::SetFreeBlockKey(size_t slot, UINT64 freeBlockSize) noexcept
+{
+	size_t node = m_leafCount + slot;
+
+	// An evacuating or evicted slot should never be found by FindSlot. The tree is grown before
+	// a slot is added, so the slot might not exist yet.
+	const bool isUnavailable = slot < std::size(m_evacuatingSlots)
+		&& (m_evacuatingSlots[slot] || m_evictedSlots[slot]);
+
+	m_freeBlockTree[node] = isUnavailable ? 0u : freeBlockSize;
+
+	for (node /= 2u; node; node /= 2u)
+		m_freeBlockTree[node] = std::max(m_freeBlockTree[node * 2u], m_freeBlockTree[node * 2u + 1u]);
 }
 
-UINT64 MemoryManager::GetNewAllocationSize(D3D12_HEAP_TYPE heapType) const noexcept
+size_t D3DAllocatorGroup::FindSlot(UINT64 size, size_t startingSlot) const noexcept
 {
-	// Might add some algorithm here later.
-	return heapType == D3D12_HEAP_TYPE_DEFAULT ? 2_GB : 100_MB;
+	if (startingSlot >= std::size(m_allocators))
+		return s_invalidSlot;
+
+	// The unused leaves have 0 as their keys, so they should never be returned.
+	size = std::max(size, UINT64{ 1u });
+
+	size_t node = m_leafCount + startingSlot;
+
+	// Go up until a subtree on the right has a large enough key.
+	while (m_freeBlockTree[node] < size)
+	{
+		// Only a left child has a sibling on its right. The root becomes 0.
+		while (node & 1u)
+			node /= 2u;
+
+		if (!node)
+			return s_invalidSlot;
+
+		++node;
+	}
+
+	// Then go down to the leftmost leaf in that subtree, which has a large enough key.
+	while (node < m_leafCount)
+		node = m_freeBlockTree[node * 2u] >= size ? node * 2u : node * 2u + 1u;
+
+	return node - m_leafCount;
 }
 
-MemoryManager::MemoryAllocation MemoryManager::Allocate(
-	const D3D12_RESOURCE_DESC& resourceDesc, D3D12_HEAP_TYPE heapType, bool msaa /* = false */
+std::optional<D3DAllocatorGroup::Allocation> D3DAllocatorGroup::AllocateFromSlot(
+	size_t slot, const D3D12_RESOURCE_ALLOCATION_INFO& allocInfo
 ) {
-	const D3D12_RESOURCE_ALLOCATION_INFO allocationInfo = GetAllocationInfo(resourceDesc);
-	const UINT64 bufferSize                             = allocationInfo.SizeInBytes;
-	const bool isCPUAccessible                          = heapType == D3D12_HEAP_TYPE_UPLOAD;
+	D3DAllocator& allocator = m_allocators[slot];
+
+	std::optional<UINT64> startingAddress = allocator.Allocate(allocInfo);
+
+	if (!startingAddress)
+		return {};
+
+	// The largest block can only shrink after an allocation. So, keep the key if it was
+	// already lower.
+	SetFreeBlockKey(slot, std::min(GetFreeBlockKey(slot), allocator.LargestFreeBlockSize()));
+
+	m_idleFrameCounts[slot] = 0u;
 
-	std::vector<D3DAllocator>& allocators = GetAllocators(isCPUAccessible, msaa);
+	return Allocation
+	{
+		.heapOffset = startingAddress.value(),
+		.heap       = allocator.GetHeap(),
+		.memoryID   = allocator.GetID()
+	};
+}
 
-	// Look through the already existing allocators and try to allocate the buffer.
-	// An allocator may still fail even if its total available size is more than the bufferSize.
-	// As in a buddy allocator, there must be a block with more than or equal to the size of the
-	// allocation.
-	for (size_t index = 0u; index < std::size(allocators); ++index)
+std::optional<D3DAllocatorGroup::Allocation> D3DAllocatorGroup::Allocate(
+	const D3D12_RESOURCE_ALLOCATION_INFO& allocInfo
+) {
+	// The allocators with a smaller free block than the size are skipped. An allocator may
+	// still fail even if its key is larger than the size, because of the alignment or because
+	// the buddy allocator's key is only an upper bound. So, keep looking in that case.
+	for (size_t slot = FindSlot(allocInfo.SizeInBytes, 0u); slot != s_invalidSlot;
+		slot = FindSlot(allocInfo.SizeInBytes, slot + 1u))
 	{
-		D3DAllocator& allocator = allocators[index];
+		if (std::optional<Allocation> allocation = AllocateFromSlot(slot, allocInfo); allocation)
+			return allocation;
+
+		// If a buddy allocator fails, it doesn't have a block which can house this size. So,
+		// lower its key and it won't be tried again for this size, until something is
+		// deallocated from it.
+		if (m_allocators[slot].GetAllocatorType() == HeapAllocatorType::Buddy)
+			SetFreeBlockKey(slot, std::min(GetFreeBlockKey(slot), allocInfo.SizeInBytes - 1u));
+	}
+
+	return {};
+}
+
+std::optional<D3DAllocatorGroup::Allocation> D3DAllocatorGroup::AllocateFrom(
+	std::uint16_t id, const D3D12_RESOURCE_ALLOCATION_INFO& allocInfo
+) {
+	const size_t slot = GetSlot(id);
+
+	if (slot == s_invalidSlot)
+		return {};
+
+	return AllocateFromSlot(slot, allocInfo);
+}
+
+std::optional<D3DAllocatorGroup::Allocation> D3DAllocatorGroup::AllocateAt(
+	std::uint16_t id, UINT64 heapOffset, const D3D12_RESOURCE_ALLOCATION_INFO& allocInfo
+) {
+	const size_t slot = GetSlot(id);
 
-		if (allocator.AvailableSize() >= bufferSize)
+	if (slot == s_invalidSlot)
+		return {};
+
+	D3DAllocator& allocator = m_allocators[slot];
+
+	if (!allocator.AllocateAt(heapOffset, allocInfo))
+		return {};
+
+	SetFreeBlockKey(slot, std::min(GetFreeBlockKey(slot), allocator.LargestFreeBlockSize()));
+
+	m_idleFrameCounts[slot] = 0u;
+
+	return Allocation
+	{
+		.heapOffset = heapOffset,
+		.heap       = allocator.GetHeap(),
+		.memoryID   = allocator.GetID()
+	};
+}
+
+bool D3DAllocatorGroup::Deallocate(
+	std::uint16_t id, UINT64 startingAddress, UINT64 bufferSize, UINT64 alignment
+) noexcept {
+	const size_t slot = GetSlot(id);
+
+	if (slot == s_invalidSlot)
+		return false;
+
+	D3DAllocator& allocator = m_allocators[slot];
+
+	allocator.Deallocate(startingAddress, bufferSize, alignment);
+
+	SetFreeBlockKey(slot, allocator.LargestFreeBlockSize());
+
+	return allocator.Size() == allocator.AvailableSize();
+}
+
+// Memory Manager Base
+MemoryManagerBase::MemoryManagerBase()
+	: m_cpuAllocators{ HeapAllocatorType::Buddy, D3D12_HEAP_TYPE_UPLOAD },
+	m_gpuAllocators{ HeapAllocatorType::Buddy, D3D12_HEAP_TYPE_DEFAULT },
+	m_msaaAllocators{ HeapAllocatorType::Buddy, D3D12_HEAP_TYPE_DEFAULT },
+	m_allocatorMutex{ std::make_unique<std::mutex>() },
+	m_allocationCaches{ std::make_unique<AllocationCaches_t>() },
+	m_hasUnavailableHeaps{ false }, m_traceRecorder{ nullptr }
+{
+	// So caching a freed block never has to allocate.
+	for (AllocationCache& cache : *m_allocationCaches)
+		for (CachedBlocks_t& cachedBlocks : cache.blocks)
+			cachedBlocks.reserve(s_cachedBlocksPerClass);
+}
+
+std::optional<size_t> MemoryManagerBase::GetCachedBlocksIndex(
+	UINT64 size, UINT64 alignment, bool cpu, bool msaa
+) noexcept {
+	const bool isCacheable = alignment == s_cachedAlignment && size && size % s_cachedAlignment == 0u
+		&& size <= s_cachedAlignment * s_cachedSizeClassCount;
+
+	if (!isCacheable)
+		return {};
+
+	const size_t groupIndex = cpu ? 0u : (msaa ? 2u : 1u);
+	const auto sizeClass    = static_cast<size_t>(size / s_cachedAlignment) - 1u;
+
+	return groupIndex * s_cachedSizeClassCount + sizeClass;
+}
+
+void MemoryManagerBase::SetAllocatorType(
+	D3D12_HEAP_TYPE heapType, HeapAllocatorType allocatorType, bool msaa /* = false */
+) noexcept {
+	std::scoped_lock allocatorLock{ *m_allocatorMutex };
+
+	GetAllocators(heapType == D3D12_HEAP_TYPE_UPLOAD, msaa).SetAllocatorType(allocatorType);
+}
+
+void MemoryManagerBase::SetGrowthPolicySettings(
+	D3D12_HEAP_TYPE heapType, const HeapGrowthPolicy::Settings& settings, bool msaa /* = false */
+) noexcept {
+	std::scoped_lock allocatorLock{ *m_allocatorMutex };
+
+	GetAllocators(heapType == D3D12_HEAP_TYPE_UPLOAD, msaa).GetGrowthPolicy().SetSettings(settings);
+}
+
+void MemoryManagerBase::FlushCaches() noexcept
+{
+	for (AllocationCache& cache : *m_allocationCaches)
+	{
+		std::scoped_lock cacheLock{ cache.mutex };
+
+		for (size_t blocksIndex = 0u; blocksIndex < std::size(cache.blocks); ++blocksIndex)
 		{
-			std::optional<UINT64> startingAddress = allocator.Allocate(allocationInfo);
+			const size_t groupIndex = blocksIndex / s_cachedSizeClassCount;
+			const UINT64 blockSize  = (blocksIndex % s_cachedSizeClassCount + 1u) * s_cachedAlignment;
+			const bool isCPU        = groupIndex == 0u;
 
-			if (startingAddress)
-			{
-				const UINT64 offset = startingAddress.value();
+			D3DAllocatorGroup& allocators = GetAllocators(isCPU, groupIndex == 2u);
 
-				MemoryAllocation allocation
-				{
-					.heapOffset = offset,
-					.heap       = allocator.GetHeap(),
-					.size       = bufferSize,
-					.alignment  = allocationInfo.Alignment,
-					.memoryID   = allocator.GetID(),
-					.isValid    = true
-				};
-
-				return allocation;
-			}
+			for (const D3DAllocatorGroup::Allocation& block : cache.blocks[blocksIndex])
+				DeallocateLocked(
+					allocators, isCPU, block.memoryID, block.heapOffset, blockSize,
+					s_cachedAlignment
+				);
+
+			cache.blocks[blocksIndex].clear();
 		}
 	}
+}
+
+void MemoryManagerBase::FlushCachesForUnavailableHeap() noexcept
+{
+	// Deallocate checks the flag with the lock of its shard held. So, after a shard has been
+	// flushed here, none of the blocks of the unavailable heap can be cached in it again.
+	m_hasUnavailableHeaps = true;
+
+	FlushCaches();
+}
+
+void MemoryManagerBase::ReleaseIdleHeaps() noexcept
+{
+	std::scoped_lock allocatorLock{ *m_allocatorMutex };
+
+	FlushCaches();
+
+	// The empty CPU heaps are already released on deallocation.
+	for (D3DAllocatorGroup* allocators : { &m_gpuAllocators, &m_msaaAllocators })
+		allocators->ReleaseIdleAllocators(
+			allocators->GetGrowthPolicy().GetIdleFramesBeforeRelease()
+		);
+}
+
+std::vector<HeapDefragPlanner::Heap> MemoryManagerBase::GetDefragHeaps(
+	D3D12_HEAP_TYPE heapType, bool msaa /* = false */
+) {
+	std::scoped_lock allocatorLock{ *m_allocatorMutex };
+
+	// The cached blocks would look like pinned allocations.
+	FlushCaches();
 
+	const D3DAllocatorGroup& allocators = GetAllocators(heapType == D3D12_HEAP_TYPE_UPLOAD, msaa);
+
+	std::vector<HeapDefragPlanner::Heap> heaps{};
+	heaps.reserve(allocators.GetAllocatorCount());
+
+	for (const D3DAllocator& allocator : allocators.GetAllocators())
 	{
-		// If the already available allocators were unable to allocate, then try to allocate new memory.
-		UINT64 newAllocationSize   = GetNewAllocationSize(heapType);
+		HeapDefragPlanner::Heap& heap = heaps.emplace_back(
+			HeapDefragPlanner::Heap
+			{
+				.memoryID             = allocator.GetID(),
+				.size                 = allocator.Size(),
+				.allocations          = {},
+				.usesPowerOfTwoBlocks = allocator.GetAllocatorType() == HeapAllocatorType::Buddy
+			}
+		);
+
+		const D3DAllocator::LiveAllocations_t& liveAllocations = allocator.GetLiveAllocations();
+
+		heap.allocations.reserve(std::size(liveAllocations));
+
+		for (const auto& [heapOffset, liveAllocation] : liveAllocations)
+			heap.allocations.emplace_back(
+				HeapDefragPlanner::Allocation
+				{
+					.offset        = heapOffset,
+					.size          = liveAllocation.size,
+					.alignment     = liveAllocation.alignment,
+					.resourceIndex = 0u,
+					.isMovable     = false
+				}
+			);
+	}
 
-		// If the newAllocationSize isn't an exponent of 2, the largest block in the
-		// buddy allocator might not be able to house it. So, we have to query the required
-		// size.
-		UINT64 minimumRequiredSize
-			= Callisto::Buddy::GetMinimumRequiredNewAllocationSizeFor(bufferSize);
+	return heaps;
+}
 
-		newAllocationSize = std::max(newAllocationSize, minimumRequiredSize);
+void MemoryManagerBase::SetHeapEvacuating(
+	std::uint16_t memoryID, D3D12_HEAP_TYPE heapType, bool evacuating, bool msaa /* = false */
+) noexcept {
+	std::scoped_lock allocatorLock{ *m_allocatorMutex };
 
-		const UINT64 availableMemorySize = GetAvailableMemory();
+	// So none of the cached blocks of the heap are reused.
+	if (evacuating)
+		FlushCachesForUnavailableHeap();
+
+	GetAllocators(heapType == D3D12_HEAP_TYPE_UPLOAD, msaa).SetEvacuating(memoryID, evacuating);
+}
 
-		// If allocation is not possible, check if the buffer can be allocated on the available memory.
-		if (newAllocationSize > availableMemorySize)
+void MemoryManagerBase::ClearEvacuatingHeaps(
+	D3D12_HEAP_TYPE heapType, bool msaa /* = false */
+) noexcept {
+	std::scoped_lock allocatorLock{ *m_allocatorMutex };
+
+	GetAllocators(heapType == D3D12_HEAP_TYPE_UPLOAD, msaa).ClearEvacuatingAllocators();
+
+	UpdateUnavailableHeapsFlag();
+}
+
+void MemoryManagerBase::SetHeapEvicted(
+	std::uint16_t memoryID, D3D12_HEAP_TYPE heapType, bool evicted, bool msaa /* = false */
+) noexcept {
+	std::scoped_lock allocatorLock{ *m_allocatorMutex };
+
+	// So none of the cached blocks of the heap are reused.
+	if (evicted)
+		FlushCachesForUnavailableHeap();
+
+	GetAllocators(heapType == D3D12_HEAP_TYPE_UPLOAD, msaa).SetEvicted(memoryID, evicted);
+
+	if (!evicted)
+		UpdateUnavailableHeapsFlag();
+}
+
+void MemoryManagerBase::UpdateUnavailableHeapsFlag() noexcept
+{
+	const bool hasUnavailableHeaps = std::ranges::any_of(
+		std::array{ &m_cpuAllocators, &m_gpuAllocators, &m_msaaAllocators },
+		[](const D3DAllocatorGroup* allocators)
 		{
-			if (availableMemorySize >= minimumRequiredSize)
-				newAllocationSize = availableMemorySize;
-			else
-				throw Exception("MemoryException", "Not Enough memory for allocation.");
+			return std::ranges::any_of(
+				allocators->GetAllocators(), [allocators](const D3DAllocator& allocator)
+				{
+					return allocators->IsEvacuating(allocator.GetID())
+						|| allocators->IsEvicted(allocator.GetID());
+				}
+			);
 		}
+	);
+
+	m_hasUnavailableHeaps = hasUnavailableHeaps;
+}
+
+std::optional<D3DAllocatorGroup::Allocation> MemoryManagerBase::AllocateFromCache(
+	UINT64 size, UINT64 alignment, bool cpu, bool msaa
+) noexcept {
+	std::optional<size_t> blocksIndex = GetCachedBlocksIndex(size, alignment, cpu, msaa);
+
+	if (!blocksIndex)
+		return {};
+
+	// The shard may have been filled by any of the threads which hash to it.
+	AllocationCache& cache = GetThreadCache();
+
+	std::scoped_lock cacheLock{ cache.mutex };
 
-		// Since this is a new allocator. If the code reaches here, at least the top most
-		// block should have enough memory for allocation.
-		D3DAllocator allocator{
-			CreateHeap(heapType, newAllocationSize, msaa), GetID(isCPUAccessible, msaa)
-		};
+	CachedBlocks_t& cachedBlocks = cache.blocks[blocksIndex.value()];
 
-		std::optional<UINT64> startingAddress = allocator.Allocate(allocationInfo);
+	if (std::empty(cachedBlocks))
+		return {};
 
-		if (startingAddress)
+	const D3DAllocatorGroup::Allocation cachedBlock = cachedBlocks.back();
+
+	cachedBlocks.pop_back();
+
+	++cache.hitCounts[blocksIndex.value()];
+
+	return cachedBlock;
+}
+
+void MemoryManagerBase::RecordCacheHits() noexcept
+{
+	for (AllocationCache& cache : *m_allocationCaches)
+	{
+		std::scoped_lock cacheLock{ cache.mutex };
+
+		for (size_t blocksIndex = 0u; blocksIndex < std::size(cache.hitCounts); ++blocksIndex)
 		{
-			const UINT64 offset = startingAddress.value();
+			std::uint32_t& hitCount = cache.hitCounts[blocksIndex];
 
-			MemoryAllocation allocation
-			{
-				.heapOffset = offset,
-				.heap       = allocator.GetHeap(),
-				.size       = bufferSize,
-				.alignment  = allocationInfo.Alignment,
-				.memoryID   = allocator.GetID(),
-				.isValid    = true
-			};
+			if (!hitCount)
+				continue;
 
-			allocators.emplace_back(std::move(allocator));
+			const size_t groupIndex = blocksIndex / s_cachedSizeClassCount;
+			const UINT64 blockSize  = (blocksIndex % s_cachedSizeClassCount + 1u) * s_cachedAlignment;
 
-			return allocation;
+			GetAllocators(groupIndex == 0u, groupIndex == 2u).GetGrowthPolicy().RecordAllocations(
+				blockSize, hitCount
+			);
+
+			hitCount = 0u;
 		}
-		else
-			throw Exception("MemoryException", "Not Enough memory for allocation.");
 	}
 }
 
-void MemoryManager::Deallocate(
+void MemoryManagerBase::RecordAllocation(
+	const MemoryAllocation& allocation, D3D12_HEAP_TYPE heapType, bool msaa
+) const noexcept {
+	if (AllocationTraceRecorder* traceRecorder = m_traceRecorder; traceRecorder)
+		traceRecorder->RecordHeapEvent(
+			AllocationTraceRecorder::EventType::Allocate, heapType, msaa, allocation.memoryID,
+			allocation.heapOffset, allocation.size, allocation.alignment
+		);
+}
+
+void MemoryManagerBase::DeallocateLocked(
+	D3DAllocatorGroup& allocators, bool isCPUAccessible, std::uint16_t memoryID,
+	UINT64 heapOffset, UINT64 size, UINT64 alignment
+) noexcept {
+	const bool isEmpty = allocators.Deallocate(memoryID, heapOffset, size, alignment);
+
+	// Check if the allocator is fully empty and isn't the last allocator.
+	// If so deallocate the empty allocator. Only deallocate CPU accessible allocators
+	// if they are empty.
+	const bool eraseCondition =
+		isCPUAccessible
+		&& allocators.GetAllocatorCount() > 1u
+		&& isEmpty;
+
+	if (eraseCondition)
+		allocators.RemoveAllocator(memoryID);
+}
+
+void MemoryManagerBase::Deallocate(
 	const MemoryAllocation& allocation, D3D12_HEAP_TYPE heapType, bool msaa /* = false */
 ) noexcept {
-	const bool isCPUAccessible            = heapType == D3D12_HEAP_TYPE_UPLOAD;
-	std::vector<D3DAllocator>& allocators = GetAllocators(isCPUAccessible, msaa);
+	const bool isCPUAccessible = heapType == D3D12_HEAP_TYPE_UPLOAD;
 
-	auto result = std::ranges::find_if(
-		allocators,
-		[id = allocation.memoryID](const D3DAllocator& alloc) { return alloc.GetID() == id; }
-	);
+	if (AllocationTraceRecorder* traceRecorder = m_traceRecorder; traceRecorder)
+		traceRecorder->RecordHeapEvent(
+			AllocationTraceRecorder::EventType::Deallocate, heapType, msaa, allocation.memoryID,
+			allocation.heapOffset, allocation.size, allocation.alignment
+		);
 
-	if (result != std::end(allocators))
+	if (std::optional<size_t> blocksIndex = GetCachedBlocksIndex(
+			allocation.size, allocation.alignment, isCPUAccessible, msaa
+		); blocksIndex)
 	{
-		D3DAllocator& allocator = *result;
-		allocator.Deallocate(allocation.heapOffset, allocation.size, allocation.alignment);
-
-		// Check if the allocator is fully empty and isn't the last allocator.
-		// If so deallocate the empty allocator. Only deallocate CPU accessible allocators
-		// if they are empty.
-		const bool eraseCondition =
-			isCPUAccessible
-			&& std::size(allocators) > 1u
-			&& allocator.Size() == allocator.AvailableSize();
-
-		if (eraseCondition)
+		AllocationCache& cache = GetThreadCache();
+
+		std::scoped_lock cacheLock{ cache.mutex };
+
+		CachedBlocks_t& cachedBlocks = cache.blocks[blocksIndex.value()];
+
+		// The flag must be checked with the shard locked. Otherwise, a heap could become
+		// unavailable and have this shard flushed, before the block is cached here.
+		// The vectors are reserved, so this can't throw.
+		if (!m_hasUnavailableHeaps && std::size(cachedBlocks) < s_cachedBlocksPerClass)
 		{
-			std::queue<std::uint16_t>& availableIndices = GetAvailableIndices(
-				isCPUAccessible, msaa
+			cachedBlocks.emplace_back(
+				D3DAllocatorGroup::Allocation
+				{
+					.heapOffset = allocation.heapOffset,
+					.heap       = allocation.heap,
+					.memoryID   = allocation.memoryID
+				}
 			);
 
-			availableIndices.push(allocator.GetID());
-			allocators.erase(result);
+			return;
 		}
 	}
+
+	std::scoped_lock allocatorLock{ *m_allocatorMutex };
+
+	DeallocateLocked(
+		GetAllocators(isCPUAccessible, msaa), isCPUAccessible, allocation.memoryID,
+		allocation.heapOffset, allocation.size, allocation.alignment
+	);
+}
+
+// Heap Provider
+D3DHeap D3DHeapProvider::CreateHeap(D3D12_HEAP_TYPE type, UINT64 size, bool msaa) const
+{
+	return D3DHeap{ m_device, type, size, msaa };
+}
+
+UINT64 D3DHeapProvider::GetAvailableMemory() const noexcept
+{
+	// Assuming there is a single GPU for now.
+	constexpr UINT gpuNodeIndex                      = 0u;
+	// Also only checking the GPU memory.
+	constexpr DXGI_MEMORY_SEGMENT_GROUP segmentGroup = DXGI_MEMORY_SEGMENT_GROUP_LOCAL;
+
+	DXGI_QUERY_VIDEO_MEMORY_INFO videoMemoryInfo
+	{
+		.Budget       = 0u,
+		.CurrentUsage = 0u
+	};
+
+	m_adapter->QueryVideoMemoryInfo(gpuNodeIndex, segmentGroup, &videoMemoryInfo);
+
+	// The usage can be over the budget, if the budget was lowered by the OS.
+	if (videoMemoryInfo.CurrentUsage >= videoMemoryInfo.Budget)
+		return 0u;
+
+	return videoMemoryInfo.Budget - videoMemoryInfo.CurrentUsage;
+}
+
+D3D12_RESOURCE_ALLOCATION_INFO D3DHeapProvider::GetAllocationInfo(
+	const D3D12_RESOURCE_DESC& resourceDesc
+) const noexcept {
+	return m_device->GetResourceAllocationInfo(0u, 1u, &resourceDesc);
 }
 }
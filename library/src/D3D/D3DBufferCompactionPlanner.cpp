@@ -0,0 +1,63 @@
+#include <D3DBufferCompactionPlanner.hpp>
+#include <iterator>
+
+namespace Gaia
+{
+BufferCompactionPlanner::Plan BufferCompactionPlanner::CreatePlan(
+	const std::map<UINT64, UINT64>& freeRegions,
+	const std::map<UINT64, UINT64>& liveAllocations, UINT64 byteBudget
+) {
+	Plan plan{ .moves = {}, .movedBytes = 0u };
+
+	// The parts of the free regions which haven't been used by the plan yet.
+	std::map<UINT64, UINT64> remainingRegions = freeRegions;
+
+	for (auto allocation = std::rbegin(liveAllocations); allocation != std::rend(liveAllocations);
+		++allocation)
+	{
+		if (plan.movedBytes >= byteBudget || std::empty(remainingRegions))
+			break;
+
+		const auto [srcOffset, size] = *allocation;
+
+		if (!size)
+			continue;
+
+		// The free regions don't overlap the allocations, so a region which starts before the
+		// allocation also ends before it.
+		for (auto region = std::begin(remainingRegions);
+			region != std::end(remainingRegions) && region->first < srcOffset; ++region)
+		{
+			const auto [regionOffset, regionSize] = *region;
+
+			if (regionSize < size)
+				continue;
+
+			plan.moves.emplace_back(
+				Move{ .srcOffset = srcOffset, .dstOffset = regionOffset, .size = size }
+			);
+			plan.movedBytes += size;
+
+			remainingRegions.erase(region);
+
+			if (regionSize > size)
+				remainingRegions.emplace(regionOffset + size, regionSize - size);
+
+			break;
+		}
+	}
+
+	return plan;
+}
+
+UINT64 BufferCompactionPlanner::GetUsedEnd(
+	const std::map<UINT64, UINT64>& liveAllocations
+) noexcept {
+	if (std::empty(liveAllocations))
+		return 0u;
+
+	const auto [offset, size] = *std::prev(std::end(liveAllocations));
+
+	return offset + size;
+}
+}
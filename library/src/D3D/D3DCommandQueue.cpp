@@ -37,8 +37,9 @@ void D3DCommandList::Copy(
 	m_commandList->CopyBufferRegion(dst.Get(), dstOffset, src.Get(), srcOffset, size);
 }
 
-void D3DCommandList::Copy(
-	const Buffer& src, UINT64 srcOffset, const Texture& dst, UINT subresourceIndex
+void D3DCommandList::CopyRows(
+	const Buffer& src, UINT64 srcOffset, const Texture& dst, UINT subresourceIndex,
+	UINT firstRow, UINT rowCount
 ) const noexcept {
 	D3D12_TEXTURE_COPY_LOCATION dstLocation
 	{
@@ -47,13 +48,18 @@ void D3DCommandList::Copy(
 		.SubresourceIndex = subresourceIndex
 	};
 
+	// The footprint is in texels, but must consist of whole blocks. The smaller mips of a block
+	// compressed texture are still stored as whole blocks.
+	const UINT blockSize  = dst.GetBlockSize();
+	const UINT64 mipWidth = dst.GetMipWidth(subresourceIndex);
+
 	D3D12_SUBRESOURCE_FOOTPRINT srcFootprint
 	{
 		.Format   = dst.Format(),
-		.Width    = static_cast<UINT>(dst.GetWidth()),
-		.Height   = dst.GetHeight(),
-		.Depth    = dst.GetDepth(),
-		.RowPitch = static_cast<UINT>(dst.GetRowPitchD3DAligned())
+		.Width    = static_cast<UINT>(Callisto::Align(mipWidth, blockSize)),
+		.Height   = rowCount * blockSize,
+		.Depth    = dst.GetMipDepth(subresourceIndex),
+		.RowPitch = static_cast<UINT>(dst.GetRowPitchD3DAligned(subresourceIndex))
 	};
 
 	D3D12_PLACED_SUBRESOURCE_FOOTPRINT srcPlacedFootprint
@@ -71,7 +77,7 @@ void D3DCommandList::Copy(
 
 	m_commandList->CopyTextureRegion(
 		&dstLocation,
-		0u, 0u, 0u,
+		0u, firstRow * blockSize, 0u,
 		&srcLocation,
 		nullptr
 	);
@@ -109,17 +109,16 @@ void D3DExternalResourceManager::UpdateDescriptor(
 		);
 }
 
-void D3DExternalResourceManager::UploadExternalBufferGPUOnlyData(
-	StagingBufferManager& stagingBufferManager, Callisto::TemporaryDataBufferGPU& tempGPUBuffer,
-	std::uint32_t externalBufferIndex, std::shared_ptr<void> cpuData, size_t srcDataSizeInBytes,
-	size_t dstBufferOffset
+UploadTicket D3DExternalResourceManager::UploadExternalBufferGPUOnlyData(
+	UploadScheduler& uploadScheduler, std::uint32_t externalBufferIndex,
+	std::shared_ptr<void> cpuData, size_t srcDataSizeInBytes, size_t dstBufferOffset
 ) const {
-	stagingBufferManager.AddBuffer(
+	return uploadScheduler.AddBuffer(
 		std::move(cpuData),
 		static_cast<UINT64>(srcDataSizeInBytes),
 		&m_resourceFactory.GetD3DBuffer(static_cast<size_t>(externalBufferIndex)),
 		static_cast<UINT64>(dstBufferOffset),
-		tempGPUBuffer
+		UploadPriority::Critical
 	);
 }
 
@@ -0,0 +1,265 @@
+#include <D3DHeapDefragPlanner.hpp>
+#include <AllocatorBase.hpp>
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <limits>
+#include <numeric>
+
+namespace Gaia
+{
+UINT64 HeapDefragPlanner::GetUsedSize(const Heap& heap) noexcept
+{
+	UINT64 usedSize = 0u;
+
+	for (const Allocation& allocation : heap.allocations)
+		usedSize += allocation.size;
+
+	return usedSize;
+}
+
+UINT64 HeapDefragPlanner::GetBlockSize(const Heap& heap, UINT64 size, UINT64 alignment) noexcept
+{
+	if (heap.usesPowerOfTwoBlocks)
+		return std::bit_ceil(std::max(size, alignment));
+
+	return size;
+}
+
+std::vector<HeapDefragPlanner::FreeRange> HeapDefragPlanner::GetFreeRanges(const Heap& heap)
+{
+	std::vector<const Allocation*> sortedAllocations{};
+	sortedAllocations.reserve(std::size(heap.allocations));
+
+	for (const Allocation& allocation : heap.allocations)
+		sortedAllocations.emplace_back(&allocation);
+
+	std::ranges::sort(
+		sortedAllocations,
+		[](const Allocation* lhs, const Allocation* rhs) { return lhs->offset < rhs->offset; }
+	);
+
+	std::vector<FreeRange> freeRanges{};
+
+	UINT64 rangeStart = 0u;
+
+	for (const Allocation* allocation : sortedAllocations)
+	{
+		if (allocation->offset > rangeStart)
+			freeRanges.emplace_back(FreeRange{ rangeStart, allocation->offset - rangeStart });
+
+		rangeStart = std::max(
+			rangeStart,
+			allocation->offset + GetBlockSize(heap, allocation->size, allocation->alignment)
+		);
+	}
+
+	if (heap.size > rangeStart)
+		freeRanges.emplace_back(FreeRange{ rangeStart, heap.size - rangeStart });
+
+	return freeRanges;
+}
+
+std::optional<HeapDefragPlanner::Placement> HeapDefragPlanner::FindPlacement(
+	const std::vector<Heap>& heaps, const FreeRanges_t& freeRanges,
+	const std::vector<bool>& isDestination, UINT64 size, UINT64 alignment
+) noexcept {
+	std::optional<Placement> bestPlacement{};
+	UINT64 bestLeftover = std::numeric_limits<UINT64>::max();
+
+	for (size_t heapIndex = 0u; heapIndex < std::size(freeRanges); ++heapIndex)
+	{
+		if (!isDestination[heapIndex])
+			continue;
+
+		const std::vector<FreeRange>& heapRanges = freeRanges[heapIndex];
+
+		// A buddy block is aligned to its own size.
+		const Heap& heap            = heaps[heapIndex];
+		const UINT64 blockSize      = GetBlockSize(heap, size, alignment);
+		const UINT64 blockAlignment = heap.usesPowerOfTwoBlocks ? blockSize : alignment;
+
+		for (size_t rangeIndex = 0u; rangeIndex < std::size(heapRanges); ++rangeIndex)
+		{
+			const FreeRange& freeRange  = heapRanges[rangeIndex];
+			const UINT64 alignedOffset  = Callisto::Align(freeRange.offset, blockAlignment);
+			const UINT64 rangeEnd       = freeRange.offset + freeRange.size;
+
+			if (alignedOffset + blockSize > rangeEnd)
+				continue;
+
+			if (const UINT64 leftover = rangeEnd - alignedOffset - blockSize;
+				leftover < bestLeftover)
+			{
+				bestLeftover  = leftover;
+				bestPlacement = Placement
+				{
+					.heapIndex  = heapIndex,
+					.rangeIndex = rangeIndex,
+					.offset     = alignedOffset,
+					.size       = blockSize
+				};
+			}
+		}
+	}
+
+	return bestPlacement;
+}
+
+void HeapDefragPlanner::Place(FreeRanges_t& freeRanges, const Placement& placement)
+{
+	std::vector<FreeRange>& heapRanges = freeRanges[placement.heapIndex];
+
+	const FreeRange freeRange = heapRanges[placement.rangeIndex];
+	const UINT64 rangeEnd     = freeRange.offset + freeRange.size;
+	const UINT64 placementEnd = placement.offset + placement.size;
+
+	heapRanges.erase(std::begin(heapRanges) + static_cast<std::ptrdiff_t>(placement.rangeIndex));
+
+	// The alignment padding in the front and the leftover at the back are still free.
+	if (placementEnd < rangeEnd)
+		heapRanges.emplace_back(FreeRange{ placementEnd, rangeEnd - placementEnd });
+
+	if (placement.offset > freeRange.offset)
+		heapRanges.emplace_back(FreeRange{ freeRange.offset, placement.offset - freeRange.offset });
+}
+
+HeapDefragPlanner::Plan HeapDefragPlanner::CreatePlan(const std::vector<Heap>& heaps) const
+{
+	Plan plan{ .evacuatedHeaps = {}, .relocations = {}, .movedBytes = 0u };
+
+	const size_t heapCount = std::size(heaps);
+
+	FreeRanges_t freeRanges{};
+	freeRanges.reserve(heapCount);
+
+	for (const Heap& heap : heaps)
+		freeRanges.emplace_back(GetFreeRanges(heap));
+
+	// Any heap can receive allocations, until it is evacuated.
+	std::vector<bool> isDestination(heapCount, true);
+	std::vector<bool> hasReceived(heapCount, false);
+
+	// Try to evacuate the least used heaps first, as they need the least amount of copying.
+	std::vector<size_t> candidateIndices(heapCount);
+	std::iota(std::begin(candidateIndices), std::end(candidateIndices), size_t{ 0u });
+
+	std::ranges::sort(
+		candidateIndices,
+		[&heaps](size_t lhs, size_t rhs)
+		{
+			const auto lhsOccupancy = static_cast<double>(GetUsedSize(heaps[lhs]))
+				/ static_cast<double>(std::max(heaps[lhs].size, UINT64{ 1u }));
+			const auto rhsOccupancy = static_cast<double>(GetUsedSize(heaps[rhs]))
+				/ static_cast<double>(std::max(heaps[rhs].size, UINT64{ 1u }));
+
+			return lhsOccupancy < rhsOccupancy;
+		}
+	);
+
+	for (size_t heapIndex : candidateIndices)
+	{
+		const Heap& heap      = heaps[heapIndex];
+		const UINT64 usedSize = GetUsedSize(heap);
+
+		// Empty heaps will be released anyway.
+		if (hasReceived[heapIndex] || std::empty(heap.allocations))
+			continue;
+
+		const double occupancy
+			= static_cast<double>(usedSize) / static_cast<double>(std::max(heap.size, UINT64{ 1u }));
+
+		// The candidates are sorted, so none of the remaining heaps can be evacuated either.
+		if (occupancy > static_cast<double>(m_settings.maximumOccupancy))
+			break;
+
+		if (plan.movedBytes + usedSize > m_settings.maximumMovedBytes)
+			continue;
+
+		const bool areAllMovable = std::ranges::all_of(
+			heap.allocations, [](const Allocation& allocation) { return allocation.isMovable; }
+		);
+
+		if (!areAllMovable)
+			continue;
+
+		// Place the larger allocations first, as they are the hardest to fit.
+		std::vector<const Allocation*> sortedAllocations{};
+		sortedAllocations.reserve(std::size(heap.allocations));
+
+		for (const Allocation& allocation : heap.allocations)
+			sortedAllocations.emplace_back(&allocation);
+
+		std::ranges::sort(
+			sortedAllocations,
+			[](const Allocation* lhs, const Allocation* rhs) { return lhs->size > rhs->size; }
+		);
+
+		// Work on a copy, so nothing changes if only some of the allocations could be placed.
+		FreeRanges_t newFreeRanges = freeRanges;
+
+		isDestination[heapIndex] = false;
+
+		std::vector<Relocation> heapRelocations{};
+		heapRelocations.reserve(std::size(sortedAllocations));
+
+		bool canEvacuate = true;
+
+		for (const Allocation* allocation : sortedAllocations)
+		{
+			std::optional<Placement> placement = FindPlacement(
+				heaps, newFreeRanges, isDestination, allocation->size, allocation->alignment
+			);
+
+			if (!placement)
+			{
+				canEvacuate = false;
+
+				break;
+			}
+
+			Place(newFreeRanges, placement.value());
+
+			heapRelocations.emplace_back(
+				Relocation
+				{
+					.resourceIndex = allocation->resourceIndex,
+					.srcMemoryID   = heap.memoryID,
+					.srcOffset     = allocation->offset,
+					.dstMemoryID   = heaps[placement->heapIndex].memoryID,
+					.dstOffset     = placement->offset,
+					.size          = allocation->size
+				}
+			);
+		}
+
+		if (!canEvacuate)
+		{
+			isDestination[heapIndex] = true;
+
+			continue;
+		}
+
+		freeRanges = std::move(newFreeRanges);
+
+		for (const Relocation& relocation : heapRelocations)
+		{
+			const auto destination = std::ranges::find_if(
+				heaps, [id = relocation.dstMemoryID](const Heap& dstHeap)
+				{
+					return dstHeap.memoryID == id;
+				}
+			);
+
+			hasReceived[static_cast<size_t>(std::distance(std::begin(heaps), destination))] = true;
+		}
+
+		plan.evacuatedHeaps.emplace_back(heap.memoryID);
+		plan.movedBytes += usedSize;
+
+		std::ranges::move(heapRelocations, std::back_inserter(plan.relocations));
+	}
+
+	return plan;
+}
+}
@@ -0,0 +1,84 @@
+#include <D3DHeapGrowthPolicy.hpp>
+#include <AllocatorBase.hpp>
+#include <algorithm>
+
+namespace Gaia
+{
+HeapGrowthPolicy::Settings HeapGrowthPolicy::GetDefaultSettings(D3D12_HEAP_TYPE heapType) noexcept
+{
+	if (heapType == D3D12_HEAP_TYPE_UPLOAD)
+		return Settings
+		{
+			.minimumHeapSize         = 16_MB,
+			.maximumHeapSize         = 256_MB,
+			.budgetFraction          = 0.25f,
+			.growthWindow            = 64u,
+			.idleFramesBeforeRelease = 0u
+		};
+
+	return Settings
+	{
+		.minimumHeapSize         = 64_MB,
+		.maximumHeapSize         = 2_GB,
+		.budgetFraction          = 0.5f,
+		.growthWindow            = 64u,
+		.idleFramesBeforeRelease = 120u
+	};
+}
+
+void HeapGrowthPolicy::RecordAllocation(UINT64 size) noexcept
+{
+	UINT64& oldestSize = m_recentSizes[m_recentSizeIndex];
+
+	m_recentTotal     = m_recentTotal - oldestSize + size;
+	oldestSize        = size;
+	m_recentSizeIndex = (m_recentSizeIndex + 1u) % s_historySize;
+
+	if (m_allocationsSinceNewHeap != std::numeric_limits<std::uint32_t>::max())
+		++m_allocationsSinceNewHeap;
+}
+
+void HeapGrowthPolicy::RecordAllocations(UINT64 size, std::uint32_t count) noexcept
+{
+	constexpr std::uint32_t noHeapCount = std::numeric_limits<std::uint32_t>::max();
+
+	const std::uint32_t allocationsSinceNewHeap = m_allocationsSinceNewHeap;
+
+	// Only the last few would stay in the history, but all of them count towards the window.
+	for (size_t _ = 0u; _ < std::min<size_t>(count, s_historySize); ++_)
+		RecordAllocation(size);
+
+	if (allocationsSinceNewHeap != noHeapCount)
+		m_allocationsSinceNewHeap = static_cast<std::uint32_t>(
+			std::min<UINT64>(UINT64{ allocationsSinceNewHeap } + count, noHeapCount - 1u)
+		);
+}
+
+void HeapGrowthPolicy::RecordNewHeap(UINT64 heapSize) noexcept
+{
+	m_lastHeapSize            = heapSize;
+	m_allocationsSinceNewHeap = 0u;
+}
+
+UINT64 HeapGrowthPolicy::GetNewHeapSize(
+	UINT64 minimumRequiredSize, UINT64 availableBudget
+) const noexcept {
+	// Assume the next few allocations will be similar to the last few.
+	UINT64 heapSize = std::max(m_settings.minimumHeapSize, m_recentTotal);
+
+	// If the last heap was filled up quickly, the scene is probably large. So, grow
+	// geometrically instead of creating a lot of small heaps.
+	if (m_allocationsSinceNewHeap <= m_settings.growthWindow)
+		heapSize = std::max(heapSize, m_lastHeapSize * 2u);
+
+	heapSize = std::min(heapSize, m_settings.maximumHeapSize);
+
+	const auto budgetLimit = static_cast<UINT64>(
+		static_cast<double>(availableBudget) * static_cast<double>(m_settings.budgetFraction)
+	);
+
+	heapSize = std::min(heapSize, budgetLimit);
+
+	return std::max(heapSize, minimumRequiredSize);
+}
+}
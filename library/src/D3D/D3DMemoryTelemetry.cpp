@@ -0,0 +1,224 @@
+#include <D3DMemoryTelemetry.hpp>
+#include <algorithm>
+#include <bit>
+#include <format>
+#include <fstream>
+
+namespace Gaia
+{
+// Region Stats Builder
+MemoryTelemetry::RegionStatsBuilder::RegionStatsBuilder(UINT64 regionSize)
+	: m_stats{
+		.size             = regionSize,
+		.usedSize         = 0u,
+		.largestFreeBlock = 0u,
+		.fragmentation    = 0.f,
+		.allocationCount  = 0u,
+		.sizeHistogram    = {}
+	}, m_freeStart{ 0u }
+{}
+
+void MemoryTelemetry::RegionStatsBuilder::AddAllocation(UINT64 offset, UINT64 size) noexcept
+{
+	if (offset > m_freeStart)
+		m_stats.largestFreeBlock = std::max(m_stats.largestFreeBlock, offset - m_freeStart);
+
+	m_freeStart = std::max(m_freeStart, offset + size);
+
+	m_stats.usedSize += size;
+	++m_stats.allocationCount;
+	++m_stats.sizeHistogram[GetHistogramBin(size)];
+}
+
+MemoryTelemetry::RegionStats MemoryTelemetry::RegionStatsBuilder::Build() const noexcept
+{
+	RegionStats stats = m_stats;
+
+	if (stats.size > m_freeStart)
+		stats.largestFreeBlock = std::max(stats.largestFreeBlock, stats.size - m_freeStart);
+
+	const UINT64 freeSize = stats.size > stats.usedSize ? stats.size - stats.usedSize : 0u;
+
+	if (freeSize)
+		stats.fragmentation = 1.f - static_cast<float>(
+			static_cast<double>(stats.largestFreeBlock) / static_cast<double>(freeSize)
+		);
+
+	return stats;
+}
+
+// Memory Telemetry
+size_t MemoryTelemetry::GetHistogramBin(UINT64 size) noexcept
+{
+	// 256B and below go to the first bin.
+	constexpr size_t firstBinWidth = 8u;
+
+	const auto binIndex = static_cast<size_t>(std::bit_width(std::max(size, UINT64{ 1u }) - 1u));
+
+	return std::min(
+		binIndex > firstBinWidth ? binIndex - firstBinWidth : 0u, s_histogramBinCount - 1u
+	);
+}
+
+MemoryTelemetry::RegionStats MemoryTelemetry::GetRegionStats(const D3DAllocator& allocator)
+{
+	RegionStatsBuilder statsBuilder{ allocator.Size() };
+
+	for (const auto& [heapOffset, liveAllocation] : allocator.GetLiveAllocations())
+		statsBuilder.AddAllocation(heapOffset, liveAllocation.size);
+
+	return statsBuilder.Build();
+}
+
+MemoryTelemetry::RegionStats MemoryTelemetry::GetRegionStats(const SharedBufferBase& sharedBuffer)
+{
+	RegionStatsBuilder statsBuilder{ sharedBuffer.Size() };
+
+	for (const auto& [offset, size] : sharedBuffer.GetLiveAllocations())
+		statsBuilder.AddAllocation(offset, size);
+
+	return statsBuilder.Build();
+}
+
+void MemoryTelemetry::AddHeapReports(
+	std::vector<HeapReport>& heapReports, const D3DAllocatorGroup& allocators,
+	D3D12_HEAP_TYPE heapType, bool msaa
+) {
+	for (const D3DAllocator& allocator : allocators.GetAllocators())
+		heapReports.emplace_back(
+			HeapReport
+			{
+				.memoryID      = allocator.GetID(),
+				.heapType      = heapType,
+				.msaa          = msaa,
+				.allocatorType = allocator.GetAllocatorType(),
+				.stats         = GetRegionStats(allocator)
+			}
+		);
+}
+
+std::vector<MemoryTelemetry::HeapReport> MemoryTelemetry::GetHeapReports(
+	const MemoryManager& memoryManager
+) {
+	std::vector<HeapReport> heapReports{};
+
+	memoryManager.ForEachAllocatorGroup(
+		[&heapReports]
+		(const D3DAllocatorGroup& allocators, D3D12_HEAP_TYPE heapType, bool msaa)
+		{
+			AddHeapReports(heapReports, allocators, heapType, msaa);
+		}
+	);
+
+	return heapReports;
+}
+
+static std::string RegionStatsToJSON(const MemoryTelemetry::RegionStats& stats)
+{
+	std::string histogram{};
+
+	for (size_t index = 0u; index < std::size(stats.sizeHistogram); ++index)
+		histogram += std::format("{}{}", index ? "," : "", stats.sizeHistogram[index]);
+
+	return std::format(
+		"\"size\":{},\"used\":{},\"largestFreeBlock\":{},\"fragmentation\":{:.4f},"
+		"\"allocationCount\":{},\"histogram\":[{}]",
+		stats.size, stats.usedSize, stats.largestFreeBlock, stats.fragmentation,
+		stats.allocationCount, histogram
+	);
+}
+
+std::string MemoryTelemetry::ToJSON(const Report& report)
+{
+	std::string json = std::format("{{\"frame\":{},\"heaps\":[", report.frameNumber);
+
+	for (size_t index = 0u; index < std::size(report.heaps); ++index)
+	{
+		const HeapReport& heapReport = report.heaps[index];
+
+		json += std::format(
+			"{}{{\"memoryID\":{},\"heapType\":\"{}\",\"msaa\":{},\"allocator\":\"{}\",{}}}",
+			index ? "," : "", heapReport.memoryID,
+			heapReport.heapType == D3D12_HEAP_TYPE_UPLOAD ? "Upload" : "Default",
+			heapReport.msaa,
+			heapReport.allocatorType == HeapAllocatorType::TLSF ? "TLSF" : "Buddy",
+			RegionStatsToJSON(heapReport.stats)
+		);
+	}
+
+	json += "],\"sharedBuffers\":[";
+
+	for (size_t index = 0u; index < std::size(report.sharedBuffers); ++index)
+	{
+		const SharedBufferReport& bufferReport = report.sharedBuffers[index];
+
+		json += std::format(
+			"{}{{\"name\":\"{}\",{}}}", index ? "," : "", bufferReport.name,
+			RegionStatsToJSON(bufferReport.stats)
+		);
+	}
+
+	json += "]}";
+
+	return json;
+}
+
+void MemoryTelemetry::SetExport(std::uint32_t frameInterval, std::string filePath) noexcept
+{
+	m_exportInterval    = frameInterval;
+	m_exportPath        = std::move(filePath);
+	m_framesSinceExport = 0u;
+}
+
+bool MemoryTelemetry::AdvanceFrame() noexcept
+{
+	++m_frameNumber;
+
+	if (!m_exportInterval)
+		return false;
+
+	++m_framesSinceExport;
+
+	if (m_framesSinceExport < m_exportInterval)
+		return false;
+
+	m_framesSinceExport = 0u;
+
+	return true;
+}
+
+MemoryTelemetry::~MemoryTelemetry() noexcept
+{
+	WaitForExport();
+}
+
+static void WriteReport(const std::string& filePath, const MemoryTelemetry::Report& report)
+{
+	std::ofstream exportFile(filePath, std::ios_base::app | std::ios_base::out);
+	exportFile << MemoryTelemetry::ToJSON(report) << '\n';
+}
+
+void MemoryTelemetry::Export(Report&& report)
+{
+	if (!m_threadPool)
+	{
+		WriteReport(m_exportPath, report);
+
+		return;
+	}
+
+	WaitForExport();
+
+	m_exportWaitObj = m_threadPool->SubmitWork(std::function{
+		[filePath = m_exportPath, report = std::move(report)]
+		{
+			WriteReport(filePath, report);
+		}});
+}
+
+void MemoryTelemetry::WaitForExport() noexcept
+{
+	if (m_exportWaitObj.valid())
+		m_exportWaitObj.wait();
+}
+}
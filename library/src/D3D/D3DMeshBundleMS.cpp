@@ -1,5 +1,4 @@
 #include <D3DMeshBundleMS.hpp>
-#include <VectorToSharedPtr.hpp>
 
 namespace Gaia
 {
@@ -33,12 +32,13 @@ void D3DMeshBundleMS::_setMeshBundle(
 		sharedData   = sharedBuffer.AllocateAndGetSharedData(bufferSize, tempBuffer);
 		detailOffset = static_cast<std::uint32_t>(sharedData.offset / stride);
 
-		std::shared_ptr<std::uint8_t[]> tempDataBuffer = Callisto::CopyVectorToSharedPtr(elements);
-
-		stagingBufferMan.AddBuffer(
-			std::move(tempDataBuffer), bufferSize, sharedData.bufferData, sharedData.offset,
-			tempBuffer
+		const StagingBufferManager::Reservation reservation = stagingBufferMan.ReserveBuffer(
+			bufferSize, tempBuffer
 		);
+
+		memcpy(std::data(reservation.data), std::data(elements), bufferSize);
+
+		stagingBufferMan.CommitBuffer(reservation, sharedData.bufferData, sharedData.offset);
 	};
 
 	const std::vector<std::uint32_t>& vertexIndices   = meshBundle.indices;
@@ -97,30 +97,18 @@ void D3DMeshBundleMS::SetMeshBundle(
 		perMeshDataSize, tempBuffer
 	);
 
-	auto perMeshBufferData = std::make_shared<std::uint8_t[]>(perMeshDataSize);
-
-	{
-		size_t perMeshOffset             = 0u;
-		std::uint8_t* perMeshBufferStart = perMeshBufferData.get();
-
-		for (const MeshTemporaryDetailsMS& meshDetail : meshDetailsMS)
-		{
-			memcpy(perMeshBufferStart + perMeshOffset, &meshDetail.aabb, perMeshDataStride);
-
-			perMeshOffset += perMeshDataStride;
-		}
-	}
-
 	// Mesh Bundle Data
 	constexpr size_t perMeshBundleDataSize = sizeof(PerMeshBundleData);
 
-	auto perBundleData = std::make_shared<std::uint8_t[]>(perMeshBundleDataSize);
-
 	m_perMeshBundleSharedData = perMeshBundleSharedBuffer.AllocateAndGetSharedData(
 		perMeshBundleDataSize, tempBuffer
 	);
 
 	{
+		const StagingBufferManager::Reservation reservation = stagingBufferMan.ReserveBuffer(
+			perMeshBundleDataSize, tempBuffer
+		);
+
 		PerMeshBundleData bundleData
 		{
 			.meshOffset = static_cast<std::uint32_t>(
@@ -128,18 +116,32 @@ void D3DMeshBundleMS::SetMeshBundle(
 			)
 		};
 
-		memcpy(perBundleData.get(), &bundleData, perMeshBundleDataSize);
+		memcpy(std::data(reservation.data), &bundleData, perMeshBundleDataSize);
+
+		stagingBufferMan.CommitBuffer(
+			reservation, m_perMeshBundleSharedData.bufferData, m_perMeshBundleSharedData.offset
+		);
 	}
 
-	stagingBufferMan.AddBuffer(
-		std::move(perBundleData), perMeshBundleDataSize,
-		m_perMeshBundleSharedData.bufferData, m_perMeshBundleSharedData.offset, tempBuffer
-	);
+	{
+		const StagingBufferManager::Reservation reservation = stagingBufferMan.ReserveBuffer(
+			perMeshDataSize, tempBuffer
+		);
 
-	stagingBufferMan.AddBuffer(
-		std::move(perMeshBufferData), perMeshDataSize,
-		m_perMeshSharedData.bufferData, m_perMeshSharedData.offset, tempBuffer
-	);
+		size_t perMeshOffset             = 0u;
+		std::uint8_t* perMeshBufferStart = std::data(reservation.data);
+
+		for (const MeshTemporaryDetailsMS& meshDetail : meshDetailsMS)
+		{
+			memcpy(perMeshBufferStart + perMeshOffset, &meshDetail.aabb, perMeshDataStride);
+
+			perMeshOffset += perMeshDataStride;
+		}
+
+		stagingBufferMan.CommitBuffer(
+			reservation, m_perMeshSharedData.bufferData, m_perMeshSharedData.offset
+		);
+	}
 
 	_setMeshBundle(
 		std::move(meshBundle),
@@ -1,5 +1,4 @@
 #include <D3DMeshBundleVS.hpp>
-#include <VectorToSharedPtr.hpp>
 
 namespace Gaia
 {
@@ -24,13 +23,14 @@ void D3DMeshBundleVS::_setMeshBundle(
 			vertexBufferSize, tempBuffer
 		);
 
-		std::shared_ptr<std::uint8_t[]> vertexBufferData
-			= Callisto::CopyVectorToSharedPtr(vertices);
+		const StagingBufferManager::Reservation reservation = stagingBufferMan.ReserveBuffer(
+			vertexBufferSize, tempBuffer
+		);
 
-		stagingBufferMan.AddBuffer(
-			std::move(vertexBufferData), vertexBufferSize,
-			m_vertexBufferSharedData.bufferData, m_vertexBufferSharedData.offset,
-			tempBuffer
+		memcpy(std::data(reservation.data), std::data(vertices), vertexBufferSize);
+
+		stagingBufferMan.CommitBuffer(
+			reservation, m_vertexBufferSharedData.bufferData, m_vertexBufferSharedData.offset
 		);
 	}
 
@@ -46,12 +46,14 @@ void D3DMeshBundleVS::_setMeshBundle(
 			indexBufferSize, tempBuffer
 		);
 
-		std::shared_ptr<std::uint8_t[]> indexBufferData = Callisto::CopyVectorToSharedPtr(indices);
+		const StagingBufferManager::Reservation reservation = stagingBufferMan.ReserveBuffer(
+			indexBufferSize, tempBuffer
+		);
+
+		memcpy(std::data(reservation.data), std::data(indices), indexBufferSize);
 
-		stagingBufferMan.AddBuffer(
-			std::move(indexBufferData), indexBufferSize,
-			m_indexBufferSharedData.bufferData, m_indexBufferSharedData.offset,
-			tempBuffer
+		stagingBufferMan.CommitBuffer(
+			reservation, m_indexBufferSharedData.bufferData, m_indexBufferSharedData.offset
 		);
 	}
 
@@ -87,11 +89,13 @@ void D3DMeshBundleVS::SetMeshBundle(
 		perMeshDataSize, tempBuffer
 	);
 
-	auto perMeshBufferData = std::make_shared<std::uint8_t[]>(perMeshDataSize);
-
 	{
+		const StagingBufferManager::Reservation reservation = stagingBufferMan.ReserveBuffer(
+			perMeshDataSize, tempBuffer
+		);
+
 		size_t perMeshOffset             = 0u;
-		std::uint8_t* perMeshBufferStart = perMeshBufferData.get();
+		std::uint8_t* perMeshBufferStart = std::data(reservation.data);
 
 		for (const MeshTemporaryDetailsVS& meshDetail : meshDetailsVS)
 		{
@@ -99,14 +103,31 @@ void D3DMeshBundleVS::SetMeshBundle(
 
 			perMeshOffset += perMeshDataStride;
 		}
+
+		stagingBufferMan.CommitBuffer(
+			reservation, m_perMeshSharedData.bufferData, m_perMeshSharedData.offset
+		);
 	}
 
 	// Mesh Bundle Data
-	constexpr size_t perMeshBundleDataSize = sizeof(PerMeshBundleData);
+	m_perMeshBundleSharedData = perMeshBundleSharedBuffer.AllocateAndGetSharedData(
+		sizeof(PerMeshBundleData), tempBuffer
+	);
 
-	auto perBundleData = std::make_shared<std::uint8_t[]>(perMeshBundleDataSize);
+	UploadPerMeshBundleData(stagingBufferMan, tempBuffer);
 
-	m_perMeshBundleSharedData = perMeshBundleSharedBuffer.AllocateAndGetSharedData(
+	_setMeshBundle(
+		std::move(meshBundle), stagingBufferMan, vertexSharedBuffer, indexSharedBuffer, tempBuffer
+	);
+}
+
+void D3DMeshBundleVS::UploadPerMeshBundleData(
+	StagingBufferManager& stagingBufferMan, Callisto::TemporaryDataBufferGPU& tempBuffer
+) {
+	constexpr size_t perMeshDataStride     = sizeof(AxisAlignedBoundingBox);
+	constexpr size_t perMeshBundleDataSize = sizeof(PerMeshBundleData);
+
+	const StagingBufferManager::Reservation reservation = stagingBufferMan.ReserveBuffer(
 		perMeshBundleDataSize, tempBuffer
 	);
 
@@ -118,22 +139,21 @@ void D3DMeshBundleVS::SetMeshBundle(
 			)
 		};
 
-		memcpy(perBundleData.get(), &bundleData, perMeshBundleDataSize);
+		memcpy(std::data(reservation.data), &bundleData, perMeshBundleDataSize);
 	}
 
-	stagingBufferMan.AddBuffer(
-		std::move(perBundleData), perMeshBundleDataSize,
-		m_perMeshBundleSharedData.bufferData, m_perMeshBundleSharedData.offset, tempBuffer
+	stagingBufferMan.CommitBuffer(
+		reservation, m_perMeshBundleSharedData.bufferData, m_perMeshBundleSharedData.offset
 	);
+}
 
-	stagingBufferMan.AddBuffer(
-		std::move(perMeshBufferData), perMeshDataSize,
-		m_perMeshSharedData.bufferData, m_perMeshSharedData.offset, tempBuffer
-	);
+void D3DMeshBundleVS::SetPerMeshOffset(
+	UINT64 offset, StagingBufferManager& stagingBufferMan,
+	Callisto::TemporaryDataBufferGPU& tempBuffer
+) {
+	m_perMeshSharedData.offset = offset;
 
-	_setMeshBundle(
-		std::move(meshBundle), stagingBufferMan, vertexSharedBuffer, indexSharedBuffer, tempBuffer
-	);
+	UploadPerMeshBundleData(stagingBufferMan, tempBuffer);
 }
 
 void D3DMeshBundleVS::Bind(const D3DCommandList& graphicsCmdList) const noexcept
@@ -43,6 +43,41 @@ void MeshManagerVSIndividual::ConfigureRemoveMesh(size_t bundleIndex) noexcept
 	}
 }
 
+void MeshManagerVSIndividual::ReserveMeshBundles(
+	const std::vector<MeshBundleTemporaryData>& meshBundles,
+	Callisto::TemporaryDataBufferGPU& tempBuffer
+) {
+	ReserveBuffer(
+		m_vertexBuffer, meshBundles,
+		[](const MeshBundleTemporaryData& meshBundle)
+		{
+			return sizeof(Vertex) * std::size(meshBundle.vertices);
+		}, tempBuffer
+	);
+	ReserveBuffer(
+		m_indexBuffer, meshBundles,
+		[](const MeshBundleTemporaryData& meshBundle)
+		{
+			return sizeof(std::uint32_t) * std::size(meshBundle.indices);
+		}, tempBuffer
+	);
+}
+
+void MeshManagerVSIndividual::CompactBuffersImpl(
+	UINT64 byteBudget, CompactionResult& result,
+	[[maybe_unused]] StagingBufferManager& stagingBufferMan,
+	Callisto::TemporaryDataBufferGPU& tempBuffer
+) {
+	CompactBuffer(
+		m_vertexBuffer, byteBudget, result, &D3DMeshBundleVS::GetVertexSharedData,
+		&D3DMeshBundleVS::SetVertexOffset, tempBuffer
+	);
+	CompactBuffer(
+		m_indexBuffer, byteBudget, result, &D3DMeshBundleVS::GetIndexSharedData,
+		&D3DMeshBundleVS::SetIndexOffset, tempBuffer
+	);
+}
+
 // Mesh Manager VS Indirect
 MeshManagerVSIndirect::MeshManagerVSIndirect(ID3D12Device5* device, MemoryManager* memoryManager)
 	: MeshManager{},
@@ -81,6 +116,67 @@ void MeshManagerVSIndirect::ConfigureRemoveMesh(size_t bundleIndex) noexcept
 	}
 }
 
+void MeshManagerVSIndirect::ReserveMeshBundles(
+	const std::vector<MeshBundleTemporaryData>& meshBundles,
+	Callisto::TemporaryDataBufferGPU& tempBuffer
+) {
+	ReserveBuffer(
+		m_vertexBuffer, meshBundles,
+		[](const MeshBundleTemporaryData& meshBundle)
+		{
+			return sizeof(Vertex) * std::size(meshBundle.vertices);
+		}, tempBuffer
+	);
+	ReserveBuffer(
+		m_indexBuffer, meshBundles,
+		[](const MeshBundleTemporaryData& meshBundle)
+		{
+			return sizeof(std::uint32_t) * std::size(meshBundle.indices);
+		}, tempBuffer
+	);
+	ReserveBuffer(
+		m_perMeshDataBuffer, meshBundles,
+		[](const MeshBundleTemporaryData& meshBundle)
+		{
+			return sizeof(AxisAlignedBoundingBox)
+				* std::size(meshBundle.bundleDetails.meshTemporaryDetailsVS);
+		}, tempBuffer
+	);
+	ReserveBuffer(
+		m_perMeshBundleDataBuffer, meshBundles,
+		[](const MeshBundleTemporaryData&)
+		{
+			return sizeof(D3DMeshBundleVS::PerMeshBundleData);
+		}, tempBuffer
+	);
+}
+
+void MeshManagerVSIndirect::CompactBuffersImpl(
+	UINT64 byteBudget, CompactionResult& result, StagingBufferManager& stagingBufferMan,
+	Callisto::TemporaryDataBufferGPU& tempBuffer
+) {
+	CompactBuffer(
+		m_vertexBuffer, byteBudget, result, &D3DMeshBundleVS::GetVertexSharedData,
+		&D3DMeshBundleVS::SetVertexOffset, tempBuffer
+	);
+	CompactBuffer(
+		m_indexBuffer, byteBudget, result, &D3DMeshBundleVS::GetIndexSharedData,
+		&D3DMeshBundleVS::SetIndexOffset, tempBuffer
+	);
+	CompactBuffer(
+		m_perMeshDataBuffer, byteBudget, result, &D3DMeshBundleVS::GetPerMeshSharedData,
+		[&stagingBufferMan, &tempBuffer](D3DMeshBundleVS& meshBundle, UINT64 offset)
+		{
+			meshBundle.SetPerMeshOffset(offset, stagingBufferMan, tempBuffer);
+		},
+		tempBuffer
+	);
+
+	// The per mesh bundle data is indexed with the bundle indices in the shaders, so it can't
+	// be moved.
+	ShrinkBuffer(m_perMeshBundleDataBuffer, byteBudget, result, tempBuffer);
+}
+
 void MeshManagerVSIndirect::SetDescriptorLayoutCS(
 	std::vector<D3DDescriptorManager>& descriptorManagers, size_t csRegisterSpace
 ) const noexcept {
@@ -161,6 +257,63 @@ void MeshManagerMS::ConfigureRemoveMesh(size_t bundleIndex) noexcept
 	}
 }
 
+void MeshManagerMS::ReserveMeshBundles(
+	const std::vector<MeshBundleTemporaryData>& meshBundles,
+	Callisto::TemporaryDataBufferGPU& tempBuffer
+) {
+	ReserveBuffer(
+		m_vertexBuffer, meshBundles,
+		[](const MeshBundleTemporaryData& meshBundle)
+		{
+			return sizeof(Vertex) * std::size(meshBundle.vertices);
+		}, tempBuffer
+	);
+	ReserveBuffer(
+		m_vertexIndicesBuffer, meshBundles,
+		[](const MeshBundleTemporaryData& meshBundle)
+		{
+			return sizeof(std::uint32_t) * std::size(meshBundle.indices);
+		}, tempBuffer
+	);
+	ReserveBuffer(
+		m_primIndicesBuffer, meshBundles,
+		[](const MeshBundleTemporaryData& meshBundle)
+		{
+			return sizeof(std::uint32_t) * std::size(meshBundle.primIndices);
+		}, tempBuffer
+	);
+	ReserveBuffer(
+		m_perMeshletBuffer, meshBundles,
+		[](const MeshBundleTemporaryData& meshBundle)
+		{
+			return sizeof(MeshletDetails) * std::size(meshBundle.meshletDetails);
+		}, tempBuffer
+	);
+}
+
+void MeshManagerMS::CompactBuffersImpl(
+	UINT64 byteBudget, CompactionResult& result,
+	[[maybe_unused]] StagingBufferManager& stagingBufferMan,
+	Callisto::TemporaryDataBufferGPU& tempBuffer
+) {
+	CompactBuffer(
+		m_perMeshletBuffer, byteBudget, result, &D3DMeshBundleMS::GetPerMeshletSharedData,
+		&D3DMeshBundleMS::SetPerMeshletOffset, tempBuffer
+	);
+	CompactBuffer(
+		m_vertexBuffer, byteBudget, result, &D3DMeshBundleMS::GetVertexSharedData,
+		&D3DMeshBundleMS::SetVertexOffset, tempBuffer
+	);
+	CompactBuffer(
+		m_vertexIndicesBuffer, byteBudget, result, &D3DMeshBundleMS::GetVertexIndicesSharedData,
+		&D3DMeshBundleMS::SetVertexIndicesOffset, tempBuffer
+	);
+	CompactBuffer(
+		m_primIndicesBuffer, byteBudget, result, &D3DMeshBundleMS::GetPrimIndicesSharedData,
+		&D3DMeshBundleMS::SetPrimIndicesOffset, tempBuffer
+	);
+}
+
 void MeshManagerMS::SetDescriptorLayout(
 	std::vector<D3DDescriptorManager>& descriptorManagers, size_t msRegisterSpace
 ) const noexcept {
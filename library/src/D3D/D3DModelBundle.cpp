@@ -133,7 +133,7 @@ void PipelineModelsMSIndividual::Draw(
 // Pipeline Models CS Indirect
 PipelineModelsCSIndirect::PipelineModelsCSIndirect()
 	: PipelineModelsBase{}, m_perPipelineSharedData{ nullptr, 0u, 0u },
-	m_perModelSharedData{ nullptr, 0u, 0u }, m_argumentInputSharedData{}
+	m_perModelSharedData{ nullptr, 0u, 0u, 0u }, m_argumentInputSharedData{}
 {}
 
 void PipelineModelsCSIndirect::ResetCullingData() const noexcept
@@ -203,7 +203,7 @@ void PipelineModelsCSIndirect::UpdateNonPerFrameData(
 
 		if (!std::empty(m_argumentInputSharedData))
 		{
-			const SharedBufferData& sharedBufferData = m_argumentInputSharedData.front();
+			const PagedBufferData& sharedBufferData = m_argumentInputSharedData.front();
 
 			perPipelineData.modelOffset = static_cast<std::uint32_t>(
 				sharedBufferData.offset / argumentStrideSize
@@ -244,8 +244,8 @@ void PipelineModelsCSIndirect::UpdateNonPerFrameData(
 
 void PipelineModelsCSIndirect::AllocateBuffers(
 	const std::vector<PipelineModelBundle>& pipelineBundles,
-	std::vector<SharedBufferCPU>& argumentInputSharedBuffers,
-	SharedBufferCPU& perPipelineSharedBuffer, SharedBufferCPU& perModelSharedBuffer
+	std::vector<SharedBufferPagedCPU>& argumentInputSharedBuffers,
+	SharedBufferSlabCPU& perPipelineSharedBuffer, SharedBufferPagedCPU& perModelSharedBuffer
 ) {
 	const size_t modelCount = GetModelCount(pipelineBundles);
 
@@ -254,7 +254,6 @@ void PipelineModelsCSIndirect::AllocateBuffers(
 
 	constexpr size_t argumentStrideSize = sizeof(IndirectArgument);
 	constexpr size_t perModelStride     = sizeof(PerModelData);
-	const auto perPipelineDataSize      = static_cast<UINT64>(sizeof(PerPipelineData));
 
 	const auto argumentBufferSize = static_cast<UINT64>(argumentStrideSize * modelCount);
 	const auto perModelDataSize   = static_cast<UINT64>(perModelStride * modelCount);
@@ -264,19 +263,19 @@ void PipelineModelsCSIndirect::AllocateBuffers(
 
 	if (std::empty(m_argumentInputSharedData))
 		m_argumentInputSharedData.resize(
-			argumentInputBufferCount, SharedBufferData{ nullptr, 0u, 0u }
+			argumentInputBufferCount, PagedBufferData{ nullptr, 0u, 0u, 0u }
 		);
 
 	for (size_t index = 0u; index < argumentInputBufferCount; ++index)
 	{
-		SharedBufferData& argumentInputSharedData  = m_argumentInputSharedData[index];
-		SharedBufferCPU& argumentInputSharedBuffer = argumentInputSharedBuffers[index];
+		PagedBufferData& argumentInputSharedData        = m_argumentInputSharedData[index];
+		SharedBufferPagedCPU& argumentInputSharedBuffer = argumentInputSharedBuffers[index];
 
 		if (argumentInputSharedData.bufferData)
 			argumentInputSharedBuffer.RelinquishMemory(argumentInputSharedData);
 
 		argumentInputSharedData = argumentInputSharedBuffer.AllocateAndGetSharedData(
-			argumentBufferSize, true
+			argumentBufferSize
 		);
 	}
 
@@ -285,9 +284,7 @@ void PipelineModelsCSIndirect::AllocateBuffers(
 		if (m_perPipelineSharedData.bufferData)
 			perPipelineSharedBuffer.RelinquishMemory(m_perPipelineSharedData);
 
-		m_perPipelineSharedData = perPipelineSharedBuffer.AllocateAndGetSharedData(
-			perPipelineDataSize, true
-		);
+		m_perPipelineSharedData = perPipelineSharedBuffer.AllocateAndGetSharedData(true);
 	}
 
 	// Per Model Data
@@ -295,8 +292,14 @@ void PipelineModelsCSIndirect::AllocateBuffers(
 		if (m_perModelSharedData.bufferData)
 			perModelSharedBuffer.RelinquishMemory(m_perModelSharedData);
 
-		m_perModelSharedData = perModelSharedBuffer.AllocateAndGetSharedData(
-			perModelDataSize, true
+		m_perModelSharedData = perModelSharedBuffer.AllocateAndGetSharedData(perModelDataSize);
+
+		// The compute shader finds the per model data of an argument with the same index.
+		assert(
+			m_perModelSharedData.pageIndex == m_argumentInputSharedData.front().pageIndex
+			&& m_perModelSharedData.offset / perModelStride
+			== m_argumentInputSharedData.front().offset / argumentStrideSize
+			&& "The per model data and the arguments aren't at the same model offset."
 		);
 	}
 }
@@ -315,7 +318,7 @@ void PipelineModelsCSIndirect::Update(
 	if (!modelCount)
 		return;
 
-	const SharedBufferData& argumentInputSharedData = m_argumentInputSharedData[frameIndex];
+	const PagedBufferData& argumentInputSharedData = m_argumentInputSharedData[frameIndex];
 
 	std::uint8_t* argumentInputStart = argumentInputSharedData.bufferData->CPUHandle();
 	std::uint8_t* perModelStart      = m_perModelSharedData.bufferData->CPUHandle();
@@ -366,20 +369,20 @@ void PipelineModelsCSIndirect::Update(
 }
 
 void PipelineModelsCSIndirect::RelinquishMemory(
-	std::vector<SharedBufferCPU>& argumentInputSharedBuffers,
-	SharedBufferCPU& perPipelineSharedBuffer, SharedBufferCPU& perModelSharedBuffer
+	std::vector<SharedBufferPagedCPU>& argumentInputSharedBuffers,
+	SharedBufferSlabCPU& perPipelineSharedBuffer, SharedBufferPagedCPU& perModelSharedBuffer
 ) noexcept {
 	// Input Buffers
 	for (size_t index = 0u; index < std::size(m_argumentInputSharedData); ++index)
 	{
-		SharedBufferCPU& argumentSharedBuffer = argumentInputSharedBuffers[index];
-		SharedBufferData& argumentSharedData  = m_argumentInputSharedData[index];
+		SharedBufferPagedCPU& argumentSharedBuffer = argumentInputSharedBuffers[index];
+		PagedBufferData& argumentSharedData        = m_argumentInputSharedData[index];
 
 		if (argumentSharedData.bufferData)
 		{
 			argumentSharedBuffer.RelinquishMemory(argumentSharedData);
 
-			argumentSharedData = SharedBufferData{ nullptr, 0u, 0u };
+			argumentSharedData = PagedBufferData{ nullptr, 0u, 0u, 0u };
 		}
 	}
 
@@ -396,7 +399,7 @@ void PipelineModelsCSIndirect::RelinquishMemory(
 	{
 		perModelSharedBuffer.RelinquishMemory(m_perModelSharedData);
 
-		m_perModelSharedData = SharedBufferData{ nullptr, 0u, 0u };
+		m_perModelSharedData = PagedBufferData{ nullptr, 0u, 0u, 0u };
 	}
 }
 
@@ -406,8 +409,8 @@ PipelineModelsVSIndirect::PipelineModelsVSIndirect()
 {}
 
 void PipelineModelsVSIndirect::AllocateBuffers(
-	std::vector<SharedBufferGPUWriteOnly>& argumentOutputSharedBuffers,
-	std::vector<SharedBufferGPUWriteOnly>& counterSharedBuffers
+	std::vector<SharedBufferPagedGPUWriteOnly>& argumentOutputSharedBuffers,
+	std::vector<SharedBufferSlabGPUWriteOnly>& counterSharedBuffers
 ) {
 	constexpr size_t argStrideSize      = sizeof(PipelineModelsCSIndirect::IndirectArgument);
 	const auto argumentOutputBufferSize = static_cast<UINT64>(m_modelCount * argStrideSize);
@@ -421,13 +424,15 @@ void PipelineModelsVSIndirect::AllocateBuffers(
 
 		if (std::empty(m_argumentOutputSharedData))
 			m_argumentOutputSharedData.resize(
-				argumentOutputBufferCount, SharedBufferData{ nullptr, 0u, 0u }
+				argumentOutputBufferCount, PagedBufferData{ nullptr, 0u, 0u, 0u }
 			);
 
+		// The input and output buffers have the same page size and are allocated and freed in
+		// the same order, so the output lands on the same page and offset as the input.
 		for (size_t index = 0u; index < argumentOutputBufferCount; ++index)
 		{
-			SharedBufferData& argumentOutputSharedData = m_argumentOutputSharedData[index];
-			SharedBufferGPUWriteOnly& argumentOutputSharedBuffer
+			PagedBufferData& argumentOutputSharedData = m_argumentOutputSharedData[index];
+			SharedBufferPagedGPUWriteOnly& argumentOutputSharedBuffer
 				= argumentOutputSharedBuffers[index];
 
 			if (argumentOutputSharedData.bufferData)
@@ -451,14 +456,12 @@ void PipelineModelsVSIndirect::AllocateBuffers(
 		for (size_t index = 0u; index < counterBufferCount; ++index)
 		{
 			SharedBufferData& counterSharedData           = m_counterSharedData[index];
-			SharedBufferGPUWriteOnly& counterSharedBuffer = counterSharedBuffers[index];
+			SharedBufferSlabGPUWriteOnly& counterSharedBuffer = counterSharedBuffers[index];
 
 			if (counterSharedData.bufferData)
 				counterSharedBuffer.RelinquishMemory(counterSharedData);
 
-			counterSharedData = counterSharedBuffer.AllocateAndGetSharedData(
-				s_counterBufferSize
-			);
+			counterSharedData = counterSharedBuffer.AllocateAndGetSharedData();
 		}
 	}
 }
@@ -472,8 +475,8 @@ void PipelineModelsVSIndirect::Draw(
 	if (!m_modelCount)
 		return;
 
-	const SharedBufferData& argumentOutputSharedData = m_argumentOutputSharedData[frameIndex];
-	const SharedBufferData& counterSharedData        = m_counterSharedData[frameIndex];
+	const PagedBufferData& argumentOutputSharedData = m_argumentOutputSharedData[frameIndex];
+	const SharedBufferData& counterSharedData       = m_counterSharedData[frameIndex];
 
 	cmdList->ExecuteIndirect(
 		commandSignature, m_modelCount,
@@ -483,27 +486,27 @@ void PipelineModelsVSIndirect::Draw(
 }
 
 void PipelineModelsVSIndirect::RelinquishMemory(
-	std::vector<SharedBufferGPUWriteOnly>& argumentOutputSharedBuffers,
-	std::vector<SharedBufferGPUWriteOnly>& counterSharedBuffers
+	std::vector<SharedBufferPagedGPUWriteOnly>& argumentOutputSharedBuffers,
+	std::vector<SharedBufferSlabGPUWriteOnly>& counterSharedBuffers
 ) noexcept {
 	// Output Buffers
 	for (size_t index = 0u; index < std::size(m_argumentOutputSharedData); ++index)
 	{
-		SharedBufferGPUWriteOnly& argumentSharedBuffer = argumentOutputSharedBuffers[index];
-		SharedBufferData& argumentSharedData           = m_argumentOutputSharedData[index];
+		SharedBufferPagedGPUWriteOnly& argumentSharedBuffer = argumentOutputSharedBuffers[index];
+		PagedBufferData& argumentSharedData                 = m_argumentOutputSharedData[index];
 
 		if (argumentSharedData.bufferData)
 		{
 			argumentSharedBuffer.RelinquishMemory(argumentSharedData);
 
-			argumentSharedData = SharedBufferData{ nullptr, 0u, 0u };
+			argumentSharedData = PagedBufferData{ nullptr, 0u, 0u, 0u };
 		}
 	}
 
 	// Counter Shared Buffer
 	for (size_t index = 0u; index < std::size(m_counterSharedData); ++index)
 	{
-		SharedBufferGPUWriteOnly& counterSharedBuffer = counterSharedBuffers[index];
+		SharedBufferSlabGPUWriteOnly& counterSharedBuffer = counterSharedBuffers[index];
 		SharedBufferData& counterSharedData           = m_counterSharedData[index];
 
 		if (counterSharedData.bufferData)
@@ -579,10 +582,10 @@ void ModelBundleMSIndividual::DrawPipeline(
 
 // Model Bundle VS Indirect
 void ModelBundleVSIndirect::AddNewPipelinesFromBundle(
-	std::uint32_t modelBundleIndex, std::vector<SharedBufferCPU>& argumentInputSharedBuffers,
-	SharedBufferCPU& perPipelineSharedBuffer, SharedBufferCPU& perModelDataCSBuffer,
-	std::vector<SharedBufferGPUWriteOnly>& argumentOutputSharedBuffers,
-	std::vector<SharedBufferGPUWriteOnly>& counterSharedBuffers
+	std::uint32_t modelBundleIndex, std::vector<SharedBufferPagedCPU>& argumentInputSharedBuffers,
+	SharedBufferSlabCPU& perPipelineSharedBuffer, SharedBufferPagedCPU& perModelDataCSBuffer,
+	std::vector<SharedBufferPagedGPUWriteOnly>& argumentOutputSharedBuffers,
+	std::vector<SharedBufferSlabGPUWriteOnly>& counterSharedBuffers
 ) {
 	const size_t pipelinesInBundle    = m_modelBundle->GetPipelineCount();
 	const size_t currentPipelineCount = std::size(m_pipelines);
@@ -605,10 +608,10 @@ void ModelBundleVSIndirect::AddNewPipelinesFromBundle(
 }
 
 void ModelBundleVSIndirect::CleanupData(
-	std::vector<SharedBufferCPU>& argumentInputSharedBuffers,
-	SharedBufferCPU& perPipelineSharedBuffer, SharedBufferCPU& perModelDataCSBuffer,
-	std::vector<SharedBufferGPUWriteOnly>& argumentOutputSharedBuffers,
-	std::vector<SharedBufferGPUWriteOnly>& counterSharedBuffers
+	std::vector<SharedBufferPagedCPU>& argumentInputSharedBuffers,
+	SharedBufferSlabCPU& perPipelineSharedBuffer, SharedBufferPagedCPU& perModelDataCSBuffer,
+	std::vector<SharedBufferPagedGPUWriteOnly>& argumentOutputSharedBuffers,
+	std::vector<SharedBufferSlabGPUWriteOnly>& counterSharedBuffers
 ) noexcept {
 	const size_t pipelineCount = std::size(m_pipelines);
 
@@ -623,10 +626,10 @@ void ModelBundleVSIndirect::CleanupData(
 
 void ModelBundleVSIndirect::RemovePipeline(
 	size_t pipelineLocalIndex,
-	std::vector<SharedBufferCPU>& argumentInputSharedBuffers,
-	SharedBufferCPU& perPipelineSharedBuffer, SharedBufferCPU& perModelDataCSBuffer,
-	std::vector<SharedBufferGPUWriteOnly>& argumentOutputSharedBuffers,
-	std::vector<SharedBufferGPUWriteOnly>& counterSharedBuffers
+	std::vector<SharedBufferPagedCPU>& argumentInputSharedBuffers,
+	SharedBufferSlabCPU& perPipelineSharedBuffer, SharedBufferPagedCPU& perModelDataCSBuffer,
+	std::vector<SharedBufferPagedGPUWriteOnly>& argumentOutputSharedBuffers,
+	std::vector<SharedBufferSlabGPUWriteOnly>& counterSharedBuffers
 ) noexcept {
 	// CS
 	PipelineModelsCSIndirect& csPipeline = m_pipelines[pipelineLocalIndex];
@@ -666,10 +669,10 @@ size_t ModelBundleVSIndirect::GetLocalPipelineIndex(std::uint32_t pipelineIndex)
 void ModelBundleVSIndirect::ReconfigureModels(
 	std::uint32_t modelBundleIndex, std::uint32_t decreasedModelsPipelineIndex,
 	std::uint32_t increasedModelsPipelineIndex,
-	std::vector<SharedBufferCPU>& argumentInputSharedBuffers,
-	SharedBufferCPU& perPipelineSharedBuffer, SharedBufferCPU& perModelDataCSBuffer,
-	std::vector<SharedBufferGPUWriteOnly>& argumentOutputSharedBuffers,
-	std::vector<SharedBufferGPUWriteOnly>& counterSharedBuffers
+	std::vector<SharedBufferPagedCPU>& argumentInputSharedBuffers,
+	SharedBufferSlabCPU& perPipelineSharedBuffer, SharedBufferPagedCPU& perModelDataCSBuffer,
+	std::vector<SharedBufferPagedGPUWriteOnly>& argumentOutputSharedBuffers,
+	std::vector<SharedBufferSlabGPUWriteOnly>& counterSharedBuffers
 ) {
 	auto decreasedPipelineLocalIndex = std::numeric_limits<size_t>::max();
 	auto increasedPipelineLocalIndex = std::numeric_limits<std::uint32_t>::max();
@@ -762,10 +765,10 @@ size_t ModelBundleVSIndirect::FindAddableStartIndex(
 
 void ModelBundleVSIndirect::ResizePreviousPipelines(
 	size_t addableStartIndex, size_t pipelineLocalIndex, std::uint32_t modelBundleIndex,
-	std::vector<SharedBufferCPU>& argumentInputSharedBuffers,
-	SharedBufferCPU& perPipelineSharedBuffer, SharedBufferCPU& perModelDataCSBuffer,
-	std::vector<SharedBufferGPUWriteOnly>& argumentOutputSharedBuffers,
-	std::vector<SharedBufferGPUWriteOnly>& counterSharedBuffers
+	std::vector<SharedBufferPagedCPU>& argumentInputSharedBuffers,
+	SharedBufferSlabCPU& perPipelineSharedBuffer, SharedBufferPagedCPU& perModelDataCSBuffer,
+	std::vector<SharedBufferPagedGPUWriteOnly>& argumentOutputSharedBuffers,
+	std::vector<SharedBufferSlabGPUWriteOnly>& counterSharedBuffers
 ) {
 	const std::vector<PipelineModelBundle>& pipelines = m_modelBundle->GetPipelines();
 
@@ -788,10 +791,10 @@ void ModelBundleVSIndirect::ResizePreviousPipelines(
 
 void ModelBundleVSIndirect::RecreateFollowingPipelines(
 	size_t pipelineLocalIndex, std::uint32_t modelBundleIndex,
-	std::vector<SharedBufferCPU>& argumentInputSharedBuffers,
-	SharedBufferCPU& perPipelineSharedBuffer, SharedBufferCPU& perModelDataCSBuffer,
-	std::vector<SharedBufferGPUWriteOnly>& argumentOutputSharedBuffers,
-	std::vector<SharedBufferGPUWriteOnly>& counterSharedBuffers
+	std::vector<SharedBufferPagedCPU>& argumentInputSharedBuffers,
+	SharedBufferSlabCPU& perPipelineSharedBuffer, SharedBufferPagedCPU& perModelDataCSBuffer,
+	std::vector<SharedBufferPagedGPUWriteOnly>& argumentOutputSharedBuffers,
+	std::vector<SharedBufferSlabGPUWriteOnly>& counterSharedBuffers
 ) {
 	const size_t pipelineCount = std::size(m_pipelines);
 
@@ -826,10 +829,10 @@ void ModelBundleVSIndirect::RecreateFollowingPipelines(
 
 void ModelBundleVSIndirect::SetupPipelineBuffers(
 	std::uint32_t pipelineLocalIndex, std::uint32_t modelBundleIndex,
-	std::vector<SharedBufferCPU>& argumentInputSharedBuffers,
-	SharedBufferCPU& perPipelineSharedBuffer, SharedBufferCPU& perModelDataCSBuffer,
-	std::vector<SharedBufferGPUWriteOnly>& argumentOutputSharedBuffers,
-	std::vector<SharedBufferGPUWriteOnly>& counterSharedBuffers
+	std::vector<SharedBufferPagedCPU>& argumentInputSharedBuffers,
+	SharedBufferSlabCPU& perPipelineSharedBuffer, SharedBufferPagedCPU& perModelDataCSBuffer,
+	std::vector<SharedBufferPagedGPUWriteOnly>& argumentOutputSharedBuffers,
+	std::vector<SharedBufferSlabGPUWriteOnly>& counterSharedBuffers
 ) {
 	PipelineModelsCSIndirect& pipeline = m_pipelines[pipelineLocalIndex];
 
@@ -48,31 +48,49 @@ ModelManagerVSIndirect::ModelManagerVSIndirect(
 	ID3D12Device5* device, MemoryManager* memoryManager, std::uint32_t frameCount
 ) : ModelManager{},
 	m_argumentInputBuffers{}, m_argumentOutputBuffers{},
-	m_perPipelineBuffer{ device, memoryManager, D3D12_RESOURCE_STATE_GENERIC_READ },
+	m_perPipelineBuffer{
+		device, memoryManager, D3D12_RESOURCE_STATE_GENERIC_READ,
+		static_cast<UINT64>(sizeof(PipelineModelsCSIndirect::PerPipelineData))
+	},
 	m_counterBuffers{},
 	m_counterResetBuffer{ device, memoryManager, D3D12_HEAP_TYPE_UPLOAD },
 	m_perModelBundleBuffer{
 		device, memoryManager, frameCount, static_cast<std::uint32_t>(sizeof(PerModelBundleData))
 	},
-	m_perModelBuffer{ device, memoryManager, D3D12_RESOURCE_STATE_GENERIC_READ },
-	m_dispatchXCount{ 0u }, m_allocatedModelCount{ 0u }, m_csPSOIndex{ 0u }, m_constantsVSRootIndex{ 0u },
-	m_constantsCSRootIndex{ 0u }
+	// The pages of the argument input, argument output and the per model buffers have the same
+	// model count, so the allocations of a pipeline are on the same page and at the same model
+	// offset in all of them.
+	m_perModelBuffer{
+		device, memoryManager, D3D12_RESOURCE_STATE_GENERIC_READ,
+		static_cast<UINT64>(s_modelsPerPage * PipelineModelsCSIndirect::GetPerModelStride())
+	},
+	m_csPSOIndex{ 0u }, m_constantsVSRootIndex{ 0u }, m_constantsCSRootIndex{ 0u },
+	m_argumentInputRootIndex{ 0u }, m_argumentOutputRootIndex{ 0u }, m_perModelRootIndex{ 0u }
 {
 	for (size_t _ = 0u; _ < frameCount; ++_)
 	{
 		m_argumentInputBuffers.emplace_back(
-			SharedBufferCPU{ device, memoryManager, D3D12_RESOURCE_STATE_GENERIC_READ }
+			SharedBufferPagedCPU{
+				device, memoryManager, D3D12_RESOURCE_STATE_GENERIC_READ,
+				static_cast<UINT64>(
+					s_modelsPerPage * sizeof(PipelineModelsCSIndirect::IndirectArgument)
+				)
+			}
 		);
 		m_argumentOutputBuffers.emplace_back(
-			SharedBufferGPUWriteOnly{
+			SharedBufferPagedGPUWriteOnly{
 				device, memoryManager, D3D12_RESOURCE_STATE_COMMON,
+				static_cast<UINT64>(
+					s_modelsPerPage * sizeof(PipelineModelsCSIndirect::IndirectArgument)
+				),
 				D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS
 			}
 		);
 		// Doing the resetting on the Compute queue, so CG should be fine.
 		m_counterBuffers.emplace_back(
-			SharedBufferGPUWriteOnly{
+			SharedBufferSlabGPUWriteOnly{
 				device, memoryManager, D3D12_RESOURCE_STATE_COMMON,
+				PipelineModelsVSIndirect::GetCounterBufferSize(),
 				D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS
 			}
 		);
@@ -93,6 +111,17 @@ void ModelManagerVSIndirect::SetComputeConstantsRootIndex(
 	m_constantsVSRootIndex = descriptorManager.GetRootIndexCBV(
 		s_constantDataCSCBVRegisterSlot, constantsRegisterSpace
 	);
+
+	// The paged buffers are bound for each dispatch.
+	m_argumentInputRootIndex  = descriptorManager.GetRootIndexSRV(
+		s_argumentInputSRVRegisterSlot, constantsRegisterSpace
+	);
+	m_argumentOutputRootIndex = descriptorManager.GetRootIndexUAV(
+		s_argumenOutputUAVRegisterSlot, constantsRegisterSpace
+	);
+	m_perModelRootIndex       = descriptorManager.GetRootIndexSRV(
+		s_perModelSRVRegisterSlot, constantsRegisterSpace
+	);
 }
 
 void ModelManagerVSIndirect::ReconfigureModels(
@@ -106,24 +135,6 @@ void ModelManagerVSIndirect::ReconfigureModels(
 	);
 }
 
-void ModelManagerVSIndirect::UpdateAllocatedModelCount() noexcept
-{
-	// We can't reduce the amount of allocated model count, as we don't deallocate. We only
-	// make the memory available for something else. So, if a bundle from the middle is freed
-	// and we decrease the model count, then the last ones will be the ones which won't be rendered.
-	// Then again we can't also keep adding the newly added model count, as they might be allocated
-	// in some freed memory. We should set the model count to the total allocated model count, that
-	// way it won't skip the last ones and also not unnecessarily add extra ones.
-	m_allocatedModelCount = static_cast<UINT>(
-		m_perModelBuffer.Size() / PipelineModelsCSIndirect::GetPerModelStride()
-	);
-
-	// ThreadBlockSize is the number of threads in a thread group. If the allocated model count
-	// is more than the BlockSize then dispatch more groups. Ex: Threads 64, Model 60 = Group 1
-	// Threads 64, Model 65 = Group 2.
-	m_dispatchXCount = static_cast<UINT>(std::ceil(m_allocatedModelCount / THREADBLOCKSIZE));
-}
-
 std::uint32_t ModelManagerVSIndirect::AddModelBundle(std::shared_ptr<ModelBundle>&& modelBundle)
 {
 	const size_t bundleIndex  = m_modelBundles.Add(ModelBundleVSIndirect{});
@@ -142,8 +153,6 @@ std::uint32_t ModelManagerVSIndirect::AddModelBundle(std::shared_ptr<ModelBundle
 
 	m_perModelBundleBuffer.AllocateForIndex(bundleIndex);
 
-	UpdateAllocatedModelCount();
-
 	return bundleIndexU32;
 }
 
@@ -244,25 +253,14 @@ void ModelManagerVSIndirect::SetDescriptors(
 	{
 		D3DDescriptorManager& descriptorManager = descriptorManagers[index];
 
-		descriptorManager.SetRootSRV(
-			s_argumentInputSRVRegisterSlot, csRegisterSpace,
-			m_argumentInputBuffers[index].GetGPUAddress(), false
-		);
 		descriptorManager.SetRootSRV(
 			s_perPipelineSRVRegisterSlot, csRegisterSpace, m_perPipelineBuffer.GetGPUAddress(),
 			false
 		);
-		descriptorManager.SetRootUAV(
-			s_argumenOutputUAVRegisterSlot, csRegisterSpace,
-			m_argumentOutputBuffers[index].GetGPUAddress(), false
-		);
 		descriptorManager.SetRootUAV(
 			s_counterUAVRegisterSlot, csRegisterSpace, m_counterBuffers[index].GetGPUAddress(),
 			false
 		);
-		descriptorManager.SetRootSRV(
-			s_perModelSRVRegisterSlot, csRegisterSpace, m_perModelBuffer.GetGPUAddress(), false
-		);
 
 		m_perModelBundleBuffer.SetRootSRVCom(
 			descriptorManager, s_perModelBundleSRVRegisterSlot, csRegisterSpace
@@ -271,7 +269,8 @@ void ModelManagerVSIndirect::SetDescriptors(
 }
 
 void ModelManagerVSIndirect::Dispatch(
-	const D3DCommandList& computeList, const PipelineManager<ComputePipeline_t>& pipelineManager
+	size_t frameIndex, const D3DCommandList& computeList,
+	const PipelineManager<ComputePipeline_t>& pipelineManager
 ) const noexcept {
 	ID3D12GraphicsCommandList* cmdList      = computeList.Get();
 
@@ -280,20 +279,49 @@ void ModelManagerVSIndirect::Dispatch(
 
 	pipelineManager.BindPipeline(computePSOIndex, computeList);
 
+	const SharedBufferPagedCPU& argumentInputBuffer            = m_argumentInputBuffers[frameIndex];
+	const SharedBufferPagedGPUWriteOnly& argumentOutputBuffer = m_argumentOutputBuffers[frameIndex];
+	const size_t pageCount                                    = argumentInputBuffer.GetPageCount();
+
+	for (size_t pageIndex = 0u; pageIndex < pageCount; ++pageIndex)
 	{
-		constexpr UINT pushConstantCount = GetConstantCount();
+		cmdList->SetComputeRootShaderResourceView(
+			m_argumentInputRootIndex, argumentInputBuffer.GetPage(pageIndex).GetGPUAddress()
+		);
+		cmdList->SetComputeRootUnorderedAccessView(
+			m_argumentOutputRootIndex, argumentOutputBuffer.GetPage(pageIndex).GetGPUAddress()
+		);
+		cmdList->SetComputeRootShaderResourceView(
+			m_perModelRootIndex, m_perModelBuffer.GetPage(pageIndex).GetGPUAddress()
+		);
+
+		// The freed regions of a page aren't compacted, so all of the models which fit in the
+		// page are processed, otherwise the ones after a freed region would be skipped.
+		const auto allocatedModelCount = static_cast<UINT>(
+			m_perModelBuffer.GetPageAllocator().GetPageSize(pageIndex)
+			/ PipelineModelsCSIndirect::GetPerModelStride()
+		);
 
-		const ConstantData constantData
 		{
-			.allocatedModelCount = m_allocatedModelCount
-		};
+			constexpr UINT pushConstantCount = GetConstantCount();
+
+			const ConstantData constantData
+			{
+				.allocatedModelCount = allocatedModelCount
+			};
+
+			cmdList->SetComputeRoot32BitConstants(
+				m_constantsCSRootIndex, pushConstantCount, &constantData, 0u
+			);
+		}
 
-		cmdList->SetComputeRoot32BitConstants(
-			m_constantsCSRootIndex, pushConstantCount, &constantData, 0u
+		// ThreadBlockSize is the number of threads in a thread group. If the allocated model
+		// count is more than the BlockSize then dispatch more groups. Ex: Threads 64, Model 60
+		// = Group 1 Threads 64, Model 65 = Group 2.
+		cmdList->Dispatch(
+			static_cast<UINT>(std::ceil(allocatedModelCount / THREADBLOCKSIZE)), 1u, 1u
 		);
 	}
-
-	cmdList->Dispatch(m_dispatchXCount, 1u, 1u);
 }
 
 void ModelManagerVSIndirect::DrawPipeline(
@@ -320,7 +348,7 @@ void ModelManagerVSIndirect::DrawPipeline(
 void ModelManagerVSIndirect::ResetCounterBuffer(
 	const D3DCommandList& computeList, size_t frameIndex
 ) const noexcept {
-	const SharedBufferGPUWriteOnly& counterBuffer = m_counterBuffers[frameIndex];
+	const SharedBufferSlabGPUWriteOnly& counterBuffer = m_counterBuffers[frameIndex];
 
 	computeList.CopyWhole(m_counterResetBuffer, counterBuffer.GetBuffer());
 
@@ -333,11 +361,29 @@ void ModelManagerVSIndirect::ResetCounterBuffer(
 	).RecordBarriers(computeList.Get());
 }
 
+void ModelManagerVSIndirect::SetTraceRecorder(
+	AllocationTraceRecorder* traceRecorder, std::uint16_t firstBufferID
+) noexcept {
+	std::uint16_t bufferID = firstBufferID;
+
+	m_perPipelineBuffer.SetTraceRecorder(traceRecorder, bufferID++);
+	m_perModelBuffer.SetTraceRecorder(traceRecorder, bufferID++);
+
+	for (SharedBufferPagedCPU& argumentInputBuffer : m_argumentInputBuffers)
+		argumentInputBuffer.SetTraceRecorder(traceRecorder, bufferID++);
+
+	for (SharedBufferPagedGPUWriteOnly& argumentOutputBuffer : m_argumentOutputBuffers)
+		argumentOutputBuffer.SetTraceRecorder(traceRecorder, bufferID++);
+
+	for (SharedBufferSlabGPUWriteOnly& counterBuffer : m_counterBuffers)
+		counterBuffer.SetTraceRecorder(traceRecorder, bufferID++);
+}
+
 void ModelManagerVSIndirect::UpdateCounterResetValues()
 {
 	if (!std::empty(m_counterBuffers))
 	{
-		const SharedBufferGPUWriteOnly& counterBuffer = m_counterBuffers.front();
+		const SharedBufferSlabGPUWriteOnly& counterBuffer = m_counterBuffers.front();
 
 		const UINT64 counterBufferSize = counterBuffer.Size();
 		const UINT64 oldCounterSize    = m_counterResetBuffer.BufferSize();
@@ -12,13 +12,14 @@ RenderEngine::RenderEngine(
 RenderEngine::RenderEngine(
 	IDXGIAdapter3* adapter, ID3D12Device5* device, std::shared_ptr<ThreadPool> threadPool,
 	size_t frameCount
-) : m_threadPool{ std::move(threadPool) },
+) : m_threadPool{ std::move(threadPool) }, m_traceRecorder{},
 	m_memoryManager{ std::make_unique<MemoryManager>(adapter, device, 20_MB, 400_KB) },
 	// The fences will be initialised as 0. So, the starting value should be 1.
 	m_counterValues(frameCount, 0u),
 	m_graphicsQueue{}, m_graphicsWait{},
 	m_copyQueue{}, m_copyWait{},
-	m_stagingManager{ device, m_memoryManager.get(), m_threadPool.get()},
+	m_stagingManager{ device, m_memoryManager.get(), m_threadPool.get() },
+	m_uploadScheduler{}, m_uploadTracker{},
 	m_dsvHeap{
 		std::make_unique<D3DReusableDescriptorHeap>(
 			device, D3D12_DESCRIPTOR_HEAP_TYPE_DSV, D3D12_DESCRIPTOR_HEAP_FLAG_NONE
@@ -27,10 +28,12 @@ RenderEngine::RenderEngine(
 	m_graphicsDescriptorManagers{},
 	m_externalResourceManager{ device, m_memoryManager.get() },
 	m_graphicsRootSignature{},
-	m_textureStorage{ device, m_memoryManager.get() },
+	m_textureStorage{ device, m_memoryManager.get(), m_threadPool.get() },
 	m_textureManager{ device },
 	m_cameraManager{ device, m_memoryManager.get() },
 	m_viewportAndScissors{}, m_temporaryDataBuffer{}, m_renderPasses{}, m_swapchainRenderPass{},
+	m_memoryTelemetry{ m_threadPool.get() },
+	m_residencyManager{ adapter, device, ResidencyManager::GetDefaultSettings(frameCount) },
 	m_gpuCopyNecessary{ false }
 {
 	for (size_t _ = 0u; _ < frameCount; ++_)
@@ -75,6 +78,60 @@ void RenderEngine::UnbindTexture(size_t textureIndex, UINT bindingIndex)
 	m_textureManager.SetBindingAvailability<DescType>(bindingIndex, true);
 
 	m_textureStorage.SetTextureCacheDetails(static_cast<UINT>(textureIndex), localCacheIndex);
+
+	m_textureStorage.RemoveBinding(textureIndex);
+}
+
+void RenderEngine::UpdateResidency()
+{
+	const std::unordered_map<std::uint16_t, size_t> unboundTextureCounts
+		= m_textureStorage.GetUnboundTextureCounts();
+
+	std::vector<ResidencyManager::HeapUsage> heaps{};
+
+	// Only the GPU heaps are managed. The upload heaps are used by the CPU every frame and the
+	// MSAA heaps only have render targets.
+	m_memoryManager->ForEachAllocatorGroup(
+		[&](const D3DAllocatorGroup& allocators, D3D12_HEAP_TYPE heapType, bool msaa)
+		{
+			if (heapType != D3D12_HEAP_TYPE_DEFAULT || msaa)
+				return;
+
+			for (const D3DAllocator& allocator : allocators.GetAllocators())
+			{
+				const std::uint16_t memoryID     = allocator.GetID();
+				const size_t liveAllocationCount = std::size(allocator.GetLiveAllocations());
+
+				auto unboundTextureCount = unboundTextureCounts.find(memoryID);
+
+				// A heap is only evictable if all of its allocations are unbound textures. Nothing
+				// is evicted while there are pending copies, as they might write to the textures.
+				const bool isEvictable = !m_gpuCopyNecessary && !m_uploadScheduler.HasBacklog()
+					&& liveAllocationCount
+					&& unboundTextureCount != std::end(unboundTextureCounts)
+					&& unboundTextureCount->second == liveAllocationCount;
+
+				heaps.emplace_back(
+					ResidencyManager::HeapUsage
+					{
+						.heap        = allocator.GetHeap(),
+						.size        = allocator.Size(),
+						.memoryID    = memoryID,
+						.isEvictable = isEvictable,
+						.isResident  = !allocators.IsEvicted(memoryID)
+					}
+				);
+			}
+		}
+	);
+
+	const ResidencyManager::Changes changes = m_residencyManager.Update(heaps);
+
+	for (std::uint16_t memoryID : changes.evictedHeaps)
+		m_memoryManager->SetHeapEvicted(memoryID, D3D12_HEAP_TYPE_DEFAULT, true);
+
+	for (std::uint16_t memoryID : changes.residentHeaps)
+		m_memoryManager->SetHeapEvicted(memoryID, D3D12_HEAP_TYPE_DEFAULT, false);
 }
 
 void RenderEngine::UnbindExternalTexture(UINT bindingIndex)
@@ -133,13 +190,13 @@ void RenderEngine::UpdateExternalBufferDescriptor(
 	m_externalResourceManager.UpdateDescriptor(m_graphicsDescriptorManagers, bindingDetails);
 }
 
-void RenderEngine::UploadExternalBufferGPUOnlyData(
+UploadTicket RenderEngine::UploadExternalBufferGPUOnlyData(
 	std::uint32_t externalBufferIndex, std::shared_ptr<void> cpuData, size_t srcDataSizeInBytes,
 	size_t dstBufferOffset
 ) {
-	m_externalResourceManager.UploadExternalBufferGPUOnlyData(
-		m_stagingManager, m_temporaryDataBuffer,
-		externalBufferIndex, std::move(cpuData), srcDataSizeInBytes, dstBufferOffset
+	return m_externalResourceManager.UploadExternalBufferGPUOnlyData(
+		m_uploadScheduler, externalBufferIndex, std::move(cpuData), srcDataSizeInBytes,
+		dstBufferOffset
 	);
 }
 
@@ -119,6 +119,23 @@ std::uint32_t RenderEngineMS::AddMeshBundle(MeshBundleTemporaryData&& meshBundle
 {
 	WaitForGPUToFinish();
 
+	return AddMeshBundleAsync(std::move(meshBundle)).result;
+}
+
+std::vector<std::uint32_t> RenderEngineMS::AddMeshBundles(
+	std::vector<MeshBundleTemporaryData>&& meshBundles
+) {
+	WaitForGPUToFinish();
+
+	return AddMeshBundlesAsync(std::move(meshBundles)).result;
+}
+
+AsyncUpload<std::uint32_t> RenderEngineMS::AddMeshBundleAsync(
+	MeshBundleTemporaryData&& meshBundle
+) {
+	// The old mesh buffers are kept in the temporary data buffer and the root descriptors are
+	// only read while recording. And the regions of the removed bundles aren't reused until
+	// they have retired. So, the frames which are still running aren't affected.
 	const std::uint32_t index = m_meshManager.AddMeshBundle(
 		std::move(meshBundle), m_stagingManager, m_temporaryDataBuffer
 	);
@@ -127,7 +144,27 @@ std::uint32_t RenderEngineMS::AddMeshBundle(MeshBundleTemporaryData&& meshBundle
 
 	m_gpuCopyNecessary = true;
 
-	return index;
+	return AsyncUpload<std::uint32_t>{
+		.result = index,
+		.ticket = m_uploadScheduler.GetImmediateTicket()
+	};
+}
+
+AsyncUpload<std::vector<std::uint32_t>> RenderEngineMS::AddMeshBundlesAsync(
+	std::vector<MeshBundleTemporaryData>&& meshBundles
+) {
+	std::vector<std::uint32_t> indices = m_meshManager.AddMeshBundles(
+		std::move(meshBundles), m_stagingManager, m_temporaryDataBuffer
+	);
+
+	m_meshManager.SetDescriptors(m_graphicsDescriptorManagers, s_vertexShaderRegisterSpace);
+
+	m_gpuCopyNecessary = true;
+
+	return AsyncUpload<std::vector<std::uint32_t>>{
+		.result = std::move(indices),
+		.ticket = m_uploadScheduler.GetImmediateTicket()
+	};
 }
 
 ID3D12Fence* RenderEngineMS::GenericCopyStage(
@@ -137,9 +174,11 @@ ID3D12Fence* RenderEngineMS::GenericCopyStage(
 	// If the Copy stage isn't executed, pass the waitFence on.
 	ID3D12Fence* signalledFence = waitFence;
 
-	// Only execute this stage if copying is necessary.
-	if (m_gpuCopyNecessary)
+	// The uploads which didn't fit in the budget of the previous frames should be copied too.
+	if (m_gpuCopyNecessary || m_uploadScheduler.HasBacklog())
 	{
+		QueueScheduledUploads();
+
 		const D3DCommandList& copyCmdList = m_copyQueue.GetCommandList(frameIndex);
 
 		{
@@ -167,6 +206,10 @@ ID3D12Fence* RenderEngineMS::GenericCopyStage(
 			m_copyQueue.SubmitCommandLists(copySubmitBuilder);
 
 			m_temporaryDataBuffer.SetUsed(frameIndex);
+			m_stagingManager.SetUsed(copyWaitFence.Get(), counterValue);
+			m_uploadTracker.SetSubmitted(
+				copyWaitFence, counterValue, m_uploadScheduler.GetQueuedCounts()
+			);
 		}
 
 		m_gpuCopyNecessary = false;
@@ -119,11 +119,48 @@ std::uint32_t RenderEngineVSIndividual::AddMeshBundle(MeshBundleTemporaryData&&
 {
 	WaitForGPUToFinish();
 
-	m_gpuCopyNecessary = true;
+	return AddMeshBundleAsync(std::move(meshBundle)).result;
+}
+
+std::vector<std::uint32_t> RenderEngineVSIndividual::AddMeshBundles(
+	std::vector<MeshBundleTemporaryData>&& meshBundles
+) {
+	WaitForGPUToFinish();
+
+	return AddMeshBundlesAsync(std::move(meshBundles)).result;
+}
 
-	return m_meshManager.AddMeshBundle(
+AsyncUpload<std::uint32_t> RenderEngineVSIndividual::AddMeshBundleAsync(
+	MeshBundleTemporaryData&& meshBundle
+) {
+	// The vertex and index buffers are bound while recording and the old ones are kept in the
+	// temporary data buffer. And the regions of the removed bundles aren't reused until they
+	// have retired. So, the frames which are still running aren't affected.
+	const std::uint32_t index = m_meshManager.AddMeshBundle(
 		std::move(meshBundle), m_stagingManager, m_temporaryDataBuffer
 	);
+
+	m_gpuCopyNecessary = true;
+
+	return AsyncUpload<std::uint32_t>{
+		.result = index,
+		.ticket = m_uploadScheduler.GetImmediateTicket()
+	};
+}
+
+AsyncUpload<std::vector<std::uint32_t>> RenderEngineVSIndividual::AddMeshBundlesAsync(
+	std::vector<MeshBundleTemporaryData>&& meshBundles
+) {
+	std::vector<std::uint32_t> indices = m_meshManager.AddMeshBundles(
+		std::move(meshBundles), m_stagingManager, m_temporaryDataBuffer
+	);
+
+	m_gpuCopyNecessary = true;
+
+	return AsyncUpload<std::vector<std::uint32_t>>{
+		.result = std::move(indices),
+		.ticket = m_uploadScheduler.GetImmediateTicket()
+	};
 }
 
 ID3D12Fence* RenderEngineVSIndividual::GenericCopyStage(
@@ -133,8 +170,11 @@ ID3D12Fence* RenderEngineVSIndividual::GenericCopyStage(
 	// If the Copy stage isn't executed, pass the waitFence on.
 	ID3D12Fence* signalledFence = waitFence;
 
-	if (m_gpuCopyNecessary)
+	// The uploads which didn't fit in the budget of the previous frames should be copied too.
+	if (m_gpuCopyNecessary || m_uploadScheduler.HasBacklog())
 	{
+		QueueScheduledUploads();
+
 		const D3DCommandList& copyCmdList = m_copyQueue.GetCommandList(frameIndex);
 
 		{
@@ -162,6 +202,10 @@ ID3D12Fence* RenderEngineVSIndividual::GenericCopyStage(
 			m_copyQueue.SubmitCommandLists(copySubmitBuilder);
 
 			m_temporaryDataBuffer.SetUsed(frameIndex);
+			m_stagingManager.SetUsed(copyWaitFence.Get(), counterValue);
+			m_uploadTracker.SetSubmitted(
+				copyWaitFence, counterValue, m_uploadScheduler.GetQueuedCounts()
+			);
 		}
 
 		m_gpuCopyNecessary = false;
@@ -609,6 +653,21 @@ std::uint32_t RenderEngineVSIndirect::AddMeshBundle(MeshBundleTemporaryData&& me
 {
 	WaitForGPUToFinish();
 
+	return AddMeshBundleAsync(std::move(meshBundle)).result;
+}
+
+std::vector<std::uint32_t> RenderEngineVSIndirect::AddMeshBundles(
+	std::vector<MeshBundleTemporaryData>&& meshBundles
+) {
+	WaitForGPUToFinish();
+
+	return AddMeshBundlesAsync(std::move(meshBundles)).result;
+}
+
+AsyncUpload<std::uint32_t> RenderEngineVSIndirect::AddMeshBundleAsync(
+	MeshBundleTemporaryData&& meshBundle
+) {
+	// The mesh descriptors of the compute pass are root descriptors as well.
 	const std::uint32_t index = m_meshManager.AddMeshBundle(
 		std::move(meshBundle), m_stagingManager, m_temporaryDataBuffer
 	);
@@ -617,7 +676,27 @@ std::uint32_t RenderEngineVSIndirect::AddMeshBundle(MeshBundleTemporaryData&& me
 
 	m_gpuCopyNecessary = true;
 
-	return index;
+	return AsyncUpload<std::uint32_t>{
+		.result = index,
+		.ticket = m_uploadScheduler.GetImmediateTicket()
+	};
+}
+
+AsyncUpload<std::vector<std::uint32_t>> RenderEngineVSIndirect::AddMeshBundlesAsync(
+	std::vector<MeshBundleTemporaryData>&& meshBundles
+) {
+	std::vector<std::uint32_t> indices = m_meshManager.AddMeshBundles(
+		std::move(meshBundles), m_stagingManager, m_temporaryDataBuffer
+	);
+
+	m_meshManager.SetDescriptorsCS(m_computeDescriptorManagers, s_computeShaderRegisterSpace);
+
+	m_gpuCopyNecessary = true;
+
+	return AsyncUpload<std::vector<std::uint32_t>>{
+		.result = std::move(indices),
+		.ticket = m_uploadScheduler.GetImmediateTicket()
+	};
 }
 
 ID3D12Fence* RenderEngineVSIndirect::GenericCopyStage(
@@ -627,8 +706,11 @@ ID3D12Fence* RenderEngineVSIndirect::GenericCopyStage(
 	// If the Copy stage isn't executed, pass the waitFence on.
 	ID3D12Fence* signalledFence = waitFence;
 
-	if (m_gpuCopyNecessary)
+	// The uploads which didn't fit in the budget of the previous frames should be copied too.
+	if (m_gpuCopyNecessary || m_uploadScheduler.HasBacklog())
 	{
+		QueueScheduledUploads();
+
 		const D3DCommandList& copyCmdList = m_copyQueue.GetCommandList(frameIndex);
 
 		{
@@ -656,6 +738,10 @@ ID3D12Fence* RenderEngineVSIndirect::GenericCopyStage(
 			m_copyQueue.SubmitCommandLists(copySubmitBuilder);
 
 			m_temporaryDataBuffer.SetUsed(frameIndex);
+			m_stagingManager.SetUsed(copyWaitFence.Get(), counterValue);
+			m_uploadTracker.SetSubmitted(
+				copyWaitFence, counterValue, m_uploadScheduler.GetQueuedCounts()
+			);
 		}
 
 		m_gpuCopyNecessary = false;
@@ -682,7 +768,7 @@ ID3D12Fence* RenderEngineVSIndirect::FrustumCullingStage(
 
 		m_computeDescriptorManagers[frameIndex].BindDescriptors(computeCmdListScope);
 
-		m_modelManager.Dispatch(computeCmdListScope, m_computePipelineManager);
+		m_modelManager.Dispatch(frameIndex, computeCmdListScope, m_computePipelineManager);
 	}
 
 	const D3DFence& computeWaitFence = m_computeWait[frameIndex];
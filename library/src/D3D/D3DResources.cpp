@@ -1,5 +1,4 @@
 #include <D3DResources.hpp>
-#include <unordered_map>
 #include <cassert>
 #include <GaiaException.hpp>
 
@@ -40,6 +39,19 @@ void Resource::Allocate(const D3D12_RESOURCE_DESC& resourceDesc, bool msaa)
 		throw Exception("MemoryManager Exception", "Memory manager unavailable.");
 }
 
+bool Resource::AllocateAt(
+	const D3D12_RESOURCE_DESC& resourceDesc, std::uint16_t memoryID, UINT64 heapOffset, bool msaa
+) {
+	if (!m_memoryManager)
+		throw Exception("MemoryManager Exception", "Memory manager unavailable.");
+
+	m_allocationInfo = m_memoryManager->AllocateAt(
+		resourceDesc, m_resourceType, memoryID, heapOffset, msaa
+	);
+
+	return m_allocationInfo.isValid;
+}
+
 void Resource::Deallocate(bool msaa) noexcept
 {
 	if (m_memoryManager && m_allocationInfo.isValid)
@@ -72,11 +84,9 @@ Buffer::~Buffer() noexcept
 	SelfDestruct();
 }
 
-void Buffer::Create(
-	UINT64 bufferSize, D3D12_RESOURCE_STATES initialState,
-	D3D12_RESOURCE_FLAGS flags /* = D3D12_RESOURCE_FLAG_NONE */
-) {
-	D3D12_RESOURCE_DESC bufferDesc
+D3D12_RESOURCE_DESC Buffer::GetBufferDesc(UINT64 bufferSize, D3D12_RESOURCE_FLAGS flags) noexcept
+{
+	return D3D12_RESOURCE_DESC
 	{
 		.Dimension        = D3D12_RESOURCE_DIMENSION_BUFFER,
 		.Alignment        = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT,
@@ -89,19 +99,48 @@ void Buffer::Create(
 		.Layout           = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
 		.Flags            = flags
 	};
+}
+
+void Buffer::Create(
+	UINT64 bufferSize, D3D12_RESOURCE_STATES initialState,
+	D3D12_RESOURCE_FLAGS flags /* = D3D12_RESOURCE_FLAG_NONE */
+) {
+	const D3D12_RESOURCE_DESC bufferDesc = GetBufferDesc(bufferSize, flags);
 
 	// If the buffer pointer is already allocated, then free it.
 	Destroy();
 
 	Allocate(bufferDesc, false);
 
+	CreatePlacedBuffer(bufferDesc, initialState);
+}
+
+bool Buffer::CreateAt(
+	UINT64 bufferSize, D3D12_RESOURCE_STATES initialState, std::uint16_t memoryID,
+	UINT64 heapOffset, D3D12_RESOURCE_FLAGS flags /* = D3D12_RESOURCE_FLAG_NONE */
+) {
+	const D3D12_RESOURCE_DESC bufferDesc = GetBufferDesc(bufferSize, flags);
+
+	Destroy();
+
+	if (!AllocateAt(bufferDesc, memoryID, heapOffset, false))
+		return false;
+
+	CreatePlacedBuffer(bufferDesc, initialState);
+
+	return true;
+}
+
+void Buffer::CreatePlacedBuffer(
+	const D3D12_RESOURCE_DESC& bufferDesc, D3D12_RESOURCE_STATES initialState
+) {
 	CreatePlacedResource(bufferDesc, initialState, nullptr);
 
 	// If the buffer is of the type Upload, map the buffer to the cpu handle.
 	if (GetHeapType() == D3D12_HEAP_TYPE_UPLOAD)
 		m_resource->Map(0u, nullptr, reinterpret_cast<void**>(&m_cpuHandle));
 
-	m_bufferSize = bufferSize;
+	m_bufferSize = bufferDesc.Width;
 }
 
 void Buffer::Destroy() noexcept
@@ -188,6 +227,13 @@ void Texture::Create(
 	m_format    = textureFormat;
 	m_msaa      = msaa;
 
+	// The top mip of a block compressed texture must consist of whole blocks.
+	assert(
+		!IsBlockCompressed(textureFormat)
+		|| (!msaa && width % 4u == 0u && height % 4u == 0u)
+		&& "A block compressed texture must be a multiple of 4 and can't be multi sampled."
+	);
+
 	const UINT64 textureAlignment = msaa ?
 		D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT : D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
 
@@ -324,46 +370,20 @@ D3D12_UNORDERED_ACCESS_VIEW_DESC Texture::GetUAVDesc(UINT mipSlice/* = 0u */) co
 	return uavDesc;
 }
 
-UINT64 Texture::GetRowPitch() const noexcept
+UINT64 Texture::GetRowPitch(UINT mipLevelIndex /* = 0u */) const noexcept
 {
-	// For example: R8G8B8A8 has 4 components, 8bits at each component. So, 4bytes.
-	const static std::unordered_map<DXGI_FORMAT, UINT> formatSizeMap
-	{
-		{ DXGI_FORMAT_R8G8B8A8_TYPELESS,    4u },
-		{ DXGI_FORMAT_R8G8B8A8_UNORM,       4u },
-		{ DXGI_FORMAT_R8G8B8A8_SNORM,       4u },
-		{ DXGI_FORMAT_R8G8B8A8_UINT,        4u },
-		{ DXGI_FORMAT_R8G8B8A8_SINT,        4u },
-		{ DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,  4u },
-		{ DXGI_FORMAT_B8G8R8A8_TYPELESS,    4u },
-		{ DXGI_FORMAT_B8G8R8A8_UNORM,       4u },
-		{ DXGI_FORMAT_B8G8R8A8_UNORM_SRGB,  4u }
-	};
-
-	const DXGI_FORMAT textureFormat = Format();
-
 	// Not bothering with adding the size of every single colour format. If a format size isn't
-	// defined here, then 0 will be returned.
-	UINT64 rowPitch                 = 0u;
-
-	auto formatSize = formatSizeMap.find(textureFormat);
-
+	// defined, then 0 will be returned.
 	assert(
-		formatSize != std::end(formatSizeMap)
-		&& "Texture format isn't available in the FormatSizeMap."
+		GetTextureFormatInfo(Format()).bytesPerBlock
+		&& "Texture format isn't available in the format info."
 	);
 
-	if (formatSize != std::end(formatSizeMap))
-	{
-		const UINT64 sizePerPixel = formatSize->second;
-		rowPitch                  = m_width * sizePerPixel;
-	}
-
-	return rowPitch;
+	return GetTextureRowPitch(Format(), GetMipWidth(mipLevelIndex));
 }
 
-UINT64 Texture::GetRowPitchD3DAligned() const noexcept
+UINT64 Texture::GetRowPitchD3DAligned(UINT mipLevelIndex /* = 0u */) const noexcept
 {
-	return Callisto::Align(GetRowPitch(), D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
+	return Callisto::Align(GetRowPitch(mipLevelIndex), D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
 }
 }
@@ -40,9 +40,8 @@ void SharedBufferGPU::CreateBuffer(UINT64 size, Callisto::TemporaryDataBufferGPU
 UINT64 SharedBufferGPU::ExtendBuffer(UINT64 size, Callisto::TemporaryDataBufferGPU& tempBuffer)
 {
 	// I probably don't need to worry about aligning here, since it's all inside a single buffer?
-	const UINT64 oldSize = m_buffer.BufferSize();
-	const UINT64 offset  = oldSize;
-	const UINT64 newSize = oldSize + size;
+	const UINT64 oldSize         = m_buffer.BufferSize();
+	const auto [offset, newSize] = GetBufferExtension(size);
 
 	// If the alignment is 16bytes, at least 16bytes will be allocated. If the requested size
 	// is bigger, then there shouldn't be any issues. But if the requested size is smaller,
@@ -54,36 +53,270 @@ UINT64 SharedBufferGPU::ExtendBuffer(UINT64 size, Callisto::TemporaryDataBufferG
 	return offset;
 }
 
+bool SharedBufferGPU::Reserve(
+	std::span<const UINT64> sizes, Callisto::TemporaryDataBufferGPU& tempBuffer
+) {
+	const UINT64 oldSize = m_buffer.BufferSize();
+	const UINT64 newSize = GetReservedSize(sizes);
+
+	if (newSize <= oldSize)
+		return false;
+
+	// The free regions must end up the same as they were when the size was reserved.
+	const UINT64 offset = m_allocator.RemoveTrailingRegion(oldSize).value_or(oldSize);
+
+	m_allocator.Deallocate(offset, newSize - offset);
+
+	CreateBuffer(newSize, tempBuffer);
+
+	return true;
+}
+
+bool SharedBufferGPU::RelocateTo(
+	std::uint16_t memoryID, UINT64 heapOffset, Callisto::TemporaryDataBufferGPU& tempBuffer
+) {
+	if (!m_buffer.Get() || m_oldBuffer)
+		return false;
+
+	Buffer newBuffer = GetGPUResource<Buffer>(m_device, m_memoryManager);
+
+	if (!newBuffer.CreateAt(m_buffer.BufferSize(), m_resourceState, memoryID, heapOffset))
+		return false;
+
+	m_oldBuffer = std::make_shared<Buffer>(std::move(m_buffer));
+	tempBuffer.Add(m_oldBuffer);
+
+	m_buffer = std::move(newBuffer);
+
+	return true;
+}
+
+void SharedBufferGPU::CancelRelocation() noexcept
+{
+	if (!m_oldBuffer)
+		return;
+
+	// The temp buffer keeps the moved from object, which doesn't own anything anymore.
+	m_buffer = std::move(*m_oldBuffer);
+
+	m_oldBuffer.reset();
+}
+
 void SharedBufferGPU::CopyOldBuffer(const D3DCommandList& copyList) noexcept
 {
+	std::shared_ptr<Buffer> moveBuffer = std::move(m_moveBuffer);
+
 	if (m_oldBuffer)
 	{
 		// The temp buffer should get promoted to COPY_SRC and the new buffer
 		// to COPY_DST and then get decayed to COMMON afterwards and then
 		// to the desired state.
 		std::shared_ptr<Buffer> oldBuffer = std::move(m_oldBuffer);
-		copyList.CopyWhole(*oldBuffer, m_buffer);
+
+		// The buffer might have been shrunk, in which case the old one is bigger.
+		const UINT64 copySize = std::min(oldBuffer->BufferSize(), m_buffer.BufferSize());
+
+		// If the buffer was recreated after some regions were moved, the moved regions are
+		// copied from the old buffer and the rest is copied around their destinations, so
+		// none of the copies overlap.
+		std::ranges::sort(
+			m_pendingMoves,
+			[](const BufferCompactionPlanner::Move& lhs, const BufferCompactionPlanner::Move& rhs)
+			{
+				return lhs.dstOffset < rhs.dstOffset;
+			}
+		);
+
+		UINT64 copyStart = 0u;
+
+		for (const BufferCompactionPlanner::Move& move : m_pendingMoves)
+		{
+			if (move.dstOffset > copyStart)
+				copyList.Copy(
+					*oldBuffer, copyStart, m_buffer, copyStart, move.dstOffset - copyStart
+				);
+
+			copyList.Copy(*oldBuffer, move.srcOffset, m_buffer, move.dstOffset, move.size);
+
+			copyStart = move.dstOffset + move.size;
+		}
+
+		if (copySize > copyStart)
+			copyList.Copy(*oldBuffer, copyStart, m_buffer, copyStart, copySize - copyStart);
 	}
+	else if (moveBuffer && !std::empty(m_pendingMoves))
+	{
+		UINT64 moveOffset = 0u;
+
+		for (const BufferCompactionPlanner::Move& move : m_pendingMoves)
+		{
+			copyList.Copy(m_buffer, move.srcOffset, *moveBuffer, moveOffset, move.size);
+
+			moveOffset += move.size;
+		}
+
+		// Both buffers were promoted by the first copies, so they must be transitioned for the
+		// copies back.
+		copyList.AddBarrier(
+			D3DResourceBarrier<2u>{}
+			.AddBarrier(
+				ResourceBarrierBuilder{}
+				.Transition(
+					m_buffer.Get(),
+					D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_COPY_DEST
+				)
+			).AddBarrier(
+				ResourceBarrierBuilder{}
+				.Transition(
+					moveBuffer->Get(),
+					D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_COPY_SOURCE
+				)
+			)
+		);
+
+		moveOffset = 0u;
+
+		for (const BufferCompactionPlanner::Move& move : m_pendingMoves)
+		{
+			copyList.Copy(*moveBuffer, moveOffset, m_buffer, move.dstOffset, move.size);
+
+			moveOffset += move.size;
+		}
+	}
+
+	m_pendingMoves.clear();
 }
 
-SharedBufferData SharedBufferGPU::AllocateAndGetSharedData(
-	UINT64 size, Callisto::TemporaryDataBufferGPU& tempBuffer
+std::vector<BufferCompactionPlanner::Move> SharedBufferGPU::MoveRegions(
+	UINT64 byteBudget, Callisto::TemporaryDataBufferGPU& tempBuffer
 ) {
-	auto availableAllocIndex = m_allocator.GetAvailableAllocInfo(size);
+	if (!m_buffer.Get() || m_oldBuffer || !std::empty(m_pendingMoves))
+		return {};
+
+	BufferCompactionPlanner::Plan plan = BufferCompactionPlanner::CreatePlan(
+		m_allocator.GetFreeRegions(), m_liveAllocations, byteBudget
+	);
 
-	Callisto::SharedBufferAllocator::AllocInfo allocInfo{ .offset = 0u, .size = 0u };
+	if (std::empty(plan.moves))
+		return {};
 
-	if (!availableAllocIndex)
+	// The destinations are free, so they have already retired and none of the frames in flight
+	// can read them. The sources are still being read, so they must retire first.
+	UINT64 movedSize = 0u;
+
+	for (const BufferCompactionPlanner::Move& move : plan.moves)
+	{
+		[[maybe_unused]] const bool isAllocated = m_allocator.AllocateAt(
+			move.dstOffset, move.size
+		);
+
+		assert(isAllocated && "The destination region isn't free.");
+
+		movedSize += move.size;
+	}
+
+	for (const BufferCompactionPlanner::Move& move : plan.moves)
 	{
-		allocInfo.size   = size;
-		allocInfo.offset = ExtendBuffer(size, tempBuffer);
+		RelinquishMemory(
+			SharedBufferData
+			{
+				.bufferData = &m_buffer,
+				.offset     = move.srcOffset,
+				.size       = move.size
+			}
+		);
+		AddLiveAllocation(move.dstOffset, move.size);
+	}
+
+	m_moveBuffer = std::make_shared<Buffer>(GetGPUResource<Buffer>(m_device, m_memoryManager));
+	m_moveBuffer->Create(movedSize, D3D12_RESOURCE_STATE_COMMON);
+
+	tempBuffer.Add(m_moveBuffer);
+
+	m_pendingMoves.insert(std::end(m_pendingMoves), std::begin(plan.moves), std::end(plan.moves));
+
+	return std::move(plan.moves);
+}
+
+void SharedBufferGPU::RelinquishMemory(const SharedBufferData& sharedData) noexcept
+{
+	RemoveLiveAllocation(sharedData.offset, sharedData.size);
+
+	if (sharedData.size)
+		m_retiringRegions.emplace_back(
+			RetiringRegion
+			{
+				.offset      = sharedData.offset,
+				.size        = sharedData.size,
+				.frameNumber = m_frameNumber
+			}
+		);
+}
+
+void SharedBufferGPU::ReleaseRetiredRegions(size_t frameCount) noexcept
+{
+	++m_frameNumber;
+
+	// The regions are in the order they were relinquished.
+	while (!std::empty(m_retiringRegions)
+		&& m_frameNumber - m_retiringRegions.front().frameNumber >= frameCount)
+	{
+		const RetiringRegion& retiringRegion = m_retiringRegions.front();
+
+		m_allocator.Deallocate(retiringRegion.offset, retiringRegion.size);
+
+		m_retiringRegions.pop_front();
 	}
-	else
-		allocInfo = m_allocator.GetAndRemoveAllocInfo(*availableAllocIndex);
+}
+
+bool SharedBufferGPU::Shrink(Callisto::TemporaryDataBufferGPU& tempBuffer)
+{
+	// The moves must be copied in the current buffer first.
+	if (!m_buffer.Get() || m_oldBuffer || !std::empty(m_pendingMoves))
+		return false;
+
+	const UINT64 oldSize = m_buffer.BufferSize();
+	UINT64 usedEnd       = BufferCompactionPlanner::GetUsedEnd(m_liveAllocations);
+
+	// The retiring regions will be freed later, so they must still be in the new buffer.
+	for (const RetiringRegion& retiringRegion : m_retiringRegions)
+		usedEnd = std::max(usedEnd, retiringRegion.offset + retiringRegion.size);
+	const UINT64 newSize = m_growthPolicy.GetNewSize(0u, usedEnd);
+
+	if (!newSize || usedEnd > oldSize / 2u || newSize >= oldSize)
+		return false;
+
+	const std::optional<UINT64> trailingOffset = m_allocator.RemoveTrailingRegion(oldSize);
+
+	if (!trailingOffset)
+		return false;
+
+	// The rest of the new size is still free.
+	if (*trailingOffset < newSize)
+		m_allocator.Deallocate(*trailingOffset, newSize - *trailingOffset);
+
+	CreateBuffer(newSize, tempBuffer);
+
+	return true;
+}
+
+SharedBufferData SharedBufferGPU::AllocateAndGetSharedData(
+	UINT64 size, Callisto::TemporaryDataBufferGPU& tempBuffer
+) {
+	// An empty allocation doesn't need a region, so it must never extend the buffer.
+	if (!size)
+		return SharedBufferData{ .bufferData = &m_buffer, .offset = 0u, .size = 0u };
+
+	std::optional<UINT64> offset = m_allocator.Allocate(size);
+
+	if (!offset)
+		offset = ExtendBuffer(size, tempBuffer);
+
+	AddLiveAllocation(*offset, size);
 
 	return SharedBufferData{
 		.bufferData = &m_buffer,
-		.offset     = m_allocator.AllocateMemory(allocInfo, size),
+		.offset     = *offset,
 		.size       = size
 	};
 }
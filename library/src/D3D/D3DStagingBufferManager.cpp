@@ -2,34 +2,39 @@
 #include <ranges>
 #include <algorithm>
 #include <cassert>
+#include <functional>
 
 namespace Gaia
 {
-StagingBufferManager& StagingBufferManager::AddTexture(
-	std::shared_ptr<void> cpuData, Texture const* dst,
-	Callisto::TemporaryDataBufferGPU& tempDataBuffer, UINT mipLevelIndex/* = 0u */
+StagingBufferManager& StagingBufferManager::AddTextureRows(
+	std::shared_ptr<void> cpuData, Texture const* dst, UINT firstRow, UINT rowCount,
+	Callisto::TemporaryDataBufferGPU& tempDataBuffer, UINT mipLevelIndex/* = 0u */,
+	RepackMode repackMode/* = RepackMode::Copy */
 ) {
-	const UINT64 bufferSize = dst->GetBufferSize();
+	assert(
+		firstRow + rowCount <= dst->GetMipRowCount(mipLevelIndex)
+		&& "The rows are out of the texture."
+	);
+
+	const UINT64 bufferSize = dst->GetRowPitchD3DAligned(mipLevelIndex) * rowCount
+		* dst->GetMipDepth(mipLevelIndex);
 
 	m_textureInfo.emplace_back(
 		TextureInfo{
 			.cpuHandle     = cpuData.get(),
 			.bufferSize    = bufferSize,
 			.dst           = dst,
-			.mipLevelIndex = mipLevelIndex
+			.mipLevelIndex = mipLevelIndex,
+			.src           = CreateDedicatedBuffer(bufferSize, tempDataBuffer),
+			.srcOffset     = 0u,
+			.repackMode    = repackMode,
+			.firstRow      = firstRow,
+			.rowCount      = rowCount
 		}
 	);
 
 	m_cpuTempBuffer.Add(std::move(cpuData));
 
-	auto tempBuffer = std::make_shared<Buffer>(m_device, m_memoryManager, D3D12_HEAP_TYPE_UPLOAD);
-
-	m_tempBufferToTexture.emplace_back(tempBuffer);
-
-	tempBuffer->Create(bufferSize, D3D12_RESOURCE_STATE_GENERIC_READ);
-
-	tempDataBuffer.Add(std::move(tempBuffer));
-
 	return *this;
 }
 
@@ -42,186 +47,312 @@ StagingBufferManager& StagingBufferManager::AddBuffer(
 			.cpuHandle  = cpuData.get(),
 			.bufferSize = bufferSize,
 			.dst        = dst,
-			.offset     = offset
+			.offset     = offset,
+			.src        = CreateDedicatedBuffer(bufferSize, tempDataBuffer),
+			.srcOffset  = 0u
 		}
 	);
 
 	m_cpuTempBuffer.Add(std::move(cpuData));
 
-	auto tempBuffer = std::make_shared<Buffer>(m_device, m_memoryManager, D3D12_HEAP_TYPE_UPLOAD);
+	return *this;
+}
 
-	m_tempBufferToBuffer.emplace_back(tempBuffer);
+StagingBufferManager::Reservation StagingBufferManager::Reserve(
+	UINT64 bufferSize, UINT64 alignment, Callisto::TemporaryDataBufferGPU& tempDataBuffer
+) {
+	Buffer const* src = CreateDedicatedBuffer(bufferSize, tempDataBuffer);
+	UINT64 srcOffset  = 0u;
 
-	tempBuffer->Create(bufferSize, D3D12_RESOURCE_STATE_GENERIC_READ);
+	if (!src)
+	{
+		const UploadRingAllocator::Allocation allocation = m_uploadRing.Allocate(
+			bufferSize, alignment
+		);
 
-	tempDataBuffer.Add(std::move(tempBuffer));
+		src       = allocation.buffer;
+		srcOffset = allocation.offset;
+	}
 
-	return *this;
-}
+	++m_reservationCount;
 
-void StagingBufferManager::CopyCPU()
-{
-	struct Batch
+	return Reservation
 	{
-		size_t startIndex;
-		size_t endIndex;
+		.data      = std::span<std::uint8_t>{ src->CPUHandle() + srcOffset, bufferSize },
+		.src       = src,
+		.srcOffset = srcOffset
 	};
+}
 
-	// Making these static, so dynamic allocation happens less.
-	static std::vector<std::future<void>>     waitObjs{};
-	static std::vector<std::function<void()>> tasks{};
-	static std::vector<Batch>                 batches{};
+StagingBufferManager::Reservation StagingBufferManager::ReserveBuffer(
+	UINT64 bufferSize, Callisto::TemporaryDataBufferGPU& tempDataBuffer
+) {
+	return Reserve(bufferSize, 16u, tempDataBuffer);
+}
 
-	static constexpr size_t batchSize = 250_MB;
+StagingBufferManager::Reservation StagingBufferManager::ReserveTexture(
+	Texture const* dst, Callisto::TemporaryDataBufferGPU& tempDataBuffer,
+	UINT mipLevelIndex/* = 0u */
+) {
+	return Reserve(
+		dst->GetBufferSize(mipLevelIndex), D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, tempDataBuffer
+	);
+}
 
-	Batch tempBatch{ .startIndex = 0u, .endIndex = 0u };
-	size_t currentBatchSize = 0u;
+StagingBufferManager& StagingBufferManager::CommitBuffer(
+	const Reservation& reservation, Buffer const* dst, UINT64 offset
+) {
+	assert(m_reservationCount && "There isn't any reservation to commit.");
 
-	{
-		for (size_t index = 0u; index < std::size(m_bufferInfo); ++index)
-		{
-			const BufferInfo& bufferInfo = m_bufferInfo[index];
+	--m_reservationCount;
 
-			tasks.emplace_back([&bufferInfo, &tempBuffer = m_tempBufferToBuffer[index]]
-				{
-					memcpy(tempBuffer->CPUHandle(), bufferInfo.cpuHandle, bufferInfo.bufferSize);
-				});
+	m_bufferInfo.emplace_back(
+		BufferInfo{
+			.cpuHandle  = nullptr,
+			.bufferSize = static_cast<UINT64>(std::size(reservation.data)),
+			.dst        = dst,
+			.offset     = offset,
+			.src        = reservation.src,
+			.srcOffset  = reservation.srcOffset
+		}
+	);
 
-			currentBatchSize += bufferInfo.bufferSize;
+	return *this;
+}
 
-			if (currentBatchSize >= batchSize)
-			{
-				currentBatchSize   = 0u;
+StagingBufferManager& StagingBufferManager::CommitTexture(
+	const Reservation& reservation, Texture const* dst, UINT mipLevelIndex/* = 0u */
+) {
+	assert(m_reservationCount && "There isn't any reservation to commit.");
 
-				tempBatch.endIndex = index;
-				batches.emplace_back(tempBatch);
+	--m_reservationCount;
 
-				tempBatch.startIndex = index + 1u;
-				tempBatch.endIndex   = tempBatch.startIndex;
-			}
+	m_textureInfo.emplace_back(
+		TextureInfo{
+			.cpuHandle     = nullptr,
+			.bufferSize    = static_cast<UINT64>(std::size(reservation.data)),
+			.dst           = dst,
+			.mipLevelIndex = mipLevelIndex,
+			.src           = reservation.src,
+			.srcOffset     = reservation.srcOffset,
+			.repackMode    = RepackMode::Copy,
+			.firstRow      = 0u,
+			.rowCount      = dst->GetMipRowCount(mipLevelIndex)
 		}
+	);
 
-		// No need to finish the batching here since we might be able to put some textures into it.
-	}
+	return *this;
+}
 
-	{
-		// Need an offset here, since I want to put both buffers and textures into the same batch.
-		const size_t offset = std::size(m_bufferInfo);
+Buffer const* StagingBufferManager::CreateDedicatedBuffer(
+	UINT64 bufferSize, Callisto::TemporaryDataBufferGPU& tempDataBuffer
+) {
+	if (bufferSize <= m_uploadRing.GetMaxAllocationSize())
+		return nullptr;
 
-		for (size_t index = 0u; index < std::size(m_textureInfo); ++index)
-		{
-			const TextureInfo& textureInfo = m_textureInfo[index];
+	auto tempBuffer = std::make_shared<Buffer>(m_device, m_memoryManager, D3D12_HEAP_TYPE_UPLOAD);
 
-			tasks.emplace_back([&textureInfo, &tempBuffer = m_tempBufferToTexture[index]]
-				{
-					// The RowPitch in a texture which was loaded from the Disk Drive won't have its
-					// rowPitch aligned. But the D3D textures need their rowPitches to be aligned to 256B.
-					// So, the textures need to be copied like this.
-					Texture const* texture = textureInfo.dst;
+	m_tempBuffers.emplace_back(tempBuffer);
 
-					const auto rowCount    = static_cast<size_t>(texture->GetHeight());
-					const auto srcRowPitch = static_cast<size_t>(texture->GetRowPitch());
-					const auto dstRowPitch = static_cast<size_t>(texture->GetRowPitchD3DAligned());
+	tempBuffer->Create(bufferSize, D3D12_RESOURCE_STATE_GENERIC_READ);
 
-					std::uint8_t* dst = tempBuffer->CPUHandle();
-					auto src          = static_cast<std::uint8_t const*>(textureInfo.cpuHandle);
+	tempDataBuffer.Add(std::move(tempBuffer));
 
-					size_t srcOffset = 0u;
-					size_t dstOffset = 0u;
+	return m_tempBuffers.back().get();
+}
 
-					for (size_t rowIndex = 0u; rowIndex < rowCount; ++rowIndex)
-					{
-						memcpy(dst + dstOffset, src + srcOffset, srcRowPitch);
+void StagingBufferManager::SortBufferInfo()
+{
+	std::vector<BufferInfo> sortedInfo = m_bufferInfo;
 
-						srcOffset += srcRowPitch;
-						dstOffset += dstRowPitch;
-					}
-				});
+	// The destinations are only compared to group the copies of the same buffer.
+	std::ranges::stable_sort(
+		sortedInfo,
+		[](const BufferInfo& lhs, const BufferInfo& rhs)
+		{
+			if (lhs.dst != rhs.dst)
+				return std::less<Buffer const*>{}(lhs.dst, rhs.dst);
 
-			currentBatchSize += textureInfo.bufferSize;
+			return lhs.offset < rhs.offset;
+		}
+	);
 
-			if (currentBatchSize >= batchSize)
-			{
-				currentBatchSize   = 0u;
+	for (size_t index = 1u; index < std::size(sortedInfo); ++index)
+	{
+		const BufferInfo& previousInfo = sortedInfo[index - 1u];
+		const BufferInfo& bufferInfo   = sortedInfo[index];
+
+		if (bufferInfo.dst == previousInfo.dst
+			&& bufferInfo.offset < previousInfo.offset + previousInfo.bufferSize)
+			return;
+	}
+
+	m_bufferInfo = std::move(sortedInfo);
+}
 
-				tempBatch.endIndex = offset + index;
-				batches.emplace_back(tempBatch);
+void StagingBufferManager::AllocateFromUploadRing()
+{
+	BufferInfo const* previousInfo = nullptr;
+
+	for (BufferInfo& bufferInfo : m_bufferInfo)
+	{
+		if (bufferInfo.src)
+		{
+			previousInfo = nullptr;
 
-				tempBatch.startIndex = offset + index + 1u;
-				tempBatch.endIndex   = tempBatch.startIndex;
-			}
+			continue;
 		}
+
+		// A buffer copy doesn't have any alignment requirements, but aligning it to 16 bytes
+		// should make the memcpy faster. Unless its destination continues the previous one,
+		// then it is placed right after it, so the copies can be merged.
+		const bool isContiguous = previousInfo && previousInfo->dst == bufferInfo.dst
+			&& previousInfo->offset + previousInfo->bufferSize == bufferInfo.offset;
+
+		const UploadRingAllocator::Allocation allocation = m_uploadRing.Allocate(
+			bufferInfo.bufferSize, isContiguous ? 1u : 16u
+		);
+
+		bufferInfo.src       = allocation.buffer;
+		bufferInfo.srcOffset = allocation.offset;
+
+		previousInfo         = &bufferInfo;
 	}
 
-	// Add the last element in the batch.
-	if (auto elementCount = std::size(m_textureInfo) + std::size(m_bufferInfo);
-		elementCount > tempBatch.endIndex)
+	for (TextureInfo& textureInfo : m_textureInfo)
 	{
-		tempBatch.endIndex = elementCount - 1u;
-		batches.emplace_back(tempBatch);
+		if (textureInfo.src)
+			continue;
+
+		const UploadRingAllocator::Allocation allocation = m_uploadRing.Allocate(
+			textureInfo.bufferSize, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT
+		);
+
+		textureInfo.src       = allocation.buffer;
+		textureInfo.srcOffset = allocation.offset;
 	}
+}
 
-	// Copy batches.
-	// This is asynchronous but it should be fine as different threads shouldn't access the same
-	// location.
-	for (auto& batch : batches)
+void StagingBufferManager::CopyCPU()
+{
+	for (const BufferInfo& bufferInfo : m_bufferInfo)
+	{
+		// The reserved data has already been written.
+		if (!bufferInfo.cpuHandle)
+			continue;
+
+		m_copyQueue.AddCopy(
+			bufferInfo.src->CPUHandle() + bufferInfo.srcOffset, bufferInfo.cpuHandle,
+			static_cast<size_t>(bufferInfo.bufferSize)
+		);
+	}
+
+	for (const TextureInfo& textureInfo : m_textureInfo)
 	{
-		waitObjs.emplace_back(m_threadPool->SubmitWork(std::function{
-			[&tTasks = tasks, batch]
+		if (!textureInfo.cpuHandle)
+			continue;
+
+		// The RowPitch in a texture which was loaded from the Disk Drive won't have its
+		// rowPitch aligned. But the D3D textures need their rowPitches to be aligned to 256B.
+		// So, the textures need to be copied a row at a time.
+		Texture const* texture = textureInfo.dst;
+
+		const UINT mipLevelIndex = textureInfo.mipLevelIndex;
+		const auto rowSize       = static_cast<size_t>(texture->GetRowPitch(mipLevelIndex));
+
+		m_copyQueue.AddRowCopy(
+			textureInfo.src->CPUHandle() + textureInfo.srcOffset, textureInfo.cpuHandle,
+			rowSize, static_cast<size_t>(textureInfo.rowCount),
+			static_cast<size_t>(texture->GetRowPitchD3DAligned(mipLevelIndex)),
+			RowRepacker::GetSrcRowSize(rowSize, textureInfo.repackMode), textureInfo.repackMode
+		);
+	}
+
+	const size_t workerCount = m_copyQueue.Distribute(m_maxCopyWorkerCount);
+
+	// The calling thread would be waiting anyway, so it runs the first worker. If the pool is
+	// busy, it will steal the chunks of the others.
+	for (size_t workerIndex = 1u; workerIndex < workerCount; ++workerIndex)
+		m_copyWaitObjs.emplace_back(m_threadPool->SubmitWork(std::function{
+			[&copyQueue = m_copyQueue, workerIndex]
 			{
-				for (size_t index = batch.startIndex; index <= batch.endIndex; ++index)
-				{
-					tTasks[index]();
-				}
+				copyQueue.Run(workerIndex);
 			}}));
-	}
 
-	// Wait for all the copying to finish.
-	for (auto& waitObj : waitObjs)
+	if (workerCount)
+		m_copyQueue.Run(0u);
+
+	for (std::future<void>& waitObj : m_copyWaitObjs)
 		waitObj.wait();
 
-	// Only clearing, so we might not need to do dynamic allocate the next time.
-	waitObjs.clear();
-	tasks.clear();
-	batches.clear();
+	// Only clearing, so the memory can be reused the next time.
+	m_copyWaitObjs.clear();
+	m_copyQueue.Clear();
 }
 
 void StagingBufferManager::CopyGPU(const D3DCommandList& copyCmdList)
 {
+	const size_t bufferInfoCount = std::size(m_bufferInfo);
+	size_t recordedCopyCount     = 0u;
+
 	// Assuming the command buffer has been reset before this.
-	for(size_t index = 0u; index < std::size(m_bufferInfo); ++index)
+	for (size_t index = 0u; index < bufferInfoCount;)
 	{
-		const BufferInfo& bufferInfo = m_bufferInfo[index];
-		const Buffer& tempBuffer     = *m_tempBufferToBuffer[index];
+		const BufferInfo& firstInfo = m_bufferInfo[index];
+		UINT64 copySize             = firstInfo.bufferSize;
+
+		// The following copies which continue both the src and the dst ranges are merged.
+		for (++index; index < bufferInfoCount; ++index)
+		{
+			const BufferInfo& bufferInfo = m_bufferInfo[index];
+
+			if (bufferInfo.src != firstInfo.src || bufferInfo.dst != firstInfo.dst
+				|| bufferInfo.srcOffset != firstInfo.srcOffset + copySize
+				|| bufferInfo.offset != firstInfo.offset + copySize)
+				break;
+
+			copySize += bufferInfo.bufferSize;
+		}
 
-		// I am making a new buffer for each copy but if the buffer alignment for example is
-		// 16 bytes and the buffer size is 4bytes, copyWhole would be wrong as it would go over
-		// the reserved size in the destination buffer.
+		// The src buffer might be shared with other copies, and the dst buffer might be larger
+		// than the data. So, only the size of the data should be copied.
 		copyCmdList.Copy(
-			tempBuffer, 0u, *bufferInfo.dst, bufferInfo.offset, bufferInfo.bufferSize
+			*firstInfo.src, firstInfo.srcOffset, *firstInfo.dst, firstInfo.offset, copySize
 		);
+
+		++recordedCopyCount;
 	}
 
+	m_copyCounters.queuedBufferCopyCount   += bufferInfoCount;
+	m_copyCounters.recordedBufferCopyCount += recordedCopyCount;
+
 	for(size_t index = 0u; index < std::size(m_textureInfo); ++index)
 	{
 		const TextureInfo& textureInfo = m_textureInfo[index];
-		const Buffer& tempBuffer       = *m_tempBufferToTexture[index];
 
-		// CopyWhole would not be a problem for textures, as the destination buffer would be a texture
-		// and will be using the dimension of the texture instead of its size to copy. And there should
-		// be only a single texture in a texture buffer.
-		copyCmdList.CopyWhole(tempBuffer, *textureInfo.dst, textureInfo.mipLevelIndex);
+		// The copy uses the dimension of the texture instead of its size. So, only the data
+		// of this texture will be read from the src buffer.
+		copyCmdList.CopyRows(
+			*textureInfo.src, textureInfo.srcOffset, *textureInfo.dst, textureInfo.mipLevelIndex,
+			textureInfo.firstRow, textureInfo.rowCount
+		);
 	}
 }
 
 void StagingBufferManager::CopyAndClearQueuedBuffers(const D3DCommandList& copyCmdList)
 {
+	// The reserved memory would be released with this submission without being copied.
+	assert(!m_reservationCount && "All of the reservations must be committed before the copy.");
+
 	// Since these are first copied to temp buffers and those are
 	// copied on the GPU, we don't need any cpu synchronisation.
 	// But we should wait on some semaphores from other queues which
 	// are already running before we submit these copy commands.
 	if (!std::empty(m_textureInfo) || !std::empty(m_bufferInfo))
 	{
+		SortBufferInfo();
+		AllocateFromUploadRing();
+
 		CopyCPU();
 		CopyGPU(copyCmdList);
 
@@ -238,8 +369,7 @@ void StagingBufferManager::CopyAndClearQueuedBuffers(const D3DCommandList& copyC
 
 void StagingBufferManager::CleanUpTempBuffers() noexcept
 {
-	m_tempBufferToBuffer.clear();
-	m_tempBufferToTexture.clear();
+	m_tempBuffers.clear();
 }
 
 void StagingBufferManager::CleanUpBufferInfo() noexcept
@@ -0,0 +1,64 @@
+#include <D3DTextureFormat.hpp>
+
+namespace Gaia
+{
+TextureFormatInfo GetTextureFormatInfo(DXGI_FORMAT format) noexcept
+{
+	switch (format)
+	{
+	case DXGI_FORMAT_R8G8B8A8_TYPELESS:
+	case DXGI_FORMAT_R8G8B8A8_UNORM:
+	case DXGI_FORMAT_R8G8B8A8_SNORM:
+	case DXGI_FORMAT_R8G8B8A8_UINT:
+	case DXGI_FORMAT_R8G8B8A8_SINT:
+	case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+	case DXGI_FORMAT_B8G8R8A8_TYPELESS:
+	case DXGI_FORMAT_B8G8R8A8_UNORM:
+	case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+		return TextureFormatInfo{ .blockSize = 1u, .bytesPerBlock = 4u };
+	// BC1 and BC4 have 8 bytes per block, the rest have 16.
+	case DXGI_FORMAT_BC1_TYPELESS:
+	case DXGI_FORMAT_BC1_UNORM:
+	case DXGI_FORMAT_BC1_UNORM_SRGB:
+	case DXGI_FORMAT_BC4_TYPELESS:
+	case DXGI_FORMAT_BC4_UNORM:
+	case DXGI_FORMAT_BC4_SNORM:
+		return TextureFormatInfo{ .blockSize = 4u, .bytesPerBlock = 8u };
+	case DXGI_FORMAT_BC2_TYPELESS:
+	case DXGI_FORMAT_BC2_UNORM:
+	case DXGI_FORMAT_BC2_UNORM_SRGB:
+	case DXGI_FORMAT_BC3_TYPELESS:
+	case DXGI_FORMAT_BC3_UNORM:
+	case DXGI_FORMAT_BC3_UNORM_SRGB:
+	case DXGI_FORMAT_BC5_TYPELESS:
+	case DXGI_FORMAT_BC5_UNORM:
+	case DXGI_FORMAT_BC5_SNORM:
+	case DXGI_FORMAT_BC7_TYPELESS:
+	case DXGI_FORMAT_BC7_UNORM:
+	case DXGI_FORMAT_BC7_UNORM_SRGB:
+		return TextureFormatInfo{ .blockSize = 4u, .bytesPerBlock = 16u };
+	default:
+		return TextureFormatInfo{ .blockSize = 1u, .bytesPerBlock = 0u };
+	}
+}
+
+bool IsBlockCompressed(DXGI_FORMAT format) noexcept
+{
+	return GetTextureFormatInfo(format).blockSize > 1u;
+}
+
+UINT64 GetTextureRowPitch(DXGI_FORMAT format, UINT64 width) noexcept
+{
+	const TextureFormatInfo formatInfo = GetTextureFormatInfo(format);
+
+	// A partial block at the edge still takes a whole block.
+	return (width + formatInfo.blockSize - 1u) / formatInfo.blockSize * formatInfo.bytesPerBlock;
+}
+
+UINT GetTextureRowCount(DXGI_FORMAT format, UINT height) noexcept
+{
+	const UINT blockSize = GetTextureFormatInfo(format).blockSize;
+
+	return (height + blockSize - 1u) / blockSize;
+}
+}
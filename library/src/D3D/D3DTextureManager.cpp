@@ -1,12 +1,31 @@
 #include <D3DTextureManager.hpp>
 #include <D3DResourceBarrier.hpp>
+#include <cassert>
 
 namespace Gaia
 {
 // Texture storage
-size_t TextureStorage::AddTexture(
-	STexture&& texture, StagingBufferManager& stagingBufferManager,
-	Callisto::TemporaryDataBufferGPU& tempBuffer, bool msaa/* = false */
+DXGI_FORMAT TextureStorage::GetTextureFormat(STextureFormat format, bool srgb) noexcept
+{
+	switch (format)
+	{
+	case STextureFormat::BC1:
+		return srgb ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM;
+	case STextureFormat::BC3:
+		return srgb ? DXGI_FORMAT_BC3_UNORM_SRGB : DXGI_FORMAT_BC3_UNORM;
+	case STextureFormat::BC5:
+		return DXGI_FORMAT_BC5_UNORM;
+	case STextureFormat::BC7:
+		return srgb ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM;
+	// RGB8 is expanded to RGBA8 while being uploaded.
+	default:
+		return srgb ? s_textureFormat : DXGI_FORMAT_R8G8B8A8_UNORM;
+	}
+}
+
+AsyncUpload<size_t> TextureStorage::AddTexture(
+	STexture&& texture, UploadScheduler& uploadScheduler, UploadPriority priority,
+	bool msaa/* = false */
 ) {
 	const size_t index = m_textures.Add(
 		Texture{ m_device, m_memoryManager, D3D12_HEAP_TYPE_DEFAULT }
@@ -14,17 +33,97 @@ size_t TextureStorage::AddTexture(
 
 	Texture* texturePtr = &m_textures[index];
 
+	if (index >= std::size(m_bindingCounts))
+		m_bindingCounts.resize(index + 1u, 0u);
+
+	m_bindingCounts[index] = 0u;
+
+	const DXGI_FORMAT textureFormat = GetTextureFormat(texture.format, texture.srgb);
+
+	// The multi sampled textures can't have mips. And the block compressed ones should have
+	// their mips in the data.
+	const bool generateMips = texture.generateMips && !msaa && !IsBlockCompressed(textureFormat);
+
+	const UINT16 mipLevelCount = generateMips ?
+		MipGenerator::GetMipLevelCount(texture.width, texture.height) : texture.mipLevelCount;
+
 	texturePtr->Create2D(
-		texture.width, texture.height, 1u, s_textureFormat, D3D12_RESOURCE_STATE_COMMON,
-		D3D12_RESOURCE_FLAG_NONE, msaa
+		texture.width, texture.height, mipLevelCount, textureFormat,
+		D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_FLAG_NONE, msaa
 	);
 
-	stagingBufferManager.AddTexture(std::move(texture.data), texturePtr, tempBuffer);
+	const RepackMode repackMode = texture.format == STextureFormat::RGB8 ?
+		RepackMode::RGB8ToRGBA8 : RepackMode::Copy;
+
+	// The texture will be added to the transition queue, once its copy has been queued.
+	UploadTicket ticket{};
+
+	if (generateMips)
+	{
+		std::shared_ptr<std::uint8_t[]> image = std::static_pointer_cast<std::uint8_t[]>(
+			std::move(texture.data)
+		);
+
+		// The generator needs 4 bytes per pixel.
+		if (repackMode == RepackMode::RGB8ToRGBA8)
+		{
+			const size_t rowSize = size_t{ texture.width } * 4u;
+
+			auto expandedImage = std::make_shared_for_overwrite<std::uint8_t[]>(
+				rowSize * texture.height
+			);
+
+			RowRepacker{}.Repack(
+				expandedImage.get(), image.get(), rowSize, texture.height, rowSize,
+				RowRepacker::GetSrcRowSize(rowSize, repackMode), repackMode
+			);
+
+			image = std::move(expandedImage);
+		}
+
+		std::vector<MipGenerator::Mip> mips = m_mipGenerator.Generate(
+			image.get(), texture.width, texture.height, texture.srgb
+		);
+
+		std::vector<std::shared_ptr<void>> mipData{};
+		mipData.reserve(std::size(mips) + 1u);
+
+		mipData.emplace_back(std::move(image));
 
-	// Should be fine because of the deque.
-	m_transitionQueue.push(texturePtr);
+		for (MipGenerator::Mip& mip : mips)
+			mipData.emplace_back(std::move(mip.data));
 
-	return index;
+		ticket = uploadScheduler.AddTextureMips(std::move(mipData), texturePtr, priority);
+	}
+	else if (mipLevelCount > 1u)
+	{
+		assert(
+			repackMode == RepackMode::Copy && "The mips of an RGB8 texture can't be in the data."
+		);
+
+		// The mips are tightly packed, so each one is aliased at its offset in the data.
+		auto mipBytes    = static_cast<std::uint8_t*>(texture.data.get());
+		size_t mipOffset = 0u;
+
+		std::vector<std::shared_ptr<void>> mipData{};
+		mipData.reserve(mipLevelCount);
+
+		for (UINT mipLevelIndex = 0u; mipLevelIndex < mipLevelCount; ++mipLevelIndex)
+		{
+			mipData.emplace_back(texture.data, mipBytes + mipOffset);
+
+			mipOffset += static_cast<size_t>(texturePtr->GetRowPitch(mipLevelIndex))
+				* texturePtr->GetMipRowCount(mipLevelIndex);
+		}
+
+		ticket = uploadScheduler.AddTextureMips(std::move(mipData), texturePtr, priority);
+	}
+	else
+		ticket = uploadScheduler.AddTexture(
+			std::move(texture.data), texturePtr, priority, 0u, repackMode
+		);
+
+	return AsyncUpload<size_t>{ .result = index, .ticket = ticket };
 }
 
 size_t TextureStorage::AddSampler(const SamplerBuilder& builder)
@@ -53,6 +152,28 @@ void TextureStorage::RemoveTexture(size_t index)
 {
 	m_textures[index].Destroy();
 	m_textures.RemoveElement(index);
+
+	m_bindingCounts[index] = 0u;
+}
+
+std::unordered_map<std::uint16_t, size_t> TextureStorage::GetUnboundTextureCounts() const
+{
+	std::unordered_map<std::uint16_t, size_t> unboundTextureCounts{};
+
+	const size_t textureCount = std::size(m_textures);
+
+	for (size_t index = 0u; index < textureCount; ++index)
+	{
+		if (!m_textures.IsInUse(index) || m_bindingCounts[index])
+			continue;
+
+		const MemoryManager::MemoryAllocation& allocation = m_textures[index].GetAllocation();
+
+		if (allocation.isValid)
+			++unboundTextureCounts[allocation.memoryID];
+	}
+
+	return unboundTextureCounts;
 }
 
 void TextureStorage::RemoveSampler(size_t index)
@@ -0,0 +1,121 @@
+#include <D3DUploadRingAllocator.hpp>
+#include <algorithm>
+#include <cassert>
+
+namespace Gaia
+{
+UploadRingAllocator::UploadRingAllocator(
+	ID3D12Device* device, MemoryManager* memoryManager, UINT64 capacity /* = 16_MB */,
+	UINT64 maxAllocationSize /* = 4_MB */, std::uint32_t underusedFramesBeforeShrink /* = 120u */
+) : m_device{ device }, m_memoryManager{ memoryManager }, m_buffer{}, m_ring{ capacity },
+	m_submissions{}, m_retiredBuffers{}, m_maxAllocationSize{ maxAllocationSize },
+	m_initialCapacity{ capacity }, m_underusedFramesBeforeShrink{ underusedFramesBeforeShrink },
+	m_underusedFrameCount{ 0u }
+{
+	m_buffer = std::make_unique<Buffer>(m_device, m_memoryManager, D3D12_HEAP_TYPE_UPLOAD);
+
+	m_buffer->Create(capacity, D3D12_RESOURCE_STATE_GENERIC_READ);
+}
+
+void UploadRingAllocator::ReleaseCompletedSubmissions() noexcept
+{
+	// The copies are submitted to a single queue, so the submissions complete in order.
+	while (!std::empty(m_submissions) && IsCompleted(m_submissions.front()))
+	{
+		m_ring.ReleaseSubmission();
+
+		m_submissions.pop_front();
+	}
+
+	std::erase_if(
+		m_retiredBuffers,
+		[](const RetiredBuffer& retiredBuffer)
+		{
+			return IsCompleted(retiredBuffer.submission);
+		}
+	);
+}
+
+void UploadRingAllocator::Replace(UINT64 capacity)
+{
+	// The last submission of the old ring will be completed before the one which has its
+	// unsubmitted allocations. So, the old submissions don't need to be tracked anymore. And
+	// if nothing is in flight, the old buffer can be released right away.
+	if (m_ring.GetUsedSize())
+		m_retiredBuffers.emplace_back(
+			RetiredBuffer{
+				.buffer     = std::move(m_buffer),
+				.submission = Submission{ .fence = nullptr, .fenceValue = 0u }
+			}
+		);
+
+	m_submissions.clear();
+
+	m_underusedFrameCount = 0u;
+
+	m_ring   = RingAllocator{ capacity };
+
+	m_buffer = std::make_unique<Buffer>(m_device, m_memoryManager, D3D12_HEAP_TYPE_UPLOAD);
+
+	m_buffer->Create(capacity, D3D12_RESOURCE_STATE_GENERIC_READ);
+}
+
+void UploadRingAllocator::Grow(UINT64 size)
+{
+	Replace(std::max(m_ring.GetCapacity() * 2u, size));
+}
+
+void UploadRingAllocator::ShrinkIfUnderused()
+{
+	ReleaseCompletedSubmissions();
+
+	// A few frames can be in flight, so the initial ring should still have some space left.
+	const bool isUnderused = m_ring.GetCapacity() > m_initialCapacity
+		&& m_ring.GetUsedSize() <= m_initialCapacity / 2u;
+
+	if (!isUnderused)
+	{
+		m_underusedFrameCount = 0u;
+
+		return;
+	}
+
+	++m_underusedFrameCount;
+
+	if (m_underusedFrameCount >= m_underusedFramesBeforeShrink)
+		Replace(m_initialCapacity);
+}
+
+UploadRingAllocator::Allocation UploadRingAllocator::Allocate(UINT64 size, UINT64 alignment)
+{
+	assert(size <= m_maxAllocationSize && "The allocation is larger than the max size.");
+
+	ReleaseCompletedSubmissions();
+
+	std::optional<UINT64> offset = m_ring.Allocate(size, alignment);
+
+	if (!offset)
+	{
+		Grow(size);
+
+		offset = m_ring.Allocate(size, alignment);
+	}
+
+	return Allocation
+	{
+		.buffer = m_buffer.get(),
+		.offset = *offset
+	};
+}
+
+void UploadRingAllocator::SetUsed(ID3D12Fence* fence, UINT64 fenceValue)
+{
+	m_ring.Submit();
+
+	m_submissions.emplace_back(Submission{ .fence = fence, .fenceValue = fenceValue });
+
+	for (RetiredBuffer& retiredBuffer : m_retiredBuffers)
+		if (!retiredBuffer.submission.fence)
+			retiredBuffer.submission = Submission{ .fence = fence, .fenceValue = fenceValue };
+}
+}
@@ -0,0 +1,228 @@
+#include <D3DUploadScheduler.hpp>
+#include <algorithm>
+
+namespace Gaia
+{
+UploadScheduler::UploadScheduler(
+	UINT64 bytesPerFrame /* = 0u */, UINT64 chunkSize /* = 4_MB */,
+	UINT64 stagingWindowSize /* = 8_MB */
+) : m_uploads{}, m_nextUploadIndices{}, m_queuedTextures{}, m_bytesPerFrame{ bytesPerFrame },
+	m_chunkSize{ chunkSize }, m_stagingWindowSize{ stagingWindowSize },
+	m_frameStats{ .uploadedBytes = 0u, .backlogBytes = 0u, .backlogCount = 0u }
+{}
+
+[[nodiscard]]
+// The chunk shares the ownership of the whole data.
+static std::shared_ptr<void> GetChunkData(
+	const std::shared_ptr<void>& cpuData, size_t offset
+) noexcept {
+	return std::shared_ptr<void>{ cpuData, static_cast<std::uint8_t*>(cpuData.get()) + offset };
+}
+
+void UploadScheduler::AddUpload(Upload&& upload, UploadPriority priority)
+{
+	m_frameStats.backlogBytes += upload.bufferSize;
+	++m_frameStats.backlogCount;
+
+	m_uploads[static_cast<size_t>(priority)].emplace_back(std::move(upload));
+}
+
+UploadTicket UploadScheduler::AddBuffer(
+	std::shared_ptr<void> cpuData, UINT64 bufferSize, Buffer const* dst, UINT64 offset,
+	UploadPriority priority
+) {
+	const UploadTicket ticket = GetNextTicket(priority);
+	const bool isChunked      = bufferSize > m_chunkSize;
+
+	for (UINT64 chunkOffset = 0u; chunkOffset < bufferSize; chunkOffset += m_chunkSize)
+		AddUpload(
+			Upload{
+				.cpuData       = GetChunkData(cpuData, static_cast<size_t>(chunkOffset)),
+				.bufferSize    = std::min(m_chunkSize, bufferSize - chunkOffset),
+				.dstBuffer     = dst,
+				.offset        = offset + chunkOffset,
+				.dstTexture    = nullptr,
+				.mipLevelIndex = 0u,
+				.repackMode    = RepackMode::Copy,
+				.firstRow      = 0u,
+				.rowCount      = 0u,
+				.isChunked     = isChunked,
+				.isLastChunk   = chunkOffset + m_chunkSize >= bufferSize,
+				.uploadIndex   = ticket.uploadIndex
+			}, priority
+		);
+
+	return ticket;
+}
+
+void UploadScheduler::AddTextureBands(
+	std::shared_ptr<void> cpuData, Texture const* dst, UploadPriority priority,
+	UINT mipLevelIndex, RepackMode repackMode, UINT64 uploadIndex, bool isLastMip
+) {
+	const UINT mipRowCount     = dst->GetMipRowCount(mipLevelIndex);
+	const UINT64 stagedRowSize = dst->GetRowPitchD3DAligned(mipLevelIndex)
+		* dst->GetMipDepth(mipLevelIndex);
+	const size_t srcRowPitch   = RowRepacker::GetSrcRowSize(
+		static_cast<size_t>(dst->GetRowPitch(mipLevelIndex)), repackMode
+	);
+
+	// The 2D textures are split into bands of rows. A band has at least one row, even if the
+	// row is bigger than the chunk size.
+	const UINT rowsPerChunk = dst->GetDepth() == 1u ?
+		static_cast<UINT>(std::clamp<UINT64>(m_chunkSize / stagedRowSize, 1u, mipRowCount))
+		: mipRowCount;
+	const bool isChunked    = rowsPerChunk < mipRowCount;
+
+	for (UINT firstRow = 0u; firstRow < mipRowCount; firstRow += rowsPerChunk)
+	{
+		const UINT rowCount = std::min(rowsPerChunk, mipRowCount - firstRow);
+
+		AddUpload(
+			Upload{
+				.cpuData       = GetChunkData(cpuData, firstRow * srcRowPitch),
+				.bufferSize    = stagedRowSize * rowCount,
+				.dstBuffer     = nullptr,
+				.offset        = 0u,
+				.dstTexture    = dst,
+				.mipLevelIndex = mipLevelIndex,
+				.repackMode    = repackMode,
+				.firstRow      = firstRow,
+				.rowCount      = rowCount,
+				.isChunked     = isChunked,
+				.isLastChunk   = isLastMip && firstRow + rowCount == mipRowCount,
+				.uploadIndex   = uploadIndex
+			}, priority
+		);
+	}
+}
+
+UploadTicket UploadScheduler::AddTexture(
+	std::shared_ptr<void> cpuData, Texture const* dst, UploadPriority priority,
+	UINT mipLevelIndex /* = 0u */, RepackMode repackMode /* = RepackMode::Copy */
+) {
+	const UploadTicket ticket = GetNextTicket(priority);
+
+	AddTextureBands(
+		std::move(cpuData), dst, priority, mipLevelIndex, repackMode, ticket.uploadIndex, true
+	);
+
+	return ticket;
+}
+
+UploadTicket UploadScheduler::AddTextureMips(
+	std::vector<std::shared_ptr<void>> mipData, Texture const* dst, UploadPriority priority
+) {
+	const UploadTicket ticket = GetNextTicket(priority);
+	const size_t mipCount     = std::size(mipData);
+
+	for (size_t mipLevelIndex = 0u; mipLevelIndex < mipCount; ++mipLevelIndex)
+		AddTextureBands(
+			std::move(mipData[mipLevelIndex]), dst, priority, static_cast<UINT>(mipLevelIndex),
+			RepackMode::Copy, ticket.uploadIndex, mipLevelIndex + 1u == mipCount
+		);
+
+	return ticket;
+}
+
+void UploadScheduler::RemoveTexture(Texture const* dst) noexcept
+{
+	for (std::deque<Upload>& uploads : m_uploads)
+		std::erase_if(
+			uploads,
+			[this, dst](const Upload& upload)
+			{
+				if (upload.dstTexture != dst)
+					return false;
+
+				m_frameStats.backlogBytes -= upload.bufferSize;
+				--m_frameStats.backlogCount;
+
+				return true;
+			}
+		);
+}
+
+void UploadScheduler::QueueUploads(
+	StagingBufferManager& stagingBufferManager, Callisto::TemporaryDataBufferGPU& tempDataBuffer
+) {
+	m_queuedTextures.clear();
+
+	UINT64 uploadedBytes = 0u;
+	UINT64 chunkBytes    = 0u;
+	bool isBudgetReached = false;
+
+	for (size_t priorityIndex = 0u; priorityIndex < std::size(m_uploads); ++priorityIndex)
+	{
+		std::deque<Upload>& uploads = m_uploads[priorityIndex];
+		const auto priority         = static_cast<UploadPriority>(priorityIndex);
+
+		while (!std::empty(uploads) && !isBudgetReached)
+		{
+			Upload& upload = uploads.front();
+
+			// An upload which is bigger than the budget would never fit, so it is queued alone.
+			// And the lower priorities shouldn't be queued before a higher one which didn't fit.
+			const bool isOverBudget = priority != UploadPriority::Critical && m_bytesPerFrame
+				&& uploadedBytes && uploadedBytes + upload.bufferSize > m_bytesPerFrame;
+			// The chunks of the big uploads are spread over the submissions, so the upload
+			// memory they need doesn't depend on the size of the resources. But the critical
+			// ones must be submitted with the next frame, so all of their chunks are queued.
+			// They still fill the window, so the lower priorities don't add to their memory.
+			const bool isOverWindow = priority != UploadPriority::Critical && upload.isChunked
+				&& chunkBytes && chunkBytes + upload.bufferSize > m_stagingWindowSize;
+
+			if (isOverBudget || isOverWindow)
+			{
+				isBudgetReached = true;
+
+				break;
+			}
+
+			if (upload.dstTexture)
+			{
+				stagingBufferManager.AddTextureRows(
+					std::move(upload.cpuData), upload.dstTexture, upload.firstRow,
+					upload.rowCount, tempDataBuffer, upload.mipLevelIndex, upload.repackMode
+				);
+
+				// The texture can only be transitioned after its last band has been copied.
+				if (upload.isLastChunk)
+					m_queuedTextures.emplace_back(upload.dstTexture);
+			}
+			else
+				stagingBufferManager.AddBuffer(
+					std::move(upload.cpuData), upload.bufferSize, upload.dstBuffer, upload.offset,
+					tempDataBuffer
+				);
+
+			if (upload.isChunked)
+				chunkBytes += upload.bufferSize;
+
+			uploadedBytes             += upload.bufferSize;
+			m_frameStats.backlogBytes -= upload.bufferSize;
+			--m_frameStats.backlogCount;
+
+			uploads.pop_front();
+		}
+	}
+
+	m_frameStats.uploadedBytes = uploadedBytes;
+}
+
+UploadTracker::UploadCounts UploadScheduler::GetQueuedCounts() const noexcept
+{
+	UploadTracker::UploadCounts queuedCounts{};
+
+	// The uploads of a priority are queued in order, so the ones before the oldest one in the
+	// backlog have all been queued.
+	for (size_t priorityIndex = 0u; priorityIndex < std::size(m_uploads); ++priorityIndex)
+	{
+		const std::deque<Upload>& uploads = m_uploads[priorityIndex];
+
+		queuedCounts[priorityIndex] = std::empty(uploads) ?
+			m_nextUploadIndices[priorityIndex] : uploads.front().uploadIndex;
+	}
+
+	return queuedCounts;
+}
+}
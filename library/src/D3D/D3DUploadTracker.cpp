@@ -0,0 +1,57 @@
+#include <D3DUploadTracker.hpp>
+
+namespace Gaia
+{
+void UploadTracker::SetSubmitted(
+	const D3DFence& fence, UINT64 fenceValue, const UploadCounts& submittedCounts
+) {
+	m_submissions.emplace_back(
+		Submission{ .fence = &fence, .fenceValue = fenceValue, .submittedCounts = submittedCounts }
+	);
+
+	m_submittedCounts = submittedCounts;
+
+	// Otherwise the submissions would pile up, if the tickets are never checked.
+	ReleaseCompletedSubmissions();
+}
+
+void UploadTracker::ReleaseCompletedSubmissions() noexcept
+{
+	while (!std::empty(m_submissions))
+	{
+		const Submission& submission = m_submissions.front();
+
+		if (submission.fence->GetCurrentValue() < submission.fenceValue)
+			break;
+
+		m_completedCounts = submission.submittedCounts;
+
+		m_submissions.pop_front();
+	}
+}
+
+bool UploadTracker::IsCompleted(const UploadTicket& ticket) noexcept
+{
+	ReleaseCompletedSubmissions();
+
+	return ticket.uploadIndex < m_completedCounts[static_cast<size_t>(ticket.priority)];
+}
+
+bool UploadTracker::Wait(const UploadTicket& ticket)
+{
+	if (!IsSubmitted(ticket))
+		return false;
+
+	const auto priorityIndex = static_cast<size_t>(ticket.priority);
+
+	for (const Submission& submission : m_submissions)
+		if (ticket.uploadIndex < submission.submittedCounts[priorityIndex])
+		{
+			submission.fence->Wait(submission.fenceValue);
+
+			break;
+		}
+
+	return true;
+}
+}
@@ -0,0 +1,236 @@
+#include <DDSLoader.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <D3DTextureFormat.hpp>
+#include <GaiaException.hpp>
+
+namespace Gaia
+{
+struct DDSPixelFormat
+{
+	std::uint32_t size;
+	std::uint32_t flags;
+	std::uint32_t fourCC;
+	std::uint32_t rgbBitCount;
+	std::uint32_t rBitMask;
+	std::uint32_t gBitMask;
+	std::uint32_t bBitMask;
+	std::uint32_t aBitMask;
+};
+
+struct DDSHeader
+{
+	std::uint32_t  size;
+	std::uint32_t  flags;
+	std::uint32_t  height;
+	std::uint32_t  width;
+	std::uint32_t  pitchOrLinearSize;
+	std::uint32_t  depth;
+	std::uint32_t  mipMapCount;
+	std::uint32_t  reserved1[11];
+	DDSPixelFormat pixelFormat;
+	std::uint32_t  caps;
+	std::uint32_t  caps2;
+	std::uint32_t  caps3;
+	std::uint32_t  caps4;
+	std::uint32_t  reserved2;
+};
+
+struct DDSHeaderDX10
+{
+	std::uint32_t dxgiFormat;
+	std::uint32_t resourceDimension;
+	std::uint32_t miscFlag;
+	std::uint32_t arraySize;
+	std::uint32_t miscFlags2;
+};
+
+static_assert(sizeof(DDSHeader) == 124u, "The DDS header must match the file layout.");
+static_assert(sizeof(DDSHeaderDX10) == 20u, "The DX10 header must match the file layout.");
+
+[[nodiscard]]
+static constexpr std::uint32_t MakeFourCC(char first, char second, char third, char fourth) noexcept
+{
+	return static_cast<std::uint32_t>(static_cast<std::uint8_t>(first))
+		| static_cast<std::uint32_t>(static_cast<std::uint8_t>(second)) << 8u
+		| static_cast<std::uint32_t>(static_cast<std::uint8_t>(third)) << 16u
+		| static_cast<std::uint32_t>(static_cast<std::uint8_t>(fourth)) << 24u;
+}
+
+static constexpr std::uint32_t s_ddsMagic           = MakeFourCC('D', 'D', 'S', ' ');
+static constexpr std::uint32_t s_mipMapCountFlag    = 0x20000u;
+static constexpr std::uint32_t s_fourCCFlag         = 0x4u;
+static constexpr std::uint32_t s_rgbFlag            = 0x40u;
+// Cubemaps and volume textures.
+static constexpr std::uint32_t s_unsupportedCaps2   = 0x200u | 0x200000u;
+static constexpr std::uint32_t s_texture2DDimension = 3u;
+
+[[nodiscard]]
+static std::optional<STextureFormat> GetSTextureFormat(DXGI_FORMAT format) noexcept
+{
+	switch (format)
+	{
+	case DXGI_FORMAT_R8G8B8A8_UNORM:
+	case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+		return STextureFormat::RGBA8;
+	case DXGI_FORMAT_BC1_UNORM:
+	case DXGI_FORMAT_BC1_UNORM_SRGB:
+		return STextureFormat::BC1;
+	case DXGI_FORMAT_BC3_UNORM:
+	case DXGI_FORMAT_BC3_UNORM_SRGB:
+		return STextureFormat::BC3;
+	case DXGI_FORMAT_BC5_UNORM:
+		return STextureFormat::BC5;
+	case DXGI_FORMAT_BC7_UNORM:
+	case DXGI_FORMAT_BC7_UNORM_SRGB:
+		return STextureFormat::BC7;
+	default:
+		return {};
+	}
+}
+
+[[nodiscard]]
+static bool IsSRGBFormat(DXGI_FORMAT format) noexcept
+{
+	return format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB || format == DXGI_FORMAT_BC1_UNORM_SRGB
+		|| format == DXGI_FORMAT_BC3_UNORM_SRGB || format == DXGI_FORMAT_BC7_UNORM_SRGB;
+}
+
+[[nodiscard]]
+// The formats of the files without the DX10 header. They don't specify the colour space, so
+// they are loaded as UNORM.
+static DXGI_FORMAT GetLegacyFormat(const DDSPixelFormat& pixelFormat) noexcept
+{
+	if (pixelFormat.flags & s_fourCCFlag)
+	{
+		const std::uint32_t fourCC = pixelFormat.fourCC;
+
+		if (fourCC == MakeFourCC('D', 'X', 'T', '1'))
+			return DXGI_FORMAT_BC1_UNORM;
+		// DXT4 is DXT5 with a premultiplied alpha.
+		if (fourCC == MakeFourCC('D', 'X', 'T', '4') || fourCC == MakeFourCC('D', 'X', 'T', '5'))
+			return DXGI_FORMAT_BC3_UNORM;
+		if (fourCC == MakeFourCC('A', 'T', 'I', '2') || fourCC == MakeFourCC('B', 'C', '5', 'U'))
+			return DXGI_FORMAT_BC5_UNORM;
+	}
+	else if (
+		pixelFormat.flags & s_rgbFlag && pixelFormat.rgbBitCount == 32u
+		&& pixelFormat.rBitMask == 0x000000FFu && pixelFormat.gBitMask == 0x0000FF00u
+		&& pixelFormat.bBitMask == 0x00FF0000u
+	) return DXGI_FORMAT_R8G8B8A8_UNORM;
+
+	return DXGI_FORMAT_UNKNOWN;
+}
+
+STexture DDSLoader::Load(const std::string& filePath)
+{
+	std::ifstream ddsFile{ filePath, std::ios_base::binary | std::ios_base::ate };
+
+	if (!ddsFile)
+		throw Exception("DDSException", "Couldn't open the DDS file.");
+
+	const auto fileSize = static_cast<size_t>(ddsFile.tellg());
+
+	ddsFile.seekg(0, std::ios_base::beg);
+
+	auto fileData = std::make_shared_for_overwrite<std::uint8_t[]>(fileSize);
+
+	ddsFile.read(reinterpret_cast<char*>(fileData.get()), static_cast<std::streamsize>(fileSize));
+
+	if (!ddsFile)
+		throw Exception("DDSException", "Couldn't read the DDS file.");
+
+	return Parse(std::move(fileData), fileSize);
+}
+
+STexture DDSLoader::Parse(std::shared_ptr<std::uint8_t[]> fileData, size_t fileSize)
+{
+	std::uint32_t magic = 0u;
+	DDSHeader header{};
+
+	size_t dataOffset = sizeof(magic) + sizeof(header);
+
+	if (fileSize < dataOffset)
+		throw Exception("DDSException", "The DDS file is too small.");
+
+	memcpy(&magic, fileData.get(), sizeof(magic));
+	memcpy(&header, fileData.get() + sizeof(magic), sizeof(header));
+
+	if (magic != s_ddsMagic || header.size != sizeof(header))
+		throw Exception("DDSException", "The file isn't a DDS file.");
+
+	if (header.caps2 & s_unsupportedCaps2)
+		throw Exception("DDSException", "Only the 2D DDS textures are supported.");
+
+	DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+
+	if (header.pixelFormat.flags & s_fourCCFlag
+		&& header.pixelFormat.fourCC == MakeFourCC('D', 'X', '1', '0')
+	) {
+		DDSHeaderDX10 headerDX10{};
+
+		if (fileSize < dataOffset + sizeof(headerDX10))
+			throw Exception("DDSException", "The DDS file is too small.");
+
+		memcpy(&headerDX10, fileData.get() + dataOffset, sizeof(headerDX10));
+
+		dataOffset += sizeof(headerDX10);
+
+		if (headerDX10.resourceDimension != s_texture2DDimension || headerDX10.arraySize > 1u)
+			throw Exception("DDSException", "Only the 2D DDS textures are supported.");
+
+		format = static_cast<DXGI_FORMAT>(headerDX10.dxgiFormat);
+	}
+	else
+		format = GetLegacyFormat(header.pixelFormat);
+
+	const std::optional<STextureFormat> textureFormat = GetSTextureFormat(format);
+
+	if (!textureFormat)
+		throw Exception("DDSException", "The format of the DDS file isn't supported.");
+
+	// The top mip of a block compressed texture must consist of whole blocks.
+	const UINT blockSize = GetTextureFormatInfo(format).blockSize;
+
+	if (header.width == 0u || header.height == 0u
+		|| header.width % blockSize || header.height % blockSize
+	) throw Exception("DDSException", "The size of the DDS texture isn't supported.");
+
+	const std::uint32_t mipLevelCount = header.flags & s_mipMapCountFlag ?
+		std::max(header.mipMapCount, 1u) : 1u;
+
+	// The last mip can't be smaller than 1x1.
+	if (mipLevelCount > 16u
+		|| std::max(header.width, header.height) >> (mipLevelCount - 1u) == 0u
+	) throw Exception("DDSException", "The DDS file has too many mips.");
+
+	// The mips are tightly packed after the headers.
+	size_t dataSize = 0u;
+
+	for (std::uint32_t mipLevelIndex = 0u; mipLevelIndex < mipLevelCount; ++mipLevelIndex)
+	{
+		const UINT mipWidth  = std::max(header.width >> mipLevelIndex, 1u);
+		const UINT mipHeight = std::max(header.height >> mipLevelIndex, 1u);
+
+		dataSize += static_cast<size_t>(GetTextureRowPitch(format, mipWidth))
+			* GetTextureRowCount(format, mipHeight);
+	}
+
+	if (fileSize - dataOffset < dataSize)
+		throw Exception("DDSException", "The DDS file is truncated.");
+
+	STexture texture{};
+
+	// Aliasing the file data, so it is kept alive with the texture.
+	texture.data          = std::shared_ptr<void>{ fileData, fileData.get() + dataOffset };
+	texture.width         = header.width;
+	texture.height        = header.height;
+	texture.format        = *textureFormat;
+	texture.mipLevelCount = static_cast<std::uint16_t>(mipLevelCount);
+	texture.srgb          = IsSRGBFormat(format);
+
+	return texture;
+}
+}
@@ -0,0 +1,116 @@
+#include <FreeRegionAllocator.hpp>
+#include <cassert>
+
+namespace Gaia
+{
+void FreeRegionAllocator::AddRegion(UINT64 offset, UINT64 size)
+{
+	m_regionsByOffset.emplace(offset, size);
+	m_regionsBySize.emplace(size, offset);
+
+	m_freeSize += size;
+}
+
+void FreeRegionAllocator::RemoveRegion(std::map<UINT64, UINT64>::iterator region) noexcept
+{
+	m_regionsBySize.erase(SizeKey_t{ region->second, region->first });
+
+	m_freeSize -= region->second;
+
+	m_regionsByOffset.erase(region);
+}
+
+std::optional<UINT64> FreeRegionAllocator::Allocate(UINT64 size)
+{
+	auto bestFit = m_regionsBySize.lower_bound(SizeKey_t{ size, 0u });
+
+	if (bestFit == std::end(m_regionsBySize))
+		return {};
+
+	const auto [regionSize, regionOffset] = *bestFit;
+
+	RemoveRegion(m_regionsByOffset.find(regionOffset));
+
+	if (regionSize > size)
+		AddRegion(regionOffset + size, regionSize - size);
+
+	return regionOffset;
+}
+
+bool FreeRegionAllocator::AllocateAt(UINT64 offset, UINT64 size)
+{
+	auto region = m_regionsByOffset.upper_bound(offset);
+
+	if (region == std::begin(m_regionsByOffset))
+		return false;
+
+	--region;
+
+	const auto [regionOffset, regionSize] = *region;
+
+	if (offset + size > regionOffset + regionSize)
+		return false;
+
+	RemoveRegion(region);
+
+	if (offset > regionOffset)
+		AddRegion(regionOffset, offset - regionOffset);
+
+	if (regionOffset + regionSize > offset + size)
+		AddRegion(offset + size, regionOffset + regionSize - offset - size);
+
+	return true;
+}
+
+void FreeRegionAllocator::Deallocate(UINT64 offset, UINT64 size)
+{
+	if (!size)
+		return;
+
+	auto nextRegion = m_regionsByOffset.lower_bound(offset);
+
+	assert(
+		(nextRegion == std::end(m_regionsByOffset) || nextRegion->first >= offset + size)
+		&& "The region overlaps a free region."
+	);
+
+	if (nextRegion != std::end(m_regionsByOffset) && nextRegion->first == offset + size)
+	{
+		size += nextRegion->second;
+
+		RemoveRegion(nextRegion++);
+	}
+
+	if (nextRegion != std::begin(m_regionsByOffset))
+	{
+		auto previousRegion = std::prev(nextRegion);
+
+		if (previousRegion->first + previousRegion->second == offset)
+		{
+			offset  = previousRegion->first;
+			size   += previousRegion->second;
+
+			RemoveRegion(previousRegion);
+		}
+	}
+
+	AddRegion(offset, size);
+}
+
+std::optional<UINT64> FreeRegionAllocator::RemoveTrailingRegion(UINT64 bufferSize) noexcept
+{
+	if (std::empty(m_regionsByOffset))
+		return {};
+
+	auto lastRegion = std::prev(std::end(m_regionsByOffset));
+
+	if (lastRegion->first + lastRegion->second != bufferSize)
+		return {};
+
+	const UINT64 offset = lastRegion->first;
+
+	RemoveRegion(lastRegion);
+
+	return offset;
+}
+}
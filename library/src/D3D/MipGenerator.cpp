@@ -0,0 +1,224 @@
+#include <MipGenerator.hpp>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <functional>
+#include <thread>
+#include <immintrin.h>
+
+namespace Gaia
+{
+// The linear colours are encoded with this many steps. The sRGB curve is steep near black, so
+// a step there is still less than one sRGB value.
+static constexpr size_t s_linearStepCount = 4'096u;
+
+[[nodiscard]]
+static std::array<float, 256u> CreateSRGBToLinearTable() noexcept
+{
+	std::array<float, 256u> table{};
+
+	for (size_t index = 0u; index < std::size(table); ++index)
+	{
+		const float srgb = static_cast<float>(index) / 255.f;
+
+		table[index] = srgb <= 0.04045f ? srgb / 12.92f : std::pow((srgb + 0.055f) / 1.055f, 2.4f);
+	}
+
+	return table;
+}
+
+[[nodiscard]]
+static std::array<std::uint8_t, s_linearStepCount> CreateLinearToSRGBTable() noexcept
+{
+	std::array<std::uint8_t, s_linearStepCount> table{};
+
+	for (size_t index = 0u; index < std::size(table); ++index)
+	{
+		const float linear = static_cast<float>(index) / (s_linearStepCount - 1u);
+
+		const float srgb = linear <= 0.0031308f ?
+			linear * 12.92f : 1.055f * std::pow(linear, 1.f / 2.4f) - 0.055f;
+
+		table[index] = static_cast<std::uint8_t>(std::lround(srgb * 255.f));
+	}
+
+	return table;
+}
+
+static const std::array<float, 256u> s_srgbToLinear = CreateSRGBToLinearTable();
+static const std::array<std::uint8_t, s_linearStepCount> s_linearToSRGB
+	= CreateLinearToSRGBTable();
+
+[[nodiscard]]
+static __m128 LoadLinear(std::uint8_t const* pixel) noexcept
+{
+	return _mm_setr_ps(
+		s_srgbToLinear[pixel[0]], s_srgbToLinear[pixel[1]], s_srgbToLinear[pixel[2]],
+		static_cast<float>(pixel[3]) / 255.f
+	);
+}
+
+static void StoreSRGB(std::uint8_t* pixel, __m128 linear) noexcept
+{
+	// The colours are scaled to the indices of the table and the alpha to its 8bit value.
+	constexpr auto lastStep = static_cast<float>(s_linearStepCount - 1u);
+
+	const __m128 scale = _mm_setr_ps(lastStep, lastStep, lastStep, 255.f);
+
+	alignas(16) std::int32_t values[4]{};
+
+	_mm_store_si128(
+		reinterpret_cast<__m128i*>(values), _mm_cvtps_epi32(_mm_mul_ps(linear, scale))
+	);
+
+	pixel[0] = s_linearToSRGB[static_cast<size_t>(values[0])];
+	pixel[1] = s_linearToSRGB[static_cast<size_t>(values[1])];
+	pixel[2] = s_linearToSRGB[static_cast<size_t>(values[2])];
+	pixel[3] = static_cast<std::uint8_t>(values[3]);
+}
+
+[[nodiscard]]
+static __m128 LoadUNorm(std::uint8_t const* pixel) noexcept
+{
+	return _mm_mul_ps(
+		_mm_setr_ps(
+			static_cast<float>(pixel[0]), static_cast<float>(pixel[1]),
+			static_cast<float>(pixel[2]), static_cast<float>(pixel[3])
+		),
+		_mm_set1_ps(1.f / 255.f)
+	);
+}
+
+static void StoreUNorm(std::uint8_t* pixel, __m128 value) noexcept
+{
+	alignas(16) std::int32_t values[4]{};
+
+	_mm_store_si128(
+		reinterpret_cast<__m128i*>(values), _mm_cvtps_epi32(_mm_mul_ps(value, _mm_set1_ps(255.f)))
+	);
+
+	for (size_t channel = 0u; channel < 4u; ++channel)
+		pixel[channel] = static_cast<std::uint8_t>(values[channel]);
+}
+
+MipGenerator::MipGenerator(ThreadPool* threadPool)
+	: m_threadPool{ threadPool }, m_waitObjs{},
+	m_maxWorkerCount{ std::max(std::thread::hardware_concurrency(), 1u) }
+{}
+
+void MipGenerator::DownsampleRows(
+	std::uint8_t* dst, std::uint32_t dstWidth, std::uint8_t const* src, std::uint32_t srcWidth,
+	std::uint32_t srcHeight, size_t firstRow, size_t rowCount, bool srgb
+) noexcept {
+	const __m128 quarter = _mm_set1_ps(0.25f);
+
+	const size_t srcRowPitch = size_t{ srcWidth } * 4u;
+
+	auto Load = srgb ? LoadLinear : LoadUNorm;
+
+	for (size_t rowIndex = firstRow; rowIndex < firstRow + rowCount; ++rowIndex)
+	{
+		// If a dimension is odd, its last row or column is dropped. If it is 1, the same one is
+		// used twice.
+		std::uint8_t const* topRow
+			= src + std::min<size_t>(rowIndex * 2u, srcHeight - 1u) * srcRowPitch;
+		std::uint8_t const* bottomRow
+			= src + std::min<size_t>(rowIndex * 2u + 1u, srcHeight - 1u) * srcRowPitch;
+
+		std::uint8_t* dstRow = dst + rowIndex * dstWidth * 4u;
+
+		for (size_t columnIndex = 0u; columnIndex < dstWidth; ++columnIndex)
+		{
+			const size_t left  = std::min<size_t>(columnIndex * 2u, srcWidth - 1u) * 4u;
+			const size_t right = std::min<size_t>(columnIndex * 2u + 1u, srcWidth - 1u) * 4u;
+
+			const __m128 top    = _mm_add_ps(Load(topRow + left), Load(topRow + right));
+			const __m128 bottom = _mm_add_ps(Load(bottomRow + left), Load(bottomRow + right));
+			const __m128 mean   = _mm_mul_ps(_mm_add_ps(top, bottom), quarter);
+
+			if (srgb)
+				StoreSRGB(dstRow + columnIndex * 4u, mean);
+			else
+				StoreUNorm(dstRow + columnIndex * 4u, mean);
+		}
+	}
+}
+
+std::vector<MipGenerator::Mip> MipGenerator::Generate(
+	std::uint8_t const* image, std::uint32_t width, std::uint32_t height, bool srgb /* = true */
+) {
+	const std::uint16_t mipLevelCount = GetMipLevelCount(width, height);
+
+	std::vector<Mip> mips{};
+
+	mips.reserve(mipLevelCount > 1u ? mipLevelCount - 1u : 0u);
+
+	std::uint8_t const* src = image;
+	std::uint32_t srcWidth  = width;
+	std::uint32_t srcHeight = height;
+
+	for (std::uint16_t mipLevelIndex = 1u; mipLevelIndex < mipLevelCount; ++mipLevelIndex)
+	{
+		const std::uint32_t dstWidth  = std::max(srcWidth / 2u, 1u);
+		const std::uint32_t dstHeight = std::max(srcHeight / 2u, 1u);
+
+		Mip mip{
+			.data   = std::make_shared_for_overwrite<std::uint8_t[]>(
+				size_t{ dstWidth } * dstHeight * 4u
+			),
+			.width  = dstWidth,
+			.height = dstHeight
+		};
+
+		std::uint8_t* dst = mip.data.get();
+
+		// Each mip needs the previous one, so the workers are waited on before the next mip.
+		const size_t workerCount   = std::clamp<size_t>(
+			dstHeight / s_minRowsPerWorker, 1u, m_maxWorkerCount
+		);
+		const size_t rowsPerWorker = (dstHeight + workerCount - 1u) / workerCount;
+
+		for (size_t workerIndex = 1u; workerIndex < workerCount; ++workerIndex)
+		{
+			const size_t firstRow = workerIndex * rowsPerWorker;
+
+			if (firstRow >= dstHeight)
+				break;
+
+			const size_t rowCount = std::min<size_t>(rowsPerWorker, dstHeight - firstRow);
+
+			m_waitObjs.emplace_back(m_threadPool->SubmitWork(std::function{
+				[dst, dstWidth, src, srcWidth, srcHeight, firstRow, rowCount, srgb]
+				{
+					DownsampleRows(
+						dst, dstWidth, src, srcWidth, srcHeight, firstRow, rowCount, srgb
+					);
+				}}));
+		}
+
+		// The calling thread would be waiting anyway, so it does the first rows.
+		DownsampleRows(
+			dst, dstWidth, src, srcWidth, srcHeight, 0u,
+			std::min<size_t>(rowsPerWorker, dstHeight), srgb
+		);
+
+		for (std::future<void>& waitObj : m_waitObjs)
+			waitObj.wait();
+
+		m_waitObjs.clear();
+
+		mips.emplace_back(std::move(mip));
+
+		src       = dst;
+		srcWidth  = dstWidth;
+		srcHeight = dstHeight;
+	}
+
+	return mips;
+}
+
+std::uint16_t MipGenerator::GetMipLevelCount(std::uint32_t width, std::uint32_t height) noexcept
+{
+	return static_cast<std::uint16_t>(std::bit_width(std::max(width, height)));
+}
+}
@@ -0,0 +1,56 @@
+#include <PageAllocator.hpp>
+#include <algorithm>
+
+namespace Gaia
+{
+PageAllocator::PageAllocator(UINT64 pageSize)
+	: m_pageSize{ pageSize }, m_pages{}, m_totalSize{ 0u }
+{}
+
+std::optional<PageAllocator::Allocation> PageAllocator::Allocate(UINT64 size)
+{
+	const size_t pageCount = std::size(m_pages);
+
+	for (size_t pageIndex = 0u; pageIndex < pageCount; ++pageIndex)
+	{
+		FreeRegionAllocator& freeRegions = m_pages[pageIndex].freeRegions;
+
+		if (freeRegions.GetLargestFreeRegion() < size)
+			continue;
+
+		if (std::optional<UINT64> offset = freeRegions.Allocate(size); offset)
+			return Allocation{ .pageIndex = pageIndex, .offset = *offset };
+	}
+
+	return {};
+}
+
+void PageAllocator::Deallocate(const Allocation& allocation, UINT64 size)
+{
+	m_pages[allocation.pageIndex].freeRegions.Deallocate(allocation.offset, size);
+}
+
+size_t PageAllocator::AddPage(UINT64 size)
+{
+	const size_t pageIndex = std::size(m_pages);
+	const UINT64 pageSize  = std::max(m_pageSize, size);
+
+	Page& page = m_pages.emplace_back(Page{ .size = pageSize, .freeRegions = {} });
+
+	page.freeRegions.Deallocate(0u, pageSize);
+
+	m_totalSize += pageSize;
+
+	return pageIndex;
+}
+
+UINT64 PageAllocator::GetFreeSize() const noexcept
+{
+	UINT64 freeSize = 0u;
+
+	for (const Page& page : m_pages)
+		freeSize += page.freeRegions.GetFreeSize();
+
+	return freeSize;
+}
+}
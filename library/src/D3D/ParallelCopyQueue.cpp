@@ -0,0 +1,198 @@
+#include <ParallelCopyQueue.hpp>
+#include <algorithm>
+#include <cassert>
+
+namespace Gaia
+{
+ParallelCopyQueue::ParallelCopyQueue(size_t chunkSize, const RowRepacker& rowRepacker)
+	: m_chunkSize{ chunkSize }, m_copySize{ 0u }, m_chunks{}, m_ranges{}, m_rangeCapacity{ 0u },
+	m_workerCount{ 0u }, m_rowRepacker{ rowRepacker }
+{}
+
+void ParallelCopyQueue::AddCopy(void* dst, void const* src, size_t size)
+{
+	auto dstStart = static_cast<std::uint8_t*>(dst);
+	auto srcStart = static_cast<std::uint8_t const*>(src);
+
+	for (size_t offset = 0u; offset < size; offset += m_chunkSize)
+		m_chunks.emplace_back(
+			Chunk{
+				.dst         = dstStart + offset,
+				.src         = srcStart + offset,
+				.rowSize     = std::min(m_chunkSize, size - offset),
+				.rowCount    = 1u,
+				.dstRowPitch = 0u,
+				.srcRowPitch = 0u,
+				.mode        = RepackMode::Copy
+			}
+		);
+
+	m_copySize += size;
+}
+
+void ParallelCopyQueue::AddRowCopy(
+	void* dst, void const* src, size_t rowSize, size_t rowCount, size_t dstRowPitch,
+	size_t srcRowPitch, RepackMode mode /* = RepackMode::Copy */
+) {
+	// If the rows are tightly packed in both, they can be copied as a single block.
+	if (mode == RepackMode::Copy && rowSize == dstRowPitch && rowSize == srcRowPitch)
+	{
+		AddCopy(dst, src, rowSize * rowCount);
+
+		return;
+	}
+
+	auto dstStart = static_cast<std::uint8_t*>(dst);
+	auto srcStart = static_cast<std::uint8_t const*>(src);
+
+	const size_t rowsPerChunk = std::max<size_t>(m_chunkSize / std::max<size_t>(rowSize, 1u), 1u);
+
+	for (size_t rowIndex = 0u; rowIndex < rowCount; rowIndex += rowsPerChunk)
+		m_chunks.emplace_back(
+			Chunk{
+				.dst         = dstStart + rowIndex * dstRowPitch,
+				.src         = srcStart + rowIndex * srcRowPitch,
+				.rowSize     = rowSize,
+				.rowCount    = std::min(rowsPerChunk, rowCount - rowIndex),
+				.dstRowPitch = dstRowPitch,
+				.srcRowPitch = srcRowPitch,
+				.mode        = mode
+			}
+		);
+
+	m_copySize += rowSize * rowCount;
+}
+
+size_t ParallelCopyQueue::Distribute(size_t maxWorkerCount)
+{
+	const size_t chunkCount = std::size(m_chunks);
+
+	assert(chunkCount <= UINT32_MAX && "The chunk indices must fit in 32 bits.");
+
+	m_workerCount = std::min(maxWorkerCount, chunkCount);
+
+	if (m_workerCount > m_rangeCapacity)
+	{
+		m_ranges        = std::make_unique<std::atomic<std::uint64_t>[]>(m_workerCount);
+		m_rangeCapacity = m_workerCount;
+	}
+
+	// Each range should have roughly the same number of bytes. A range ends once the total
+	// size of the chunks so far reaches its share, but it should have at least one chunk, so
+	// each of the workers has something to start with.
+	size_t rangeStart  = 0u;
+	size_t chunkIndex  = 0u;
+	size_t copiedSoFar = 0u;
+
+	for (size_t workerIndex = 0u; workerIndex < m_workerCount; ++workerIndex)
+	{
+		const size_t remainingWorkers = m_workerCount - workerIndex - 1u;
+
+		if (remainingWorkers == 0u)
+			chunkIndex = chunkCount;
+		else
+		{
+			const size_t rangeEndSize = m_copySize / m_workerCount * (workerIndex + 1u);
+
+			do
+			{
+				const Chunk& chunk  = m_chunks[chunkIndex];
+				copiedSoFar        += chunk.rowSize * chunk.rowCount;
+
+				++chunkIndex;
+			} while (copiedSoFar < rangeEndSize && chunkCount - chunkIndex > remainingWorkers);
+		}
+
+		m_ranges[workerIndex].store(PackRange(rangeStart, chunkIndex), std::memory_order_relaxed);
+
+		rangeStart = chunkIndex;
+	}
+
+	return m_workerCount;
+}
+
+bool ParallelCopyQueue::PopFront(size_t workerIndex, size_t& chunkIndex) noexcept
+{
+	std::atomic<std::uint64_t>& range = m_ranges[workerIndex];
+
+	std::uint64_t packedRange = range.load(std::memory_order_relaxed);
+
+	while (true)
+	{
+		const std::uint64_t start = packedRange & UINT32_MAX;
+		const std::uint64_t end   = packedRange >> 32u;
+
+		if (start >= end)
+			return false;
+
+		if (range.compare_exchange_weak(
+			packedRange, PackRange(start + 1u, end), std::memory_order_relaxed
+		)) {
+			chunkIndex = static_cast<size_t>(start);
+
+			return true;
+		}
+	}
+}
+
+bool ParallelCopyQueue::StealBack(size_t workerIndex, size_t& chunkIndex) noexcept
+{
+	// Starting with the next worker, so the thieves don't all go after the same range.
+	for (size_t offset = 1u; offset < m_workerCount; ++offset)
+	{
+		std::atomic<std::uint64_t>& range = m_ranges[(workerIndex + offset) % m_workerCount];
+
+		std::uint64_t packedRange = range.load(std::memory_order_relaxed);
+
+		while (true)
+		{
+			const std::uint64_t start = packedRange & UINT32_MAX;
+			const std::uint64_t end   = packedRange >> 32u;
+
+			if (start >= end)
+				break;
+
+			if (range.compare_exchange_weak(
+				packedRange, PackRange(start, end - 1u), std::memory_order_relaxed
+			)) {
+				chunkIndex = static_cast<size_t>(end - 1u);
+
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void ParallelCopyQueue::CopyChunk(const Chunk& chunk) const noexcept
+{
+	m_rowRepacker.Repack(
+		chunk.dst, chunk.src, chunk.rowSize, chunk.rowCount, chunk.dstRowPitch, chunk.srcRowPitch,
+		chunk.mode
+	);
+}
+
+void ParallelCopyQueue::Run(size_t workerIndex) noexcept
+{
+	assert(workerIndex < m_workerCount && "The worker index is out of the distributed range.");
+
+	size_t chunkIndex = 0u;
+
+	// The chunks are only read here and each of them is claimed once. So, the ranges don't
+	// need to synchronise anything else.
+	while (PopFront(workerIndex, chunkIndex))
+		CopyChunk(m_chunks[chunkIndex]);
+
+	while (StealBack(workerIndex, chunkIndex))
+		CopyChunk(m_chunks[chunkIndex]);
+}
+
+void ParallelCopyQueue::Clear() noexcept
+{
+	m_chunks.clear();
+
+	m_copySize    = 0u;
+	m_workerCount = 0u;
+}
+}
@@ -0,0 +1,46 @@
+#include <RingAllocator.hpp>
+#include <AllocatorBase.hpp>
+
+namespace Gaia
+{
+RingAllocator::RingAllocator(UINT64 capacity)
+	: m_capacity{ capacity }, m_head{ 0u }, m_tail{ 0u }, m_submissionEnds{}
+{}
+
+std::optional<UINT64> RingAllocator::Allocate(UINT64 size, UINT64 alignment)
+{
+	if (size > m_capacity)
+		return {};
+
+	const UINT64 headOffset = m_head % m_capacity;
+	UINT64 offset           = Callisto::Align(headOffset, alignment);
+
+	// The allocation must be contiguous, so the rest of the ring is skipped.
+	if (offset + size > m_capacity)
+		offset = m_capacity;
+
+	const UINT64 start = m_head + (offset - headOffset);
+
+	if (start + size - m_tail > m_capacity)
+		return {};
+
+	m_head = start + size;
+
+	return offset % m_capacity;
+}
+
+void RingAllocator::Submit()
+{
+	m_submissionEnds.emplace(m_head);
+}
+
+void RingAllocator::ReleaseSubmission() noexcept
+{
+	if (std::empty(m_submissionEnds))
+		return;
+
+	m_tail = m_submissionEnds.front();
+
+	m_submissionEnds.pop();
+}
+}
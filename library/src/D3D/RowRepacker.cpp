@@ -0,0 +1,281 @@
+#include <RowRepacker.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <intrin.h>
+#include <immintrin.h>
+
+namespace Gaia
+{
+static constexpr std::uint32_t s_opaqueAlpha = 0xFF000000u;
+
+template<size_t alignment>
+[[nodiscard]]
+// The number of bytes before the first aligned address.
+static size_t GetHeadSize(std::uint8_t const* dst, size_t size) noexcept
+{
+	const auto address = reinterpret_cast<std::uintptr_t>(dst);
+
+	return std::min(static_cast<size_t>((alignment - address % alignment) % alignment), size);
+}
+
+[[nodiscard]]
+static std::uint32_t ExpandRGB8(std::uint8_t const* src) noexcept
+{
+	// The bytes of an RGBA8 pixel are in the R, G, B, A order in the memory.
+	return static_cast<std::uint32_t>(src[0]) | static_cast<std::uint32_t>(src[1]) << 8u
+		| static_cast<std::uint32_t>(src[2]) << 16u | s_opaqueAlpha;
+}
+
+static void ExpandPixelsScalar(
+	std::uint8_t* dst, std::uint8_t const* src, size_t pixelCount
+) noexcept {
+	for (size_t pixelIndex = 0u; pixelIndex < pixelCount; ++pixelIndex)
+	{
+		const std::uint32_t pixel = ExpandRGB8(src + pixelIndex * 3u);
+
+		memcpy(dst + pixelIndex * 4u, &pixel, sizeof(pixel));
+	}
+}
+
+// Scalar
+static void CopyRowScalar(std::uint8_t* dst, std::uint8_t const* src, size_t rowSize) noexcept
+{
+	memcpy(dst, src, rowSize);
+}
+
+static void ExpandRowScalar(std::uint8_t* dst, std::uint8_t const* src, size_t rowSize) noexcept
+{
+	ExpandPixelsScalar(dst, src, rowSize / 4u);
+}
+
+// SSE2
+static void CopyRowSSE2(std::uint8_t* dst, std::uint8_t const* src, size_t rowSize) noexcept
+{
+	const size_t headSize = GetHeadSize<16u>(dst, rowSize);
+
+	memcpy(dst, src, headSize);
+
+	size_t offset = headSize;
+
+	// A whole cache line at a time, so the write combining buffers are filled completely.
+	for (; offset + 64u <= rowSize; offset += 64u)
+	{
+		auto srcLine = reinterpret_cast<__m128i const*>(src + offset);
+		auto dstLine = reinterpret_cast<__m128i*>(dst + offset);
+
+		const __m128i first  = _mm_loadu_si128(srcLine);
+		const __m128i second = _mm_loadu_si128(srcLine + 1u);
+		const __m128i third  = _mm_loadu_si128(srcLine + 2u);
+		const __m128i fourth = _mm_loadu_si128(srcLine + 3u);
+
+		_mm_stream_si128(dstLine, first);
+		_mm_stream_si128(dstLine + 1u, second);
+		_mm_stream_si128(dstLine + 2u, third);
+		_mm_stream_si128(dstLine + 3u, fourth);
+	}
+
+	for (; offset + 16u <= rowSize; offset += 16u)
+		_mm_stream_si128(
+			reinterpret_cast<__m128i*>(dst + offset),
+			_mm_loadu_si128(reinterpret_cast<__m128i const*>(src + offset))
+		);
+
+	memcpy(dst + offset, src + offset, rowSize - offset);
+}
+
+static void ExpandRowSSE2(std::uint8_t* dst, std::uint8_t const* src, size_t rowSize) noexcept
+{
+	const size_t pixelCount = rowSize / 4u;
+
+	// The head pixels can't align the destination otherwise.
+	if (reinterpret_cast<std::uintptr_t>(dst) % 4u)
+	{
+		ExpandPixelsScalar(dst, src, pixelCount);
+
+		return;
+	}
+
+	const size_t headPixelCount = GetHeadSize<16u>(dst, pixelCount * 4u) / 4u;
+
+	ExpandPixelsScalar(dst, src, headPixelCount);
+
+	size_t pixelIndex = headPixelCount;
+
+	// SSE2 doesn't have a byte shuffle, so the pixels are expanded in the scalar registers and
+	// only the stores are vectorised.
+	for (; pixelIndex + 4u <= pixelCount; pixelIndex += 4u)
+	{
+		std::uint8_t const* pixelSrc = src + pixelIndex * 3u;
+
+		const __m128i pixels = _mm_setr_epi32(
+			static_cast<int>(ExpandRGB8(pixelSrc)), static_cast<int>(ExpandRGB8(pixelSrc + 3u)),
+			static_cast<int>(ExpandRGB8(pixelSrc + 6u)), static_cast<int>(ExpandRGB8(pixelSrc + 9u))
+		);
+
+		_mm_stream_si128(reinterpret_cast<__m128i*>(dst + pixelIndex * 4u), pixels);
+	}
+
+	ExpandPixelsScalar(
+		dst + pixelIndex * 4u, src + pixelIndex * 3u, pixelCount - pixelIndex
+	);
+}
+
+// AVX2
+static void CopyRowAVX2(std::uint8_t* dst, std::uint8_t const* src, size_t rowSize) noexcept
+{
+	const size_t headSize = GetHeadSize<32u>(dst, rowSize);
+
+	memcpy(dst, src, headSize);
+
+	size_t offset = headSize;
+
+	for (; offset + 64u <= rowSize; offset += 64u)
+	{
+		auto srcLine = reinterpret_cast<__m256i const*>(src + offset);
+		auto dstLine = reinterpret_cast<__m256i*>(dst + offset);
+
+		const __m256i first  = _mm256_loadu_si256(srcLine);
+		const __m256i second = _mm256_loadu_si256(srcLine + 1u);
+
+		_mm256_stream_si256(dstLine, first);
+		_mm256_stream_si256(dstLine + 1u, second);
+	}
+
+	if (offset + 32u <= rowSize)
+	{
+		_mm256_stream_si256(
+			reinterpret_cast<__m256i*>(dst + offset),
+			_mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + offset))
+		);
+
+		offset += 32u;
+	}
+
+	memcpy(dst + offset, src + offset, rowSize - offset);
+}
+
+static void ExpandRowAVX2(std::uint8_t* dst, std::uint8_t const* src, size_t rowSize) noexcept
+{
+	const size_t pixelCount = rowSize / 4u;
+
+	if (reinterpret_cast<std::uintptr_t>(dst) % 4u)
+	{
+		ExpandPixelsScalar(dst, src, pixelCount);
+
+		return;
+	}
+
+	const size_t headPixelCount = GetHeadSize<32u>(dst, pixelCount * 4u) / 4u;
+
+	ExpandPixelsScalar(dst, src, headPixelCount);
+
+	size_t pixelIndex = headPixelCount;
+
+	// Each lane has 4 pixels in its first 12 bytes. The shuffle spreads them out and leaves a
+	// zero byte for the alpha.
+	const __m256i shuffleMask = _mm256_setr_epi8(
+		0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+		0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1
+	);
+	const __m256i alphaMask   = _mm256_set1_epi32(static_cast<int>(s_opaqueAlpha));
+
+	// The second load reads 4 bytes past the 8 pixels. So, there must be at least 2 more pixels
+	// in the row, or it would read past the row.
+	for (; pixelIndex + 10u <= pixelCount; pixelIndex += 8u)
+	{
+		std::uint8_t const* pixelSrc = src + pixelIndex * 3u;
+
+		const __m128i lowPixels  = _mm_loadu_si128(reinterpret_cast<__m128i const*>(pixelSrc));
+		const __m128i highPixels = _mm_loadu_si128(
+			reinterpret_cast<__m128i const*>(pixelSrc + 12u)
+		);
+
+		const __m256i pixels = _mm256_inserti128_si256(
+			_mm256_castsi128_si256(lowPixels), highPixels, 1
+		);
+
+		_mm256_stream_si256(
+			reinterpret_cast<__m256i*>(dst + pixelIndex * 4u),
+			_mm256_or_si256(_mm256_shuffle_epi8(pixels, shuffleMask), alphaMask)
+		);
+	}
+
+	ExpandPixelsScalar(
+		dst + pixelIndex * 4u, src + pixelIndex * 3u, pixelCount - pixelIndex
+	);
+}
+
+template<void(*RepackRow)(std::uint8_t*, std::uint8_t const*, size_t) noexcept>
+static void RepackRows(
+	std::uint8_t* dst, std::uint8_t const* src, size_t rowSize, size_t rowCount,
+	size_t dstRowPitch, size_t srcRowPitch
+) noexcept {
+	for (size_t rowIndex = 0u; rowIndex < rowCount; ++rowIndex)
+	{
+		RepackRow(dst, src, rowSize);
+
+		if (dstRowPitch > rowSize)
+			memset(dst + rowSize, 0, dstRowPitch - rowSize);
+
+		dst += dstRowPitch;
+		src += srcRowPitch;
+	}
+}
+
+RowRepacker::RowRepacker(InstructionSet instructionSet)
+	: m_instructionSet{ instructionSet }, m_kernels{}
+{
+	assert(IsSupported(instructionSet) && "The CPU doesn't support the instruction set.");
+
+	if (instructionSet == InstructionSet::AVX2)
+		m_kernels = { RepackRows<CopyRowAVX2>, RepackRows<ExpandRowAVX2> };
+	else if (instructionSet == InstructionSet::SSE2)
+		m_kernels = { RepackRows<CopyRowSSE2>, RepackRows<ExpandRowSSE2> };
+	else
+		m_kernels = { RepackRows<CopyRowScalar>, RepackRows<ExpandRowScalar> };
+}
+
+void RowRepacker::Repack(
+	void* dst, void const* src, size_t rowSize, size_t rowCount, size_t dstRowPitch,
+	size_t srcRowPitch, RepackMode mode
+) const noexcept {
+	m_kernels[static_cast<size_t>(mode)](
+		static_cast<std::uint8_t*>(dst), static_cast<std::uint8_t const*>(src), rowSize, rowCount,
+		dstRowPitch, srcRowPitch
+	);
+
+	// The non-temporal stores are weakly ordered. So, they must be fenced before the copies
+	// are submitted.
+	if (m_instructionSet != InstructionSet::Scalar)
+		_mm_sfence();
+}
+
+RowRepacker::InstructionSet RowRepacker::GetSupportedInstructionSet() noexcept
+{
+	// SSE2 is a part of x64, so only AVX2 needs to be checked.
+	constexpr int osxsaveBit = 1 << 27;
+	constexpr int avxBit     = 1 << 28;
+	constexpr int avx2Bit    = 1 << 5;
+
+	int cpuInfo[4]{};
+
+	__cpuid(cpuInfo, 0);
+
+	if (cpuInfo[0] < 7)
+		return InstructionSet::SSE2;
+
+	__cpuid(cpuInfo, 1);
+
+	if (!(cpuInfo[2] & osxsaveBit) || !(cpuInfo[2] & avxBit))
+		return InstructionSet::SSE2;
+
+	// The OS must save the upper halves of the YMM registers as well.
+	if ((_xgetbv(0) & 0x6u) != 0x6u)
+		return InstructionSet::SSE2;
+
+	__cpuidex(cpuInfo, 7, 0);
+
+	return cpuInfo[1] & avx2Bit ? InstructionSet::AVX2 : InstructionSet::SSE2;
+}
+}
@@ -0,0 +1,72 @@
+#include <SlabAllocator.hpp>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace Gaia
+{
+static constexpr size_t s_slotsPerMask = 64u;
+
+SlabAllocator::SlabAllocator(size_t slotSize, size_t slabSize)
+	: m_slotSize{ slotSize }, m_slabSlotCount{ std::max(slabSize / slotSize, size_t{ 1u }) },
+	m_slotCount{ 0u }, m_allocatedSlotCount{ 0u }, m_freeSlotMasks{}, m_firstFreeMaskIndex{ 0u }
+{}
+
+void SlabAllocator::SetSlotFree(size_t slotIndex, bool isFree) noexcept
+{
+	const std::uint64_t slotBit = std::uint64_t{ 1u } << (slotIndex % s_slotsPerMask);
+	std::uint64_t& freeSlotMask = m_freeSlotMasks[slotIndex / s_slotsPerMask];
+
+	if (isFree)
+		freeSlotMask |= slotBit;
+	else
+		freeSlotMask &= ~slotBit;
+}
+
+size_t SlabAllocator::AddSlab()
+{
+	const size_t firstSlotIndex = m_slotCount;
+
+	m_slotCount += m_slabSlotCount;
+
+	m_freeSlotMasks.resize((m_slotCount + s_slotsPerMask - 1u) / s_slotsPerMask, 0u);
+
+	for (size_t slotIndex = firstSlotIndex; slotIndex < m_slotCount; ++slotIndex)
+		SetSlotFree(slotIndex, true);
+
+	m_firstFreeMaskIndex = std::min(m_firstFreeMaskIndex, firstSlotIndex / s_slotsPerMask);
+
+	return firstSlotIndex;
+}
+
+std::optional<size_t> SlabAllocator::Allocate() noexcept
+{
+	const size_t maskCount = std::size(m_freeSlotMasks);
+
+	while (m_firstFreeMaskIndex < maskCount && !m_freeSlotMasks[m_firstFreeMaskIndex])
+		++m_firstFreeMaskIndex;
+
+	if (m_firstFreeMaskIndex == maskCount)
+		return {};
+
+	const size_t slotIndex = m_firstFreeMaskIndex * s_slotsPerMask
+		+ static_cast<size_t>(std::countr_zero(m_freeSlotMasks[m_firstFreeMaskIndex]));
+
+	SetSlotFree(slotIndex, false);
+
+	++m_allocatedSlotCount;
+
+	return slotIndex;
+}
+
+void SlabAllocator::Deallocate(size_t slotIndex) noexcept
+{
+	assert(slotIndex < m_slotCount && "The slot index is out of range.");
+
+	SetSlotFree(slotIndex, true);
+
+	--m_allocatedSlotCount;
+
+	m_firstFreeMaskIndex = std::min(m_firstFreeMaskIndex, slotIndex / s_slotsPerMask);
+}
+}
@@ -0,0 +1,402 @@
+#include <TLSFAllocator.hpp>
+#include <AllocatorBase.hpp>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace Gaia
+{
+TLSFAllocator::TLSFAllocator(size_t startingAddress, size_t size, size_t granularity)
+	: m_startingAddress{ startingAddress }, m_size{ 0u }, m_granularity{ granularity },
+	m_availableSize{ 0u }, m_freeBlockCount{ 0u }, m_firstLevelBitmap{ 0u },
+	m_secondLevelBitmaps{}, m_freeHeads{}, m_blocks{}, m_unusedBlockIndices{},
+	m_allocatedBlocks{}
+{
+	assert(std::has_single_bit(granularity) && "The granularity must be a power of 2.");
+
+	m_secondLevelBitmaps.fill(0u);
+
+	for (std::array<size_t, s_secondLevelCount>& heads : m_freeHeads)
+		heads.fill(s_invalidIndex);
+
+	// Any remainder which is smaller than the granularity can't be allocated anyway.
+	m_size          = size - (size % granularity);
+	m_availableSize = m_size;
+
+	if (m_size)
+		InsertFreeBlock(CreateBlock(m_startingAddress, m_size, s_invalidIndex, s_invalidIndex));
+}
+
+size_t TLSFAllocator::GetMinimumRequiredNewAllocationSizeFor(
+	size_t allocationSize, size_t granularity
+) noexcept {
+	return Callisto::Align(allocationSize, granularity);
+}
+
+TLSFAllocator::ListIndex TLSFAllocator::GetListIndex(size_t unitCount) noexcept
+{
+	// The small blocks are put linearly in the first row.
+	if (unitCount < s_secondLevelCount)
+		return ListIndex{ .firstLevel = 0u, .secondLevel = unitCount };
+
+	const auto mostSignificantBit = static_cast<size_t>(std::bit_width(unitCount) - 1u);
+
+	return ListIndex
+	{
+		.firstLevel  = mostSignificantBit - s_secondLevelLog2 + 1u,
+		.secondLevel = (unitCount >> (mostSignificantBit - s_secondLevelLog2)) - s_secondLevelCount
+	};
+}
+
+std::optional<TLSFAllocator::ListIndex> TLSFAllocator::FindSuitableList(
+	size_t unitCount
+) const noexcept {
+	// The blocks in a list can be of any size in the range of the list. So, round the request up
+	// to the start of the next list, so whichever block we find would be big enough.
+	if (unitCount >= s_secondLevelCount)
+	{
+		const auto mostSignificantBit = static_cast<size_t>(std::bit_width(unitCount) - 1u);
+
+		unitCount += (size_t{ 1u } << (mostSignificantBit - s_secondLevelLog2)) - 1u;
+	}
+
+	ListIndex listIndex = GetListIndex(unitCount);
+
+	if (listIndex.firstLevel >= s_firstLevelCount)
+		return {};
+
+	std::uint32_t secondLevelMap
+		= m_secondLevelBitmaps[listIndex.firstLevel] & (~0u << listIndex.secondLevel);
+
+	if (!secondLevelMap)
+	{
+		const size_t nextFirstLevel = listIndex.firstLevel + 1u;
+
+		if (nextFirstLevel >= s_firstLevelCount)
+			return {};
+
+		const std::uint64_t firstLevelMap = m_firstLevelBitmap & (~0ull << nextFirstLevel);
+
+		if (!firstLevelMap)
+			return {};
+
+		listIndex.firstLevel = static_cast<size_t>(std::countr_zero(firstLevelMap));
+		secondLevelMap       = m_secondLevelBitmaps[listIndex.firstLevel];
+	}
+
+	listIndex.secondLevel = static_cast<size_t>(std::countr_zero(secondLevelMap));
+
+	return listIndex;
+}
+
+size_t TLSFAllocator::FindFittingBlock(size_t size, size_t alignment) const noexcept
+{
+	const ListIndex listIndex = GetListIndex(size / m_granularity);
+
+	if (listIndex.firstLevel >= s_firstLevelCount)
+		return s_invalidIndex;
+
+	for (size_t blockIndex = m_freeHeads[listIndex.firstLevel][listIndex.secondLevel];
+		blockIndex != s_invalidIndex; blockIndex = m_blocks[blockIndex].nextFree)
+	{
+		const Block& block         = m_blocks[blockIndex];
+		const size_t alignedOffset = Callisto::Align(block.offset, alignment);
+
+		if (alignedOffset + size <= block.offset + block.size)
+			return blockIndex;
+	}
+
+	return s_invalidIndex;
+}
+
+size_t TLSFAllocator::CreateBlock(
+	size_t offset, size_t size, size_t prevPhysical, size_t nextPhysical
+) {
+	const Block block
+	{
+		.offset       = offset,
+		.size         = size,
+		.prevPhysical = prevPhysical,
+		.nextPhysical = nextPhysical,
+		.prevFree     = s_invalidIndex,
+		.nextFree     = s_invalidIndex,
+		.isFree       = false
+	};
+
+	if (!std::empty(m_unusedBlockIndices))
+	{
+		const size_t blockIndex = m_unusedBlockIndices.back();
+		m_unusedBlockIndices.pop_back();
+
+		m_blocks[blockIndex] = block;
+
+		return blockIndex;
+	}
+
+	m_blocks.emplace_back(block);
+
+	// So releasing a block later never needs to allocate.
+	m_unusedBlockIndices.reserve(std::size(m_blocks));
+
+	return std::size(m_blocks) - 1u;
+}
+
+void TLSFAllocator::ReleaseBlock(size_t blockIndex) noexcept
+{
+	// The capacity was reserved when the block was created.
+	m_unusedBlockIndices.emplace_back(blockIndex);
+}
+
+void TLSFAllocator::InsertFreeBlock(size_t blockIndex) noexcept
+{
+	Block& block = m_blocks[blockIndex];
+
+	const ListIndex listIndex = GetListIndex(block.size / m_granularity);
+
+	size_t& head = m_freeHeads[listIndex.firstLevel][listIndex.secondLevel];
+
+	block.isFree   = true;
+	block.prevFree = s_invalidIndex;
+	block.nextFree = head;
+
+	if (head != s_invalidIndex)
+		m_blocks[head].prevFree = blockIndex;
+
+	head = blockIndex;
+
+	m_firstLevelBitmap |= 1ull << listIndex.firstLevel;
+	m_secondLevelBitmaps[listIndex.firstLevel] |= 1u << listIndex.secondLevel;
+
+	++m_freeBlockCount;
+}
+
+void TLSFAllocator::RemoveFreeBlock(size_t blockIndex) noexcept
+{
+	Block& block = m_blocks[blockIndex];
+
+	const ListIndex listIndex = GetListIndex(block.size / m_granularity);
+
+	if (block.prevFree != s_invalidIndex)
+		m_blocks[block.prevFree].nextFree = block.nextFree;
+	else
+		m_freeHeads[listIndex.firstLevel][listIndex.secondLevel] = block.nextFree;
+
+	if (block.nextFree != s_invalidIndex)
+		m_blocks[block.nextFree].prevFree = block.prevFree;
+
+	if (m_freeHeads[listIndex.firstLevel][listIndex.secondLevel] == s_invalidIndex)
+	{
+		std::uint32_t& secondLevelMap = m_secondLevelBitmaps[listIndex.firstLevel];
+
+		secondLevelMap &= ~(1u << listIndex.secondLevel);
+
+		if (!secondLevelMap)
+			m_firstLevelBitmap &= ~(1ull << listIndex.firstLevel);
+	}
+
+	block.isFree   = false;
+	block.prevFree = s_invalidIndex;
+	block.nextFree = s_invalidIndex;
+
+	--m_freeBlockCount;
+}
+
+size_t TLSFAllocator::SplitBlock(size_t blockIndex, size_t size)
+{
+	const size_t newBlockIndex = CreateBlock(
+		m_blocks[blockIndex].offset + size, m_blocks[blockIndex].size - size, blockIndex,
+		m_blocks[blockIndex].nextPhysical
+	);
+
+	// The vector might have been reallocated, so only take the reference now.
+	Block& block = m_blocks[blockIndex];
+
+	if (block.nextPhysical != s_invalidIndex)
+		m_blocks[block.nextPhysical].prevPhysical = newBlockIndex;
+
+	block.nextPhysical = newBlockIndex;
+	block.size         = size;
+
+	return newBlockIndex;
+}
+
+void TLSFAllocator::MergeWithNext(size_t blockIndex) noexcept
+{
+	Block& block               = m_blocks[blockIndex];
+	const size_t nextIndex     = block.nextPhysical;
+	const Block& nextBlock     = m_blocks[nextIndex];
+
+	block.size         += nextBlock.size;
+	block.nextPhysical  = nextBlock.nextPhysical;
+
+	if (block.nextPhysical != s_invalidIndex)
+		m_blocks[block.nextPhysical].prevPhysical = blockIndex;
+
+	ReleaseBlock(nextIndex);
+}
+
+std::optional<size_t> TLSFAllocator::Allocate(size_t size, size_t alignment)
+{
+	const size_t alignedSize = Callisto::Align(std::max(size, size_t{ 1u }), m_granularity);
+	alignment                = std::max(alignment, m_granularity);
+
+	if (alignedSize > m_availableSize)
+		return {};
+
+	size_t blockIndex = s_invalidIndex;
+
+	// Most of the time the free blocks should already be aligned, so check the head of the list
+	// for the size first.
+	if (std::optional<ListIndex> listIndex = FindSuitableList(alignedSize / m_granularity);
+		listIndex)
+	{
+		const size_t headIndex = m_freeHeads[listIndex->firstLevel][listIndex->secondLevel];
+		const size_t offset    = m_blocks[headIndex].offset;
+
+		if (Callisto::Align(offset, alignment) == offset)
+			blockIndex = headIndex;
+	}
+
+	if (blockIndex == s_invalidIndex)
+	{
+		// If the alignment is bigger than the granularity, the start of a free block might need
+		// some padding. So, look for a block which would fit the request in the worst case.
+		const size_t searchSize = alignedSize + alignment - m_granularity;
+
+		std::optional<ListIndex> listIndex = FindSuitableList(searchSize / m_granularity);
+
+		if (listIndex)
+			blockIndex = m_freeHeads[listIndex->firstLevel][listIndex->secondLevel];
+		else
+			blockIndex = FindFittingBlock(alignedSize, alignment);
+
+		if (blockIndex == s_invalidIndex)
+			return {};
+	}
+
+	RemoveFreeBlock(blockIndex);
+
+	const size_t allocationStart = Callisto::Align(m_blocks[blockIndex].offset, alignment);
+
+	AllocateFromBlock(blockIndex, allocationStart, alignedSize);
+
+	return allocationStart;
+}
+
+bool TLSFAllocator::AllocateAt(size_t offset, size_t size)
+{
+	const size_t alignedSize = Callisto::Align(std::max(size, size_t{ 1u }), m_granularity);
+
+	if (offset % m_granularity || alignedSize > m_availableSize)
+		return false;
+
+	// The free blocks aren't indexed by their offsets, so go through all of the free lists.
+	for (std::uint64_t firstLevelMap = m_firstLevelBitmap; firstLevelMap;
+		firstLevelMap &= firstLevelMap - 1u)
+	{
+		const auto firstLevel = static_cast<size_t>(std::countr_zero(firstLevelMap));
+
+		for (std::uint32_t secondLevelMap = m_secondLevelBitmaps[firstLevel]; secondLevelMap;
+			secondLevelMap &= secondLevelMap - 1u)
+		{
+			const auto secondLevel = static_cast<size_t>(std::countr_zero(secondLevelMap));
+
+			for (size_t blockIndex = m_freeHeads[firstLevel][secondLevel];
+				blockIndex != s_invalidIndex; blockIndex = m_blocks[blockIndex].nextFree)
+			{
+				const Block& block = m_blocks[blockIndex];
+
+				if (offset < block.offset || offset + alignedSize > block.offset + block.size)
+					continue;
+
+				RemoveFreeBlock(blockIndex);
+
+				AllocateFromBlock(blockIndex, offset, alignedSize);
+
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void TLSFAllocator::AllocateFromBlock(size_t blockIndex, size_t offset, size_t alignedSize)
+{
+	// The padding will be a multiple of the granularity, so it can be a free block on its own.
+	if (const size_t padding = offset - m_blocks[blockIndex].offset; padding)
+	{
+		const size_t paddingBlockIndex = blockIndex;
+
+		blockIndex = SplitBlock(paddingBlockIndex, padding);
+
+		InsertFreeBlock(paddingBlockIndex);
+	}
+
+	// The next physical block can't be free, as free blocks are always merged. So, the leftover
+	// can be put into the free lists as it is.
+	if (m_blocks[blockIndex].size > alignedSize)
+		InsertFreeBlock(SplitBlock(blockIndex, alignedSize));
+
+	m_availableSize -= alignedSize;
+
+	m_allocatedBlocks.emplace(offset, blockIndex);
+}
+
+void TLSFAllocator::Deallocate(size_t startingAddress) noexcept
+{
+	auto result = m_allocatedBlocks.find(startingAddress);
+
+	assert(result != std::end(m_allocatedBlocks) && "This address wasn't allocated.");
+
+	if (result == std::end(m_allocatedBlocks))
+		return;
+
+	size_t blockIndex = result->second;
+
+	m_allocatedBlocks.erase(result);
+
+	m_availableSize += m_blocks[blockIndex].size;
+
+	// Coalesce with the physical neighbours right away, so the free lists never contain
+	// two adjacent blocks.
+	if (const size_t nextIndex = m_blocks[blockIndex].nextPhysical;
+		nextIndex != s_invalidIndex && m_blocks[nextIndex].isFree)
+	{
+		RemoveFreeBlock(nextIndex);
+		MergeWithNext(blockIndex);
+	}
+
+	if (const size_t prevIndex = m_blocks[blockIndex].prevPhysical;
+		prevIndex != s_invalidIndex && m_blocks[prevIndex].isFree)
+	{
+		RemoveFreeBlock(prevIndex);
+		MergeWithNext(prevIndex);
+
+		blockIndex = prevIndex;
+	}
+
+	InsertFreeBlock(blockIndex);
+}
+
+size_t TLSFAllocator::LargestFreeBlockSize() const noexcept
+{
+	if (!m_firstLevelBitmap)
+		return 0u;
+
+	const auto firstLevel  = static_cast<size_t>(std::bit_width(m_firstLevelBitmap) - 1u);
+	const auto secondLevel = static_cast<size_t>(
+		std::bit_width(m_secondLevelBitmaps[firstLevel]) - 1u
+	);
+
+	// The blocks in the last non-empty list can have different sizes, so we have to check
+	// all of them.
+	size_t largestSize = 0u;
+
+	for (size_t blockIndex = m_freeHeads[firstLevel][secondLevel]; blockIndex != s_invalidIndex;
+		blockIndex = m_blocks[blockIndex].nextFree)
+		largestSize = std::max(largestSize, m_blocks[blockIndex].size);
+
+	return largestSize;
+}
+}
@@ -1,27 +1,59 @@
 #ifndef TEXTURE_SOL_HPP_
 #define TEXTURE_SOL_HPP_
+#include <cstdint>
 #include <memory>
 
+enum class STextureFormat : std::uint8_t
+{
+	RGBA8,
+	// Expanded to RGBA8 with an opaque alpha, while being uploaded.
+	RGB8,
+	// Block compressed. The colour ones are in the space of the srgb flag, like RGBA8. BC5 has
+	// two linear channels, for the normal maps.
+	BC1,
+	BC3,
+	BC5,
+	BC7
+};
+
 struct STexture
 {
-	STexture() : data{}, width{ 0u }, height{ 0u } {}
+	STexture()
+		: data{}, width{ 0u }, height{ 0u }, format{ STextureFormat::RGBA8 },
+		mipLevelCount{ 1u }, generateMips{ false }, srgb{ true }
+	{}
 
 	std::shared_ptr<void> data;
 	std::uint32_t         width;
 	std::uint32_t         height;
+	STextureFormat        format;
+	// If there are multiple mips in the data, they should be tightly packed one after another,
+	// like in a DDS file.
+	std::uint16_t         mipLevelCount;
+	// The mip chain is generated on the CPU while the texture is being added.
+	bool                  generateMips;
+	// If the colours are in the sRGB space. Otherwise, they are linear, like the data of a
+	// UNORM format. Doesn't affect BC5.
+	bool                  srgb;
 
 	STexture(const STexture&) = delete;
 	STexture& operator=(const STexture&) = delete;
 
 	STexture(STexture&& tex) noexcept
-		: data{ std::move(tex.data) }, width{ tex.width }, height{ tex.height }
+		: data{ std::move(tex.data) }, width{ tex.width }, height{ tex.height },
+		format{ tex.format }, mipLevelCount{ tex.mipLevelCount }, generateMips{ tex.generateMips },
+		srgb{ tex.srgb }
 	{}
 
 	STexture& operator=(STexture&& tex) noexcept
 	{
-		data   = std::move(tex.data);
-		width  = tex.width;
-		height = tex.height;
+		data          = std::move(tex.data);
+		width         = tex.width;
+		height        = tex.height;
+		format        = tex.format;
+		mipLevelCount = tex.mipLevelCount;
+		generateMips  = tex.generateMips;
+		srgb          = tex.srgb;
 
 		return *this;
 	}
@@ -0,0 +1,35 @@
+#ifndef FAKE_HEAP_PROVIDER_HPP_
+#define FAKE_HEAP_PROVIDER_HPP_
+#include <D3DAllocator.hpp>
+
+namespace Gaia
+{
+// Creates the heaps without a device, so the allocation logic can be tested on the CPU. The
+// resources are sized like the buffers with the default 64KB alignment.
+class FakeHeapProvider
+{
+public:
+	FakeHeapProvider(
+		[[maybe_unused]] IDXGIAdapter3* adapter, [[maybe_unused]] ID3D12Device* device
+	) {}
+
+	[[nodiscard]]
+	D3DHeap CreateHeap(D3D12_HEAP_TYPE type, UINT64 size, [[maybe_unused]] bool msaa) const
+	{
+		return D3DHeap{ type, size };
+	}
+
+	[[nodiscard]]
+	UINT64 GetAvailableMemory() const noexcept { return 4_GB; }
+
+	[[nodiscard]]
+	D3D12_RESOURCE_ALLOCATION_INFO GetAllocationInfo(
+		const D3D12_RESOURCE_DESC& resourceDesc
+	) const noexcept {
+		return { .SizeInBytes = Callisto::Align(resourceDesc.Width, 64_KB), .Alignment = 64_KB };
+	}
+};
+
+using FakeMemoryManager = MemoryManagerGeneric<FakeHeapProvider>;
+}
+#endif
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <vector>
+
+#include <D3DAllocator.hpp>
+#include <D3DAllocationTraceRecorder.hpp>
+#include <D3DAllocationTraceReplayer.hpp>
+#include <FakeHeapProvider.hpp>
+
+using namespace Gaia;
+
+[[nodiscard]]
+static D3D12_RESOURCE_DESC GetBufferDesc(UINT64 size) noexcept
+{
+	return D3D12_RESOURCE_DESC
+	{
+		.Dimension        = D3D12_RESOURCE_DIMENSION_BUFFER,
+		.Alignment        = 0u,
+		.Width            = size,
+		.Height           = 1u,
+		.DepthOrArraySize = 1u,
+		.MipLevels        = 1u,
+		.Format           = DXGI_FORMAT_UNKNOWN,
+		.SampleDesc       = { .Count = 1u, .Quality = 0u },
+		.Layout           = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
+		.Flags            = D3D12_RESOURCE_FLAG_NONE
+	};
+}
+
+TEST(AllocationTraceTest, RecordAndReplayTest)
+{
+	using EventType = AllocationTraceRecorder::EventType;
+
+	const std::string tracePath
+		= (std::filesystem::temp_directory_path() / "GaiaXAllocationTraceTest.gtrc").string();
+
+	{
+		AllocationTraceRecorder traceRecorder{ tracePath };
+
+		FakeMemoryManager memoryManager{ nullptr, nullptr, 20_MB, 400_KB };
+
+		memoryManager.SetTraceRecorder(&traceRecorder);
+
+		std::vector<FakeMemoryManager::MemoryAllocation> allocations{};
+
+		for (size_t index = 0u; index < 8u; ++index)
+			allocations.emplace_back(
+				memoryManager.Allocate(GetBufferDesc(1_MB), D3D12_HEAP_TYPE_DEFAULT)
+			);
+
+		traceRecorder.AdvanceFrame();
+
+		// Frees every other allocation, so the heap has some holes.
+		for (size_t index = 0u; index < std::size(allocations); index += 2u)
+			memoryManager.Deallocate(allocations[index], D3D12_HEAP_TYPE_DEFAULT);
+
+		memoryManager.Deallocate(
+			memoryManager.Allocate(GetBufferDesc(64_KB), D3D12_HEAP_TYPE_UPLOAD),
+			D3D12_HEAP_TYPE_UPLOAD
+		);
+
+		traceRecorder.AdvanceFrame();
+
+		traceRecorder.RecordSharedBufferEvent(EventType::SharedAllocate, 0u, 0u, 256u);
+		traceRecorder.RecordSharedBufferEvent(EventType::SharedAllocate, 0u, 256u, 512u);
+		traceRecorder.RecordSharedBufferEvent(EventType::SharedRelinquish, 0u, 0u, 256u);
+		// Allocated before the recording started.
+		traceRecorder.RecordSharedBufferEvent(EventType::SharedRelinquish, 1u, 0u, 128u);
+
+		memoryManager.SetTraceRecorder(nullptr);
+
+		for (size_t index = 1u; index < std::size(allocations); index += 2u)
+			memoryManager.Deallocate(allocations[index], D3D12_HEAP_TYPE_DEFAULT);
+	}
+
+	const std::vector<AllocationTraceRecorder::Event> events
+		= AllocationTraceRecorder::ReadTrace(tracePath);
+
+	std::filesystem::remove(tracePath);
+
+	ASSERT_EQ(std::size(events), 18u) << "The events weren't all recorded.";
+
+	EXPECT_EQ(events.front().type, EventType::Allocate) << "The first event isn't an allocation.";
+	EXPECT_EQ(events.front().size, 1_MB) << "The allocation size wasn't recorded.";
+	EXPECT_EQ(events.front().alignment, 64_KB) << "The alignment wasn't recorded.";
+	EXPECT_EQ(events.front().frameNumber, 0u) << "The frame number is wrong.";
+	EXPECT_EQ(
+		AllocationTraceRecorder::GetHeapType(events.front()), D3D12_HEAP_TYPE_DEFAULT
+	) << "The heap type wasn't recorded.";
+
+	EXPECT_EQ(events[8u].type, EventType::Deallocate) << "The deallocation wasn't recorded.";
+	EXPECT_EQ(events[8u].offset, events.front().offset) << "The offsets don't match.";
+	EXPECT_EQ(events[8u].frameNumber, 1u) << "The frame wasn't advanced.";
+	EXPECT_EQ(
+		AllocationTraceRecorder::GetHeapType(events[12u]), D3D12_HEAP_TYPE_UPLOAD
+	) << "The upload heap type wasn't recorded.";
+	EXPECT_EQ(events.back().frameNumber, 2u) << "The frame wasn't advanced.";
+
+	for (HeapAllocatorType allocatorType : { HeapAllocatorType::Buddy, HeapAllocatorType::TLSF })
+	{
+		AllocationTraceReplayer::Settings settings = AllocationTraceReplayer::GetDefaultSettings();
+
+		settings.allocatorType = allocatorType;
+
+		const AllocationTraceReplayer::Report report
+			= AllocationTraceReplayer{ settings }.Replay(events);
+
+		EXPECT_EQ(report.eventCount, 18u) << "The events weren't all replayed.";
+		EXPECT_EQ(report.unmatchedEventCount, 1u) << "The unmatched release wasn't counted.";
+		EXPECT_EQ(report.frameCount, 3u) << "The frame count is wrong.";
+		EXPECT_EQ(report.peakHeapUsedSize, 8_MB) << "The peak used heap size is wrong.";
+		EXPECT_GE(report.peakHeapSize, report.peakHeapUsedSize)
+			<< "The heaps are smaller than their allocations.";
+		EXPECT_EQ(report.peakSharedBufferUsedSize, 768u) << "The peak used buffer size is wrong.";
+		EXPECT_EQ(report.peakSharedBufferSize, 64_KB)
+			<< "The buffer didn't grow like the shared buffers.";
+		EXPECT_GE(report.averageHeapFragmentation, 0.f) << "The fragmentation is negative.";
+		EXPECT_LE(report.averageHeapFragmentation, 1.f) << "The fragmentation is over 1.";
+	}
+}
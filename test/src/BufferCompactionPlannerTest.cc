@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <map>
+
+#include <AllocatorBase.hpp>
+#include <D3DBufferCompactionPlanner.hpp>
+#include <FreeRegionAllocator.hpp>
+
+using namespace Gaia;
+
+TEST(BufferCompactionPlannerTest, PlanTest)
+{
+	// The allocations of a 1MB buffer with holes at 64KB and 256KB.
+	const std::map<UINT64, UINT64> liveAllocations
+	{
+		{ 0u, 64_KB }, { 128_KB, 128_KB }, { 512_KB, 64_KB }, { 768_KB, 32_KB }
+	};
+	const std::map<UINT64, UINT64> freeRegions
+	{
+		{ 64_KB, 64_KB }, { 256_KB, 256_KB }, { 576_KB, 192_KB }, { 800_KB, 224_KB }
+	};
+
+	EXPECT_EQ(BufferCompactionPlanner::GetUsedEnd(liveAllocations), 800_KB)
+		<< "The end of the last allocation is wrong.";
+
+	{
+		const BufferCompactionPlanner::Plan plan = BufferCompactionPlanner::CreatePlan(
+			freeRegions, liveAllocations, 1_MB
+		);
+
+		// The allocation at 128KB doesn't fit in the rest of the first hole and the other holes
+		// are after it.
+		ASSERT_EQ(std::size(plan.moves), 2u) << "Two allocations should be moved.";
+		EXPECT_EQ(plan.movedBytes, 96_KB) << "The moved size is wrong.";
+
+		EXPECT_EQ(plan.moves[0].srcOffset, 768_KB) << "The last allocation wasn't moved first.";
+		EXPECT_EQ(plan.moves[0].dstOffset, 64_KB) << "The lowest region wasn't used.";
+		EXPECT_EQ(plan.moves[1].srcOffset, 512_KB) << "The allocation wasn't moved.";
+		EXPECT_EQ(plan.moves[1].dstOffset, 256_KB) << "The rest of the first hole is too small.";
+	}
+
+	{
+		const BufferCompactionPlanner::Plan plan = BufferCompactionPlanner::CreatePlan(
+			freeRegions, liveAllocations, 1u
+		);
+
+		ASSERT_EQ(std::size(plan.moves), 1u) << "The budget should stop the plan.";
+		EXPECT_EQ(plan.movedBytes, 32_KB) << "The last move should go over the budget.";
+	}
+
+	{
+		const BufferCompactionPlanner::Plan plan = BufferCompactionPlanner::CreatePlan(
+			{ { 800_KB, 224_KB } }, liveAllocations, 1_MB
+		);
+
+		EXPECT_TRUE(std::empty(plan.moves)) << "Moved an allocation to a higher offset.";
+	}
+}
+
+TEST(BufferCompactionPlannerTest, ApplyPlanTest)
+{
+	FreeRegionAllocator allocator{};
+	std::map<UINT64, UINT64> liveAllocations{};
+
+	// 16 allocations of 4KB, where every other one has been freed.
+	for (UINT64 index = 0u; index < 16u; ++index)
+		if (index % 2u)
+			liveAllocations.emplace(index * 4_KB, 4_KB);
+		else
+			allocator.Deallocate(index * 4_KB, 4_KB);
+
+	// Applies the plans like the shared buffers do, until nothing can be moved.
+	for (size_t pass = 0u; pass < 16u; ++pass)
+	{
+		const BufferCompactionPlanner::Plan plan = BufferCompactionPlanner::CreatePlan(
+			allocator.GetFreeRegions(), liveAllocations, 8_KB
+		);
+
+		if (std::empty(plan.moves))
+			break;
+
+		EXPECT_LE(plan.movedBytes, 8_KB) << "The budget was ignored.";
+
+		for (const BufferCompactionPlanner::Move& move : plan.moves)
+			EXPECT_TRUE(allocator.AllocateAt(move.dstOffset, move.size))
+				<< "The destination isn't free.";
+
+		for (const BufferCompactionPlanner::Move& move : plan.moves)
+		{
+			allocator.Deallocate(move.srcOffset, move.size);
+
+			liveAllocations.erase(move.srcOffset);
+			liveAllocations.emplace(move.dstOffset, move.size);
+		}
+	}
+
+	EXPECT_EQ(BufferCompactionPlanner::GetUsedEnd(liveAllocations), 32_KB)
+		<< "The allocations weren't packed.";
+	EXPECT_EQ(allocator.GetFreeRegionCount(), 1u) << "The free space isn't in a single region.";
+	EXPECT_EQ(allocator.RemoveTrailingRegion(64_KB).value(), 32_KB)
+		<< "The free space isn't at the end.";
+}
+
+TEST(BufferCompactionPlannerTest, AllocateAtTest)
+{
+	FreeRegionAllocator allocator{};
+
+	allocator.Deallocate(64u, 64u);
+
+	EXPECT_FALSE(allocator.AllocateAt(32u, 16u)) << "Allocated outside the free regions.";
+	EXPECT_FALSE(allocator.AllocateAt(96u, 64u)) << "Allocated past the end of the region.";
+	EXPECT_TRUE(allocator.AllocateAt(80u, 16u)) << "The range couldn't be allocated.";
+
+	EXPECT_EQ(allocator.GetFreeRegionCount(), 2u) << "The region wasn't split.";
+	EXPECT_EQ(allocator.GetFreeSize(), 48u) << "The free size is wrong.";
+	EXPECT_EQ(allocator.GetFreeRegions().at(64u), 16u) << "The part before the range is wrong.";
+	EXPECT_EQ(allocator.GetFreeRegions().at(96u), 32u) << "The part after the range is wrong.";
+}
@@ -0,0 +1,281 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <D3DAllocator.hpp>
+
+using namespace Gaia;
+
+// The heaps don't need any memory for the bookkeeping, so these tests don't need a device.
+static D3DHeap CreateFakeHeap(UINT64 size)
+{
+	return D3DHeap{ D3D12_HEAP_TYPE_DEFAULT, size };
+}
+
+TEST(D3DAllocatorGroupTest, IndexTest)
+{
+	D3DAllocatorGroup allocators{ HeapAllocatorType::TLSF };
+
+	const std::uint16_t firstID  = allocators.AddAllocator(CreateFakeHeap(8_MB));
+	const std::uint16_t secondID = allocators.AddAllocator(CreateFakeHeap(32_MB));
+
+	EXPECT_EQ(firstID, 0u) << "The first ID isn't 0.";
+	EXPECT_EQ(secondID, 1u) << "The second ID isn't 1.";
+
+	{
+		// Should skip the first allocator, as it can't house the allocation.
+		std::optional<D3DAllocatorGroup::Allocation> allocation = allocators.Allocate(
+			{ .SizeInBytes = 16_MB, .Alignment = 64_KB }
+		);
+
+		ASSERT_TRUE(allocation.has_value()) << "Allocation failed.";
+		EXPECT_EQ(allocation->memoryID, secondID) << "The allocation wasn't on the second heap.";
+
+		// The first allocator can house this one, so it should be tried first.
+		std::optional<D3DAllocatorGroup::Allocation> smallAllocation = allocators.Allocate(
+			{ .SizeInBytes = 4_MB, .Alignment = 64_KB }
+		);
+
+		ASSERT_TRUE(smallAllocation.has_value()) << "Allocation failed.";
+		EXPECT_EQ(smallAllocation->memoryID, firstID) << "The allocation wasn't on the first heap.";
+
+		const bool isEmpty = allocators.Deallocate(
+			allocation->memoryID, allocation->heapOffset, 16_MB, 64_KB
+		);
+
+		EXPECT_TRUE(isEmpty) << "The second heap should be empty.";
+	}
+
+	allocators.RemoveAllocator(firstID);
+
+	EXPECT_EQ(allocators.GetAllocatorCount(), 1u) << "The allocator count isn't 1.";
+
+	{
+		// The removed ID should be reused.
+		const std::uint16_t thirdID = allocators.AddAllocator(CreateFakeHeap(8_MB));
+
+		EXPECT_EQ(thirdID, firstID) << "The ID wasn't reused.";
+
+		std::optional<D3DAllocatorGroup::Allocation> allocation = allocators.Allocate(
+			{ .SizeInBytes = 20_MB, .Alignment = 64_KB }
+		);
+
+		ASSERT_TRUE(allocation.has_value()) << "Allocation failed.";
+		EXPECT_EQ(allocation->memoryID, secondID) << "The moved allocator wasn't found.";
+
+		std::optional<D3DAllocatorGroup::Allocation> tooBig = allocators.Allocate(
+			{ .SizeInBytes = 16_MB, .Alignment = 64_KB }
+		);
+
+		EXPECT_FALSE(tooBig.has_value()) << "The allocation shouldn't have succeeded.";
+	}
+}
+
+TEST(D3DAllocatorGroupTest, AllocateAtTest)
+{
+	for (HeapAllocatorType allocatorType : { HeapAllocatorType::Buddy, HeapAllocatorType::TLSF })
+	{
+		D3DAllocatorGroup allocators{ allocatorType };
+
+		const std::uint16_t id = allocators.AddAllocator(CreateFakeHeap(8_MB));
+
+		std::optional<D3DAllocatorGroup::Allocation> allocation = allocators.AllocateAt(
+			id, 4_MB, { .SizeInBytes = 1_MB, .Alignment = 64_KB }
+		);
+
+		ASSERT_TRUE(allocation.has_value()) << "Allocation failed.";
+		EXPECT_EQ(allocation->heapOffset, 4_MB) << "The allocation isn't at the offset.";
+
+		std::optional<D3DAllocatorGroup::Allocation> usedAllocation = allocators.AllocateAt(
+			id, 4_MB, { .SizeInBytes = 1_MB, .Alignment = 64_KB }
+		);
+
+		EXPECT_FALSE(usedAllocation.has_value()) << "An allocated range was allocated again.";
+		// The skipped blocks of the buddy allocator must have been returned.
+		EXPECT_EQ(allocators.GetAllocators().front().AvailableSize(), 7_MB)
+			<< "The available size isn't 7MB.";
+
+		const bool isEmpty = allocators.Deallocate(id, allocation->heapOffset, 1_MB, 64_KB);
+
+		EXPECT_TRUE(isEmpty) << "The heap should be empty.";
+	}
+}
+
+TEST(D3DAllocatorGroupTest, DISABLED_MixedAllocationBenchmark)
+{
+	// Runs the same sequence with the indexed group and with a linear search over the heaps,
+	// which is how the MemoryManager used to find an allocator. The heaps are small, so a few
+	// hundred of them are created. The results are recorded as the properties of the test.
+	constexpr UINT64 heapSize       = 64_MB;
+	constexpr size_t operationCount = 100'000u;
+
+	struct Operation
+	{
+		bool   allocate;
+		UINT64 size;
+		size_t freeIndex;
+	};
+
+	std::vector<Operation> operations{};
+
+	{
+		std::mt19937_64 randomEngine{ 4321u };
+		std::uniform_int_distribution<UINT64> blockCount{ 1u, 64u };
+		std::uniform_int_distribution<size_t> percent{ 0u, 99u };
+		std::uniform_int_distribution<size_t> anyIndex{};
+
+		for (size_t _ = 0u; _ < operationCount; ++_)
+		{
+			const bool allocate = percent(randomEngine) < 55u;
+
+			operations.emplace_back(
+				Operation{ allocate, blockCount(randomEngine) * 64_KB, anyIndex(randomEngine) }
+			);
+		}
+	}
+
+	struct Allocation
+	{
+		UINT64        offset;
+		UINT64        size;
+		std::uint16_t memoryID;
+	};
+
+	auto Replay = [&operations]<typename Allocate_t, typename Deallocate_t>
+		(Allocate_t&& allocate, Deallocate_t&& deallocate) -> double
+	{
+		std::vector<Allocation> liveAllocations{};
+
+		const auto startTime = std::chrono::steady_clock::now();
+
+		for (const Operation& operation : operations)
+		{
+			if (operation.allocate || std::empty(liveAllocations))
+				liveAllocations.emplace_back(allocate(operation.size));
+			else
+			{
+				const size_t freeIndex = operation.freeIndex % std::size(liveAllocations);
+
+				deallocate(liveAllocations[freeIndex]);
+
+				liveAllocations[freeIndex] = liveAllocations.back();
+				liveAllocations.pop_back();
+			}
+		}
+
+		const auto elapsedTime = std::chrono::duration<double, std::nano>{
+			std::chrono::steady_clock::now() - startTime
+		};
+
+		return elapsedTime.count() / static_cast<double>(operationCount);
+	};
+
+	struct BenchmarkResult
+	{
+		size_t heapCount;
+		size_t failedCount;
+		double nanosecondsPerOperation;
+	};
+
+	auto RunIndexed = [&Replay](HeapAllocatorType allocatorType) -> BenchmarkResult
+	{
+		D3DAllocatorGroup allocators{ allocatorType };
+		size_t failedCount = 0u;
+
+		const double time = Replay(
+			[&allocators, &failedCount](UINT64 size) -> Allocation
+			{
+				const D3D12_RESOURCE_ALLOCATION_INFO allocInfo{ .SizeInBytes = size, .Alignment = 64_KB };
+
+				std::optional<D3DAllocatorGroup::Allocation> allocation = allocators.Allocate(allocInfo);
+
+				if (!allocation)
+					allocation = allocators.AllocateFrom(
+						allocators.AddAllocator(CreateFakeHeap(heapSize)), allocInfo
+					);
+
+				if (!allocation)
+				{
+					++failedCount;
+
+					return Allocation{ 0u, 0u, 0u };
+				}
+
+				return Allocation{ allocation->heapOffset, size, allocation->memoryID };
+			},
+			[&allocators](const Allocation& allocation)
+			{
+				if (allocation.size)
+					allocators.Deallocate(
+						allocation.memoryID, allocation.offset, allocation.size, 64_KB
+					);
+			}
+		);
+
+		return BenchmarkResult{ allocators.GetAllocatorCount(), failedCount, time };
+	};
+
+	auto RunLinear = [&Replay](HeapAllocatorType allocatorType) -> BenchmarkResult
+	{
+		std::vector<D3DAllocator> allocators{};
+
+		const double time = Replay(
+			[&allocators, allocatorType](UINT64 size) -> Allocation
+			{
+				const D3D12_RESOURCE_ALLOCATION_INFO allocInfo{ .SizeInBytes = size, .Alignment = 64_KB };
+
+				for (D3DAllocator& allocator : allocators)
+					if (allocator.AvailableSize() >= size)
+						if (std::optional<UINT64> offset = allocator.Allocate(allocInfo); offset)
+							return Allocation{ offset.value(), size, allocator.GetID() };
+
+				const auto newID = static_cast<std::uint16_t>(std::size(allocators));
+
+				D3DAllocator& allocator = allocators.emplace_back(
+					CreateFakeHeap(heapSize), newID, allocatorType
+				);
+
+				return Allocation{ allocator.Allocate(allocInfo).value(), size, newID };
+			},
+			[&allocators](const Allocation& allocation)
+			{
+				auto result = std::ranges::find_if(
+					allocators,
+					[id = allocation.memoryID](const D3DAllocator& alloc)
+					{
+						return alloc.GetID() == id;
+					}
+				);
+
+				result->Deallocate(allocation.offset, allocation.size, 64_KB);
+			}
+		);
+
+		return BenchmarkResult{ std::size(allocators), 0u, time };
+	};
+
+	for (HeapAllocatorType allocatorType : { HeapAllocatorType::Buddy, HeapAllocatorType::TLSF })
+	{
+		const BenchmarkResult indexedResult = RunIndexed(allocatorType);
+		const BenchmarkResult linearResult  = RunLinear(allocatorType);
+
+		const std::string typeName = allocatorType == HeapAllocatorType::TLSF ? "TLSF" : "Buddy";
+
+		RecordProperty(typeName + "_indexedHeaps", static_cast<int>(indexedResult.heapCount));
+		RecordProperty(typeName + "_linearHeaps", static_cast<int>(linearResult.heapCount));
+		RecordProperty(
+			typeName + "_indexedNsPerOperation",
+			std::to_string(indexedResult.nanosecondsPerOperation)
+		);
+		RecordProperty(
+			typeName + "_linearNsPerOperation",
+			std::to_string(linearResult.nanosecondsPerOperation)
+		);
+
+		EXPECT_EQ(indexedResult.failedCount, 0u) << "Some of the allocations failed.";
+		EXPECT_GT(indexedResult.heapCount, 100u) << "The benchmark should create a lot of heaps.";
+	}
+}
@@ -1,8 +1,10 @@
 #include <D3DDeviceManager.hpp>
 #include <gtest/gtest.h>
+#include <filesystem>
 #include <memory>
 
 #include <D3DSharedBuffer.hpp>
+#include <D3DAllocationTraceRecorder.hpp>
 
 using namespace Gaia;
 
@@ -45,6 +47,9 @@ TEST_F(D3DSharedBufferTest, SharedBufferTest)
 		device, &memoryManager, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS
 	};
 
+	// So the sizes can be checked after each allocation.
+	sharedBuffer.SetGrowthPolicy(SharedBufferGrowthPolicy::GetExactPolicy());
+
 	Callisto::TemporaryDataBufferGPU tempDataBuffer{};
 
 	{
@@ -65,6 +70,8 @@ TEST_F(D3DSharedBufferTest, SharedBufferTest)
 		EXPECT_EQ(size, 24u) << "Size isn't 24Bytes.";
 
 		sharedBuffer.RelinquishMemory(allocInfo);
+		// The GPU isn't using the buffer, so the region can be freed right away.
+		sharedBuffer.ReleaseRetiredRegions(0u);
 	}
 
 	{
@@ -142,6 +149,7 @@ TEST_F(D3DSharedBufferTest, SharedBufferTest)
 	}
 
 	sharedBuffer.RelinquishMemory(twentyKBAllocInfo);
+	sharedBuffer.ReleaseRetiredRegions(0u);
 
 	{
 		auto allocInfo = sharedBuffer.AllocateAndGetSharedData(20_KB, tempDataBuffer);
@@ -161,3 +169,342 @@ TEST_F(D3DSharedBufferTest, SharedBufferTest)
 		EXPECT_EQ(size, 100_KB + midOffset) << "Size isn't 100KB.";
 	}
 }
+
+TEST_F(D3DSharedBufferTest, GeometricGrowthTest)
+{
+	ID3D12Device5* device  = s_deviceManager->GetDevice();
+	IDXGIAdapter3* adapter = s_deviceManager->GetAdapter();
+
+	MemoryManager memoryManager{ adapter, device, 20_MB, 200_KB };
+
+	SharedBufferGPU sharedBuffer{ device, &memoryManager };
+
+	Callisto::TemporaryDataBufferGPU tempDataBuffer{};
+
+	{
+		auto allocInfo = sharedBuffer.AllocateAndGetSharedData(12u, tempDataBuffer);
+
+		EXPECT_EQ(allocInfo.offset, 0u) << "Offset isn't 0.";
+		EXPECT_EQ(sharedBuffer.Size(), 64_KB) << "Size isn't the minimum size.";
+	}
+
+	{
+		auto allocInfo = sharedBuffer.AllocateAndGetSharedData(20_KB, tempDataBuffer);
+
+		EXPECT_EQ(allocInfo.offset, 12u) << "The slack wasn't used.";
+		EXPECT_EQ(sharedBuffer.Size(), 64_KB) << "The buffer was recreated.";
+	}
+
+	// The allocation starts at the trailing free region, so the buffer only grows by what is
+	// missing.
+	{
+		auto allocInfo = sharedBuffer.AllocateAndGetSharedData(50_KB, tempDataBuffer);
+
+		EXPECT_EQ(allocInfo.offset, 20_KB + 12u) << "The trailing free region wasn't used.";
+		EXPECT_EQ(sharedBuffer.Size(), 96_KB) << "The buffer didn't grow geometrically.";
+	}
+
+	{
+		auto allocInfo = sharedBuffer.AllocateAndGetSharedData(50_KB, tempDataBuffer);
+
+		EXPECT_EQ(allocInfo.offset, 70_KB + 12u) << "The trailing free region wasn't used.";
+		EXPECT_EQ(sharedBuffer.Size(), 144_KB) << "The buffer didn't grow geometrically.";
+	}
+}
+
+TEST_F(D3DSharedBufferTest, CompactionTest)
+{
+	ID3D12Device5* device  = s_deviceManager->GetDevice();
+	IDXGIAdapter3* adapter = s_deviceManager->GetAdapter();
+
+	MemoryManager memoryManager{ adapter, device, 20_MB, 200_KB };
+
+	Callisto::TemporaryDataBufferGPU tempDataBuffer{};
+
+	// Everything fits in the first buffer, so there isn't an old buffer waiting to be copied.
+	{
+		SharedBufferGPU sharedBuffer{ device, &memoryManager };
+
+		[[maybe_unused]] auto firstInfo = sharedBuffer.AllocateAndGetSharedData(12u, tempDataBuffer);
+
+		auto secondInfo = sharedBuffer.AllocateAndGetSharedData(16_KB, tempDataBuffer);
+		auto thirdInfo  = sharedBuffer.AllocateAndGetSharedData(16_KB, tempDataBuffer);
+		auto fourthInfo = sharedBuffer.AllocateAndGetSharedData(16_KB, tempDataBuffer);
+
+		EXPECT_EQ(fourthInfo.offset, 32_KB + 12u) << "The regions aren't contiguous.";
+
+		sharedBuffer.RelinquishMemory(secondInfo);
+		sharedBuffer.ReleaseRetiredRegions(0u);
+
+		const std::vector<BufferCompactionPlanner::Move> moves = sharedBuffer.MoveRegions(
+			1u, tempDataBuffer
+		);
+
+		ASSERT_EQ(std::size(moves), 1u) << "The budget should allow a single move.";
+		EXPECT_EQ(moves.front().srcOffset, fourthInfo.offset) << "The last region wasn't moved.";
+		EXPECT_EQ(moves.front().dstOffset, secondInfo.offset) << "The hole wasn't filled.";
+		EXPECT_EQ(sharedBuffer.GetLiveAllocations().count(secondInfo.offset), 1u)
+			<< "The moved region isn't live.";
+		EXPECT_TRUE(std::empty(sharedBuffer.MoveRegions(64_KB, tempDataBuffer)))
+			<< "Moved before the previous moves were copied.";
+		EXPECT_FALSE(sharedBuffer.Shrink(tempDataBuffer))
+			<< "Shrunk before the moves were copied.";
+
+		// The source of the move is only freed once it has retired.
+		sharedBuffer.ReleaseRetiredRegions(0u);
+
+		auto fifthInfo = sharedBuffer.AllocateAndGetSharedData(16_KB, tempDataBuffer);
+
+		EXPECT_EQ(fifthInfo.offset, thirdInfo.offset + 16_KB) << "The source wasn't freed.";
+	}
+
+	{
+		SharedBufferGPU sharedBuffer{ device, &memoryManager };
+
+		SharedBufferGrowthPolicy growthPolicy = SharedBufferGrowthPolicy::GetDefaultPolicy();
+
+		growthPolicy.minimumSize = 256_KB;
+
+		sharedBuffer.SetGrowthPolicy(growthPolicy);
+
+		[[maybe_unused]] auto firstInfo = sharedBuffer.AllocateAndGetSharedData(12u, tempDataBuffer);
+
+		auto secondInfo = sharedBuffer.AllocateAndGetSharedData(200_KB, tempDataBuffer);
+
+		EXPECT_FALSE(sharedBuffer.Shrink(tempDataBuffer)) << "Shrunk a mostly used buffer.";
+
+		sharedBuffer.RelinquishMemory(secondInfo);
+		sharedBuffer.ReleaseRetiredRegions(0u);
+		sharedBuffer.SetGrowthPolicy(SharedBufferGrowthPolicy::GetDefaultPolicy());
+
+		EXPECT_TRUE(sharedBuffer.Shrink(tempDataBuffer)) << "The buffer wasn't shrunk.";
+		EXPECT_EQ(sharedBuffer.Size(), 64_KB) << "Size isn't the minimum size.";
+		EXPECT_TRUE(std::empty(sharedBuffer.MoveRegions(64_KB, tempDataBuffer)))
+			<< "Moved before the old buffer was copied.";
+
+		auto thirdInfo = sharedBuffer.AllocateAndGetSharedData(16_KB, tempDataBuffer);
+
+		EXPECT_EQ(thirdInfo.offset, 12u) << "The rest of the new size isn't free.";
+		EXPECT_EQ(sharedBuffer.Size(), 64_KB) << "The buffer was recreated.";
+	}
+}
+
+TEST_F(D3DSharedBufferTest, RetiringRegionTest)
+{
+	ID3D12Device5* device  = s_deviceManager->GetDevice();
+	IDXGIAdapter3* adapter = s_deviceManager->GetAdapter();
+
+	MemoryManager memoryManager{ adapter, device, 20_MB, 200_KB };
+
+	SharedBufferGPU sharedBuffer{ device, &memoryManager };
+
+	Callisto::TemporaryDataBufferGPU tempDataBuffer{};
+
+	constexpr size_t frameCount = 2u;
+
+	auto firstInfo = sharedBuffer.AllocateAndGetSharedData(16_KB, tempDataBuffer);
+
+	[[maybe_unused]] auto secondInfo = sharedBuffer.AllocateAndGetSharedData(
+		16_KB, tempDataBuffer
+	);
+
+	sharedBuffer.RelinquishMemory(firstInfo);
+
+	EXPECT_EQ(sharedBuffer.GetLiveAllocations().count(firstInfo.offset), 0u)
+		<< "The relinquished region is still live.";
+
+	auto thirdInfo = sharedBuffer.AllocateAndGetSharedData(16_KB, tempDataBuffer);
+
+	EXPECT_NE(thirdInfo.offset, firstInfo.offset) << "The region was reused while in flight.";
+
+	sharedBuffer.ReleaseRetiredRegions(frameCount);
+
+	auto fourthInfo = sharedBuffer.AllocateAndGetSharedData(16_KB, tempDataBuffer);
+
+	EXPECT_NE(fourthInfo.offset, firstInfo.offset) << "The region was freed a frame early.";
+
+	sharedBuffer.ReleaseRetiredRegions(frameCount);
+
+	auto fifthInfo = sharedBuffer.AllocateAndGetSharedData(16_KB, tempDataBuffer);
+
+	EXPECT_EQ(fifthInfo.offset, firstInfo.offset) << "The retired region wasn't reused.";
+	EXPECT_EQ(sharedBuffer.Size(), 64_KB) << "The buffer was recreated.";
+}
+
+TEST_F(D3DSharedBufferTest, ReserveTest)
+{
+	ID3D12Device5* device  = s_deviceManager->GetDevice();
+	IDXGIAdapter3* adapter = s_deviceManager->GetAdapter();
+
+	MemoryManager memoryManager{ adapter, device, 20_MB, 200_KB };
+
+	SharedBufferGPU sharedBuffer{ device, &memoryManager };
+
+	Callisto::TemporaryDataBufferGPU tempDataBuffer{};
+
+	auto firstInfo = sharedBuffer.AllocateAndGetSharedData(16_KB, tempDataBuffer);
+
+	[[maybe_unused]] auto secondInfo = sharedBuffer.AllocateAndGetSharedData(
+		16_KB, tempDataBuffer
+	);
+
+	sharedBuffer.RelinquishMemory(firstInfo);
+	sharedBuffer.ReleaseRetiredRegions(0u);
+
+	// The first one fits in the freed region, the rest need the buffer to be extended.
+	const std::vector<UINT64> sizes{ 12_KB, 40_KB, 30_KB, 50_KB };
+
+	const UINT64 oldSize      = sharedBuffer.Size();
+	const UINT64 expectedSize = sharedBuffer.GetReservedSize(sizes);
+
+	EXPECT_EQ(sharedBuffer.Size(), oldSize) << "Getting the reserved size extended the buffer.";
+	EXPECT_TRUE(sharedBuffer.Reserve(sizes, tempDataBuffer)) << "The buffer wasn't extended.";
+
+	const UINT64 reservedSize = sharedBuffer.Size();
+
+	EXPECT_EQ(reservedSize, expectedSize) << "The buffer wasn't extended to the reserved size.";
+
+	EXPECT_GE(reservedSize, 32_KB + 120_KB) << "The reserved size is too small.";
+	EXPECT_FALSE(sharedBuffer.Reserve(sizes, tempDataBuffer)) << "The buffer was extended twice.";
+
+	for (UINT64 size : sizes)
+		[[maybe_unused]] auto allocInfo = sharedBuffer.AllocateAndGetSharedData(
+			size, tempDataBuffer
+		);
+
+	EXPECT_EQ(sharedBuffer.Size(), reservedSize) << "The buffer was recreated after reserving.";
+	EXPECT_EQ(sharedBuffer.GetLiveAllocations().count(firstInfo.offset), 1u)
+		<< "The freed region wasn't reused.";
+}
+
+TEST_F(D3DSharedBufferTest, ZeroSizeTest)
+{
+	ID3D12Device5* device  = s_deviceManager->GetDevice();
+	IDXGIAdapter3* adapter = s_deviceManager->GetAdapter();
+
+	MemoryManager memoryManager{ adapter, device, 20_MB, 200_KB };
+
+	SharedBufferGPU sharedBuffer{ device, &memoryManager };
+
+	Callisto::TemporaryDataBufferGPU tempDataBuffer{};
+
+	// The zero size allocation doesn't take its region, so the next one can be at its offset.
+	auto emptyInfo = sharedBuffer.AllocateAndGetSharedData(0u, tempDataBuffer);
+	auto allocInfo = sharedBuffer.AllocateAndGetSharedData(16_KB, tempDataBuffer);
+
+	EXPECT_EQ(sharedBuffer.GetLiveAllocations().count(allocInfo.offset), 1u)
+		<< "The allocation isn't live.";
+
+	sharedBuffer.RelinquishMemory(emptyInfo);
+
+	EXPECT_EQ(sharedBuffer.GetLiveAllocations().count(allocInfo.offset), 1u)
+		<< "Relinquishing the zero size allocation removed the other one.";
+	EXPECT_EQ(std::size(sharedBuffer.GetLiveAllocations()), 1u)
+		<< "The zero size allocation shouldn't be tracked.";
+
+	// Nothing is free after this one, but an empty allocation still shouldn't extend the buffer.
+	[[maybe_unused]] auto fullInfo = sharedBuffer.AllocateAndGetSharedData(48_KB, tempDataBuffer);
+
+	const UINT64 fullSize = sharedBuffer.Size();
+
+	auto secondEmptyInfo = sharedBuffer.AllocateAndGetSharedData(0u, tempDataBuffer);
+
+	EXPECT_EQ(secondEmptyInfo.size, 0u) << "The allocation isn't empty.";
+	EXPECT_EQ(sharedBuffer.Size(), fullSize) << "The buffer was extended for an empty allocation.";
+
+	SharedBufferCPU cpuBuffer{ device, &memoryManager, D3D12_RESOURCE_STATE_GENERIC_READ };
+
+	[[maybe_unused]] auto cpuInfo = cpuBuffer.AllocateAndGetSharedData(16_KB);
+
+	const UINT64 cpuSize = cpuBuffer.Size();
+
+	auto cpuEmptyInfo = cpuBuffer.AllocateAndGetSharedData(0u);
+
+	EXPECT_EQ(cpuEmptyInfo.size, 0u) << "The allocation isn't empty.";
+	EXPECT_EQ(cpuBuffer.Size(), cpuSize) << "The buffer was extended for an empty allocation.";
+}
+
+TEST_F(D3DSharedBufferTest, PagedTraceTest)
+{
+	using EventType = AllocationTraceRecorder::EventType;
+
+	ID3D12Device5* device  = s_deviceManager->GetDevice();
+	IDXGIAdapter3* adapter = s_deviceManager->GetAdapter();
+
+	MemoryManager memoryManager{ adapter, device, 20_MB, 200_KB };
+
+	SharedBufferPagedCPU pagedBuffer{
+		device, &memoryManager, D3D12_RESOURCE_STATE_GENERIC_READ, 1_KB
+	};
+
+	const std::string tracePath
+		= (std::filesystem::temp_directory_path() / "GaiaXPagedTraceTest.gtrc").string();
+
+	{
+		AllocationTraceRecorder traceRecorder{ tracePath };
+
+		pagedBuffer.SetTraceRecorder(&traceRecorder, 3u);
+
+		// The second one doesn't fit in the first page, so both are at the offset 0.
+		const PagedBufferData firstData  = pagedBuffer.AllocateAndGetSharedData(768u);
+		const PagedBufferData secondData = pagedBuffer.AllocateAndGetSharedData(768u);
+
+		EXPECT_NE(firstData.pageIndex, secondData.pageIndex) << "The allocations share a page.";
+
+		pagedBuffer.RelinquishMemory(firstData);
+
+		pagedBuffer.SetTraceRecorder(nullptr, 0u);
+
+		pagedBuffer.RelinquishMemory(secondData);
+	}
+
+	const std::vector<AllocationTraceRecorder::Event> events
+		= AllocationTraceRecorder::ReadTrace(tracePath);
+
+	std::filesystem::remove(tracePath);
+
+	ASSERT_EQ(std::size(events), 3u) << "The events weren't all recorded.";
+
+	EXPECT_EQ(events[0u].ownerID, 3u) << "The buffer ID wasn't recorded.";
+	EXPECT_EQ(events[0u].size, 768u) << "The allocation size wasn't recorded.";
+	EXPECT_NE(events[0u].offset, events[1u].offset)
+		<< "The allocations on different pages should have different offsets.";
+	EXPECT_EQ(events[2u].type, EventType::SharedRelinquish) << "The relinquish wasn't recorded.";
+	EXPECT_EQ(events[2u].offset, events[0u].offset)
+		<< "The relinquish doesn't match its allocation.";
+}
+
+TEST(SharedBufferGrowthPolicyTest, AmortisedGrowthTest)
+{
+	const SharedBufferGrowthPolicy growthPolicy = SharedBufferGrowthPolicy::GetDefaultPolicy();
+
+	UINT64 bufferSize      = 0u;
+	UINT64 usedSize        = 0u;
+	UINT64 copiedSize      = 0u;
+	size_t recreationCount = 0u;
+
+	// Adds a lot of small allocations, like the meshes of a scene being loaded one by one.
+	for (size_t index = 0u; index < 10'000u; ++index)
+	{
+		const UINT64 size = 4_KB + (index % 7u) * 1_KB;
+
+		if (usedSize + size > bufferSize)
+		{
+			copiedSize += bufferSize;
+			bufferSize  = growthPolicy.GetNewSize(bufferSize, usedSize + size);
+
+			++recreationCount;
+		}
+
+		usedSize += size;
+	}
+
+	EXPECT_LE(copiedSize, usedSize * 3u) << "The copies aren't amortised.";
+	EXPECT_LT(recreationCount, 40u) << "The buffer was recreated too many times.";
+	EXPECT_EQ(bufferSize % growthPolicy.granularity, 0u) << "The size isn't rounded up.";
+
+	const SharedBufferGrowthPolicy exactPolicy = SharedBufferGrowthPolicy::GetExactPolicy();
+
+	EXPECT_EQ(exactPolicy.GetNewSize(100u, 112u), 112u) << "The exact policy added some slack.";
+	EXPECT_EQ(exactPolicy.GetNewSize(0u, 12u), 12u) << "The exact policy added some slack.";
+}
@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <D3DTextureFormat.hpp>
+#include <DDSLoader.hpp>
+#include <GaiaException.hpp>
+
+using namespace Gaia;
+
+static constexpr std::uint32_t s_fourCCFlag      = 0x4u;
+static constexpr std::uint32_t s_mipMapCountFlag = 0x20000u;
+static constexpr std::uint8_t  s_dataByte        = 0xABu;
+
+struct DDSFileDesc
+{
+	std::uint32_t width;
+	std::uint32_t height;
+	std::uint32_t mipMapCount;
+	const char*   fourCC;
+	// Only used with the DX10 fourCC.
+	DXGI_FORMAT   dxgiFormat;
+	size_t        dataSize;
+};
+
+// The header fields are at their offsets in the file. The rest of the headers is zero and the
+// data is filled with the data byte.
+static std::vector<std::uint8_t> CreateDDSFile(const DDSFileDesc& desc)
+{
+	const bool hasDX10Header = strcmp(desc.fourCC, "DX10") == 0;
+	const size_t headerSize  = 128u + (hasDX10Header ? 20u : 0u);
+
+	std::vector<std::uint8_t> file(headerSize + desc.dataSize, s_dataByte);
+
+	std::fill_n(std::begin(file), headerSize, std::uint8_t{ 0u });
+
+	auto Write = [&file](size_t offset, std::uint32_t value)
+	{
+		memcpy(std::data(file) + offset, &value, sizeof(value));
+	};
+
+	memcpy(std::data(file), "DDS ", 4u);
+	Write(4u, 124u);
+	Write(8u, desc.mipMapCount > 1u ? s_mipMapCountFlag : 0u);
+	Write(12u, desc.height);
+	Write(16u, desc.width);
+	Write(28u, desc.mipMapCount);
+	// The pixel format.
+	Write(76u, 32u);
+	Write(80u, s_fourCCFlag);
+	memcpy(std::data(file) + 84u, desc.fourCC, 4u);
+
+	if (hasDX10Header)
+	{
+		Write(128u, static_cast<std::uint32_t>(desc.dxgiFormat));
+		// Texture2D.
+		Write(132u, 3u);
+		Write(140u, 1u);
+	}
+
+	return file;
+}
+
+static STexture ParseDDSFile(const std::vector<std::uint8_t>& file)
+{
+	auto fileData = std::make_shared<std::uint8_t[]>(std::size(file));
+
+	memcpy(fileData.get(), std::data(file), std::size(file));
+
+	return DDSLoader::Parse(std::move(fileData), std::size(file));
+}
+
+TEST(DDSLoaderTest, PitchTest)
+{
+	EXPECT_EQ(GetTextureRowPitch(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, 5u), 20u)
+		<< "The RGBA8 row pitch is wrong.";
+	EXPECT_EQ(GetTextureRowCount(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, 5u), 5u)
+		<< "The RGBA8 row count is wrong.";
+
+	// A partial block still takes a whole block.
+	EXPECT_EQ(GetTextureRowPitch(DXGI_FORMAT_BC1_UNORM, 10u), 24u) << "The BC1 row pitch is wrong.";
+	EXPECT_EQ(GetTextureRowPitch(DXGI_FORMAT_BC1_UNORM, 1u), 8u) << "The BC1 row pitch is wrong.";
+	EXPECT_EQ(GetTextureRowPitch(DXGI_FORMAT_BC3_UNORM_SRGB, 16u), 64u)
+		<< "The BC3 row pitch is wrong.";
+	EXPECT_EQ(GetTextureRowPitch(DXGI_FORMAT_BC5_UNORM, 8u), 32u) << "The BC5 row pitch is wrong.";
+	EXPECT_EQ(GetTextureRowPitch(DXGI_FORMAT_BC7_UNORM, 2u), 16u) << "The BC7 row pitch is wrong.";
+
+	EXPECT_EQ(GetTextureRowCount(DXGI_FORMAT_BC7_UNORM, 10u), 3u) << "The BC7 row count is wrong.";
+	EXPECT_EQ(GetTextureRowCount(DXGI_FORMAT_BC7_UNORM, 1u), 1u) << "The BC7 row count is wrong.";
+
+	EXPECT_TRUE(IsBlockCompressed(DXGI_FORMAT_BC1_UNORM_SRGB)) << "BC1 should be compressed.";
+	EXPECT_FALSE(IsBlockCompressed(DXGI_FORMAT_R8G8B8A8_UNORM)) << "RGBA8 isn't compressed.";
+}
+
+TEST(DDSLoaderTest, LegacyHeaderTest)
+{
+	// 16x8, 8x4, 4x2, 2x1 and 1x1. The last 3 mips take a block each.
+	const std::vector<std::uint8_t> file = CreateDDSFile(
+		DDSFileDesc{
+			.width       = 16u,
+			.height      = 8u,
+			.mipMapCount = 5u,
+			.fourCC      = "DXT1",
+			.dxgiFormat  = DXGI_FORMAT_UNKNOWN,
+			.dataSize    = 64u + 16u + 8u + 8u + 8u
+		}
+	);
+
+	const STexture texture = ParseDDSFile(file);
+
+	EXPECT_EQ(texture.format, STextureFormat::BC1) << "The format is wrong.";
+	EXPECT_EQ(texture.width, 16u) << "The width is wrong.";
+	EXPECT_EQ(texture.height, 8u) << "The height is wrong.";
+	EXPECT_EQ(texture.mipLevelCount, 5u) << "The mip count is wrong.";
+	EXPECT_FALSE(texture.srgb) << "A legacy file should be linear.";
+
+	EXPECT_THROW(
+		ParseDDSFile(
+			std::vector<std::uint8_t>{ std::begin(file), std::end(file) - 1 }
+		),
+		Exception
+	) << "A truncated file should be rejected.";
+}
+
+TEST(DDSLoaderTest, DX10HeaderTest)
+{
+	const std::vector<std::uint8_t> file = CreateDDSFile(
+		DDSFileDesc{
+			.width       = 8u,
+			.height      = 8u,
+			.mipMapCount = 1u,
+			.fourCC      = "DX10",
+			.dxgiFormat  = DXGI_FORMAT_BC7_UNORM_SRGB,
+			.dataSize    = 64u
+		}
+	);
+
+	const STexture texture = ParseDDSFile(file);
+
+	EXPECT_EQ(texture.format, STextureFormat::BC7) << "The format is wrong.";
+	EXPECT_TRUE(texture.srgb) << "An _SRGB format should be sRGB.";
+	EXPECT_EQ(texture.mipLevelCount, 1u) << "The mip count is wrong.";
+	EXPECT_EQ(*static_cast<std::uint8_t const*>(texture.data.get()), s_dataByte)
+		<< "The data should start after the DX10 header.";
+}
+
+TEST(DDSLoaderTest, LinearFormatTest)
+{
+	const STexture texture = ParseDDSFile(
+		CreateDDSFile(
+			DDSFileDesc{
+				.width       = 4u,
+				.height      = 4u,
+				.mipMapCount = 1u,
+				.fourCC      = "DX10",
+				.dxgiFormat  = DXGI_FORMAT_BC7_UNORM,
+				.dataSize    = 16u
+			}
+		)
+	);
+
+	EXPECT_EQ(texture.format, STextureFormat::BC7) << "The format is wrong.";
+	EXPECT_FALSE(texture.srgb) << "A UNORM format shouldn't be sRGB.";
+}
+
+TEST(DDSLoaderTest, InvalidFileTest)
+{
+	// Not a multiple of the block size.
+	EXPECT_THROW(
+		ParseDDSFile(
+			CreateDDSFile(
+				DDSFileDesc{
+					.width       = 6u,
+					.height      = 4u,
+					.mipMapCount = 1u,
+					.fourCC      = "DXT5",
+					.dxgiFormat  = DXGI_FORMAT_UNKNOWN,
+					.dataSize    = 32u
+				}
+			)
+		),
+		Exception
+	) << "A partial block on the top mip should be rejected.";
+
+	// BC2 isn't supported.
+	EXPECT_THROW(
+		ParseDDSFile(
+			CreateDDSFile(
+				DDSFileDesc{
+					.width       = 4u,
+					.height      = 4u,
+					.mipMapCount = 1u,
+					.fourCC      = "DXT3",
+					.dxgiFormat  = DXGI_FORMAT_UNKNOWN,
+					.dataSize    = 16u
+				}
+			)
+		),
+		Exception
+	) << "An unsupported format should be rejected.";
+
+	std::vector<std::uint8_t> file = CreateDDSFile(
+		DDSFileDesc{
+			.width       = 4u,
+			.height      = 4u,
+			.mipMapCount = 1u,
+			.fourCC      = "DXT1",
+			.dxgiFormat  = DXGI_FORMAT_UNKNOWN,
+			.dataSize    = 8u
+		}
+	);
+
+	file[0] = 'X';
+
+	EXPECT_THROW(ParseDDSFile(file), Exception) << "The magic should be checked.";
+}
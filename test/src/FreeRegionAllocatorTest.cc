@@ -0,0 +1,256 @@
+#include <gtest/gtest.h>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include <FreeRegionAllocator.hpp>
+#include <D3DMemoryTelemetry.hpp>
+#include <SharedBufferAllocator.hpp>
+
+using namespace Gaia;
+
+TEST(FreeRegionAllocatorTest, BestFitTest)
+{
+	FreeRegionAllocator allocator{};
+
+	EXPECT_FALSE(allocator.Allocate(16u).has_value()) << "Allocated without any free regions.";
+
+	allocator.Deallocate(0u, 64u);
+	allocator.Deallocate(128u, 32u);
+	allocator.Deallocate(256u, 16u);
+	allocator.Deallocate(512u, 32u);
+
+	EXPECT_EQ(allocator.GetFreeRegionCount(), 4u) << "Separate regions were merged.";
+	EXPECT_EQ(allocator.GetFreeSize(), 144u) << "The free size is wrong.";
+	EXPECT_EQ(allocator.GetLargestFreeRegion(), 64u) << "The largest region is wrong.";
+
+	EXPECT_EQ(allocator.Allocate(24u).value(), 128u) << "The lowest best fit wasn't used.";
+	EXPECT_EQ(allocator.Allocate(32u).value(), 512u) << "The exact fit wasn't used.";
+	EXPECT_EQ(allocator.Allocate(8u).value(), 152u) << "The rest of the region wasn't kept.";
+	EXPECT_EQ(allocator.Allocate(48u).value(), 0u) << "The only fitting region wasn't used.";
+	EXPECT_FALSE(allocator.Allocate(20u).has_value()) << "Allocated more than the free regions.";
+
+	EXPECT_EQ(allocator.GetFreeSize(), 32u) << "The free size is wrong.";
+}
+
+TEST(FreeRegionAllocatorTest, CoalescingTest)
+{
+	FreeRegionAllocator allocator{};
+
+	allocator.Deallocate(0u, 16u);
+	allocator.Deallocate(32u, 16u);
+
+	EXPECT_EQ(allocator.GetFreeRegionCount(), 2u) << "Separate regions were merged.";
+
+	// Fills the gap, so all three should become one region.
+	allocator.Deallocate(16u, 16u);
+
+	EXPECT_EQ(allocator.GetFreeRegionCount(), 1u) << "The neighbours weren't merged.";
+	EXPECT_EQ(allocator.GetLargestFreeRegion(), 48u) << "The merged size is wrong.";
+
+	allocator.Deallocate(48u, 16u);
+
+	EXPECT_EQ(allocator.GetFreeRegionCount(), 1u) << "The previous region wasn't merged.";
+	EXPECT_EQ(allocator.Allocate(64u).value(), 0u) << "The merged region can't be allocated.";
+
+	allocator.Deallocate(100u, 28u);
+
+	EXPECT_FALSE(allocator.RemoveTrailingRegion(256u).has_value())
+		<< "The last region doesn't end at the end of the buffer.";
+	EXPECT_EQ(allocator.RemoveTrailingRegion(128u).value(), 100u) << "The trailing region is wrong.";
+	EXPECT_EQ(allocator.GetFreeRegionCount(), 0u) << "The trailing region wasn't removed.";
+}
+
+TEST(FreeRegionAllocatorTest, CloneTest)
+{
+	FreeRegionAllocator allocator{};
+
+	allocator.Deallocate(0u, 32u);
+	allocator.Deallocate(64u, 16u);
+
+	FreeRegionAllocator clone = allocator.Clone();
+
+	EXPECT_EQ(clone.Allocate(16u).value(), 64u) << "The size index wasn't copied.";
+	EXPECT_EQ(clone.Allocate(32u).value(), 0u) << "The offset index wasn't copied.";
+	EXPECT_EQ(clone.GetFreeSize(), 0u) << "The free size of the clone is wrong.";
+
+	EXPECT_EQ(allocator.GetFreeRegionCount(), 2u) << "The original regions were changed.";
+	EXPECT_EQ(allocator.GetFreeSize(), 48u) << "The original free size was changed.";
+	EXPECT_EQ(allocator.Allocate(16u).value(), 64u) << "The original regions were changed.";
+}
+
+TEST(FreeRegionAllocatorTest, DISABLED_ChurnBenchmark)
+{
+	// Loads and unloads meshes of random sizes, like a streaming scene would. The buffer is
+	// extended by the missing size, whenever an allocation doesn't fit.
+	constexpr size_t operationCount = 50'000u;
+	constexpr size_t sampleInterval = 5'000u;
+
+	struct Operation
+	{
+		bool   allocate;
+		UINT64 size;
+		size_t freeIndex;
+	};
+
+	std::vector<Operation> operations{};
+
+	{
+		std::mt19937_64 randomEngine{ 1234u };
+		std::uniform_int_distribution<UINT64> sizeInKB{ 1u, 256u };
+		std::uniform_int_distribution<size_t> percent{ 0u, 99u };
+		std::uniform_int_distribution<size_t> anyIndex{};
+
+		for (size_t _ = 0u; _ < operationCount; ++_)
+			operations.emplace_back(
+				Operation{
+					percent(randomEngine) < 52u, sizeInKB(randomEngine) * 1_KB,
+					anyIndex(randomEngine)
+				}
+			);
+	}
+
+	struct Allocation
+	{
+		UINT64 offset;
+		UINT64 size;
+	};
+
+	struct Sample
+	{
+		UINT64 bufferSize;
+		UINT64 usedSize;
+		float  fragmentation;
+	};
+
+	auto Replay = [&operations]<typename Allocate_t, typename Deallocate_t>
+		(Allocate_t&& allocate, Deallocate_t&& deallocate) -> std::vector<Sample>
+	{
+		std::vector<Allocation> liveAllocations{};
+		std::vector<Sample> samples{};
+
+		UINT64 bufferSize = 0u;
+		UINT64 usedSize   = 0u;
+
+		for (size_t index = 0u; index < std::size(operations); ++index)
+		{
+			const Operation& operation = operations[index];
+
+			if (operation.allocate || std::empty(liveAllocations))
+			{
+				liveAllocations.emplace_back(
+					Allocation{ allocate(operation.size, bufferSize), operation.size }
+				);
+
+				usedSize += operation.size;
+			}
+			else
+			{
+				const size_t freeIndex = operation.freeIndex % std::size(liveAllocations);
+
+				deallocate(liveAllocations[freeIndex]);
+
+				usedSize -= liveAllocations[freeIndex].size;
+
+				liveAllocations[freeIndex] = liveAllocations.back();
+				liveAllocations.pop_back();
+			}
+
+			if ((index + 1u) % sampleInterval == 0u)
+			{
+				std::vector<Allocation> sortedAllocations = liveAllocations;
+
+				std::ranges::sort(sortedAllocations, {}, &Allocation::offset);
+
+				MemoryTelemetry::RegionStatsBuilder statsBuilder{ bufferSize };
+
+				for (const Allocation& allocation : sortedAllocations)
+					statsBuilder.AddAllocation(allocation.offset, allocation.size);
+
+				samples.emplace_back(
+					Sample{ bufferSize, usedSize, statsBuilder.Build().fragmentation }
+				);
+			}
+		}
+
+		return samples;
+	};
+
+	const std::vector<Sample> freeRegionSamples = [&Replay]
+	{
+		FreeRegionAllocator allocator{};
+		size_t liveCount = 0u;
+
+		return Replay(
+			[&allocator, &liveCount]
+			(UINT64 size, UINT64& bufferSize) -> UINT64
+			{
+				std::optional<UINT64> offset = allocator.Allocate(size);
+
+				if (!offset)
+				{
+					offset     = allocator.RemoveTrailingRegion(bufferSize).value_or(bufferSize);
+					bufferSize = *offset + size;
+				}
+
+				++liveCount;
+
+				// The free regions are always merged, so there can't be more of them than
+				// the gaps between the allocations.
+				EXPECT_LE(allocator.GetFreeRegionCount(), liveCount + 1u)
+					<< "The free regions weren't merged.";
+
+				return *offset;
+			},
+			[&allocator, &liveCount](const Allocation& allocation)
+			{
+				allocator.Deallocate(allocation.offset, allocation.size);
+
+				--liveCount;
+			}
+		);
+	}();
+
+	const std::vector<Sample> callistoSamples = [&Replay]
+	{
+		Callisto::SharedBufferAllocator allocator{};
+
+		return Replay(
+			[&allocator](UINT64 size, UINT64& bufferSize) -> UINT64
+			{
+				auto availableAllocIndex = allocator.GetAvailableAllocInfo(size);
+
+				Callisto::SharedBufferAllocator::AllocInfo allocInfo{ .offset = 0u, .size = 0u };
+
+				if (!availableAllocIndex)
+				{
+					allocInfo.size   = size;
+					allocInfo.offset = bufferSize;
+
+					bufferSize += size;
+				}
+				else
+					allocInfo = allocator.GetAndRemoveAllocInfo(*availableAllocIndex);
+
+				return allocator.AllocateMemory(allocInfo, size);
+			},
+			[&allocator](const Allocation& allocation)
+			{
+				allocator.RelinquishMemory(allocation.offset, allocation.size);
+			}
+		);
+	}();
+
+	ASSERT_EQ(std::size(freeRegionSamples), std::size(callistoSamples))
+		<< "The sample counts don't match.";
+
+	for (size_t index = 0u; index < std::size(freeRegionSamples); ++index)
+	{
+		const Sample& freeRegionSample = freeRegionSamples[index];
+
+		EXPECT_GE(freeRegionSample.bufferSize, freeRegionSample.usedSize)
+			<< "The buffer is smaller than its allocations.";
+		EXPECT_LE(freeRegionSample.bufferSize, callistoSamples[index].bufferSize)
+			<< "Reusing the free regions should never need a bigger buffer.";
+	}
+}
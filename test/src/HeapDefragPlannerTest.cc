@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include <D3DAllocator.hpp>
+#include <D3DHeapDefragPlanner.hpp>
+
+using namespace Gaia;
+
+static constexpr HeapDefragPlanner::Settings s_testSettings
+{
+	.maximumOccupancy  = 0.25f,
+	.maximumMovedBytes = 64_MB
+};
+
+static HeapDefragPlanner::Allocation CreateMovableAllocation(
+	UINT64 offset, UINT64 size, size_t resourceIndex
+) {
+	return HeapDefragPlanner::Allocation
+	{
+		.offset        = offset,
+		.size          = size,
+		.alignment     = 64_KB,
+		.resourceIndex = resourceIndex,
+		.isMovable     = true
+	};
+}
+
+TEST(HeapDefragPlannerTest, PlanTest)
+{
+	HeapDefragPlanner planner{ s_testSettings };
+
+	std::vector<HeapDefragPlanner::Heap> heaps
+	{
+		// Mostly used, but has a 16MB gap in the middle.
+		HeapDefragPlanner::Heap
+		{
+			.memoryID    = 0u,
+			.size        = 64_MB,
+			.allocations = {
+				CreateMovableAllocation(0u, 24_MB, 0u),
+				CreateMovableAllocation(40_MB, 24_MB, 1u)
+			}
+		},
+		HeapDefragPlanner::Heap
+		{
+			.memoryID    = 1u,
+			.size        = 64_MB,
+			.allocations = {
+				CreateMovableAllocation(8_MB, 4_MB, 2u),
+				CreateMovableAllocation(32_MB, 8_MB, 3u)
+			}
+		}
+	};
+
+	{
+		const HeapDefragPlanner::Plan plan = planner.CreatePlan(heaps);
+
+		ASSERT_EQ(std::size(plan.evacuatedHeaps), 1u) << "A single heap should be evacuated.";
+		EXPECT_EQ(plan.evacuatedHeaps.front(), 1u) << "The wrong heap was evacuated.";
+		EXPECT_EQ(plan.movedBytes, 12_MB) << "The moved size isn't 12MB.";
+
+		ASSERT_EQ(std::size(plan.relocations), 2u) << "Both allocations should be moved.";
+
+		// The larger one should be placed first.
+		EXPECT_EQ(plan.relocations[0].resourceIndex, 3u) << "The larger one wasn't placed first.";
+		EXPECT_EQ(plan.relocations[0].dstMemoryID, 0u) << "The allocation wasn't moved.";
+		EXPECT_EQ(plan.relocations[0].dstOffset, 24_MB) << "The allocation isn't in the gap.";
+		EXPECT_EQ(plan.relocations[1].dstOffset, 32_MB) << "The gap wasn't split.";
+	}
+
+	{
+		// A pinned allocation should keep the heap alive.
+		heaps[1].allocations[0].isMovable = false;
+
+		const HeapDefragPlanner::Plan plan = planner.CreatePlan(heaps);
+
+		EXPECT_TRUE(std::empty(plan.evacuatedHeaps))
+			<< "A heap with a pinned allocation was evacuated.";
+		EXPECT_TRUE(std::empty(plan.relocations)) << "Nothing should be moved.";
+
+		heaps[1].allocations[0].isMovable = true;
+	}
+
+	{
+		// Only 4MB is free now, so the 8MB allocation can't be placed.
+		heaps[0].allocations[1] = CreateMovableAllocation(24_MB, 36_MB, 1u);
+
+		const HeapDefragPlanner::Plan plan = planner.CreatePlan(heaps);
+
+		EXPECT_TRUE(std::empty(plan.relocations)) << "An allocation was moved without space.";
+		EXPECT_EQ(plan.movedBytes, 0u) << "The moved size isn't 0.";
+
+		heaps[0].allocations[1] = CreateMovableAllocation(40_MB, 24_MB, 1u);
+	}
+
+	{
+		HeapDefragPlanner budgetPlanner{
+			{ .maximumOccupancy = 0.25f, .maximumMovedBytes = 8_MB }
+		};
+
+		const HeapDefragPlanner::Plan plan = budgetPlanner.CreatePlan(heaps);
+
+		EXPECT_TRUE(std::empty(plan.evacuatedHeaps)) << "The budget was ignored.";
+	}
+}
+
+TEST(HeapDefragPlannerTest, AlignmentTest)
+{
+	HeapDefragPlanner planner{ { .maximumOccupancy = 1.f, .maximumMovedBytes = 64_MB } };
+
+	HeapDefragPlanner::Allocation alignedAllocation = CreateMovableAllocation(0u, 4_MB, 0u);
+	alignedAllocation.alignment = 4_MB;
+
+	const std::vector<HeapDefragPlanner::Heap> heaps
+	{
+		HeapDefragPlanner::Heap
+		{
+			.memoryID    = 0u,
+			.size        = 8_MB,
+			.allocations = { CreateMovableAllocation(0u, 1_MB, 1u) }
+		},
+		HeapDefragPlanner::Heap
+		{
+			.memoryID    = 1u,
+			.size        = 16_MB,
+			.allocations = { alignedAllocation, CreateMovableAllocation(8_MB, 8_MB, 2u) }
+		}
+	};
+
+	const HeapDefragPlanner::Plan plan = planner.CreatePlan(heaps);
+
+	// The second heap is fuller, so the first one should be evacuated into its gap.
+	ASSERT_EQ(std::size(plan.evacuatedHeaps), 1u) << "A single heap should be evacuated.";
+	EXPECT_EQ(plan.evacuatedHeaps.front(), 0u) << "The wrong heap was evacuated.";
+	ASSERT_EQ(std::size(plan.relocations), 1u) << "A single allocation should be moved.";
+	EXPECT_EQ(plan.relocations.front().dstOffset, 4_MB) << "The allocation isn't in the gap.";
+}
+
+TEST(HeapDefragPlannerTest, PowerOfTwoBlockTest)
+{
+	HeapDefragPlanner planner{ { .maximumOccupancy = 0.5f, .maximumMovedBytes = 64_MB } };
+
+	const std::vector<HeapDefragPlanner::Heap> heaps
+	{
+		HeapDefragPlanner::Heap
+		{
+			.memoryID             = 0u,
+			.size                 = 8_MB,
+			.allocations          = { CreateMovableAllocation(0u, 3_MB, 0u) },
+			.usesPowerOfTwoBlocks = true
+		},
+		HeapDefragPlanner::Heap
+		{
+			.memoryID             = 1u,
+			.size                 = 8_MB,
+			.allocations          = { CreateMovableAllocation(0u, 1_MB + 512_KB, 1u) },
+			.usesPowerOfTwoBlocks = true
+		}
+	};
+
+	const HeapDefragPlanner::Plan plan = planner.CreatePlan(heaps);
+
+	// The 3MB allocation takes a 4MB block, and the moved one needs a 2MB aligned block.
+	ASSERT_EQ(std::size(plan.relocations), 1u) << "A single allocation should be moved.";
+	EXPECT_EQ(plan.relocations.front().dstMemoryID, 0u) << "The allocation is on the wrong heap.";
+	EXPECT_EQ(plan.relocations.front().dstOffset, 4_MB) << "The allocation isn't after the block.";
+}
+
+TEST(HeapDefragPlannerTest, EvacuationTest)
+{
+	D3DAllocatorGroup allocators{};
+
+	const std::uint16_t firstID  = allocators.AddAllocator(D3DHeap{ D3D12_HEAP_TYPE_DEFAULT, 8_MB });
+	const std::uint16_t secondID = allocators.AddAllocator(D3DHeap{ D3D12_HEAP_TYPE_DEFAULT, 8_MB });
+
+	std::optional<D3DAllocatorGroup::Allocation> allocation = allocators.Allocate(
+		{ .SizeInBytes = 1_MB, .Alignment = 64_KB }
+	);
+
+	ASSERT_TRUE(allocation.has_value()) << "Allocation failed.";
+	ASSERT_EQ(allocation->memoryID, firstID) << "The allocation wasn't on the first heap.";
+
+	EXPECT_EQ(std::size(allocators.GetAllocators().front().GetLiveAllocations()), 1u)
+		<< "The allocation wasn't tracked.";
+
+	allocators.SetEvacuating(firstID, true);
+
+	EXPECT_TRUE(allocators.IsEvacuating(firstID)) << "The heap isn't evacuating.";
+
+	std::optional<D3DAllocatorGroup::Allocation> newAllocation = allocators.Allocate(
+		{ .SizeInBytes = 1_MB, .Alignment = 64_KB }
+	);
+
+	ASSERT_TRUE(newAllocation.has_value()) << "Allocation failed.";
+	EXPECT_EQ(newAllocation->memoryID, secondID) << "An evacuating heap was used.";
+
+	allocators.Deallocate(firstID, allocation->heapOffset, 1_MB, 64_KB);
+
+	EXPECT_TRUE(std::empty(allocators.GetAllocators().front().GetLiveAllocations()))
+		<< "The deallocation wasn't tracked.";
+
+	// An evacuated heap shouldn't wait for the idle frames.
+	allocators.ReleaseIdleAllocators(120u);
+
+	ASSERT_EQ(allocators.GetAllocatorCount(), 1u) << "The evacuated heap wasn't released.";
+	EXPECT_EQ(allocators.GetAllocators().front().GetID(), secondID) << "The wrong heap was released.";
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <D3DAllocator.hpp>
+#include <D3DHeapGrowthPolicy.hpp>
+
+using namespace Gaia;
+
+static constexpr HeapGrowthPolicy::Settings s_testSettings
+{
+	.minimumHeapSize         = 16_MB,
+	.maximumHeapSize         = 256_MB,
+	.budgetFraction          = 0.5f,
+	.growthWindow            = 8u,
+	.idleFramesBeforeRelease = 3u
+};
+
+TEST(HeapGrowthPolicyTest, GrowthTest)
+{
+	HeapGrowthPolicy growthPolicy{ s_testSettings };
+
+	// Nothing has been allocated yet, so a small scene should only get the minimum size.
+	EXPECT_EQ(growthPolicy.GetNewHeapSize(1_MB, 4_GB), 16_MB) << "The size isn't the minimum.";
+	EXPECT_EQ(growthPolicy.GetNewHeapSize(20_MB, 4_GB), 20_MB)
+		<< "The size should be at least the required size.";
+
+	for (size_t _ = 0u; _ < 10u; ++_)
+		growthPolicy.RecordAllocation(4_MB);
+
+	EXPECT_EQ(growthPolicy.GetRecentAllocationSize(), 40_MB) << "The recent size isn't 40MB.";
+	EXPECT_EQ(growthPolicy.GetNewHeapSize(1_MB, 4_GB), 40_MB)
+		<< "The size should follow the recent allocations.";
+
+	// A heap was just created, so the next one should be twice as large.
+	growthPolicy.RecordNewHeap(64_MB);
+	growthPolicy.RecordAllocation(4_MB);
+
+	EXPECT_EQ(growthPolicy.GetNewHeapSize(1_MB, 4_GB), 128_MB) << "The size wasn't doubled.";
+
+	growthPolicy.RecordNewHeap(128_MB);
+
+	EXPECT_EQ(growthPolicy.GetNewHeapSize(1_MB, 4_GB), 256_MB) << "The size wasn't doubled.";
+
+	growthPolicy.RecordNewHeap(256_MB);
+
+	EXPECT_EQ(growthPolicy.GetNewHeapSize(1_MB, 4_GB), 256_MB) << "The size isn't the maximum.";
+
+	// Only half of the remaining budget should be used.
+	EXPECT_EQ(growthPolicy.GetNewHeapSize(1_MB, 200_MB), 100_MB)
+		<< "The size should be limited by the budget.";
+
+	// After enough allocations without a new heap, the size should go back to the history.
+	for (size_t _ = 0u; _ < 32u; ++_)
+		growthPolicy.RecordAllocation(1_MB);
+
+	EXPECT_EQ(growthPolicy.GetNewHeapSize(1_MB, 4_GB), 32_MB) << "The size didn't shrink.";
+}
+
+TEST(HeapGrowthPolicyTest, RecordAllocationsTest)
+{
+	HeapGrowthPolicy growthPolicy{ s_testSettings };
+
+	growthPolicy.RecordNewHeap(64_MB);
+	growthPolicy.RecordAllocations(1_MB, 4u);
+
+	EXPECT_EQ(growthPolicy.GetNewHeapSize(1_MB, 4_GB), 128_MB)
+		<< "The allocations should still be in the growth window.";
+
+	// Only the last 32 allocations are kept, but all of them count towards the window.
+	growthPolicy.RecordAllocations(1_MB, 100u);
+
+	EXPECT_EQ(growthPolicy.GetRecentAllocationSize(), 32_MB) << "The recent size isn't 32MB.";
+	EXPECT_EQ(growthPolicy.GetNewHeapSize(1_MB, 4_GB), 32_MB)
+		<< "The allocations should be out of the growth window.";
+}
+
+TEST(HeapGrowthPolicyTest, IdleReleaseTest)
+{
+	D3DAllocatorGroup allocators{};
+
+	const std::uint16_t firstID  = allocators.AddAllocator(D3DHeap{ D3D12_HEAP_TYPE_DEFAULT, 8_MB });
+	const std::uint16_t secondID = allocators.AddAllocator(D3DHeap{ D3D12_HEAP_TYPE_DEFAULT, 8_MB });
+
+	std::optional<D3DAllocatorGroup::Allocation> allocation = allocators.AllocateFrom(
+		secondID, { .SizeInBytes = 1_MB, .Alignment = 64_KB }
+	);
+
+	ASSERT_TRUE(allocation.has_value()) << "Allocation failed.";
+
+	for (size_t _ = 0u; _ < 3u; ++_)
+		allocators.ReleaseIdleAllocators(s_testSettings.idleFramesBeforeRelease);
+
+	EXPECT_EQ(allocators.GetAllocatorCount(), 2u) << "The heap was released too early.";
+
+	allocators.ReleaseIdleAllocators(s_testSettings.idleFramesBeforeRelease);
+
+	ASSERT_EQ(allocators.GetAllocatorCount(), 1u) << "The empty heap wasn't released.";
+	EXPECT_EQ(allocators.GetAllocators().front().GetID(), secondID)
+		<< "The wrong heap was released.";
+
+	allocators.Deallocate(secondID, allocation->heapOffset, 1_MB, 64_KB);
+
+	for (size_t _ = 0u; _ < 10u; ++_)
+		allocators.ReleaseIdleAllocators(s_testSettings.idleFramesBeforeRelease);
+
+	EXPECT_EQ(allocators.GetAllocatorCount(), 1u) << "The last heap shouldn't be released.";
+
+	// Using a heap should reset its idle frames.
+	const std::uint16_t thirdID = allocators.AddAllocator(D3DHeap{ D3D12_HEAP_TYPE_DEFAULT, 8_MB });
+
+	EXPECT_EQ(thirdID, firstID) << "The ID wasn't reused.";
+
+	for (size_t _ = 0u; _ < 3u; ++_)
+	{
+		std::optional<D3DAllocatorGroup::Allocation> tempAllocation = allocators.AllocateFrom(
+			thirdID, { .SizeInBytes = 1_MB, .Alignment = 64_KB }
+		);
+
+		ASSERT_TRUE(tempAllocation.has_value()) << "Allocation failed.";
+
+		allocators.Deallocate(thirdID, tempAllocation->heapOffset, 1_MB, 64_KB);
+
+		allocators.ReleaseIdleAllocators(s_testSettings.idleFramesBeforeRelease);
+		allocators.ReleaseIdleAllocators(s_testSettings.idleFramesBeforeRelease);
+	}
+
+	// The second heap has been idle for a while, so it should have been released instead.
+	ASSERT_EQ(allocators.GetAllocatorCount(), 1u) << "The idle heap wasn't released.";
+	EXPECT_EQ(allocators.GetAllocators().front().GetID(), thirdID)
+		<< "The heap in use was released.";
+}
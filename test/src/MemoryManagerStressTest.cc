@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <D3DAllocator.hpp>
+#include <FakeHeapProvider.hpp>
+
+using namespace Gaia;
+
+struct LiveAllocation
+{
+	FakeMemoryManager::MemoryAllocation allocation;
+	D3D12_HEAP_TYPE                     heapType;
+	bool                                msaa;
+};
+
+// Keeps the live ranges of each heap, so overlapping allocations can be found.
+class OverlapChecker
+{
+	using Key_t = std::pair<size_t, std::uint16_t>;
+
+public:
+	[[nodiscard]]
+	bool Add(const LiveAllocation& liveAllocation)
+	{
+		std::scoped_lock lock{ m_mutex };
+
+		std::map<UINT64, UINT64>& ranges = m_ranges[GetKey(liveAllocation)];
+
+		const UINT64 offset = liveAllocation.allocation.heapOffset;
+		const UINT64 size   = liveAllocation.allocation.size;
+
+		auto nextRange = ranges.lower_bound(offset);
+
+		if (nextRange != std::end(ranges) && nextRange->first < offset + size)
+			return false;
+
+		if (nextRange != std::begin(ranges))
+		{
+			auto previousRange = std::prev(nextRange);
+
+			if (previousRange->first + previousRange->second > offset)
+				return false;
+		}
+
+		ranges.emplace(offset, size);
+
+		return true;
+	}
+
+	void Remove(const LiveAllocation& liveAllocation)
+	{
+		std::scoped_lock lock{ m_mutex };
+
+		m_ranges[GetKey(liveAllocation)].erase(liveAllocation.allocation.heapOffset);
+	}
+
+private:
+	[[nodiscard]]
+	static Key_t GetKey(const LiveAllocation& liveAllocation) noexcept
+	{
+		const size_t groupIndex = liveAllocation.heapType == D3D12_HEAP_TYPE_UPLOAD ?
+			0u : (liveAllocation.msaa ? 2u : 1u);
+
+		return { groupIndex, liveAllocation.allocation.memoryID };
+	}
+
+private:
+	std::mutex                              m_mutex;
+	std::map<Key_t, std::map<UINT64, UINT64>> m_ranges;
+};
+
+TEST(MemoryManagerStressTest, ConcurrentAllocationTest)
+{
+	FakeMemoryManager memoryManager{ nullptr, nullptr, 64_MB, 64_MB };
+
+	memoryManager.SetAllocatorType(D3D12_HEAP_TYPE_DEFAULT, HeapAllocatorType::TLSF);
+
+	OverlapChecker overlapChecker{};
+
+	constexpr size_t threadCount    = 8u;
+	constexpr size_t iterationCount = 20'000u;
+
+	// Mostly the small cached sizes, with some larger ones which go through the allocators.
+	constexpr std::array<UINT64, 6u> bufferSizes{ 1_KB, 64_KB, 100_KB, 256_KB, 1_MB, 3_MB };
+
+	std::array<size_t, threadCount> overlapCounts{};
+	std::vector<std::thread> threads{};
+
+	for (size_t threadIndex = 0u; threadIndex < threadCount; ++threadIndex)
+		threads.emplace_back(
+			[&, threadIndex]
+			{
+				std::mt19937 randomEngine{ static_cast<std::uint32_t>(threadIndex) };
+				std::uniform_int_distribution<size_t> sizeDistribution{ 0u, std::size(bufferSizes) - 1u };
+				std::uniform_int_distribution<size_t> groupDistribution{ 0u, 2u };
+				std::bernoulli_distribution deallocateDistribution{ 0.45 };
+
+				std::vector<LiveAllocation> liveAllocations{};
+
+				auto Deallocate = [&](size_t allocationIndex)
+				{
+					const LiveAllocation liveAllocation = liveAllocations[allocationIndex];
+
+					liveAllocations[allocationIndex] = liveAllocations.back();
+					liveAllocations.pop_back();
+
+					// Must be removed first, as the block can be reused as soon as it is freed.
+					overlapChecker.Remove(liveAllocation);
+					memoryManager.Deallocate(
+						liveAllocation.allocation, liveAllocation.heapType, liveAllocation.msaa
+					);
+				};
+
+				for (size_t _ = 0u; _ < iterationCount; ++_)
+				{
+					if (!std::empty(liveAllocations) && deallocateDistribution(randomEngine))
+					{
+						std::uniform_int_distribution<size_t> indexDistribution{
+							0u, std::size(liveAllocations) - 1u
+						};
+
+						Deallocate(indexDistribution(randomEngine));
+
+						continue;
+					}
+
+					const size_t groupIndex = groupDistribution(randomEngine);
+
+					LiveAllocation liveAllocation
+					{
+						.allocation = {},
+						.heapType   = groupIndex ? D3D12_HEAP_TYPE_DEFAULT : D3D12_HEAP_TYPE_UPLOAD,
+						.msaa       = groupIndex == 2u
+					};
+
+					D3D12_RESOURCE_DESC resourceDesc{};
+					resourceDesc.Width = bufferSizes[sizeDistribution(randomEngine)];
+
+					liveAllocation.allocation = memoryManager.Allocate(
+						resourceDesc, liveAllocation.heapType, liveAllocation.msaa
+					);
+
+					if (!overlapChecker.Add(liveAllocation))
+						++overlapCounts[threadIndex];
+
+					liveAllocations.emplace_back(liveAllocation);
+				}
+
+				while (!std::empty(liveAllocations))
+					Deallocate(std::size(liveAllocations) - 1u);
+			}
+		);
+
+	// The main thread keeps releasing the idle heaps, like it would at the end of each frame.
+	for (size_t _ = 0u; _ < 50u; ++_)
+	{
+		memoryManager.ReleaseIdleHeaps();
+
+		std::this_thread::yield();
+	}
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	for (size_t threadIndex = 0u; threadIndex < threadCount; ++threadIndex)
+		EXPECT_EQ(overlapCounts[threadIndex], 0u)
+			<< "Thread " << threadIndex << " got overlapping allocations.";
+
+	memoryManager.ReleaseIdleHeaps();
+
+	size_t liveAllocationCount = 0u;
+
+	memoryManager.ForEachAllocatorGroup(
+		[&liveAllocationCount]
+		(const D3DAllocatorGroup& allocators, D3D12_HEAP_TYPE, bool)
+		{
+			for (const D3DAllocator& allocator : allocators.GetAllocators())
+				liveAllocationCount += std::size(allocator.GetLiveAllocations());
+		}
+	);
+
+	EXPECT_EQ(liveAllocationCount, 0u) << "Some of the allocations weren't returned to the heaps.";
+}
+
+TEST(MemoryManagerStressTest, CacheReuseTest)
+{
+	FakeMemoryManager memoryManager{ nullptr, nullptr, 64_MB, 64_MB };
+
+	D3D12_RESOURCE_DESC resourceDesc{};
+	resourceDesc.Width = 64_KB;
+
+	const FakeMemoryManager::MemoryAllocation allocation = memoryManager.Allocate(
+		resourceDesc, D3D12_HEAP_TYPE_DEFAULT
+	);
+
+	memoryManager.Deallocate(allocation, D3D12_HEAP_TYPE_DEFAULT);
+
+	const FakeMemoryManager::MemoryAllocation reusedAllocation = memoryManager.Allocate(
+		resourceDesc, D3D12_HEAP_TYPE_DEFAULT
+	);
+
+	EXPECT_EQ(reusedAllocation.memoryID, allocation.memoryID) << "The cached block wasn't reused.";
+	EXPECT_EQ(reusedAllocation.heapOffset, allocation.heapOffset)
+		<< "The cached block wasn't reused.";
+
+	memoryManager.Deallocate(reusedAllocation, D3D12_HEAP_TYPE_DEFAULT);
+
+	// An evacuating heap shouldn't get its freed blocks back from the cache.
+	memoryManager.SetHeapEvacuating(allocation.memoryID, D3D12_HEAP_TYPE_DEFAULT, true);
+
+	const FakeMemoryManager::MemoryAllocation newAllocation = memoryManager.Allocate(
+		resourceDesc, D3D12_HEAP_TYPE_DEFAULT
+	);
+
+	EXPECT_NE(newAllocation.memoryID, allocation.memoryID) << "An evacuating heap was used.";
+
+	memoryManager.Deallocate(newAllocation, D3D12_HEAP_TYPE_DEFAULT);
+	memoryManager.ClearEvacuatingHeaps(D3D12_HEAP_TYPE_DEFAULT);
+}
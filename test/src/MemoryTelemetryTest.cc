@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <D3DMemoryTelemetry.hpp>
+#include <ThreadPool.hpp>
+
+using namespace Gaia;
+
+TEST(MemoryTelemetryTest, RegionStatsTest)
+{
+	EXPECT_EQ(MemoryTelemetry::GetHistogramBin(1u), 0u) << "1B isn't in the first bin.";
+	EXPECT_EQ(MemoryTelemetry::GetHistogramBin(256_B), 0u) << "256B isn't in the first bin.";
+	EXPECT_EQ(MemoryTelemetry::GetHistogramBin(257_B), 1u) << "257B isn't in the second bin.";
+	EXPECT_EQ(MemoryTelemetry::GetHistogramBin(64_KB), 8u) << "64KB isn't in the ninth bin.";
+	EXPECT_EQ(MemoryTelemetry::GetHistogramBin(1_GB), MemoryTelemetry::s_histogramBinCount - 1u)
+		<< "1GB isn't in the last bin.";
+
+	{
+		MemoryTelemetry::RegionStatsBuilder statsBuilder{ 16_MB };
+
+		statsBuilder.AddAllocation(0u, 4_MB);
+		statsBuilder.AddAllocation(6_MB, 2_MB);
+		statsBuilder.AddAllocation(12_MB, 64_KB);
+
+		const MemoryTelemetry::RegionStats stats = statsBuilder.Build();
+
+		EXPECT_EQ(stats.usedSize, 6_MB + 64_KB) << "The used size is wrong.";
+		EXPECT_EQ(stats.allocationCount, 3u) << "The allocation count isn't 3.";
+		EXPECT_EQ(stats.largestFreeBlock, 4_MB) << "The largest free block is wrong.";
+		EXPECT_EQ(stats.sizeHistogram[MemoryTelemetry::GetHistogramBin(4_MB)], 1u)
+			<< "The 4MB allocation wasn't counted.";
+
+		const float expectedFragmentation = 1.f - static_cast<float>(4_MB)
+			/ static_cast<float>(10_MB - 64_KB);
+
+		EXPECT_NEAR(stats.fragmentation, expectedFragmentation, 0.0001f)
+			<< "The fragmentation is wrong.";
+	}
+
+	{
+		const MemoryTelemetry::RegionStats stats
+			= MemoryTelemetry::RegionStatsBuilder{ 8_MB }.Build();
+
+		EXPECT_EQ(stats.largestFreeBlock, 8_MB) << "An empty region should be a single block.";
+		EXPECT_EQ(stats.fragmentation, 0.f) << "An empty region shouldn't be fragmented.";
+	}
+}
+
+TEST(MemoryTelemetryTest, HeapReportTest)
+{
+	D3DAllocatorGroup allocators{ HeapAllocatorType::TLSF };
+
+	const std::uint16_t heapID = allocators.AddAllocator(D3DHeap{ D3D12_HEAP_TYPE_DEFAULT, 8_MB });
+
+	std::optional<D3DAllocatorGroup::Allocation> allocation = allocators.Allocate(
+		{ .SizeInBytes = 1_MB, .Alignment = 64_KB }
+	);
+
+	ASSERT_TRUE(allocation.has_value()) << "Allocation failed.";
+
+	std::vector<MemoryTelemetry::HeapReport> heapReports{};
+
+	MemoryTelemetry::AddHeapReports(heapReports, allocators, D3D12_HEAP_TYPE_DEFAULT, false);
+
+	ASSERT_EQ(std::size(heapReports), 1u) << "The heap wasn't reported.";
+
+	const MemoryTelemetry::HeapReport& heapReport = heapReports.front();
+
+	EXPECT_EQ(heapReport.memoryID, heapID) << "The ID is wrong.";
+	EXPECT_EQ(heapReport.allocatorType, HeapAllocatorType::TLSF) << "The allocator type is wrong.";
+	EXPECT_EQ(heapReport.stats.size, 8_MB) << "The heap size is wrong.";
+	EXPECT_EQ(heapReport.stats.usedSize, 1_MB) << "The used size is wrong.";
+	EXPECT_EQ(heapReport.stats.largestFreeBlock, 7_MB) << "The largest free block is wrong.";
+
+	const std::string json = MemoryTelemetry::ToJSON(
+		MemoryTelemetry::Report{ .frameNumber = 60u, .heaps = heapReports, .sharedBuffers = {} }
+	);
+
+	EXPECT_EQ(json.find("{\"frame\":60,\"heaps\":[{\"memoryID\":0,"), 0u)
+		<< "The JSON doesn't start with the frame.";
+	EXPECT_NE(json.find("\"used\":1048576"), std::string::npos) << "The used size wasn't exported.";
+	EXPECT_NE(json.find("\"allocator\":\"TLSF\""), std::string::npos)
+		<< "The allocator type wasn't exported.";
+	EXPECT_TRUE(json.ends_with("\"sharedBuffers\":[]}"))
+		<< "The JSON doesn't end with the shared buffers.";
+}
+
+TEST(MemoryTelemetryTest, ExportIntervalTest)
+{
+	MemoryTelemetry telemetry{ nullptr };
+
+	EXPECT_FALSE(telemetry.AdvanceFrame()) << "Exporting should be disabled by default.";
+
+	telemetry.SetExport(3u, "MemoryReport.json");
+
+	size_t exportCount = 0u;
+
+	for (size_t _ = 0u; _ < 9u; ++_)
+		if (telemetry.AdvanceFrame())
+			++exportCount;
+
+	EXPECT_EQ(exportCount, 3u) << "The report should be exported every 3 frames.";
+	EXPECT_EQ(telemetry.GetFrameNumber(), 10u) << "The frame number is wrong.";
+}
+
+TEST(MemoryTelemetryTest, ExportTest)
+{
+	const std::filesystem::path filePath
+		= std::filesystem::temp_directory_path() / "GaiaMemoryReportTest.json";
+
+	std::filesystem::remove(filePath);
+
+	ThreadPool threadPool{ 1u };
+
+	MemoryTelemetry telemetry{ &threadPool };
+
+	telemetry.SetExport(1u, filePath.string());
+
+	// The second export waits for the first one, so the lines are in order.
+	telemetry.Export(MemoryTelemetry::Report{ .frameNumber = 1u, .heaps = {}, .sharedBuffers = {} });
+	telemetry.Export(MemoryTelemetry::Report{ .frameNumber = 2u, .heaps = {}, .sharedBuffers = {} });
+
+	telemetry.WaitForExport();
+
+	std::ifstream exportFile{ filePath };
+	std::vector<std::string> lines{};
+
+	for (std::string line{}; std::getline(exportFile, line);)
+		lines.emplace_back(std::move(line));
+
+	ASSERT_EQ(std::size(lines), 2u) << "Both of the reports should be written.";
+	EXPECT_NE(lines[0].find("\"frame\":1"), std::string::npos) << "The first report is wrong.";
+	EXPECT_NE(lines[1].find("\"frame\":2"), std::string::npos) << "The second report is wrong.";
+
+	exportFile.close();
+
+	std::filesystem::remove(filePath);
+}
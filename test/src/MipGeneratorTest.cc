@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <MipGenerator.hpp>
+#include <ThreadPool.hpp>
+
+using namespace Gaia;
+
+TEST(MipGeneratorTest, LevelCountTest)
+{
+	EXPECT_EQ(MipGenerator::GetMipLevelCount(1u, 1u), 1u) << "The level count is wrong.";
+	EXPECT_EQ(MipGenerator::GetMipLevelCount(256u, 256u), 9u) << "The level count is wrong.";
+	EXPECT_EQ(MipGenerator::GetMipLevelCount(300u, 17u), 9u) << "The level count is wrong.";
+}
+
+TEST(MipGeneratorTest, GammaTest)
+{
+	ThreadPool threadPool{ 2u };
+
+	MipGenerator mipGenerator{ &threadPool };
+
+	// Black and transparent on the top, white and opaque on the bottom.
+	const std::vector<std::uint8_t> image
+	{
+		0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,
+		255u, 255u, 255u, 255u, 255u, 255u, 255u, 255u
+	};
+
+	const std::vector<MipGenerator::Mip> mips = mipGenerator.Generate(std::data(image), 2u, 2u);
+
+	ASSERT_EQ(std::size(mips), 1u) << "The mip count is wrong.";
+	ASSERT_EQ(mips[0].width, 1u) << "The mip width is wrong.";
+
+	// Half of the linear intensity is 188 in sRGB. A naive average would be 128.
+	for (size_t channel = 0u; channel < 3u; ++channel)
+		EXPECT_NEAR(mips[0].data[channel], 188, 1) << "The colour wasn't averaged linearly.";
+
+	EXPECT_NEAR(mips[0].data[3], 128, 1) << "The alpha should be averaged as it is.";
+}
+
+TEST(MipGeneratorTest, LinearTest)
+{
+	ThreadPool threadPool{ 2u };
+
+	MipGenerator mipGenerator{ &threadPool };
+
+	const std::vector<std::uint8_t> image
+	{
+		0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,
+		255u, 255u, 255u, 255u, 255u, 255u, 255u, 255u
+	};
+
+	const std::vector<MipGenerator::Mip> mips = mipGenerator.Generate(
+		std::data(image), 2u, 2u, false
+	);
+
+	ASSERT_EQ(std::size(mips), 1u) << "The mip count is wrong.";
+
+	for (size_t channel = 0u; channel < 4u; ++channel)
+		EXPECT_NEAR(mips[0].data[channel], 128, 1) << "The linear data should be averaged as it is.";
+}
+
+TEST(MipGeneratorTest, OddSizeTest)
+{
+	ThreadPool threadPool{ 2u };
+
+	MipGenerator mipGenerator{ &threadPool };
+
+	constexpr std::uint32_t width  = 5u;
+	constexpr std::uint32_t height = 3u;
+
+	std::vector<std::uint8_t> image(width * height * 4u, 100u);
+
+	const std::vector<MipGenerator::Mip> mips = mipGenerator.Generate(
+		std::data(image), width, height
+	);
+
+	ASSERT_EQ(std::size(mips), 2u) << "The mip count is wrong.";
+
+	EXPECT_EQ(mips[0].width, 2u) << "The width of the first mip is wrong.";
+	EXPECT_EQ(mips[0].height, 1u) << "The height of the first mip is wrong.";
+	EXPECT_EQ(mips[1].width, 1u) << "The width of the last mip is wrong.";
+	EXPECT_EQ(mips[1].height, 1u) << "The height of the last mip is wrong.";
+
+	// A flat colour shouldn't change.
+	for (const MipGenerator::Mip& mip : mips)
+		for (size_t index = 0u; index < size_t{ mip.width } * mip.height * 4u; ++index)
+			EXPECT_NEAR(mip.data[index], 100, 1) << "A flat colour was changed.";
+}
+
+TEST(MipGeneratorTest, WorkerTest)
+{
+	ThreadPool threadPool{ 8u };
+
+	MipGenerator mipGenerator{ &threadPool };
+
+	constexpr std::uint32_t width  = 512u;
+	constexpr std::uint32_t height = 300u;
+
+	std::vector<std::uint8_t> image(width * height * 4u);
+
+	std::mt19937 randomEngine{ 5u };
+
+	for (std::uint8_t& value : image)
+		value = static_cast<std::uint8_t>(randomEngine());
+
+	mipGenerator.SetMaxWorkerCount(1u);
+
+	const std::vector<MipGenerator::Mip> serialMips = mipGenerator.Generate(
+		std::data(image), width, height
+	);
+
+	mipGenerator.SetMaxWorkerCount(8u);
+
+	const std::vector<MipGenerator::Mip> parallelMips = mipGenerator.Generate(
+		std::data(image), width, height
+	);
+
+	ASSERT_EQ(std::size(serialMips), std::size(parallelMips)) << "The mip counts are different.";
+
+	for (size_t mipIndex = 0u; mipIndex < std::size(serialMips); ++mipIndex)
+	{
+		const MipGenerator::Mip& serialMip = serialMips[mipIndex];
+
+		EXPECT_TRUE(
+			std::equal(
+				serialMip.data.get(),
+				serialMip.data.get() + size_t{ serialMip.width } * serialMip.height * 4u,
+				parallelMips[mipIndex].data.get()
+			)
+		) << "The mip " << mipIndex << " is different with the workers.";
+	}
+}
+
+TEST(MipGeneratorTest, DISABLED_GenerationBenchmark)
+{
+	// The times are recorded as the properties of the test, in ms per megapixel.
+	constexpr size_t workerCount = 8u;
+
+	ThreadPool threadPool{ workerCount };
+
+	MipGenerator mipGenerator{ &threadPool };
+
+	for (std::uint32_t size : { 1'024u, 2'048u, 4'096u, 8'192u })
+	{
+		std::vector<std::uint8_t> image(size_t{ size } * size * 4u, 77u);
+
+		const double megapixelCount = static_cast<double>(size) * size / 1'000'000.0;
+
+		auto Measure = [&](size_t maxWorkerCount)
+		{
+			mipGenerator.SetMaxWorkerCount(maxWorkerCount);
+
+			const auto startTime = std::chrono::steady_clock::now();
+
+			const std::vector<MipGenerator::Mip> mips = mipGenerator.Generate(
+				std::data(image), size, size
+			);
+
+			const auto elapsedTime = std::chrono::duration<double, std::milli>{
+				std::chrono::steady_clock::now() - startTime
+			};
+
+			EXPECT_EQ(std::size(mips) + 1u, MipGenerator::GetMipLevelCount(size, size))
+				<< "The mip chain is incomplete.";
+
+			return elapsedTime.count() / megapixelCount;
+		};
+
+		const double serialTime   = Measure(1u);
+		const double parallelTime = Measure(workerCount);
+
+		const std::string sizeName = std::to_string(size) + "x" + std::to_string(size);
+
+		RecordProperty(sizeName + "_1worker", std::to_string(serialTime));
+		RecordProperty(
+			sizeName + "_" + std::to_string(workerCount) + "workers", std::to_string(parallelTime)
+		);
+	}
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <optional>
+
+#include <AllocatorBase.hpp>
+#include <PageAllocator.hpp>
+
+using namespace Gaia;
+
+TEST(PageAllocatorTest, AllocationTest)
+{
+	PageAllocator allocator{ 64_KB };
+
+	EXPECT_FALSE(allocator.Allocate(16_KB)) << "Allocated without any pages.";
+
+	EXPECT_EQ(allocator.AddPage(16_KB), 0u) << "The first page index is wrong.";
+	EXPECT_EQ(allocator.GetPageSize(0u), 64_KB) << "The page size is wrong.";
+
+	{
+		const std::optional<PageAllocator::Allocation> allocation = allocator.Allocate(48_KB);
+
+		ASSERT_TRUE(allocation) << "The allocation should fit in the page.";
+		EXPECT_EQ(allocation->pageIndex, 0u) << "The page index is wrong.";
+		EXPECT_EQ(allocation->offset, 0u) << "The offset is wrong.";
+	}
+
+	// There are 16KB left on the first page, so this one shouldn't straddle the pages.
+	EXPECT_FALSE(allocator.Allocate(32_KB)) << "The allocation straddled the pages.";
+
+	EXPECT_EQ(allocator.AddPage(32_KB), 1u) << "The second page index is wrong.";
+
+	{
+		const std::optional<PageAllocator::Allocation> allocation = allocator.Allocate(32_KB);
+
+		ASSERT_TRUE(allocation) << "The allocation should fit in the new page.";
+		EXPECT_EQ(allocation->pageIndex, 1u) << "The new page wasn't used.";
+		EXPECT_EQ(allocation->offset, 0u) << "The offset is wrong.";
+	}
+
+	{
+		const std::optional<PageAllocator::Allocation> allocation = allocator.Allocate(16_KB);
+
+		ASSERT_TRUE(allocation) << "The allocation should fit in the first page.";
+		EXPECT_EQ(allocation->pageIndex, 0u) << "The first page wasn't used.";
+		EXPECT_EQ(allocation->offset, 48_KB) << "The offset is wrong.";
+	}
+
+	EXPECT_EQ(allocator.GetTotalSize(), 128_KB) << "The total size is wrong.";
+	EXPECT_EQ(allocator.GetFreeSize(), 32_KB) << "The free size is wrong.";
+
+	allocator.Deallocate(PageAllocator::Allocation{ .pageIndex = 0u, .offset = 0u }, 48_KB);
+
+	{
+		const std::optional<PageAllocator::Allocation> allocation = allocator.Allocate(32_KB);
+
+		ASSERT_TRUE(allocation) << "The freed memory wasn't reused.";
+		EXPECT_EQ(allocation->pageIndex, 0u) << "The freed page wasn't used.";
+		EXPECT_EQ(allocation->offset, 0u) << "The offset is wrong.";
+	}
+}
+
+TEST(PageAllocatorTest, OversizedPageTest)
+{
+	PageAllocator allocator{ 64_KB };
+
+	EXPECT_EQ(allocator.AddPage(160_KB), 0u) << "The page index is wrong.";
+	EXPECT_EQ(allocator.GetPageSize(0u), 160_KB) << "The page should fit the allocation.";
+	EXPECT_EQ(allocator.GetPageSize(), 64_KB) << "The default page size shouldn't change.";
+
+	const std::optional<PageAllocator::Allocation> allocation = allocator.Allocate(160_KB);
+
+	ASSERT_TRUE(allocation) << "The allocation should fit in the page.";
+	EXPECT_EQ(allocator.GetFreeSize(), 0u) << "The page should be full.";
+}
+
+TEST(PageAllocatorTest, LockStepTest)
+{
+	// The allocators of two buffers with different strides, like the argument input and the per
+	// model buffers.
+	constexpr UINT64 strideA       = 32u;
+	constexpr UINT64 strideB       = 8u;
+	constexpr UINT64 modelsPerPage = 256u;
+
+	PageAllocator allocatorA{ modelsPerPage * strideA };
+	PageAllocator allocatorB{ modelsPerPage * strideB };
+
+	auto allocate = [&](UINT64 modelCount)
+	{
+		std::optional<PageAllocator::Allocation> allocationA = allocatorA.Allocate(
+			modelCount * strideA
+		);
+		std::optional<PageAllocator::Allocation> allocationB = allocatorB.Allocate(
+			modelCount * strideB
+		);
+
+		EXPECT_EQ(static_cast<bool>(allocationA), static_cast<bool>(allocationB))
+			<< "Only one of the allocators had space.";
+
+		if (!allocationA)
+		{
+			allocatorA.AddPage(modelCount * strideA);
+			allocatorB.AddPage(modelCount * strideB);
+
+			allocationA = allocatorA.Allocate(modelCount * strideA);
+			allocationB = allocatorB.Allocate(modelCount * strideB);
+		}
+
+		EXPECT_EQ(allocationA->pageIndex, allocationB->pageIndex) << "The pages are different.";
+		EXPECT_EQ(allocationA->offset / strideA, allocationB->offset / strideB)
+			<< "The model offsets are different.";
+
+		return *allocationA;
+	};
+
+	const UINT64 modelCounts[] = { 100u, 200u, 50u, 600u, 120u, 30u };
+	PageAllocator::Allocation allocations[std::size(modelCounts)]{};
+
+	for (size_t index = 0u; index < std::size(modelCounts); ++index)
+		allocations[index] = allocate(modelCounts[index]);
+
+	// Free a few of them and allocate again, so the holes are reused.
+	for (size_t index : { 0u, 2u, 4u })
+	{
+		const PageAllocator::Allocation& allocation = allocations[index];
+
+		allocatorA.Deallocate(allocation, modelCounts[index] * strideA);
+		allocatorB.Deallocate(
+			PageAllocator::Allocation{
+				.pageIndex = allocation.pageIndex,
+				.offset    = allocation.offset / strideA * strideB
+			}, modelCounts[index] * strideB
+		);
+	}
+
+	for (UINT64 modelCount : { 40u, 90u, 150u, 10u })
+		allocate(modelCount);
+
+	EXPECT_EQ(allocatorA.GetPageCount(), allocatorB.GetPageCount())
+		<< "The page counts are different.";
+	EXPECT_EQ(allocatorA.GetFreeSize() / strideA, allocatorB.GetFreeSize() / strideB)
+		<< "The free model counts are different.";
+}
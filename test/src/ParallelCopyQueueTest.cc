@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <AllocatorBase.hpp>
+#include <ParallelCopyQueue.hpp>
+#include <ThreadPool.hpp>
+
+using namespace Gaia;
+
+TEST(ParallelCopyQueueTest, ChunkTest)
+{
+	ParallelCopyQueue copyQueue{ 4_KB };
+
+	std::vector<std::uint8_t> src(10_KB);
+	std::vector<std::uint8_t> dst(10_KB);
+
+	std::iota(std::begin(src), std::end(src), std::uint8_t{ 0u });
+
+	copyQueue.AddCopy(std::data(dst), std::data(src), 10_KB);
+
+	EXPECT_EQ(copyQueue.GetChunkCount(), 3u) << "The copy wasn't split into chunks.";
+	EXPECT_EQ(copyQueue.GetCopySize(), 10_KB) << "The copy size is wrong.";
+
+	// 1KB rows with a 1.5KB source pitch, so a chunk should have 4 of them.
+	constexpr size_t rowSize     = 1_KB;
+	constexpr size_t rowCount    = 6u;
+	constexpr size_t srcRowPitch = 1536u;
+
+	std::vector<std::uint8_t> rowSrc(srcRowPitch * rowCount);
+	std::vector<std::uint8_t> rowDst(rowSize * rowCount);
+
+	std::iota(std::begin(rowSrc), std::end(rowSrc), std::uint8_t{ 7u });
+
+	copyQueue.AddRowCopy(
+		std::data(rowDst), std::data(rowSrc), rowSize, rowCount, rowSize, srcRowPitch
+	);
+
+	EXPECT_EQ(copyQueue.GetChunkCount(), 5u) << "The rows weren't split into chunks.";
+
+	ASSERT_EQ(copyQueue.Distribute(8u), 5u) << "There should be a worker per chunk.";
+
+	for (size_t workerIndex = 0u; workerIndex < 5u; ++workerIndex)
+		copyQueue.Run(workerIndex);
+
+	EXPECT_EQ(src, dst) << "The chunked copy is wrong.";
+
+	for (size_t rowIndex = 0u; rowIndex < rowCount; ++rowIndex)
+		EXPECT_EQ(
+			memcmp(
+				std::data(rowDst) + rowIndex * rowSize, std::data(rowSrc) + rowIndex * srcRowPitch,
+				rowSize
+			), 0
+		) << "The row " << rowIndex << " is wrong.";
+
+	copyQueue.Clear();
+
+	EXPECT_EQ(copyQueue.GetChunkCount(), 0u) << "The chunks weren't cleared.";
+	EXPECT_EQ(copyQueue.Distribute(8u), 0u) << "There shouldn't be any workers without chunks.";
+}
+
+TEST(ParallelCopyQueueTest, StealingTest)
+{
+	ParallelCopyQueue copyQueue{ 1_KB };
+
+	std::vector<std::uint8_t> src(64_KB);
+	std::vector<std::uint8_t> dst(64_KB);
+
+	std::iota(std::begin(src), std::end(src), std::uint8_t{ 3u });
+
+	// A huge copy and a few small ones, so the ranges don't have the same number of chunks.
+	copyQueue.AddCopy(std::data(dst), std::data(src), 60_KB);
+
+	for (size_t offset = 60_KB; offset < 64_KB; offset += 512u)
+		copyQueue.AddCopy(std::data(dst) + offset, std::data(src) + offset, 512u);
+
+	ASSERT_EQ(copyQueue.Distribute(4u), 4u) << "The worker count is wrong.";
+
+	// Only one of the workers is run, so it has to steal the chunks of the other ones.
+	copyQueue.Run(2u);
+
+	EXPECT_EQ(src, dst) << "The chunks of the other workers weren't stolen.";
+}
+
+TEST(ParallelCopyQueueTest, DISABLED_UploadMixBenchmark)
+{
+	// The throughputs are recorded as the properties of the test, in GB/s.
+	constexpr size_t workerCount = 8u;
+
+	ThreadPool threadPool{ workerCount };
+
+	struct UploadMix
+	{
+		const char* name;
+		size_t      copyCount;
+		size_t      copySize;
+	};
+
+	const UploadMix uploadMixes[]
+	{
+		{ .name = "ManySmall", .copyCount = 16'384u, .copySize = 4_KB },
+		{ .name = "Mixed",     .copyCount = 256u,    .copySize = 256_KB },
+		{ .name = "FewHuge",   .copyCount = 2u,      .copySize = 32_MB }
+	};
+
+	ParallelCopyQueue copyQueue{};
+
+	for (const UploadMix& uploadMix : uploadMixes)
+	{
+		const size_t totalSize = uploadMix.copyCount * uploadMix.copySize;
+
+		std::vector<std::uint8_t> src(totalSize, 1u);
+		std::vector<std::uint8_t> dst(totalSize, 0u);
+
+		auto Copy = [&](size_t maxWorkerCount)
+		{
+			for (size_t index = 0u; index < uploadMix.copyCount; ++index)
+			{
+				const size_t offset = index * uploadMix.copySize;
+
+				copyQueue.AddCopy(
+					std::data(dst) + offset, std::data(src) + offset, uploadMix.copySize
+				);
+			}
+
+			const auto startTime = std::chrono::steady_clock::now();
+
+			const size_t distributedCount = copyQueue.Distribute(maxWorkerCount);
+
+			std::vector<std::future<void>> waitObjs{};
+
+			for (size_t workerIndex = 1u; workerIndex < distributedCount; ++workerIndex)
+				waitObjs.emplace_back(threadPool.SubmitWork(std::function{
+					[&copyQueue, workerIndex]
+					{
+						copyQueue.Run(workerIndex);
+					}}));
+
+			copyQueue.Run(0u);
+
+			for (std::future<void>& waitObj : waitObjs)
+				waitObj.wait();
+
+			const auto elapsedTime = std::chrono::duration<double>{
+				std::chrono::steady_clock::now() - startTime
+			};
+
+			copyQueue.Clear();
+
+			return static_cast<double>(totalSize) / 1_GB / elapsedTime.count();
+		};
+
+		// The first run touches the pages of the destination.
+		Copy(workerCount);
+
+		const double singleThroughput   = Copy(1u);
+		const double parallelThroughput = Copy(workerCount);
+
+		const std::string mixName = uploadMix.name;
+
+		RecordProperty(mixName + "_1worker", std::to_string(singleThroughput));
+		RecordProperty(
+			mixName + "_" + std::to_string(workerCount) + "workers",
+			std::to_string(parallelThroughput)
+		);
+
+		EXPECT_EQ(src, dst) << "The copy of the " << uploadMix.name << " mix is wrong.";
+	}
+}
@@ -0,0 +1,257 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+#include <D3DAllocator.hpp>
+#include <D3DResidencyManager.hpp>
+
+using namespace Gaia;
+
+// Reports a budget which can be changed by the test and the usage of the resident heaps.
+class FakeAdapter
+{
+public:
+	HRESULT QueryVideoMemoryInfo(
+		[[maybe_unused]] UINT nodeIndex, [[maybe_unused]] DXGI_MEMORY_SEGMENT_GROUP segmentGroup,
+		DXGI_QUERY_VIDEO_MEMORY_INFO* videoMemoryInfo
+	) const noexcept {
+		videoMemoryInfo->Budget       = budget;
+		videoMemoryInfo->CurrentUsage = usage;
+
+		return S_OK;
+	}
+
+	UINT64 budget = 1_GB;
+	UINT64 usage  = 0u;
+};
+
+// Updates the usage of the adapter, when the heaps are evicted or made resident.
+class FakeDevice
+{
+public:
+	FakeDevice(FakeAdapter& adapter) : m_adapter{ adapter }, m_heapSizes{} {}
+
+	void AddHeap(ID3D12Heap* heap, UINT64 size)
+	{
+		m_heapSizes[heap] = size;
+
+		m_adapter.usage += size;
+	}
+
+	HRESULT Evict(UINT objectCount, ID3D12Pageable* const* objects) noexcept
+	{
+		++evictCallCount;
+
+		for (UINT index = 0u; index < objectCount; ++index)
+			m_adapter.usage -= m_heapSizes[objects[index]];
+
+		return S_OK;
+	}
+
+	HRESULT MakeResident(UINT objectCount, ID3D12Pageable* const* objects) noexcept
+	{
+		++makeResidentCallCount;
+
+		for (UINT index = 0u; index < objectCount; ++index)
+			m_adapter.usage += m_heapSizes[objects[index]];
+
+		return S_OK;
+	}
+
+	size_t evictCallCount        = 0u;
+	size_t makeResidentCallCount = 0u;
+
+private:
+	FakeAdapter&                                m_adapter;
+	std::unordered_map<ID3D12Pageable*, UINT64> m_heapSizes;
+};
+
+using FakeResidencyManager = ResidencyManagerGeneric<FakeAdapter, FakeDevice>;
+
+// Keeps the residency of the heaps like the memory manager would.
+class FakeHeaps
+{
+public:
+	FakeHeaps(FakeDevice& device, const std::vector<UINT64>& sizes)
+		: m_heapStorage(std::size(sizes)), m_heaps{}
+	{
+		for (size_t index = 0u; index < std::size(sizes); ++index)
+		{
+			// The heaps are never dereferenced, they only need different addresses.
+			auto heap = reinterpret_cast<ID3D12Heap*>(&m_heapStorage[index]);
+
+			device.AddHeap(heap, sizes[index]);
+
+			m_heaps.emplace_back(
+				FakeResidencyManager::HeapUsage
+				{
+					.heap        = heap,
+					.size        = sizes[index],
+					.memoryID    = static_cast<std::uint16_t>(index),
+					.isEvictable = false,
+					.isResident  = true
+				}
+			);
+		}
+	}
+
+	void SetEvictable(size_t index, bool isEvictable) noexcept
+	{
+		m_heaps[index].isEvictable = isEvictable;
+	}
+
+	[[nodiscard]]
+	bool IsResident(size_t index) const noexcept { return m_heaps[index].isResident; }
+
+	FakeResidencyManager::Changes Update(FakeResidencyManager& residencyManager)
+	{
+		FakeResidencyManager::Changes changes = residencyManager.Update(m_heaps);
+
+		for (std::uint16_t memoryID : changes.evictedHeaps)
+			m_heaps[memoryID].isResident = false;
+
+		for (std::uint16_t memoryID : changes.residentHeaps)
+			m_heaps[memoryID].isResident = true;
+
+		return changes;
+	}
+
+private:
+	std::vector<std::uint64_t>                   m_heapStorage;
+	std::vector<FakeResidencyManager::HeapUsage> m_heaps;
+};
+
+TEST(ResidencyManagerTest, ShrinkingBudgetTest)
+{
+	FakeAdapter adapter{};
+	FakeDevice device{ adapter };
+
+	// The first heap has buffers on it, so it is never evictable. The others only have textures.
+	FakeHeaps heaps{ device, { 64_MB, 32_MB, 32_MB, 32_MB } };
+
+	FakeResidencyManager residencyManager{
+		&adapter, &device, { .budgetUsageLimit = 1.f, .minimumIdleFrames = 2u }
+	};
+
+	// The textures are unbound in different frames, so the first texture heap is the least
+	// recently used one.
+	for (size_t frameIndex = 1u; frameIndex <= 5u; ++frameIndex)
+	{
+		heaps.SetEvictable(1u, frameIndex > 1u);
+		heaps.SetEvictable(2u, frameIndex > 3u);
+		heaps.SetEvictable(3u, frameIndex > 5u);
+
+		FakeResidencyManager::Changes changes = heaps.Update(residencyManager);
+
+		EXPECT_TRUE(std::empty(changes.evictedHeaps)) << "Evicted while under the budget.";
+	}
+
+	heaps.SetEvictable(3u, true);
+
+	adapter.budget = 150_MB;
+
+	{
+		FakeResidencyManager::Changes changes = heaps.Update(residencyManager);
+
+		ASSERT_EQ(std::size(changes.evictedHeaps), 1u) << "Only one heap needed to be evicted.";
+		EXPECT_EQ(changes.evictedHeaps.front(), 1u)
+			<< "The least recently used heap wasn't evicted.";
+		EXPECT_EQ(adapter.usage, 128_MB) << "The usage wasn't reduced.";
+	}
+
+	adapter.budget = 100_MB;
+
+	{
+		FakeResidencyManager::Changes changes = heaps.Update(residencyManager);
+
+		ASSERT_EQ(std::size(changes.evictedHeaps), 1u) << "Only one heap needed to be evicted.";
+		EXPECT_EQ(changes.evictedHeaps.front(), 2u)
+			<< "The next least recently used heap wasn't evicted.";
+	}
+
+	// Can't get under this budget, but the heap with the buffers must stay resident.
+	adapter.budget = 50_MB;
+
+	{
+		FakeResidencyManager::Changes changes = heaps.Update(residencyManager);
+
+		ASSERT_EQ(std::size(changes.evictedHeaps), 1u) << "The last texture heap wasn't evicted.";
+		EXPECT_EQ(changes.evictedHeaps.front(), 3u) << "The wrong heap was evicted.";
+		EXPECT_TRUE(heaps.IsResident(0u)) << "The heap with the buffers was evicted.";
+		EXPECT_EQ(adapter.usage, 64_MB) << "The usage isn't of the buffer heap only.";
+	}
+
+	// The first texture is bound again, so its heap must be made resident, even when it is over
+	// the budget.
+	heaps.SetEvictable(1u, false);
+
+	{
+		FakeResidencyManager::Changes changes = heaps.Update(residencyManager);
+
+		ASSERT_EQ(std::size(changes.residentHeaps), 1u) << "The used heap wasn't made resident.";
+		EXPECT_EQ(changes.residentHeaps.front(), 1u) << "The wrong heap was made resident.";
+		EXPECT_TRUE(std::empty(changes.evictedHeaps)) << "Nothing else could have been evicted.";
+		EXPECT_EQ(adapter.usage, 96_MB) << "The usage wasn't increased.";
+	}
+
+	EXPECT_EQ(device.makeResidentCallCount, 1u) << "The heaps weren't made resident in a batch.";
+}
+
+TEST(ResidencyManagerTest, InFlightHeapTest)
+{
+	FakeAdapter adapter{};
+	FakeDevice device{ adapter };
+
+	FakeHeaps heaps{ device, { 32_MB, 32_MB } };
+
+	FakeResidencyManager residencyManager{
+		&adapter, &device, { .budgetUsageLimit = 0.5f, .minimumIdleFrames = 3u }
+	};
+
+	// Both of the heaps are used in the first frame. So, the frames in flight might still be
+	// using them.
+	heaps.Update(residencyManager);
+
+	heaps.SetEvictable(0u, true);
+	heaps.SetEvictable(1u, true);
+
+	adapter.budget = 64_MB;
+
+	for (size_t frameIndex = 2u; frameIndex <= 3u; ++frameIndex)
+	{
+		FakeResidencyManager::Changes changes = heaps.Update(residencyManager);
+
+		EXPECT_TRUE(std::empty(changes.evictedHeaps)) << "A heap in flight was evicted.";
+	}
+
+	FakeResidencyManager::Changes changes = heaps.Update(residencyManager);
+
+	// The usage needs to be at or below 32MB, so only one heap should be evicted.
+	EXPECT_EQ(std::size(changes.evictedHeaps), 1u) << "An idle heap wasn't evicted.";
+	EXPECT_EQ(device.evictCallCount, 1u) << "Evict was called without any heaps.";
+}
+
+TEST(ResidencyManagerTest, EvictedAllocatorTest)
+{
+	D3DAllocatorGroup allocators{ HeapAllocatorType::TLSF };
+
+	const std::uint16_t firstID  = allocators.AddAllocator(D3DHeap{ D3D12_HEAP_TYPE_DEFAULT, 8_MB });
+	const std::uint16_t secondID = allocators.AddAllocator(D3DHeap{ D3D12_HEAP_TYPE_DEFAULT, 8_MB });
+
+	allocators.SetEvicted(firstID, true);
+
+	std::optional<D3DAllocatorGroup::Allocation> allocation = allocators.Allocate(
+		{ .SizeInBytes = 1_MB, .Alignment = 64_KB }
+	);
+
+	ASSERT_TRUE(allocation.has_value()) << "Allocation failed.";
+	EXPECT_EQ(allocation->memoryID, secondID) << "Allocated on an evicted heap.";
+
+	allocators.SetEvicted(firstID, false);
+
+	allocation = allocators.Allocate({ .SizeInBytes = 1_MB, .Alignment = 64_KB });
+
+	ASSERT_TRUE(allocation.has_value()) << "Allocation failed.";
+	EXPECT_EQ(allocation->memoryID, firstID) << "The resident heap wasn't used again.";
+}
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include <optional>
+
+#include <AllocatorBase.hpp>
+#include <RingAllocator.hpp>
+
+using namespace Gaia;
+
+TEST(RingAllocatorTest, AllocationTest)
+{
+	RingAllocator allocator{ 1_KB };
+
+	EXPECT_EQ(allocator.Allocate(100u, 16u).value(), 0u) << "The first offset isn't 0.";
+	EXPECT_EQ(allocator.Allocate(100u, 16u).value(), 112u) << "The offset isn't aligned.";
+	EXPECT_EQ(allocator.GetUsedSize(), 212u) << "The used size is wrong.";
+
+	allocator.Submit();
+
+	EXPECT_EQ(allocator.Allocate(600u, 16u).value(), 224u) << "The offset is wrong.";
+
+	allocator.Submit();
+
+	// The rest of the ring is too small, and the start is still used.
+	EXPECT_FALSE(allocator.Allocate(300u, 16u)) << "Allocated over a used region.";
+
+	allocator.ReleaseSubmission();
+
+	// The allocation wraps around, and the rest of the ring is skipped.
+	EXPECT_EQ(allocator.Allocate(200u, 16u).value(), 0u) << "The allocation didn't wrap.";
+	EXPECT_EQ(allocator.GetUsedSize(), 1_KB - 212u + 200u)
+		<< "The skipped space isn't counted as used.";
+	EXPECT_FALSE(allocator.Allocate(100u, 16u)) << "Allocated over the second submission.";
+
+	allocator.Submit();
+
+	EXPECT_EQ(allocator.GetSubmissionCount(), 2u) << "The submission count is wrong.";
+
+	allocator.ReleaseSubmission();
+	allocator.ReleaseSubmission();
+
+	EXPECT_EQ(allocator.GetUsedSize(), 0u) << "The submissions weren't released.";
+	EXPECT_EQ(allocator.Allocate(100u, 16u).value(), 208u)
+		<< "The allocation didn't continue from the head.";
+	EXPECT_FALSE(allocator.Allocate(2_KB, 16u)) << "Allocated more than the capacity.";
+}
+
+TEST(RingAllocatorTest, SteadyStateTest)
+{
+	RingAllocator allocator{ 64_KB };
+
+	// Three submissions in flight, like the frames, with the oldest one released before each
+	// new one. The allocations should never fail, as only half of the ring is in use.
+	for (size_t frame = 0u; frame < 100u; ++frame)
+	{
+		if (allocator.GetSubmissionCount() == 3u)
+			allocator.ReleaseSubmission();
+
+		for (size_t index = 0u; index < 10u; ++index)
+			EXPECT_TRUE(allocator.Allocate(1_KB, 512u)) << "The allocation failed.";
+
+		allocator.Submit();
+
+		EXPECT_LE(allocator.GetUsedSize(), 32_KB) << "The released space wasn't reused.";
+	}
+}
@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstring>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <AllocatorBase.hpp>
+#include <RowRepacker.hpp>
+
+using namespace Gaia;
+
+static std::vector<RowRepacker::InstructionSet> GetSupportedInstructionSets()
+{
+	std::vector<RowRepacker::InstructionSet> instructionSets{};
+
+	for (auto instructionSet : {
+		RowRepacker::InstructionSet::Scalar, RowRepacker::InstructionSet::SSE2,
+		RowRepacker::InstructionSet::AVX2
+	}) if (RowRepacker::IsSupported(instructionSet))
+			instructionSets.emplace_back(instructionSet);
+
+	return instructionSets;
+}
+
+TEST(RowRepackerTest, CopyTest)
+{
+	// An odd row size and a destination which isn't aligned, so the heads and the tails of the
+	// kernels are used as well.
+	constexpr size_t rowSize     = 1'003u;
+	constexpr size_t rowCount    = 5u;
+	constexpr size_t srcRowPitch = 1'011u;
+	constexpr size_t dstRowPitch = 1'024u;
+	constexpr size_t dstOffset   = 4u;
+
+	std::vector<std::uint8_t> src(srcRowPitch * rowCount);
+
+	std::iota(std::begin(src), std::end(src), std::uint8_t{ 5u });
+
+	for (RowRepacker::InstructionSet instructionSet : GetSupportedInstructionSets())
+	{
+		const RowRepacker rowRepacker{ instructionSet };
+
+		std::vector<std::uint8_t> dst(dstOffset + dstRowPitch * rowCount, 0xCDu);
+
+		rowRepacker.Repack(
+			std::data(dst) + dstOffset, std::data(src), rowSize, rowCount, dstRowPitch,
+			srcRowPitch, RepackMode::Copy
+		);
+
+		for (size_t rowIndex = 0u; rowIndex < rowCount; ++rowIndex)
+		{
+			std::uint8_t const* dstRow = std::data(dst) + dstOffset + rowIndex * dstRowPitch;
+
+			EXPECT_EQ(memcmp(dstRow, std::data(src) + rowIndex * srcRowPitch, rowSize), 0)
+				<< "The row " << rowIndex << " is wrong with the set "
+				<< static_cast<int>(instructionSet) << ".";
+
+			for (size_t offset = rowSize; offset < dstRowPitch; ++offset)
+				ASSERT_EQ(dstRow[offset], 0u) << "The padding wasn't zeroed.";
+		}
+
+		EXPECT_EQ(dst[0], 0xCDu) << "The bytes before the destination were written.";
+	}
+}
+
+TEST(RowRepackerTest, RGB8ToRGBA8Test)
+{
+	constexpr size_t width       = 37u;
+	constexpr size_t rowCount    = 3u;
+	constexpr size_t srcRowPitch = width * 3u;
+	constexpr size_t dstRowPitch = 256u;
+	constexpr size_t dstOffset   = 12u;
+
+	std::vector<std::uint8_t> src(srcRowPitch * rowCount);
+
+	std::iota(std::begin(src), std::end(src), std::uint8_t{ 1u });
+
+	for (RowRepacker::InstructionSet instructionSet : GetSupportedInstructionSets())
+	{
+		const RowRepacker rowRepacker{ instructionSet };
+
+		std::vector<std::uint8_t> dst(dstOffset + dstRowPitch * rowCount, 0xCDu);
+
+		rowRepacker.Repack(
+			std::data(dst) + dstOffset, std::data(src), width * 4u, rowCount, dstRowPitch,
+			srcRowPitch, RepackMode::RGB8ToRGBA8
+		);
+
+		for (size_t rowIndex = 0u; rowIndex < rowCount; ++rowIndex)
+			for (size_t pixelIndex = 0u; pixelIndex < width; ++pixelIndex)
+			{
+				std::uint8_t const* dstPixel
+					= std::data(dst) + dstOffset + rowIndex * dstRowPitch + pixelIndex * 4u;
+				std::uint8_t const* srcPixel
+					= std::data(src) + rowIndex * srcRowPitch + pixelIndex * 3u;
+
+				ASSERT_EQ(memcmp(dstPixel, srcPixel, 3u), 0)
+					<< "The pixel " << pixelIndex << " of the row " << rowIndex
+					<< " is wrong with the set " << static_cast<int>(instructionSet) << ".";
+				ASSERT_EQ(dstPixel[3], 255u) << "The alpha isn't opaque.";
+			}
+
+		EXPECT_EQ(dst[dstOffset + width * 4u], 0u) << "The padding wasn't zeroed.";
+	}
+}
+
+TEST(RowRepackerTest, DISABLED_RepackBenchmark)
+{
+	// The throughputs are recorded as the properties of the test, in GB/s. The destination here
+	// is cached memory, unlike the write combined upload memory. So, the non-temporal stores
+	// only avoid reading the destination lines here.
+	constexpr size_t pitchAlignment = 256u;
+	constexpr size_t repeatCount    = 3u;
+
+	for (size_t width : { 256u, 1'000u, 2'048u, 4'096u, 8'192u })
+	{
+		const size_t height      = width;
+		const size_t rowSize     = width * 4u;
+		const size_t dstRowPitch = (rowSize + pitchAlignment - 1u) / pitchAlignment * pitchAlignment;
+
+		std::vector<std::uint8_t> src(rowSize * height, 1u);
+		std::vector<std::uint8_t> dst(dstRowPitch * height, 0u);
+
+		auto Measure = [&](auto&& copy)
+		{
+			// The first run touches the pages of the destination.
+			copy();
+
+			const auto startTime = std::chrono::steady_clock::now();
+
+			for (size_t index = 0u; index < repeatCount; ++index)
+				copy();
+
+			const auto elapsedTime = std::chrono::duration<double>{
+				std::chrono::steady_clock::now() - startTime
+			};
+
+			return static_cast<double>(rowSize * height * repeatCount) / 1_GB / elapsedTime.count();
+		};
+
+		// The per row memcpy, which was used before the repacker.
+		const double memcpyThroughput = Measure(
+			[&]
+			{
+				for (size_t rowIndex = 0u; rowIndex < height; ++rowIndex)
+					memcpy(
+						std::data(dst) + rowIndex * dstRowPitch, std::data(src) + rowIndex * rowSize,
+						rowSize
+					);
+			}
+		);
+
+		const std::string sizeName = std::to_string(width) + "x" + std::to_string(height);
+
+		RecordProperty(sizeName + "_memcpy", std::to_string(memcpyThroughput));
+
+		for (RowRepacker::InstructionSet instructionSet : GetSupportedInstructionSets())
+		{
+			const RowRepacker rowRepacker{ instructionSet };
+
+			const double copyThroughput = Measure(
+				[&]
+				{
+					rowRepacker.Repack(
+						std::data(dst), std::data(src), rowSize, height, dstRowPitch, rowSize,
+						RepackMode::Copy
+					);
+				}
+			);
+
+			const double expandThroughput = Measure(
+				[&]
+				{
+					rowRepacker.Repack(
+						std::data(dst), std::data(src), rowSize, height, dstRowPitch,
+						width * 3u, RepackMode::RGB8ToRGBA8
+					);
+				}
+			);
+
+			const std::string setName
+				= sizeName + "_set" + std::to_string(static_cast<int>(instructionSet));
+
+			RecordProperty(setName + "_copy", std::to_string(copyThroughput));
+			RecordProperty(setName + "_rgb8", std::to_string(expandThroughput));
+		}
+
+		EXPECT_EQ(dst[dstRowPitch * (height - 1u)], 1u) << "The last row wasn't copied.";
+	}
+}
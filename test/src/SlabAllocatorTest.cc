@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include <SlabAllocator.hpp>
+
+using namespace Gaia;
+
+TEST(SlabAllocatorTest, AllocationTest)
+{
+	// The per pipeline data is 12 bytes, so only 341 of them fit in 4KB.
+	SlabAllocator allocator{ 12u, 4096u };
+
+	EXPECT_EQ(allocator.GetSlabSlotCount(), 341u) << "The slab slot count isn't 341.";
+	EXPECT_EQ(allocator.GetSlabSize(), 4092u) << "The slab size isn't a multiple of the slot size.";
+	EXPECT_FALSE(allocator.Allocate().has_value()) << "Allocated without a slab.";
+
+	EXPECT_EQ(allocator.AddSlab(), 0u) << "The first slab doesn't start at 0.";
+
+	for (size_t index = 0u; index < allocator.GetSlabSlotCount(); ++index)
+	{
+		std::optional<size_t> slotIndex = allocator.Allocate();
+
+		ASSERT_TRUE(slotIndex.has_value()) << "Allocation failed.";
+		EXPECT_EQ(slotIndex.value(), index) << "The lowest slot wasn't returned.";
+	}
+
+	EXPECT_FALSE(allocator.Allocate().has_value()) << "Allocated more than the slab size.";
+
+	EXPECT_EQ(allocator.AddSlab(), 341u) << "The second slab doesn't follow the first one.";
+	EXPECT_EQ(allocator.GetSlotOffset(341u), 4092u) << "The slabs aren't contiguous.";
+
+	allocator.Deallocate(100u);
+	allocator.Deallocate(5u);
+
+	EXPECT_EQ(allocator.GetAllocatedSlotCount(), 339u) << "The allocated slot count is wrong.";
+
+	EXPECT_EQ(allocator.Allocate().value(), 5u) << "The lowest freed slot wasn't reused.";
+	EXPECT_EQ(allocator.Allocate().value(), 100u) << "The second freed slot wasn't reused.";
+	EXPECT_EQ(allocator.Allocate().value(), 341u) << "The new slab wasn't used.";
+}
+
+TEST(SlabAllocatorTest, MatchingSlotTest)
+{
+	// The counters and the per pipeline data are indexed with the same pipeline index. So, they
+	// must get the same slots, even though their slabs hold different slot counts.
+	SlabAllocator perPipelineAllocator{ 12u, 4096u };
+	SlabAllocator counterAllocator{ 4u, 4096u };
+
+	auto Allocate = [](SlabAllocator& allocator)
+	{
+		std::optional<size_t> slotIndex = allocator.Allocate();
+
+		if (!slotIndex)
+		{
+			allocator.AddSlab();
+
+			slotIndex = allocator.Allocate();
+		}
+
+		return slotIndex.value();
+	};
+
+	std::mt19937 randomEngine{ 7u };
+	std::bernoulli_distribution deallocateDistribution{ 0.3 };
+
+	std::vector<size_t> liveSlots{};
+	size_t mismatchCount = 0u;
+
+	for (size_t _ = 0u; _ < 5'000u; ++_)
+	{
+		if (!std::empty(liveSlots) && deallocateDistribution(randomEngine))
+		{
+			std::uniform_int_distribution<size_t> indexDistribution{ 0u, std::size(liveSlots) - 1u };
+
+			const size_t liveIndex = indexDistribution(randomEngine);
+
+			perPipelineAllocator.Deallocate(liveSlots[liveIndex]);
+			counterAllocator.Deallocate(liveSlots[liveIndex]);
+
+			liveSlots[liveIndex] = liveSlots.back();
+			liveSlots.pop_back();
+
+			continue;
+		}
+
+		const size_t perPipelineSlot = Allocate(perPipelineAllocator);
+		const size_t counterSlot     = Allocate(counterAllocator);
+
+		if (perPipelineSlot != counterSlot)
+			++mismatchCount;
+
+		liveSlots.emplace_back(perPipelineSlot);
+	}
+
+	EXPECT_EQ(mismatchCount, 0u) << "The allocators returned different slots.";
+	EXPECT_EQ(perPipelineAllocator.GetAllocatedSlotCount(), std::size(liveSlots))
+		<< "The allocated slot count is wrong.";
+}
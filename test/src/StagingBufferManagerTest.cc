@@ -83,5 +83,218 @@ TEST_F(StagingBufferTest, StagingTest)
 
 	copyQueue.SubmitCommandLists(submitBuilder);
 
+	stagingBufferMan.SetUsed(waitFence.Get(), 1u);
+
+	waitFence.Wait(1u);
+}
+
+TEST_F(StagingBufferTest, CopyCoalescingTest)
+{
+	ID3D12Device5* device  = s_deviceManager->GetDevice();
+	IDXGIAdapter3* adapter = s_deviceManager->GetAdapter();
+
+	MemoryManager memoryManager{ adapter, device, 20_MB, 200_KB };
+
+	D3DCommandQueue copyQueue{};
+	copyQueue.Create(device, D3D12_COMMAND_LIST_TYPE_COPY, Constants::frameCount);
+
+	ThreadPool threadPool{ 8u };
+
+	StagingBufferManager stagingBufferMan{ device, &memoryManager, &threadPool };
+
+	Buffer firstBuffer{ device, &memoryManager, D3D12_HEAP_TYPE_DEFAULT };
+	firstBuffer.Create(4_KB, D3D12_RESOURCE_STATE_COMMON);
+
+	Buffer secondBuffer{ device, &memoryManager, D3D12_HEAP_TYPE_DEFAULT };
+	secondBuffer.Create(4_KB, D3D12_RESOURCE_STATE_COMMON);
+
+	Callisto::TemporaryDataBufferGPU tempDataBuffer{};
+
+	// The contiguous ranges of the first buffer are queued out of order and with a copy to a
+	// different buffer between them.
+	for (UINT64 offset : { 1_KB, 0u, 3_KB })
+	{
+		stagingBufferMan.AddBuffer(
+			std::make_unique<std::uint8_t[]>(1_KB), 1_KB, &firstBuffer, offset, tempDataBuffer
+		);
+		stagingBufferMan.AddBuffer(
+			std::make_unique<std::uint8_t[]>(12u), 12u, &secondBuffer, offset, tempDataBuffer
+		);
+	}
+
+	stagingBufferMan.AddBuffer(
+		std::make_unique<std::uint8_t[]>(1_KB), 1_KB, &firstBuffer, 2_KB, tempDataBuffer
+	);
+
+	const D3DCommandList& copyCmdList = copyQueue.GetCommandList(0u);
+
+	{
+		const CommandListScope cmdListScope{ copyCmdList };
+
+		stagingBufferMan.CopyAndClearQueuedBuffers(cmdListScope);
+	}
+
+	const StagingBufferManager::CopyCounters& copyCounters = stagingBufferMan.GetCopyCounters();
+
+	EXPECT_EQ(copyCounters.queuedBufferCopyCount, 7u) << "The queued copy count is wrong.";
+	// The copies of the second buffer aren't contiguous, but the first buffer needs a single one.
+	EXPECT_EQ(copyCounters.recordedBufferCopyCount, 4u) << "The contiguous copies weren't merged.";
+
+	D3DFence waitFence{};
+	waitFence.Create(device);
+
+	QueueSubmitBuilder<0u, 1u> submitBuilder{};
+	submitBuilder.SignalFence(waitFence).CommandList(copyCmdList);
+
+	copyQueue.SubmitCommandLists(submitBuilder);
+
+	stagingBufferMan.SetUsed(waitFence.Get(), 1u);
+
+	waitFence.Wait(1u);
+
+	stagingBufferMan.ResetCopyCounters();
+
+	EXPECT_EQ(stagingBufferMan.GetCopyCounters().queuedBufferCopyCount, 0u)
+		<< "The counters weren't reset.";
+}
+
+TEST_F(StagingBufferTest, ReservationTest)
+{
+	ID3D12Device5* device  = s_deviceManager->GetDevice();
+	IDXGIAdapter3* adapter = s_deviceManager->GetAdapter();
+
+	MemoryManager memoryManager{ adapter, device, 20_MB, 200_KB };
+
+	D3DCommandQueue copyQueue{};
+	copyQueue.Create(device, D3D12_COMMAND_LIST_TYPE_COPY, Constants::frameCount);
+
+	ThreadPool threadPool{ 8u };
+
+	StagingBufferManager stagingBufferMan{ device, &memoryManager, &threadPool };
+
+	Buffer testBuffer{ device, &memoryManager, D3D12_HEAP_TYPE_DEFAULT };
+	testBuffer.Create(2_KB, D3D12_RESOURCE_STATE_COMMON);
+
+	// Bigger than the max allocation size of the upload ring, so it gets its own buffer.
+	Buffer bigBuffer{ device, &memoryManager, D3D12_HEAP_TYPE_DEFAULT };
+	bigBuffer.Create(6_MB, D3D12_RESOURCE_STATE_COMMON);
+
+	Texture testTexture{ device, &memoryManager, D3D12_HEAP_TYPE_DEFAULT };
+	testTexture.Create2D(
+		250u, 100u, 1u, DXGI_FORMAT_R8G8B8A8_UNORM, D3D12_RESOURCE_STATE_COMMON
+	);
+
+	Callisto::TemporaryDataBufferGPU tempDataBuffer{};
+
+	{
+		const StagingBufferManager::Reservation reservation = stagingBufferMan.ReserveBuffer(
+			2_KB, tempDataBuffer
+		);
+
+		ASSERT_EQ(std::size(reservation.data), 2_KB) << "The reserved size is wrong.";
+		EXPECT_EQ(reservation.srcOffset % 16u, 0u) << "The reservation isn't aligned.";
+
+		memset(std::data(reservation.data), 1, std::size(reservation.data));
+
+		stagingBufferMan.CommitBuffer(reservation, &testBuffer, 0u);
+	}
+
+	{
+		const StagingBufferManager::Reservation reservation = stagingBufferMan.ReserveBuffer(
+			6_MB, tempDataBuffer
+		);
+
+		EXPECT_EQ(reservation.srcOffset, 0u) << "The big data didn't get its own buffer.";
+
+		memset(std::data(reservation.data), 2, std::size(reservation.data));
+
+		stagingBufferMan.CommitBuffer(reservation, &bigBuffer, 0u);
+	}
+
+	{
+		const StagingBufferManager::Reservation reservation = stagingBufferMan.ReserveTexture(
+			&testTexture, tempDataBuffer
+		);
+
+		EXPECT_EQ(
+			reservation.srcOffset % D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, 0u
+		) << "The texture reservation isn't aligned.";
+
+		const auto rowCount    = static_cast<size_t>(testTexture.GetHeight());
+		const auto rowSize     = static_cast<size_t>(testTexture.GetRowPitch());
+		const auto dstRowPitch = static_cast<size_t>(testTexture.GetRowPitchD3DAligned());
+
+		ASSERT_GE(std::size(reservation.data), dstRowPitch * (rowCount - 1u) + rowSize)
+			<< "The reservation can't fit the aligned rows.";
+
+		for (size_t rowIndex = 0u; rowIndex < rowCount; ++rowIndex)
+			memset(std::data(reservation.data) + rowIndex * dstRowPitch, 3, rowSize);
+
+		stagingBufferMan.CommitTexture(reservation, &testTexture);
+	}
+
+	// The reserved copies can be queued with the usual ones.
+	stagingBufferMan.AddBuffer(
+		std::make_unique<std::uint8_t[]>(1_KB), 1_KB, &testBuffer, 1_KB, tempDataBuffer
+	);
+
+	const D3DCommandList& copyCmdList = copyQueue.GetCommandList(0u);
+
+	{
+		const CommandListScope cmdListScope{ copyCmdList };
+
+		stagingBufferMan.CopyAndClearQueuedBuffers(cmdListScope);
+	}
+
+	EXPECT_EQ(stagingBufferMan.GetCopyCounters().queuedBufferCopyCount, 3u)
+		<< "The reserved copies weren't queued.";
+
+	D3DFence waitFence{};
+	waitFence.Create(device);
+
+	QueueSubmitBuilder<0u, 1u> submitBuilder{};
+	submitBuilder.SignalFence(waitFence).CommandList(copyCmdList);
+
+	copyQueue.SubmitCommandLists(submitBuilder);
+
+	stagingBufferMan.SetUsed(waitFence.Get(), 1u);
+
 	waitFence.Wait(1u);
 }
+
+TEST_F(StagingBufferTest, UploadRingShrinkTest)
+{
+	ID3D12Device5* device  = s_deviceManager->GetDevice();
+	IDXGIAdapter3* adapter = s_deviceManager->GetAdapter();
+
+	MemoryManager memoryManager{ adapter, device, 20_MB, 200_KB };
+
+	UploadRingAllocator uploadRing{ device, &memoryManager, 64_KB, 64_KB, 2u };
+
+	D3DFence waitFence{};
+	waitFence.Create(device);
+
+	[[maybe_unused]] auto firstAllocation  = uploadRing.Allocate(48_KB, 256u);
+	[[maybe_unused]] auto secondAllocation = uploadRing.Allocate(48_KB, 256u);
+
+	ASSERT_GT(uploadRing.GetCapacity(), 64_KB) << "The ring didn't grow.";
+
+	uploadRing.SetUsed(waitFence.Get(), 1u);
+
+	// The allocations are still in flight, so the ring is used.
+	uploadRing.ShrinkIfUnderused();
+	uploadRing.ShrinkIfUnderused();
+
+	EXPECT_GT(uploadRing.GetCapacity(), 64_KB) << "The ring was shrunk while it was used.";
+
+	// The fence is signalled on the CPU, as nothing was copied.
+	waitFence.Signal(1u);
+
+	uploadRing.ShrinkIfUnderused();
+
+	EXPECT_GT(uploadRing.GetCapacity(), 64_KB) << "The ring was shrunk too early.";
+
+	uploadRing.ShrinkIfUnderused();
+
+	EXPECT_EQ(uploadRing.GetCapacity(), 64_KB) << "The ring wasn't shrunk back.";
+}
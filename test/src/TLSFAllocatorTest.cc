@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <D3DAllocator.hpp>
+#include <TLSFAllocator.hpp>
+
+using namespace Gaia;
+
+TEST(TLSFAllocatorTest, AllocationTest)
+{
+	TLSFAllocator allocator{ 0u, 111_MB, 256_B };
+
+	EXPECT_EQ(allocator.AvailableSize(), 111_MB) << "The available size isn't 111MB.";
+
+	{
+		std::optional<size_t> offset = allocator.Allocate(5_MB, 64_KB);
+
+		ASSERT_TRUE(offset.has_value()) << "Allocation failed.";
+		EXPECT_EQ(offset.value(), 0u) << "The offset isn't 0.";
+		// Unlike the buddy allocator, the size shouldn't be rounded up to 8MB.
+		EXPECT_EQ(allocator.AvailableSize(), 106_MB) << "The available size isn't 106MB.";
+
+		allocator.Deallocate(offset.value());
+
+		EXPECT_EQ(allocator.AvailableSize(), 111_MB) << "The available size isn't 111MB.";
+		EXPECT_EQ(allocator.LargestFreeBlockSize(), 111_MB) << "The blocks weren't merged.";
+	}
+
+	{
+		std::optional<size_t> smallOffset = allocator.Allocate(1_KB, 256_B);
+		std::optional<size_t> alignedOffset = allocator.Allocate(5_MB, 64_KB);
+
+		ASSERT_TRUE(smallOffset.has_value() && alignedOffset.has_value()) << "Allocation failed.";
+		EXPECT_EQ(smallOffset.value(), 0u) << "The offset isn't 0.";
+		EXPECT_EQ(alignedOffset.value(), 64_KB) << "The offset isn't 64KB.";
+		EXPECT_EQ(allocator.AvailableSize(), 111_MB - 5_MB - 1_KB)
+			<< "The alignment padding shouldn't be allocated.";
+
+		allocator.Deallocate(smallOffset.value());
+		allocator.Deallocate(alignedOffset.value());
+
+		EXPECT_EQ(allocator.FreeBlockCount(), 1u) << "The blocks weren't merged.";
+	}
+
+	{
+		std::optional<size_t> tooBig = allocator.Allocate(112_MB, 256_B);
+
+		EXPECT_FALSE(tooBig.has_value()) << "The allocation shouldn't have succeeded.";
+	}
+}
+
+TEST(TLSFAllocatorTest, CoalescingTest)
+{
+	TLSFAllocator allocator{ 0u, 4_MB, 256_B };
+
+	std::vector<size_t> offsets{};
+
+	for (size_t index = 0u; index < 16u; ++index)
+	{
+		std::optional<size_t> offset = allocator.Allocate(256_KB, 256_B);
+
+		ASSERT_TRUE(offset.has_value()) << "Allocation failed.";
+
+		offsets.emplace_back(offset.value());
+	}
+
+	EXPECT_EQ(allocator.AvailableSize(), 0u) << "The allocator should be full.";
+
+	// Free every other block first, so nothing can be merged.
+	for (size_t index = 0u; index < std::size(offsets); index += 2u)
+		allocator.Deallocate(offsets[index]);
+
+	EXPECT_EQ(allocator.FreeBlockCount(), 8u) << "The free block count isn't 8.";
+	EXPECT_EQ(allocator.LargestFreeBlockSize(), 256_KB) << "The largest block isn't 256KB.";
+
+	for (size_t index = 1u; index < std::size(offsets); index += 2u)
+		allocator.Deallocate(offsets[index]);
+
+	EXPECT_EQ(allocator.FreeBlockCount(), 1u) << "The blocks weren't merged.";
+	EXPECT_EQ(allocator.LargestFreeBlockSize(), 4_MB) << "The largest block isn't 4MB.";
+}
+
+TEST(TLSFAllocatorTest, AllocateAtTest)
+{
+	TLSFAllocator allocator{ 0u, 4_MB, 256_B };
+
+	std::optional<size_t> offset = allocator.Allocate(1_MB, 64_KB);
+
+	ASSERT_TRUE(offset.has_value()) << "Allocation failed.";
+
+	EXPECT_FALSE(allocator.AllocateAt(512_KB, 1_MB)) << "An allocated range was allocated again.";
+	EXPECT_FALSE(allocator.AllocateAt(3_MB + 512_KB, 1_MB)) << "The range is outside of the heap.";
+
+	ASSERT_TRUE(allocator.AllocateAt(2_MB, 1_MB)) << "The free range wasn't allocated.";
+	EXPECT_EQ(allocator.AvailableSize(), 2_MB) << "The available size isn't 2MB.";
+	// The padding before the offset and the leftover after it should still be free.
+	EXPECT_EQ(allocator.FreeBlockCount(), 2u) << "The free blocks weren't split.";
+
+	allocator.Deallocate(2_MB);
+	allocator.Deallocate(offset.value());
+
+	EXPECT_EQ(allocator.FreeBlockCount(), 1u) << "The blocks weren't merged.";
+	EXPECT_EQ(allocator.LargestFreeBlockSize(), 4_MB) << "The blocks weren't merged.";
+}
+
+TEST(TLSFAllocatorTest, DISABLED_D3DAllocatorReplayBenchmark)
+{
+	// Replays the same allocate/free sequence on both of the heap allocators. The sizes are
+	// similar to what GetResourceAllocationInfo would return for buffers and textures. The
+	// results are recorded as the properties of the test.
+	constexpr size_t heapSize       = 512_MB;
+	constexpr size_t operationCount = 20'000u;
+
+	struct Operation
+	{
+		bool   allocate;
+		size_t size;
+		size_t freeIndex;
+	};
+
+	std::vector<Operation> operations{};
+
+	{
+		std::mt19937_64 randomEngine{ 1234u };
+		std::uniform_int_distribution<size_t> bufferBlocks{ 1u, 64u };
+		std::uniform_int_distribution<size_t> textureBlocks{ 1u, 512u };
+		std::uniform_int_distribution<size_t> percent{ 0u, 99u };
+
+		size_t liveCount = 0u;
+
+		for (size_t _ = 0u; _ < operationCount; ++_)
+		{
+			if (liveCount == 0u || percent(randomEngine) < 55u)
+			{
+				const size_t blockCount = percent(randomEngine) < 60u ?
+					bufferBlocks(randomEngine) : textureBlocks(randomEngine);
+
+				operations.emplace_back(Operation{ true, blockCount * 64_KB, 0u });
+
+				++liveCount;
+			}
+			else
+			{
+				std::uniform_int_distribution<size_t> liveIndex{ 0u, liveCount - 1u };
+
+				operations.emplace_back(Operation{ false, 0u, liveIndex(randomEngine) });
+
+				--liveCount;
+			}
+		}
+	}
+
+	struct ReplayResult
+	{
+		size_t failedCount;
+		size_t wastedBytes;
+		double nanosecondsPerOperation;
+	};
+
+	auto Replay = [&operations](HeapAllocatorType allocatorType) -> ReplayResult
+	{
+		D3DAllocator allocator{
+			D3DHeap{ D3D12_HEAP_TYPE_DEFAULT, heapSize }, 0u, allocatorType
+		};
+
+		struct Allocation
+		{
+			UINT64 offset;
+			UINT64 size;
+		};
+
+		std::vector<Allocation> liveAllocations{};
+		size_t failedCount    = 0u;
+		size_t requestedBytes = 0u;
+		size_t wastedBytes    = 0u;
+
+		const auto startTime = std::chrono::steady_clock::now();
+
+		for (const Operation& operation : operations)
+		{
+			if (operation.allocate)
+			{
+				std::optional<UINT64> offset = allocator.Allocate(
+					{ .SizeInBytes = operation.size, .Alignment = 64_KB }
+				);
+
+				if (offset)
+				{
+					liveAllocations.emplace_back(Allocation{ offset.value(), operation.size });
+					requestedBytes += operation.size;
+
+					const size_t usedBytes = heapSize - allocator.AvailableSize();
+					wastedBytes            = std::max(wastedBytes, usedBytes - requestedBytes);
+				}
+				else
+					++failedCount;
+			}
+			else if (!std::empty(liveAllocations))
+			{
+				const size_t freeIndex       = operation.freeIndex % std::size(liveAllocations);
+				const Allocation& allocation = liveAllocations[freeIndex];
+
+				allocator.Deallocate(allocation.offset, allocation.size, 64_KB);
+				requestedBytes -= allocation.size;
+
+				liveAllocations[freeIndex] = liveAllocations.back();
+				liveAllocations.pop_back();
+			}
+		}
+
+		const auto elapsedTime = std::chrono::duration<double, std::nano>{
+			std::chrono::steady_clock::now() - startTime
+		};
+
+		return ReplayResult
+		{
+			.failedCount             = failedCount,
+			.wastedBytes             = wastedBytes,
+			.nanosecondsPerOperation = elapsedTime.count() / static_cast<double>(operationCount)
+		};
+	};
+
+	const ReplayResult buddyResult = Replay(HeapAllocatorType::Buddy);
+	const ReplayResult tlsfResult  = Replay(HeapAllocatorType::TLSF);
+
+	auto RecordResult = [](const std::string& allocatorName, const ReplayResult& result)
+	{
+		RecordProperty(allocatorName + "_failed", static_cast<int>(result.failedCount));
+		RecordProperty(
+			allocatorName + "_peakWasteMB", static_cast<int>(result.wastedBytes / 1_MB)
+		);
+		RecordProperty(
+			allocatorName + "_nsPerOperation", std::to_string(result.nanosecondsPerOperation)
+		);
+	};
+
+	RecordResult("Buddy", buddyResult);
+	RecordResult("TLSF", tlsfResult);
+
+	// All of the sizes are multiples of the alignment, so TLSF shouldn't waste anything.
+	EXPECT_EQ(tlsfResult.wastedBytes, 0u) << "TLSF shouldn't round the allocations up.";
+	EXPECT_LE(tlsfResult.wastedBytes, buddyResult.wastedBytes) << "TLSF wasted more memory.";
+}
@@ -0,0 +1,297 @@
+#include <D3DDeviceManager.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+#include <D3DFence.hpp>
+#include <D3DUploadScheduler.hpp>
+#include <D3DUploadTracker.hpp>
+
+using namespace Gaia;
+
+class UploadTrackerTest : public ::testing::Test
+{
+protected:
+	static void SetUpTestSuite();
+	static void TearDownTestSuite();
+
+protected:
+	inline static std::unique_ptr<DeviceManager> s_deviceManager;
+};
+
+void UploadTrackerTest::SetUpTestSuite()
+{
+	s_deviceManager = std::make_unique<DeviceManager>();
+
+	s_deviceManager->GetDebugLogger().AddCallbackType(DebugCallbackType::StandardError);
+	s_deviceManager->Create(D3D_FEATURE_LEVEL_12_0);
+}
+
+void UploadTrackerTest::TearDownTestSuite()
+{
+	s_deviceManager.reset();
+}
+
+TEST_F(UploadTrackerTest, TicketTest)
+{
+	ID3D12Device5* device = s_deviceManager->GetDevice();
+
+	// The copy fences are per frame, like in the render engines.
+	D3DFence firstFence{};
+	firstFence.Create(device);
+
+	D3DFence secondFence{};
+	secondFence.Create(device);
+
+	UploadTracker uploadTracker{};
+
+	const UploadTicket firstTicket{ .priority = UploadPriority::Normal, .uploadIndex = 0u };
+	const UploadTicket secondTicket{ .priority = UploadPriority::Normal, .uploadIndex = 1u };
+	const UploadTicket criticalTicket{ .priority = UploadPriority::Critical, .uploadIndex = 0u };
+
+	EXPECT_FALSE(uploadTracker.IsSubmitted(firstTicket)) << "Nothing has been submitted yet.";
+	EXPECT_FALSE(uploadTracker.IsCompleted(firstTicket)) << "Nothing has been submitted yet.";
+	EXPECT_FALSE(uploadTracker.Wait(firstTicket)) << "Waited on an unsubmitted ticket.";
+
+	uploadTracker.SetSubmitted(firstFence, 1u, { 1u, 1u, 0u });
+
+	EXPECT_TRUE(uploadTracker.IsSubmitted(criticalTicket)) << "The ticket should be submitted.";
+	EXPECT_FALSE(uploadTracker.IsSubmitted(secondTicket))
+		<< "The second upload hasn't been submitted yet.";
+
+	uploadTracker.SetSubmitted(secondFence, 1u, { 1u, 2u, 0u });
+
+	EXPECT_TRUE(uploadTracker.IsSubmitted(secondTicket)) << "The ticket should be submitted.";
+	EXPECT_FALSE(uploadTracker.IsCompleted(firstTicket)) << "The fence hasn't been signalled.";
+
+	firstFence.Signal(1u);
+
+	EXPECT_TRUE(uploadTracker.IsCompleted(firstTicket)) << "The first upload wasn't completed.";
+	EXPECT_TRUE(uploadTracker.IsCompleted(criticalTicket)) << "The critical upload isn't done.";
+	EXPECT_FALSE(uploadTracker.IsCompleted(secondTicket)) << "The second upload isn't done yet.";
+
+	secondFence.Signal(1u);
+
+	EXPECT_TRUE(uploadTracker.Wait(secondTicket)) << "The submitted ticket wasn't waited on.";
+	EXPECT_TRUE(uploadTracker.IsCompleted(secondTicket)) << "The second upload wasn't completed.";
+	// The submissions have been released, but the older tickets should still be completed.
+	EXPECT_TRUE(uploadTracker.IsCompleted(firstTicket)) << "A released ticket isn't completed.";
+	EXPECT_TRUE(uploadTracker.Wait(firstTicket)) << "A released ticket wasn't completed.";
+
+	const UploadTicket backgroundTicket{
+		.priority = UploadPriority::Background, .uploadIndex = 0u
+	};
+
+	EXPECT_FALSE(uploadTracker.IsSubmitted(backgroundTicket))
+		<< "The background upload shouldn't be submitted.";
+}
+
+TEST_F(UploadTrackerTest, SchedulerTest)
+{
+	ID3D12Device5* device  = s_deviceManager->GetDevice();
+	IDXGIAdapter3* adapter = s_deviceManager->GetAdapter();
+
+	MemoryManager memoryManager{ adapter, device, 20_MB, 200_KB };
+
+	ThreadPool threadPool{ 8u };
+
+	StagingBufferManager stagingBufferMan{ device, &memoryManager, &threadPool };
+
+	Buffer testBuffer{ device, &memoryManager, D3D12_HEAP_TYPE_DEFAULT };
+	testBuffer.Create(16_KB, D3D12_RESOURCE_STATE_COMMON);
+
+	Callisto::TemporaryDataBufferGPU tempDataBuffer{};
+
+	UploadScheduler uploadScheduler{ 4_KB };
+
+	auto AddBuffer = [&](UINT64 offset, UINT64 size, UploadPriority priority)
+	{
+		return uploadScheduler.AddBuffer(
+			std::make_unique<std::uint8_t[]>(size), size, &testBuffer, offset, priority
+		);
+	};
+
+	const UploadTicket backgroundTicket = AddBuffer(0u, 2_KB, UploadPriority::Background);
+	const UploadTicket firstTicket      = AddBuffer(2_KB, 3_KB, UploadPriority::Normal);
+	const UploadTicket secondTicket     = AddBuffer(5_KB, 3_KB, UploadPriority::Normal);
+	const UploadTicket criticalTicket   = AddBuffer(8_KB, 2_KB, UploadPriority::Critical);
+
+	EXPECT_TRUE(uploadScheduler.HasBacklog()) << "The uploads weren't added.";
+	EXPECT_EQ(uploadScheduler.GetFrameStats().backlogBytes, 10_KB) << "The backlog size is wrong.";
+
+	// The critical upload ignores the budget, and the first normal one doesn't fit after it.
+	// But an upload is queued each frame, so the budget doesn't stop the backlog altogether.
+	uploadScheduler.QueueUploads(stagingBufferMan, tempDataBuffer);
+
+	{
+		const UploadScheduler::FrameStats& frameStats = uploadScheduler.GetFrameStats();
+
+		EXPECT_EQ(frameStats.uploadedBytes, 2_KB) << "Only the critical upload should be queued.";
+		EXPECT_EQ(frameStats.backlogCount, 3u) << "The rest should be carried over.";
+
+		const UploadTracker::UploadCounts queuedCounts = uploadScheduler.GetQueuedCounts();
+
+		EXPECT_LT(criticalTicket.uploadIndex, queuedCounts[0u])
+			<< "The critical upload wasn't queued.";
+		EXPECT_EQ(firstTicket.uploadIndex, queuedCounts[1u]) << "A normal upload was queued.";
+	}
+
+	uploadScheduler.QueueUploads(stagingBufferMan, tempDataBuffer);
+
+	{
+		const UploadScheduler::FrameStats& frameStats = uploadScheduler.GetFrameStats();
+
+		EXPECT_EQ(frameStats.uploadedBytes, 3_KB) << "The second normal upload shouldn't fit.";
+		EXPECT_EQ(frameStats.backlogBytes, 5_KB) << "The backlog size is wrong.";
+
+		const UploadTracker::UploadCounts queuedCounts = uploadScheduler.GetQueuedCounts();
+
+		EXPECT_LT(firstTicket.uploadIndex, queuedCounts[1u]) << "The first upload wasn't queued.";
+		EXPECT_EQ(secondTicket.uploadIndex, queuedCounts[1u]) << "The uploads weren't in order.";
+		// The background upload would fit, but it shouldn't skip ahead of the normal one.
+		EXPECT_EQ(backgroundTicket.uploadIndex, queuedCounts[2u])
+			<< "The background upload was queued before the normal one.";
+	}
+
+	uploadScheduler.QueueUploads(stagingBufferMan, tempDataBuffer);
+
+	EXPECT_EQ(uploadScheduler.GetFrameStats().uploadedBytes, 3_KB)
+		<< "The background upload shouldn't fit after the normal one.";
+
+	uploadScheduler.SetBudget(0u);
+
+	uploadScheduler.QueueUploads(stagingBufferMan, tempDataBuffer);
+
+	EXPECT_EQ(uploadScheduler.GetFrameStats().uploadedBytes, 2_KB)
+		<< "The background upload wasn't queued.";
+	EXPECT_FALSE(uploadScheduler.HasBacklog()) << "The backlog wasn't cleared.";
+
+	const UploadTicket immediateTicket = uploadScheduler.GetImmediateTicket();
+
+	EXPECT_LT(immediateTicket.uploadIndex, uploadScheduler.GetQueuedCounts()[0u])
+		<< "The immediate ticket should be counted as queued.";
+}
+
+TEST_F(UploadTrackerTest, ChunkTest)
+{
+	ID3D12Device5* device  = s_deviceManager->GetDevice();
+	IDXGIAdapter3* adapter = s_deviceManager->GetAdapter();
+
+	MemoryManager memoryManager{ adapter, device, 20_MB, 200_KB };
+
+	ThreadPool threadPool{ 8u };
+
+	StagingBufferManager stagingBufferMan{ device, &memoryManager, &threadPool };
+
+	Buffer testBuffer{ device, &memoryManager, D3D12_HEAP_TYPE_DEFAULT };
+	testBuffer.Create(20_KB, D3D12_RESOURCE_STATE_COMMON);
+
+	// The rows are 256 bytes, so the bands of a 4KB chunk should have 16 rows.
+	Texture testTexture{ device, &memoryManager, D3D12_HEAP_TYPE_DEFAULT };
+	testTexture.Create2D(64u, 64u, 1u, DXGI_FORMAT_R8G8B8A8_UNORM, D3D12_RESOURCE_STATE_COMMON);
+
+	Callisto::TemporaryDataBufferGPU tempDataBuffer{};
+
+	UploadScheduler uploadScheduler{ 0u, 4_KB, 8_KB };
+
+	const UploadTicket bufferTicket = uploadScheduler.AddBuffer(
+		std::make_unique<std::uint8_t[]>(20_KB), 20_KB, &testBuffer, 0u, UploadPriority::Normal
+	);
+	const UploadTicket textureTicket = uploadScheduler.AddTexture(
+		std::make_unique<std::uint8_t[]>(testTexture.GetBufferSize()), &testTexture,
+		UploadPriority::Normal
+	);
+
+	EXPECT_EQ(uploadScheduler.GetFrameStats().backlogCount, 9u)
+		<< "The uploads weren't split into chunks.";
+
+	// Even without a budget, only the window of the chunks should be queued each frame.
+	for (size_t frameIndex = 0u; frameIndex < 2u; ++frameIndex)
+	{
+		uploadScheduler.QueueUploads(stagingBufferMan, tempDataBuffer);
+
+		EXPECT_EQ(uploadScheduler.GetFrameStats().uploadedBytes, 8_KB)
+			<< "The staging window wasn't filled in the frame " << frameIndex << ".";
+		EXPECT_EQ(uploadScheduler.GetQueuedCounts()[1u], bufferTicket.uploadIndex)
+			<< "The buffer shouldn't be queued before its last chunk.";
+	}
+
+	uploadScheduler.QueueUploads(stagingBufferMan, tempDataBuffer);
+
+	EXPECT_LT(bufferTicket.uploadIndex, uploadScheduler.GetQueuedCounts()[1u])
+		<< "The last chunk of the buffer wasn't queued.";
+
+	uploadScheduler.QueueUploads(stagingBufferMan, tempDataBuffer);
+
+	EXPECT_TRUE(std::empty(uploadScheduler.GetQueuedTextures()))
+		<< "The texture shouldn't be transitioned before its last band.";
+
+	uploadScheduler.QueueUploads(stagingBufferMan, tempDataBuffer);
+
+	EXPECT_EQ(uploadScheduler.GetFrameStats().uploadedBytes, 4_KB) << "The last band is wrong.";
+	ASSERT_EQ(std::size(uploadScheduler.GetQueuedTextures()), 1u)
+		<< "The texture wasn't queued for the transition.";
+	EXPECT_LT(textureTicket.uploadIndex, uploadScheduler.GetQueuedCounts()[1u])
+		<< "The texture wasn't queued.";
+	EXPECT_FALSE(uploadScheduler.HasBacklog()) << "The backlog wasn't cleared.";
+
+	// The critical uploads must be submitted with the next frame, so the window doesn't apply.
+	const UploadTicket criticalTicket = uploadScheduler.AddBuffer(
+		std::make_unique<std::uint8_t[]>(20_KB), 20_KB, &testBuffer, 0u, UploadPriority::Critical
+	);
+
+	uploadScheduler.QueueUploads(stagingBufferMan, tempDataBuffer);
+
+	EXPECT_EQ(uploadScheduler.GetFrameStats().uploadedBytes, 20_KB)
+		<< "All the chunks of the critical upload should be queued.";
+	EXPECT_LT(criticalTicket.uploadIndex, uploadScheduler.GetQueuedCounts()[0u])
+		<< "The critical upload wasn't queued.";
+	EXPECT_FALSE(uploadScheduler.HasBacklog()) << "The backlog wasn't cleared.";
+}
+
+TEST_F(UploadTrackerTest, MipTest)
+{
+	ID3D12Device5* device  = s_deviceManager->GetDevice();
+	IDXGIAdapter3* adapter = s_deviceManager->GetAdapter();
+
+	MemoryManager memoryManager{ adapter, device, 20_MB, 200_KB };
+
+	ThreadPool threadPool{ 8u };
+
+	StagingBufferManager stagingBufferMan{ device, &memoryManager, &threadPool };
+
+	Texture testTexture{ device, &memoryManager, D3D12_HEAP_TYPE_DEFAULT };
+	testTexture.Create2D(64u, 64u, 7u, DXGI_FORMAT_R8G8B8A8_UNORM, D3D12_RESOURCE_STATE_COMMON);
+
+	Callisto::TemporaryDataBufferGPU tempDataBuffer{};
+
+	UploadScheduler uploadScheduler{ 0u, 4_KB, 8_KB };
+
+	std::vector<std::shared_ptr<void>> mipData{};
+
+	for (UINT mipLevelIndex = 0u; mipLevelIndex < testTexture.GetMipLevelCount(); ++mipLevelIndex)
+		mipData.emplace_back(
+			std::make_unique<std::uint8_t[]>(testTexture.GetBufferSize(mipLevelIndex))
+		);
+
+	const UploadTicket textureTicket = uploadScheduler.AddTextureMips(
+		std::move(mipData), &testTexture, UploadPriority::Normal
+	);
+
+	size_t transitionCount = 0u;
+
+	while (uploadScheduler.HasBacklog())
+	{
+		uploadScheduler.QueueUploads(stagingBufferMan, tempDataBuffer);
+
+		transitionCount += std::size(uploadScheduler.GetQueuedTextures());
+
+		if (uploadScheduler.HasBacklog())
+			EXPECT_EQ(textureTicket.uploadIndex, uploadScheduler.GetQueuedCounts()[1u])
+				<< "The texture shouldn't be queued before its last mip.";
+	}
+
+	EXPECT_EQ(transitionCount, 1u) << "The texture should only be transitioned once.";
+	EXPECT_LT(textureTicket.uploadIndex, uploadScheduler.GetQueuedCounts()[1u])
+		<< "The texture wasn't queued.";
+}
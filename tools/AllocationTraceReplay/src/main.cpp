@@ -0,0 +1,64 @@
+#include <D3DAllocationTraceRecorder.hpp>
+#include <D3DAllocationTraceReplayer.hpp>
+#include <GaiaException.hpp>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+using namespace Gaia;
+
+// Usage: GaiaXAllocationTraceReplay <trace file> [buddy|tlsf]
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		std::cerr << "Usage: " << argv[0] << " <trace file> [buddy|tlsf]\n";
+
+		return 1;
+	}
+
+	AllocationTraceReplayer::Settings settings = AllocationTraceReplayer::GetDefaultSettings();
+
+	if (argc > 2)
+	{
+		const std::string_view allocatorName = argv[2];
+
+		if (allocatorName == "tlsf")
+			settings.allocatorType = HeapAllocatorType::TLSF;
+		else if (allocatorName != "buddy")
+		{
+			std::cerr << "Unknown allocator: " << allocatorName << "\n";
+
+			return 1;
+		}
+	}
+
+	try
+	{
+		const std::vector<AllocationTraceRecorder::Event> events
+			= AllocationTraceRecorder::ReadTrace(argv[1]);
+
+		const AllocationTraceReplayer::Report report
+			= AllocationTraceReplayer{ settings }.Replay(events);
+
+		std::cout
+			<< "Events: "                         << report.eventCount << "\n"
+			<< "Unmatched events: "               << report.unmatchedEventCount << "\n"
+			<< "Frames: "                         << report.frameCount << "\n"
+			<< "Peak heap size: "                 << report.peakHeapSize << "\n"
+			<< "Peak heap used size: "            << report.peakHeapUsedSize << "\n"
+			<< "Heap fragmentation: "             << report.averageHeapFragmentation << "\n"
+			<< "Peak shared buffer size: "        << report.peakSharedBufferSize << "\n"
+			<< "Peak shared buffer used size: "   << report.peakSharedBufferUsedSize << "\n"
+			<< "Shared buffer fragmentation: "    << report.averageSharedBufferFragmentation << "\n"
+			<< "Replay time (ms): "               << report.replayMilliseconds << "\n";
+	}
+	catch (const Exception& exception)
+	{
+		std::cerr << exception.GetType() << ": " << exception.what() << "\n";
+
+		return 1;
+	}
+
+	return 0;
+}